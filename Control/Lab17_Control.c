@@ -59,26 +59,89 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/SysTickInts.h"
 #include "../inc/Tachometer.h"
 #include "../inc/Reflectance.h"
+#include "../inc/Format.h"
+#include "../inc/SpeedControl.h"
 //******************************************************
 // Distance to wall proportional control
 // Incremental speed control 
 // Integral control, Line follower
+
+// Speed control demo: SW1 runs the sequence below, a bump or SW2
+// stops. Each step holds both wheels at a speed in mm/s, negative is
+// backward, so the robot covers the same distance on any battery.
+struct Step{
+  int32_t Left, Right;   // mm/s
+  uint32_t Time;         // controller periods, 1/SPEED_RATE s
+};
+const struct Step Sequence[] = {
+  { 150,  150, 200},     // slow forward 2 s
+  { 300,  300, 200},     // forward 2 s
+  { 500,  500, 100},     // fast forward 1 s
+  { 200, -200,  50},     // spin right
+  {-300, -300, 100},     // back up 1 s
+  {   0,    0,   0}      // stop
+};
+
+volatile uint32_t Ticks;   // controller periods since the last step
 void Controller(void){
-// write this as part of Lab 17
+  SpeedControl_Update();
+  Ticks = Ticks+1;
+}
 
+// print setpoint and measured speed of both wheels
+void Report(const struct Step *s){
+  int32_t left, right;
+  SpeedControl_Get(&left, &right);
+  Format_OutSDecWidth(&UART0_OutString, s->Left, 5);
+  Format_OutSDecWidth(&UART0_OutString, left, 6);
+  Format_OutSDecWidth(&UART0_OutString, s->Right, 6);
+  Format_OutSDecWidth(&UART0_OutString, right, 6);
+  UART0_OutString(" mm/s\r\n");
+}
+
+// run the sequence until it ends or a bump or SW2 stops it
+void Run(void){
+  const struct Step *s = Sequence;
+  uint32_t report;
+  while(s->Time){
+    SpeedControl_Set(s->Left, s->Right);
+    Ticks = 0;
+    report = 0;
+    while(Ticks < s->Time){
+      if(Bump_Read() || (LaunchPad_Input()&0x02)){
+        SpeedControl_Set(0, 0);
+        LaunchPad_Output(0x01);  // red, stopped early
+        UART0_OutString("stopped\r\n");
+        return;
+      }
+      if(Ticks >= report){     // twice a second
+        Report(s);
+        report = report+SPEED_RATE/2;
+      }
+      Clock_Delay1ms(10);
+    }
+    s++;
+  }
+  SpeedControl_Set(0, 0);
+  LaunchPad_Output(0x02);      // green, done
 }
 
 void main(void){
   DisableInterrupts();
 // initialization
-// write this as part of Lab 17
-
+  Clock_Init48MHz();
+  LaunchPad_Init();
+  Bump_Init();
+  SpeedControl_Init();
+  UART0_Init();
+  TimerA1_Init(&Controller, 500000/SPEED_RATE);  // 100 Hz
   EnableInterrupts();
-
+  UART0_OutString("Lab17 speed control, SW1 to run\r\n");
+  UART0_OutString("  set  left   set right\r\n");
   while(1){
-// write this as part of Lab 17
-
-
+    while((LaunchPad_Input()&0x01) == 0){};    // wait for SW1
+    while(LaunchPad_Input()&0x01){};           // and its release
+    LaunchPad_Output(0x04);    // blue, running
+    Run();
   }
 }
-
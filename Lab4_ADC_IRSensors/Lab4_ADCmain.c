@@ -65,6 +65,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/UART0.h"
 #include "../inc/LaunchPad.h"
 #include "../inc/ADC14.h"
+#include "../inc/ADC14DMA.h"
 #include "../inc/LPF.h"
 
 volatile uint32_t ADCvalue;
@@ -83,12 +84,30 @@ void SensorRead_ISR(void){  // runs at 2000 Hz
   P1OUT ^= 0x01;         // profile
 }
 
+// 1 to oversample at 100 kHz with DMA instead of SensorRead_ISR
+#define OVERSAMPLE 0
+#if OVERSAMPLE
+#define RATE 4167        // Oversample_Task calls per second
+#else
+#define RATE 2000        // SensorRead_ISR calls per second
+#endif
+
+// 100 kHz conversions moved by DMA, decimated 8 to 1 per channel
+void Oversample_Task(uint32_t raw17, uint32_t raw12, uint32_t raw16){ // runs at 4167 Hz
+  P1OUT ^= 0x01;         // profile
+  nr = LPF_Calc(raw17);  // right is channel 17 P9.0
+  nc = LPF_Calc2(raw12);  // center is channel 12, P4.1
+  nl = LPF_Calc3(raw16);  // left is channel 16, P9.1
+  ADCflag = 1;           // semaphore
+  P1OUT ^= 0x01;         // profile
+}
+
 int main(void){
   uint32_t raw17,raw12,raw16;
   int32_t n; uint32_t s;
   Clock_Init48MHz();  //SMCLK=12Mhz
   ADCflag = 0;
-  s = 256; // replace with your choice
+  s = 256; // replace with your choice, 1 to LPF_FIXEDSIZE
   ADC0_InitSWTriggerCh17_12_16();   // initialize channels 17,12,16
   ADC_In17_12_16(&raw17,&raw12,&raw16);  // sample
   LPF_Init(raw17,s);     // P9.0/channel 17
@@ -96,13 +115,18 @@ int main(void){
   LPF_Init3(raw16,s);     // P9.1/channel 16
   UART0_Init();          // initialize UART0 115,200 baud rate
   LaunchPad_Init();
+#if OVERSAMPLE
+  ADC0_InitDMACh17_12_16(&Oversample_Task,120,3);  // 100 kHz conversions, average of 8
+  UART0_OutString("GP2Y0A21YK0F DMA oversampling test\nConnect analog signals to P9.0,P4.1,P9.1\n");
+#else
   TimerA1_Init(&SensorRead_ISR,250);    // 2000 Hz sampling
   UART0_OutString("GP2Y0A21YK0F test\nValvano Oct 2017\nConnect analog signals to P9.0,P4.1,P9.1\n");
+#endif
   EnableInterrupts();
   while(1){
-    for(n=0; n<2000; n++){
+    for(n=0; n<RATE; n++){
       while(ADCflag == 0){};
-      ADCflag = 0; // show every 2000th point
+      ADCflag = 0; // show one point a second
     }
     UART0_OutUDec5(LeftConvert(nl));UART0_OutString(" mm,");
     UART0_OutUDec5(CenterConvert(nc));UART0_OutString(" mm,");
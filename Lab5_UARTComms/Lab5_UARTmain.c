@@ -30,6 +30,7 @@
 #include "../inc/IRDistance.h"
 #include "../inc/ADC14.h"
 #include "../inc/LPF.h"
+#include "../inc/FilterBank.h"
 #include "../inc/TimerA1.h"
 #include "../inc/SysTickInts.h"
 #include "../inc/CortexM.h"
@@ -38,6 +39,17 @@
 #include "../inc/UART0.h"
 #include "../inc/EUSCIA0.h"
 #include "../inc/FIFO0.h"
+#include "../inc/Telemetry.h"
+#include "../inc/LogicCapture.h"
+#include "../inc/Scheduler.h"
+#include "../inc/SpeedControl.h"
+#include "../inc/Motion.h"
+#include "../inc/Odometry.h"
+#include "../inc/Format.h"
+#include "../inc/Nokia5110.h"
+#include "../inc/Widget.h"
+#include "../inc/FlashProgram.h"
+#include "../inc/FlightLog.h"
 
 //=========================================================================================
 // SECTION 1: GLOBAL VARIABLES & CONFIGURATIONS
@@ -50,7 +62,6 @@ volatile uint32_t bump_count = 0;
 volatile uint8_t emergency_stop = 0;
 
 // SysTick timing
-volatile uint32_t systick_counter = 0;
 volatile uint8_t systick_10ms_flag = 0;
 volatile uint8_t systick_100ms_flag = 0;
 volatile uint8_t systick_1s_flag = 0;
@@ -63,9 +74,15 @@ volatile uint32_t ir_left = 0, ir_center = 0, ir_right = 0;
 volatile uint8_t line_detected = 0;
 volatile uint8_t obstacle_detected = 0;
 
-// Tachometer data
-volatile uint16_t left_tach = 0, right_tach = 0;
-volatile int32_t left_steps = 0, right_steps = 0;
+// IR filters: FILTER_LPF (256-point average, about 0.26 s delay at 500 Hz),
+// FILTER_IIR, FILTER_MEDIAN or FILTER_KALMAN, see FilterBank.h
+#define IR_FILTER FILTER_LPF
+#define IR_LPF_SIZE 256
+struct Filter IRFilter[3];              // 0 right (17), 1 center (12), 2 left (16)
+uint16_t IRFilterBuf[3][IR_LPF_SIZE];   // only used by FILTER_LPF
+// Timer A1 counts (2us) between conversions; one triple every
+// 3*333*2us = 2 ms, 500 Hz, filtered in the ADC14 interrupt
+#define IR_SAMPLE_PERIOD 333
 
 // State machine variables
 typedef enum {
@@ -106,6 +123,7 @@ volatile uint16_t data_count = 0;
  * TO DISABLE: P4->IE &= ~0xED or don't call BumpInt_Init()
  */
 void Bump_ISR(uint8_t bumps){
+    Motion_Stop();    // ends a profiled move
     Motor_Stop();
     bump_triggered = 1;
     bump_value = bumps;
@@ -115,12 +133,149 @@ void Bump_ISR(uint8_t bumps){
 }
 
 /**
- * SYSTICK ISR - Periodic tasks every 1ms
+ * SCHEDULED TASKS - run by Scheduler_Run() in PendSV, not in the SysTick ISR
+ */
+void Reflectance_End_Task(void){
+    reflectance_data = Reflectance_End();
+    new_reflectance_data = 1;
+
+    // Check for line
+    if(reflectance_data & 0x18){
+        line_detected = 1;
+    } else {
+        line_detected = 0;
+    }
+}
+
+void Obstacle_Task(void){
+    // Check for obstacles, ir_center is updated by IR_Sample_ISR
+    uint32_t center_dist = CenterConvert(ir_center);
+    if(center_dist < 200){
+        obstacle_detected = 1;
+    } else {
+        obstacle_detected = 0;
+    }
+}
+
+void Flag10ms_Task(void){
+    systick_10ms_flag = 1;
+}
+
+void Flag100ms_Task(void){
+    systick_100ms_flag = 1;
+}
+
+void Odometry_Task(void){
+    uint16_t leftTach, rightTach;
+    enum TachDirection leftDir, rightDir;
+    int32_t leftSteps, rightSteps;
+    Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+    Odometry_Update(leftSteps, rightSteps);
+}
+
+// Pose to the origin, heading along x
+void Odometry_Reset(void){
+    uint16_t leftTach, rightTach;
+    enum TachDirection leftDir, rightDir;
+    int32_t leftSteps, rightSteps;
+    Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+    Odometry_Init(WHEELBASE, WHEEL_CIRCUMFERENCE, STEPS_PER_REV, leftSteps, rightSteps);
+}
+
+// Nokia5110 dashboard: reflectance bar on top, wheel speeds
+// scrolling on the left, IR distances left, center, right as bars
+struct Reflect ReflectBar;
+struct Chart SpeedChart;
+struct Gauge IRGauge[3];                // 0 left, 1 center, 2 right
+
+void Display_Init(void){
+    uint32_t i;
+    Nokia5110_Init();
+    Nokia5110_ClearBuffer();
+    Widget_InitReflect(&ReflectBar, 2, 0, 11, 8);
+    Widget_InitChart(&SpeedChart, 0, 10, 60, 38, -MOTION_VMAX, MOTION_VMAX, 2);
+    for(i = 0; i < 3; i++){
+        Widget_InitGauge(&IRGauge[i], 63 + 7*i, 10, 6, 38, 0, IR_MAXDIST, 1);
+    }
+    Nokia5110_DisplayBuffer();
+}
+
+// Only what changed is drawn, and only that is sent by the DMA
+void Display_Task(void){
+    int32_t speed[2];
+    Widget_Reflect(&ReflectBar, reflectance_data);
+    SpeedControl_Get(&speed[0], &speed[1]);
+    Widget_Chart(&SpeedChart, speed);
+    Widget_Gauge(&IRGauge[0], LeftConvert(ir_left));
+    Widget_Gauge(&IRGauge[1], CenterConvert(ir_center));
+    Widget_Gauge(&IRGauge[2], RightConvert(ir_right));
+    Nokia5110_DisplayBuffer();
+}
+
+// Flight recorder: a snapshot every 100 ms into the last 64 KB of
+// flash Bank 1, 1778 to 1905 records or about 3 minutes, kept at power-off
+#define FLIGHT_BASE    0x00030000
+#define FLIGHT_SECTORS 16
+volatile uint8_t flight_recording = 0;
+
+void Recorder_Task(void){
+    struct TelemetryRecord r;
+    uint16_t leftTach, rightTach;
+    enum TachDirection leftDir, rightDir;
+    int32_t leftSteps, rightSteps;
+    if(flight_recording == 0){
+        return;
+    }
+    Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+    r.Time = time_ms;
+    r.Reflectance = reflectance_data;
+    r.Bumps = Bump_Read();
+    r.IR[0] = ir_left;
+    r.IR[1] = ir_center;
+    r.IR[2] = ir_right;
+    r.Period[0] = leftTach;
+    r.Period[1] = rightTach;
+    r.Steps[0] = leftSteps;
+    r.Steps[1] = rightSteps;
+    r.Duty[0] = TIMER_A0->CCR[3];         // P5.4 high is left backward
+    if(P5->OUT & 0x10) r.Duty[0] = -r.Duty[0];
+    r.Duty[1] = TIMER_A0->CCR[4];         // P5.5 high is right backward
+    if(P5->OUT & 0x20) r.Duty[1] = -r.Duty[1];
+    FlightLog_Add(&r);
+}
+
+void Heartbeat_Task(void){
+    systick_1s_flag = 1;
+    P2->OUT ^= 0x02;  // Toggle green LED heartbeat
+}
+
+// Period and phase in 1 ms ticks, priority 0 is the highest.
+// Reflectance_End must follow Reflectance_Start by 1 ms.
+struct SchedTask Tasks[] = {
+    {.Name = "Refl End",   .Task = &Reflectance_End_Task, .Period = 10,   .Phase = 1,   .Priority = 0},
+    {.Name = "Refl Start", .Task = &Reflectance_Start,    .Period = 10,   .Phase = 0,   .Priority = 1},
+    {.Name = "Obstacle",   .Task = &Obstacle_Task,        .Period = 50,   .Phase = 5,   .Priority = 2},
+    {.Name = "Motion",     .Task = &Motion_Update,        .Period = 10,   .Phase = 3,   .Priority = 2},  // SPEED_RATE
+    {.Name = "Odometry",   .Task = &Odometry_Task,        .Period = 10,   .Phase = 4,   .Priority = 2},
+    {.Name = "10ms Flag",  .Task = &Flag10ms_Task,        .Period = 10,   .Phase = 9,   .Priority = 3},
+    {.Name = "100ms Flag", .Task = &Flag100ms_Task,       .Period = 100,  .Phase = 99,  .Priority = 3},
+    {.Name = "Display",    .Task = &Display_Task,         .Period = 100,  .Phase = 7,   .Priority = 4},
+    {.Name = "Recorder",   .Task = &Recorder_Task,        .Period = 100,  .Phase = 8,   .Priority = 4},
+    {.Name = "Heartbeat",  .Task = &Heartbeat_Task,       .Period = 1000, .Phase = 999, .Priority = 4},
+};
+#define NUM_TASKS (sizeof(Tasks)/sizeof(Tasks[0]))
+
+// DWT cycle counter, 48 per us
+uint32_t Cycle_Count(void){
+    return DWT->CYCCNT;
+}
+
+/**
+ * SYSTICK ISR - 1ms tick, releases the scheduled tasks
  * TO ENABLE: SysTick_Init(48000, 2)
  * TO DISABLE: SysTick->CTRL = 0
  */
 void SysTick_Handler(void){
-    systick_counter++;
     time_ms++;
 
     // State machine timer
@@ -128,55 +283,47 @@ void SysTick_Handler(void){
         state_timer--;
     }
 
-    // 10ms tasks
-    if(systick_counter % 10 == 0){
-        systick_10ms_flag = 1;
-
-        // Start reflectance reading
-        Reflectance_Start();
+    if(Scheduler_Tick()){
+        SCB->ICSR = 0x10000000;  // PENDSVSET, run the tasks after this and every other ISR
     }
+}
 
-    // 11ms - complete reflectance reading
-    if(systick_counter % 10 == 1){
-        reflectance_data = Reflectance_End();
-        new_reflectance_data = 1;
+/**
+ * PENDSV ISR - lowest priority, runs the released tasks
+ */
+void PendSV_Handler(void){
+    Scheduler_Run();
+}
 
-        // Check for line
-        if(reflectance_data & 0x18){
-            line_detected = 1;
-        } else {
-            line_detected = 0;
-        }
-    }
+/**
+ * Start the scheduler, call before SysTick_Init
+ */
+void Scheduler_Start(void){
+    CoreDebug->DEMCR |= 0x01000000;  // TRCENA, enable the DWT
+    DWT->CTRL |= 0x00000001;         // CYCCNTENA, free running for Clock_Now()
+    Scheduler_Init(Tasks, NUM_TASKS, &Cycle_Count);
+    SCB->SHP[10] = 7<<5;             // PendSV priority 7, below every interrupt
+}
 
-    // 50ms tasks
-    if(systick_counter % 50 == 0){
-        // Read IR sensors
-        uint32_t raw17, raw12, raw16;
-        ADC_In17_12_16(&raw17, &raw12, &raw16);
-        ir_right = LPF_Calc(raw17);
-        ir_center = LPF_Calc2(raw12);
-        ir_left = LPF_Calc3(raw16);
-
-        // Check for obstacles
-        uint32_t center_dist = CenterConvert(ir_center);
-        if(center_dist < 200){
-            obstacle_detected = 1;
-        } else {
-            obstacle_detected = 0;
+/**
+ * Print runs, overruns, worst-case time and CPU load of each task
+ */
+void Scheduler_Report(void){
+    uint32_t i, ticks = Scheduler_Now();
+    UART0_OutString("\n\rTask        Runs  Overruns  WCET(us)  Load(%)\n\r");
+    for(i = 0; i < NUM_TASKS; i++){
+        UART0_OutString((char *)Tasks[i].Name);
+        UART0_OutString("  ");
+        UART0_OutUDec(Tasks[i].Runs);
+        UART0_OutString("  ");
+        UART0_OutUDec(Tasks[i].Overruns);
+        UART0_OutString("  ");
+        UART0_OutUDec(Tasks[i].WCET/48);
+        UART0_OutString("  ");
+        if(ticks){              // 48000 cycles per tick, load in 0.01%
+            UART0_OutUFix2((uint32_t)(((uint64_t)Tasks[i].Cycles*10000)/((uint64_t)ticks*48000)));
         }
-    }
-
-    // 100ms tasks
-    if(systick_counter % 100 == 0){
-        systick_100ms_flag = 1;
-    }
-
-    // 1 second tasks
-    if(systick_counter >= 1000){
-        systick_counter = 0;
-        systick_1s_flag = 1;
-        P2->OUT ^= 0x02;  // Toggle green LED heartbeat
+        UART0_OutString("\n\r");
     }
 }
 
@@ -194,6 +341,40 @@ void TimerA1_Task(void){
 // SECTION 3: COMPLETE SYSTEM INITIALIZATION
 //=========================================================================================
 
+/**
+ * Initialize the three IR filters selected by IR_FILTER
+ */
+void IR_Filter_Init(uint32_t raw17, uint32_t raw12, uint32_t raw16){
+    uint32_t raw[3];
+    int i;
+    raw[0] = raw17; raw[1] = raw12; raw[2] = raw16;
+    for(i = 0; i < 3; i++){
+        switch(IR_FILTER){
+            case FILTER_IIR:
+                Filter_InitIIR(&IRFilter[i], 2, raw[i]);          // time constant 4 samples
+                break;
+            case FILTER_MEDIAN:
+                Filter_InitMedian(&IRFilter[i], 5, raw[i]);       // rejects 2-sample spikes
+                break;
+            case FILTER_KALMAN:
+                Filter_InitKalman(&IRFilter[i], 4.0f, 400.0f, raw[i]);
+                break;
+            default:
+                Filter_InitLPF(&IRFilter[i], IRFilterBuf[i], IR_LPF_SIZE, raw[i]);
+                break;
+        }
+    }
+}
+
+/**
+ * ADC14 end-of-sequence task, runs every IR_SAMPLE_PERIOD triple
+ */
+void IR_Sample_ISR(uint32_t raw17, uint32_t raw12, uint32_t raw16){
+    ir_right = Filter_Calc(&IRFilter[0], raw17);
+    ir_center = Filter_Calc(&IRFilter[1], raw12);
+    ir_left = Filter_Calc(&IRFilter[2], raw16);
+}
+
 /**
  * Initialize ALL hardware - call once at start
  */
@@ -219,12 +400,21 @@ void System_Init(void){
     // Initialize filters for IR sensors
     uint32_t raw17, raw12, raw16;
     ADC_In17_12_16(&raw17, &raw12, &raw16);
-    LPF_Init(raw17, 256);
-    LPF_Init2(raw12, 256);
-    LPF_Init3(raw16, 256);
+    IR_Filter_Init(raw17, raw12, raw16);
+    // Then sample in the background, Timer A1 triggers the ADC
+    ADC0_InitTimerTriggerCh17_12_16(&IR_Sample_ISR, IR_SAMPLE_PERIOD);
+
+    // Tachometers and speed control for the profiled moves
+    Motion_Init(WHEELBASE, WHEEL_CIRCUMFERENCE, STEPS_PER_REV);
+    Odometry_Reset();
 
-    // Optional: Tachometer
-    // Tachometer_Init();
+    // Dashboard on the Nokia5110, updated by Display_Task
+    Display_Init();
+
+    // Flight recorder, continues the log already in flash
+    if(FlightLog_Init(FLIGHT_BASE, FLIGHT_SECTORS) == NOERROR){
+        flight_recording = 1;
+    }
 
     EnableInterrupts();
 }
@@ -239,8 +429,9 @@ void System_Init_With_Interrupts(void){
 
     // Enable interrupts
     BumpInt_Init(&Bump_ISR);
+    Scheduler_Start();
     SysTick_Init(48000, 2);  // 1ms period
-    // TimerA1_Init(&TimerA1_Task, 50000);  // Optional timer
+    // TimerA1_Init(&TimerA1_Task, 50000);  // Optional timer, Timer A1 is used by the IR ADC
 
     EnableInterrupts();
 }
@@ -314,42 +505,52 @@ void Pivot_Left(uint16_t speed, uint32_t time_ms){
     Motor_Stop();
 }
 
-// === Smooth Acceleration/Deceleration ===
-void Smooth_Accelerate_Forward(void){
-    uint16_t speed;
-    for(speed = 0; speed < 5000; speed += 100){
-        Motor_Forward(speed, speed);
-        Clock_Delay1ms(10);
+// === Profiled Moves ===
+// Motion_Straight() and Motion_Rotate() ramp up and down with limited
+// acceleration and jerk and return at once; Motion_Update() runs in
+// the scheduler every 10 ms and Motion_Busy() is 0 at the end.
+void Motion_Begin(void){
+    if((SysTick->CTRL & 0x01) == 0){  // the scheduler runs Motion_Update
+        Scheduler_Start();
+        SysTick_Init(48000, 2);
     }
 }
 
-void Smooth_Decelerate_Stop(void){
-    uint16_t speed;
-    for(speed = 5000; speed > 0; speed -= 100){
-        Motor_Forward(speed, speed);
-        Clock_Delay1ms(10);
+void Wait_For_Motion(void){
+    while(Motion_Busy()){
+        WaitForInterrupt();
     }
-    Motor_Stop();
 }
 
 // === Reflectance Sensor Functions ===
+// While the scheduler runs, Reflectance_Start/Reflectance_End own the
+// sensors and reflectance_data is at most 10 ms old; a blocking read
+// in the foreground would only make the scheduler skip a scan.
+uint8_t Line_Read(void){
+    int data;
+    if(SysTick->CTRL & 0x01){
+        return reflectance_data;
+    }
+    data = Reflectance_Read(1000);
+    if(data == REFLECTANCE_BUSY){       // the last scheduled scan still running
+        return reflectance_data;
+    }
+    return data;
+}
+
 uint8_t Is_On_Line(void){
-    uint8_t data = Reflectance_Read(1000);
+    uint8_t data = Line_Read();
     return ((data & 0x18) != 0);  // Check center sensors
 }
 
 int32_t Get_Line_Position(void){
-    uint8_t data = Reflectance_Read(1000);
+    uint8_t data = Line_Read();
     return Reflectance_Position(data);
 }
 
 uint8_t Count_Sensors_On_Line(void){
-    uint8_t data = Reflectance_Read(1000);
-    uint8_t count = 0;
-    for(int i = 0; i < 8; i++){
-        if(data & (1 << i)) count++;
-    }
-    return count;
+    uint8_t data = Line_Read();
+    return Reflectance_Count(data);
 }
 
 // === Bump Switch Functions ===
@@ -387,12 +588,11 @@ uint8_t Read_Binary_From_Bumps(void){
 }
 
 // === IR Distance Sensor Functions ===
+// latest filtered values, sampled in the background by IR_Sample_ISR
 void Read_IR_Sensors(uint32_t *left, uint32_t *center, uint32_t *right){
-    uint32_t raw17, raw12, raw16;
-    ADC_In17_12_16(&raw17, &raw12, &raw16);
-    *right = LPF_Calc(raw17);
-    *center = LPF_Calc2(raw12);
-    *left = LPF_Calc3(raw16);
+    *right = ir_right;
+    *center = ir_center;
+    *left = ir_left;
 }
 
 void Get_IR_Distances_mm(int32_t *left_mm, int32_t *center_mm, int32_t *right_mm){
@@ -418,65 +618,38 @@ void Read_Tachometer_Data(uint16_t *leftTach, uint16_t *rightTach,
 }
 
 void Move_Distance(int32_t distance_mm){
-    uint16_t leftTach, rightTach;
-    int32_t leftSteps_start, rightSteps_start;
-    int32_t leftSteps_current, rightSteps_current;
-
-    Read_Tachometer_Data(&leftTach, &rightTach,
-                        &leftSteps_start, &rightSteps_start);
-
-    int32_t required_steps = (distance_mm * STEPS_PER_REV) / WHEEL_CIRCUMFERENCE;
-
-    Motor_Forward(3000, 3000);
-
-    while(1){
-        Read_Tachometer_Data(&leftTach, &rightTach,
-                            &leftSteps_current, &rightSteps_current);
-
-        int32_t traveled_steps = leftSteps_current - leftSteps_start;
-
-        if(traveled_steps >= required_steps){
-            Motor_Stop();
-            break;
-        }
-        Clock_Delay1ms(10);
-    }
+    Motion_Begin();
+    Motion_Straight(distance_mm, 0);
+    Wait_For_Motion();
 }
 
 void Rotate_Angle(int32_t angle_degrees){
-    int32_t distance_per_wheel = (WHEELBASE * 314 * abs(angle_degrees)) / (100 * 360);
-    int32_t required_steps = (distance_per_wheel * STEPS_PER_REV) / WHEEL_CIRCUMFERENCE;
-
-    uint16_t leftTach, rightTach;
-    int32_t leftSteps_start, rightSteps_start;
-    int32_t leftSteps_current, rightSteps_current;
-
-    Read_Tachometer_Data(&leftTach, &rightTach,
-                        &leftSteps_start, &rightSteps_start);
-
-    if(angle_degrees > 0){
-        Motor_Right(2000, 2000);
-    } else {
-        Motor_Left(2000, 2000);
-    }
-
-    while(1){
-        Read_Tachometer_Data(&leftTach, &rightTach,
-                            &leftSteps_current, &rightSteps_current);
-
-        int32_t traveled_steps = abs(leftSteps_current - leftSteps_start);
+    Motion_Begin();
+    Motion_Rotate(angle_degrees, 0);
+    Wait_For_Motion();
+}
 
-        if(traveled_steps >= required_steps){
-            Motor_Stop();
-            break;
-        }
-        Clock_Delay1ms(10);
-    }
+// === Dead Reckoning ===
+// Odometry_Task updates the pose every 10 ms in the scheduler
+void Display_Pose(void){
+    struct Pose pose;
+    Odometry_Get(&pose);
+    UART0_OutString("x ");
+    Format_OutSDec(&UART0_OutString, pose.X>>16);
+    UART0_OutString(" mm, y ");
+    Format_OutSDec(&UART0_OutString, pose.Y>>16);
+    UART0_OutString(" mm, heading ");
+    Format_OutSDec(&UART0_OutString, (int32_t)pose.Theta/ODOMETRY_DEGREE);
+    UART0_OutString(" deg, var x ");
+    UART0_OutUDec(pose.Pxx>>16);
+    UART0_OutString(" y ");
+    UART0_OutUDec(pose.Pyy>>16);
+    UART0_OutString(" mm^2\n\r");
 }
 
 // === UART Display Functions ===
 void Display_Sensor_Data(void){
-    uint8_t reflectance = Reflectance_Read(1000);
+    uint8_t reflectance = Line_Read();
     int32_t position = Reflectance_Position(reflectance);
     uint8_t bumps = Bump_Read();
     int32_t left_mm, center_mm, right_mm;
@@ -505,6 +678,128 @@ void Display_Sensor_Data(void){
     UART0_OutString("mm\n\r");
 }
 
+/**
+ * Stream binary sensor snapshots until SW1 is pressed.
+ * About 500 samples/s, decode on the PC with tools/telemetry/telemetry2csv.
+ * Time comes from time_ms, which runs after System_Init_With_Interrupts().
+ */
+void Stream_Telemetry(void){
+    struct TelemetryRecord r;
+    uint32_t left, center, right;
+    uint16_t leftTach, rightTach;
+    enum TachDirection leftDir, rightDir;
+
+    UART0_OutString("Streaming telemetry, press SW1 to stop\n\r");
+    UART0_Flush();
+    Telemetry_Init();
+    while((P1->IN & 0x02) != 0){
+        r.Time = time_ms;
+        r.Reflectance = Line_Read();
+        r.Bumps = Bump_Read();
+        Read_IR_Sensors(&left, &center, &right);
+        r.IR[0] = left;
+        r.IR[1] = center;
+        r.IR[2] = right;
+        Tachometer_Get(&leftTach, &leftDir, &r.Steps[0], &rightTach, &rightDir, &r.Steps[1]);
+        r.Period[0] = leftTach;
+        r.Period[1] = rightTach;
+        r.Duty[0] = TIMER_A0->CCR[3];     // P5.4 high is left backward
+        if(P5->OUT & 0x10) r.Duty[0] = -r.Duty[0];
+        r.Duty[1] = TIMER_A0->CCR[4];     // P5.5 high is right backward
+        if(P5->OUT & 0x20) r.Duty[1] = -r.Duty[1];
+        Telemetry_Add(&r);
+        Clock_Delay1ms(1);
+    }
+    Telemetry_Flush();
+    UART0_OutString("\n\rTelemetry stopped, dropped frames: ");
+    UART0_OutUDec(Telemetry_Dropped());
+    UART0_OutString("\n\r");
+}
+
+/**
+ * Send the flight log in telemetry frames, oldest first, then the
+ * record counts. Decode on the PC with tools/telemetry/telemetry2csv.
+ * The frames carry no sequence numbers, so records missing between
+ * the first and the last one sent (torn or failed bursts) are
+ * counted and reported with the totals.
+ * Recording pauses while the log is read.
+ */
+uint32_t dump_first, dump_next, dump_sent, dump_gaps, dump_missing;
+void Dump_Record(uint32_t seq, const struct TelemetryRecord *r){
+    if(dump_sent == 0){
+        dump_first = seq;
+    }else if(seq != dump_next){         // FlightLog_Walk goes oldest first
+        dump_gaps++;
+        dump_missing += seq - dump_next;
+    }
+    dump_next = seq + 1;
+    dump_sent++;
+    Telemetry_Wait();                   // a dump waits rather than drops
+    Telemetry_Add(r);
+}
+void Dump_Flight_Log(void){
+    uint8_t recording = flight_recording;
+    uint32_t count;
+    flight_recording = 0;
+    FlightLog_Flush();
+    UART0_OutString("Flight log, decode with tools/telemetry/telemetry2csv\n\r");
+    UART0_Flush();
+    Telemetry_Init();
+    dump_sent = dump_gaps = dump_missing = 0;
+    count = FlightLog_Walk(&Dump_Record);
+    Telemetry_Flush();
+    UART0_OutString("\n\rRecords: ");
+    UART0_OutUDec(count);
+    if(count){
+        UART0_OutString(", seq ");
+        UART0_OutUDec(dump_first);
+        UART0_OutString(" to ");
+        UART0_OutUDec(dump_next - 1);
+        UART0_OutString(", gaps: ");
+        UART0_OutUDec(dump_gaps);
+        UART0_OutString(" (");
+        UART0_OutUDec(dump_missing);
+        UART0_OutString(" records)");
+    }
+    UART0_OutString(", next: ");
+    UART0_OutUDec(FlightLog_Next());
+    UART0_OutString(", lost: ");
+    UART0_OutUDec(FlightLog_Lost());
+    UART0_OutString(", erases: ");
+    UART0_OutUDec(FlightLog_Erases());
+    UART0_OutString("\n\r");
+    flight_recording = recording;
+}
+
+void Clear_Flight_Log(void){
+    uint8_t recording = flight_recording;
+    flight_recording = 0;
+    if(FlightLog_Clear() == NOERROR){
+        UART0_OutString("Flight log cleared\n\r");
+    }else{
+        UART0_OutString("Flight log: erase failed\n\r");
+    }
+    flight_recording = recording;
+}
+
+/**
+ * Capture the bump switches (P4) and line sensor (P7) at 100 kHz
+ * until SW1 is pressed. Convert on the PC with
+ * tools/logic/logic2vcd -0 P4 -1 P7
+ */
+void Logic_Capture(void){
+    UART0_OutString("Capturing P4 bumps and P7 line sensor, press SW1 to stop\n\r");
+    LogicCapture_Init(&P4->IN, 0xED, &P7->IN, 0xFF, 100000, 2);
+    while((P1->IN & 0x02) != 0){
+        Line_Read();                // something to see on P7, unless the scheduler is scanning
+        Clock_Delay1ms(10);
+    }
+    LogicCapture_Stop();
+    UART0_OutString("\n\rCapture stopped, dropped samples: ");
+    UART0_OutUDec(LogicCapture_Dropped());
+    UART0_OutString("\n\r");
+}
+
 //=========================================================================================
 // SECTION 5: L-TASK FUNCTIONS (Simple, Single Module)
 //=========================================================================================
@@ -516,7 +811,7 @@ void L1_LED_Line_Detect(void){
     UART0_OutString("L1: LED responds to line sensor\n\r");
 
     while(1){
-        uint8_t data = Reflectance_Read(1000);
+        uint8_t data = Line_Read();
 
         if(data & 0x01){  // Sensor 1 (rightmost)
             RedLED_On();
@@ -598,7 +893,7 @@ void M1_Line_Turn_Right(void){
     Motor_Forward(3000, 3000);
 
     while(1){
-        uint8_t data = Reflectance_Read(1000);
+        uint8_t data = Line_Read();
 
         if(data & 0x18){  // Center sensors detect line
             Motor_Stop();
@@ -684,7 +979,7 @@ void H1_Line_Following_PD(void){
             int32_t position;
 
             // Read all 8 reflectance sensors
-            data = Reflectance_Read(1000);
+            data = Line_Read();
 
             // Calculate position (-332 to +332 in 0.1mm units)
             // Negative = line to the left, Positive = line to the right
@@ -887,7 +1182,7 @@ void H4_Maze_Navigation(void){
         Get_IR_Distances_mm(&left_dist, &center_dist, &right_dist);
 
         // Check for parking spot (all sensors black)
-        uint8_t line_data = Reflectance_Read(1000);
+        uint8_t line_data = Line_Read();
         if(line_data == 0xFF){
             Motor_Stop();
             UART0_OutString("Parked!\n\r");
@@ -980,6 +1275,7 @@ void H5_Advanced_Obstacle_Avoidance(void){
 void Interrupt_Line_Follower(void){
     // Enable interrupts
     BumpInt_Init(&Bump_ISR);
+    Scheduler_Start();
     SysTick_Init(48000, 2);
 
     UART0_OutString("Interrupt Line Follower\n\r");
@@ -1023,6 +1319,7 @@ void Interrupt_Line_Follower(void){
  */
 void State_Machine_Control(void){
     BumpInt_Init(&Bump_ISR);
+    Scheduler_Start();
     SysTick_Init(48000, 2);
 
     UART0_OutString("State Machine Control\n\r");
@@ -1125,6 +1422,7 @@ void Test_Interrupts(void){
     UART0_OutString("=== Interrupt Test ===\n\r");
 
     BumpInt_Init(&Bump_ISR);
+    Scheduler_Start();
     SysTick_Init(48000, 2);
 
     UART0_OutString("Bump switches trigger red LED\n\r");
@@ -1200,6 +1498,83 @@ void Calibrate_Turns(void){
     }
 }
 
+/**
+ * Print the IR distance tables as the IRTable[] initializer
+ */
+void Print_IRTable(void){
+    const char *names[3] = {"left", "center", "right"};
+    int s, k;
+
+    UART0_OutString("uint16_t IRTable[3][IR_TABLESIZE] = {\n\r");
+    for(s = 0; s < 3; s++){
+        UART0_OutString("  { // ");
+        UART0_OutString((char *)names[s]);
+        UART0_OutString(", calibrated\n\r");
+        for(k = 0; k < IR_TABLESIZE; k++){
+            if((k % 16) == 0){
+                UART0_OutString("    ");
+            }
+            Format_OutUDecWidth(&UART0_OutString, IRTable[s][k], 3);
+            if(k < IR_TABLESIZE - 1){
+                UART0_OutString(",");
+            }
+            if(((k % 16) == 15) || (k == IR_TABLESIZE - 1)){
+                UART0_OutString("\n\r");
+            }
+        }
+        UART0_OutString((s < 2) ? "  },\n\r" : "  }\n\r");
+    }
+    UART0_OutString("};\n\r");
+}
+
+/**
+ * Calibrate the IR distance tables
+ * Place a wall at each distance in turn and press SW1;
+ * the filtered ADC values are recorded for all three sensors
+ * and fitted with IRDistance_Calibrate(). The fitted tables are
+ * only in RAM until reset; they are printed in the form of the
+ * IRTable[] initializer, to paste into inc/IRDistance.c to keep.
+ */
+#define IR_CAL_POINTS 8
+void Calibrate_IR(void){
+    const uint32_t cal_mm[IR_CAL_POINTS] = {100, 150, 200, 250, 300, 400, 500, 700};
+    uint32_t cal_adc[3][IR_CAL_POINTS];
+    uint32_t left, center, right;
+    int i, n;
+
+    UART0_OutString("=== IR Calibration ===\n\r");
+    for(i = 0; i < IR_CAL_POINTS; i++){
+        UART0_OutString("Wall at ");
+        UART0_OutUDec(cal_mm[i]);
+        UART0_OutString("mm, press SW1\n\r");
+        while((P1->IN & 0x02) != 0);   // wait for SW1
+        for(n = 0; n < IR_LPF_SIZE; n++){   // let the filters settle, one sample per 2 ms
+            Clock_Delay1ms(2);
+        }
+        Read_IR_Sensors(&left, &center, &right);
+        cal_adc[IR_LEFT][i] = left;
+        cal_adc[IR_CENTER][i] = center;
+        cal_adc[IR_RIGHT][i] = right;
+        UART0_OutString("L:");
+        UART0_OutUDec(left);
+        UART0_OutString(" C:");
+        UART0_OutUDec(center);
+        UART0_OutString(" R:");
+        UART0_OutUDec(right);
+        UART0_OutString("\n\r");
+        while((P1->IN & 0x02) == 0);   // wait for release
+        Clock_Delay1ms(200);
+    }
+    if((IRDistance_Calibrate(IR_LEFT, cal_adc[IR_LEFT], cal_mm, IR_CAL_POINTS) == 0) ||
+       (IRDistance_Calibrate(IR_CENTER, cal_adc[IR_CENTER], cal_mm, IR_CAL_POINTS) == 0) ||
+       (IRDistance_Calibrate(IR_RIGHT, cal_adc[IR_RIGHT], cal_mm, IR_CAL_POINTS) == 0)){
+        UART0_OutString("IR calibration failed\n\r");
+        return;
+    }
+    UART0_OutString("IR calibration complete\n\r");
+    Print_IRTable();
+}
+
 //=========================================================================================
 // SECTION 10: MAIN FUNCTION WITH MENU SYSTEM
 //=========================================================================================
@@ -1219,6 +1594,13 @@ void Menu_System(void){
     UART0_OutString("6. M-Tasks\n\r");
     UART0_OutString("7. H-Tasks\n\r");
     UART0_OutString("8. Interrupt Examples\n\r");
+    UART0_OutString("9. Calibrate IR\n\r");
+    UART0_OutString("T. Stream Telemetry\n\r");
+    UART0_OutString("L. Logic Capture\n\r");
+    UART0_OutString("S. Scheduler Report\n\r");
+    UART0_OutString("P. Pose\n\r");
+    UART0_OutString("F. Dump Flight Log\n\r");
+    UART0_OutString("C. Clear Flight Log\n\r");
     UART0_OutString("Select: ");
 
     choice = UART0_InChar();
@@ -1267,6 +1649,33 @@ void Menu_System(void){
             if(choice == '1') Interrupt_Line_Follower();
             if(choice == '2') State_Machine_Control();
             break;
+        case '9':
+            Calibrate_IR();
+            break;
+        case 'T':
+        case 't':
+            Stream_Telemetry();
+            break;
+        case 'L':
+        case 'l':
+            Logic_Capture();
+            break;
+        case 'S':
+        case 's':
+            Scheduler_Report();
+            break;
+        case 'P':
+        case 'p':
+            Display_Pose();
+            break;
+        case 'F':
+        case 'f':
+            Dump_Flight_Log();
+            break;
+        case 'C':
+        case 'c':
+            Clear_Flight_Log();
+            break;
         default:
             UART0_OutString("Invalid selection\n\r");
             break;
@@ -1362,6 +1771,14 @@ int main(void){
  * Motor_Left(3000, 3000);           // Turn left
  * Motor_Stop();                     // Stop both motors
  *
+ * === PROFILED MOVES ===
+ * Motion_Begin();                   // Scheduler runs Motion_Update
+ * Motion_Straight(300, &done);      // 300mm forward, returns at once
+ * Motion_Rotate(-90, 0);            // 90 degrees left
+ * Motion_Busy();                    // 1 until the move ends
+ * Move_Distance(300);               // Same, waits for the end
+ * Odometry_Get(&pose);              // x, y in Q16 mm, heading
+ *
  * === SENSOR READING ===
  * Reflectance_Read(1000);           // Returns 8-bit value
  * Bump_Read();                      // Returns 6-bit value
@@ -1374,6 +1791,7 @@ int main(void){
  *
  * === INTERRUPTS ===
  * BumpInt_Init(&handler);           // Enable bump interrupts
+ * Scheduler_Start();               // Task table in Tasks[], before SysTick_Init
  * SysTick_Init(48000, 2);          // 1ms periodic interrupt
  * EnableInterrupts();               // Global enable
  * DisableInterrupts();              // Global disable
@@ -1381,6 +1799,8 @@ int main(void){
  * === TIMING ===
  * Clock_Delay1ms(time);             // Delay in milliseconds
  * Clock_Delay1us(time);             // Delay in microseconds
+ * Clock_Sleep1ms(time);             // Delay asleep, lower power
+ * Clock_Now();                      // 64-bit time in us
  *
  * === UART OUTPUT ===
  * UART0_OutString("text");
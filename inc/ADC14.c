@@ -197,3 +197,149 @@ void ADC_In17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
 
 }
 
+
+//**********timer-triggered repeat-sequence mode**************
+// Timer A1 CCR1 (output mode 7, reset/set) gives one rising
+// edge per period on the ADC14 SHI input. The ADC runs channels
+// 17, 12, 16 in repeat-sequence mode with ADC14MSC=0, so each
+// edge converts one channel and MEM2 completes every third edge.
+// The end-of-sequence interrupt stores the triple; nothing waits
+// on BUSY or IFGR0.
+void adc14dummy(uint32_t ch17, uint32_t ch12, uint32_t ch16){};  // dummy function
+void (*ADCTask)(uint32_t ch17, uint32_t ch12, uint32_t ch16) = adc14dummy; // user function
+struct ADCTriple ADCRing[ADC_RINGSIZE];  // lock-free, written only by ADC14_IRQHandler
+volatile uint32_t ADCPutI;               // number of triples put, free running
+volatile uint32_t ADCGetI;               // number of triples got, free running
+volatile uint32_t ADCLost;               // triples overwritten before ADC_Get17_12_16
+
+// P9.0 = A17
+// P4.1 = A12
+// P9.1 = A16
+// timer trigger, repeat sequence, 3.3V reference
+// Input: task is a user function run by the ADC14 interrupt for
+//          every triple (0 for none)
+//        period is Timer A1 counts (2 us) between conversions;
+//          one triple takes 3*period
+// Output: none
+// Uses Timer A1, so TimerA1_Init() cannot be used at the same time
+void ADC0_InitTimerTriggerCh17_12_16(void(*task)(uint32_t ch17, uint32_t ch12, uint32_t ch16), uint16_t period){
+    if(task){
+        ADCTask = task;
+    }else{
+        ADCTask = adc14dummy;
+    }
+    ADCPutI = ADCGetI = 0;
+    ADCLost = 0;
+    TIMER_A1->CTL &= ~0x0030;        // halt Timer A1
+    ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0 to allow programming
+    while(ADC14->CTL0&0x00010000){}; // wait for BUSY to be zero
+    ADC14->CTL0 = 0x1C263310;        // repeat sequence, TA1 CCR1 trigger, SMCLK, on, disabled, /1, 32 SHM
+    // 31-30 ADC14PDIV  predivider,            00b = Predivide by 1
+    // 29-27 ADC14SHSx  SHM source            011b = TA1_C1
+    // 26    ADC14SHP   SHM pulse-mode          1b = SAMPCON the sampling timer
+    // 25    ADC14ISSH  invert sample-and-hold  0b = not inverted
+    // 24-22 ADC14DIVx  clock divider         000b = /1
+    // 21-19 ADC14SSELx clock source select   100b = SMCLK
+    // 18-17 ADC14CONSEQx mode select          11b = Repeat-sequence-of-channels
+    // 16    ADC14BUSY  ADC14 busy              0b (read only)
+    // 15-12 ADC14SHT1x sample-and-hold time 0011b = 32 clocks
+    // 11-8  ADC14SHT0x sample-and-hold time 0011b = 32 clocks
+    // 7     ADC14MSC   multiple sample         0b = each conversion needs a trigger
+    // 6-5   reserved                          00b (reserved)
+    // 4     ADC14ON    ADC14 on                1b = powered up
+    // 3-2   reserved                          00b (reserved)
+    // 1     ADC14ENC   enable conversion       0b = ADC14 disabled
+    // 0     ADC14SC    ADC14 start             0b = No start
+    ADC14->CTL1 = 0x00000030;        // ADC14MEM0, 14-bit, ref on, regular power
+    ADC14->MCTL[0] = 0x00000011;     // 0 to 3.3V, channel 17 (Right IR Sensor)
+    ADC14->MCTL[1] = 0x0000000C;     // 0 to 3.3V, channel 12 (Center IR Sensor)
+    ADC14->MCTL[2] = 0x00000090;     // 0 to 3.3V, channel 16 (Left IR Sensor), end of sequence
+    ADC14->CLRIFGR0 = 0x00000007;    // clear MEM0-2 flags
+    ADC14->IER0 = 0x00000004;        // interrupt on ADC14MEM2, the end of the sequence
+    ADC14->IER1 = 0;
+    P4->SEL1 |= 0x02;                // analog mode on P4.1/A12
+    P4->SEL0 |= 0x02;
+    P9->SEL1 |= 0x03;                // analog mode on P9.0/A17 and P9.1/A16
+    P9->SEL0 |= 0x03;
+    // priority 2, same as the periodic timer tasks
+    NVIC->IP[6] = (NVIC->IP[6]&0xFFFFFF00)|0x00000040;
+    NVIC->ISER[0] = 0x01000000;      // enable interrupt 24 in NVIC
+    ADC14->CTL0 |= 0x00000002;       // enable, waits for the first trigger
+    TIMER_A1->CTL = 0x0280;          // SMCLK, /4
+    TIMER_A1->EX0 = 0x0005;          // /6, 500 kHz
+    TIMER_A1->CCTL[0] = 0x0000;      // compare, no interrupt
+    TIMER_A1->CCR[0] = period-1;
+    TIMER_A1->CCTL[1] = 0x00E0;      // output mode 7, reset/set: rising edge at CCR0
+    TIMER_A1->CCR[1] = period>>1;
+    TIMER_A1->CTL |= 0x0014;         // reset and start Timer A1 in up mode
+}
+
+// ------------ADC0_StopTimerTrigger------------
+// Stop the timer-triggered conversions
+// Input: none
+// Output: none
+void ADC0_StopTimerTrigger(void){
+    TIMER_A1->CTL &= ~0x0030;        // halt Timer A1
+    ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0
+    ADC14->IER0 = 0;
+    NVIC->ICER[0] = 0x01000000;      // disable interrupt 24 in NVIC
+}
+
+void ADC14_IRQHandler(void){
+    uint32_t ch17, ch12, ch16;
+    struct ADCTriple *p;
+    ch17 = ADC14->MEM[0];            // reading MEMx clears its flag
+    ch12 = ADC14->MEM[1];
+    ch16 = ADC14->MEM[2];
+    p = &ADCRing[ADCPutI&(ADC_RINGSIZE-1)];
+    p->Ch17 = ch17;
+    p->Ch12 = ch12;
+    p->Ch16 = ch16;
+    ADCPutI = ADCPutI+1;             // publish after the data is written
+    (*ADCTask)(ch17, ch12, ch16);    // execute user task
+}
+
+// ------------ADC_Latest17_12_16------------
+// Return the most recent triple, does not wait
+// Input: pointers to store the P9.0/A17, P4.1/A12 and P9.1/A16 results
+// Output: number of triples converted so far, 0 means none yet
+uint32_t ADC_Latest17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
+    uint32_t n;
+    struct ADCTriple *p;
+    do{
+        n = ADCPutI;
+        p = &ADCRing[(n-1)&(ADC_RINGSIZE-1)];
+        *ch17 = p->Ch17;
+        *ch12 = p->Ch12;
+        *ch16 = p->Ch16;
+    }while(n != ADCPutI);            // interrupted by a new triple, read again
+    return n;
+}
+
+// ------------ADC_Get17_12_16------------
+// Remove the oldest unread triple, does not wait
+// If the consumer falls more than ADC_RINGSIZE behind, the
+// oldest triples are skipped and counted in ADCLost.
+// Input: pointers to store the P9.0/A17, P4.1/A12 and P9.1/A16 results
+// Output: 1 if a triple was returned, 0 if none was available
+int ADC_Get17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
+    uint32_t put, get;
+    struct ADCTriple *p;
+    do{
+        put = ADCPutI;
+        get = ADCGetI;
+        if(put == get){
+            return 0;                // empty
+        }
+        if((put-get) > ADC_RINGSIZE){
+            ADCLost = ADCLost+(put-get-ADC_RINGSIZE);
+            get = put-ADC_RINGSIZE;  // skip the overwritten ones
+        }
+        p = &ADCRing[get&(ADC_RINGSIZE-1)];
+        *ch17 = p->Ch17;
+        *ch12 = p->Ch12;
+        *ch16 = p->Ch16;
+    }while((ADCPutI-get) > ADC_RINGSIZE); // overwritten while copying, try again
+    ADCGetI = get+1;
+    return 1;
+}
@@ -174,4 +174,68 @@ uint32_t ADC_In12(void);
  */
 void ADC_In17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
 
+/**
+ * Number of triples kept by the timer-triggered mode, a power of 2
+ */
+#define ADC_RINGSIZE 16
+
+/**
+ * \struct ADCTriple
+ * \brief One timer-triggered conversion of channels 17, 12 and 16
+ */
+struct ADCTriple{
+  uint16_t Ch17;   /**< P9.0/A17 result 0 to 16383 */
+  uint16_t Ch12;   /**< P4.1/A12 result 0 to 16383 */
+  uint16_t Ch16;   /**< P9.1/A16 result 0 to 16383 */
+};
+
+/**
+ * Initialize 14-bit ADC0 to convert P9.0/A17, P4.1/A12 and
+ * P9.1/A16 in repeat-sequence mode, paced by Timer A1.
+ * Each Timer A1 period triggers one conversion, so a triple
+ * takes 3*period. The ADC14 interrupt at the end of each
+ * sequence stores the triple in a ring and calls task.
+ * No function in this mode waits for the ADC.
+ * @param task user function called from the ADC14 interrupt with each triple, 0 for none
+ * @param period Timer A1 counts between conversions, units 2us (500 kHz)
+ * @return none
+ * @note  Uses Timer A1 CCR0 and CCR1, so TimerA1_Init() cannot be used with it.
+ * ADC_In17_12_16() does not work in this mode.
+ * Interrupts are enabled in the main program.
+ * @brief  Initialize 14-bit ADC0 for timer-triggered sampling
+ */
+void ADC0_InitTimerTriggerCh17_12_16(void(*task)(uint32_t ch17, uint32_t ch12, uint32_t ch16), uint16_t period);
+
+/**
+ * Stop timer-triggered conversions
+ * @param none
+ * @return none
+ * @brief  Stop Timer A1 and the ADC14 interrupt
+ */
+void ADC0_StopTimerTrigger(void);
+
+/**
+ * Return the most recent timer-triggered triple without waiting.
+ * @param ch17 is a pointer to store P9.0/A17 conversion result<br>
+ * @param ch12 is a pointer to store P4.1/A12 conversion result<br>
+ * @param ch16 is a pointer to store P9.1/A16 conversion result
+ * @return number of triples converted so far, 0 if the results are not valid yet
+ * @note  Assumes ADC0_InitTimerTriggerCh17_12_16() has been called.
+ * @brief  Latest channels 17+12+16 result.
+ */
+uint32_t ADC_Latest17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
+
+/**
+ * Remove the oldest unread timer-triggered triple without waiting.
+ * Single consumer only. If more than ADC_RINGSIZE triples arrive
+ * between calls, the oldest are dropped and counted in ADCLost.
+ * @param ch17 is a pointer to store P9.0/A17 conversion result<br>
+ * @param ch12 is a pointer to store P4.1/A12 conversion result<br>
+ * @param ch16 is a pointer to store P9.1/A16 conversion result
+ * @return 1 if a triple was returned, 0 if there was none
+ * @note  Assumes ADC0_InitTimerTriggerCh17_12_16() has been called.
+ * @brief  Next channels 17+12+16 result.
+ */
+int ADC_Get17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
+
 #endif /* ADC14_H_ */
@@ -0,0 +1,189 @@
+// ADC14DMA.c
+// Runs on MSP432
+// Timer-triggered ADC on P9.0/A17, P4.1/A12, P9.1/A16, moved
+// by DMA into ping-pong buffers and decimated one block at a time.
+// October 16, 2026
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/DMA.h"
+#include "../inc/ADC14DMA.h"
+
+#define PRIMARY   DMA_PRIMARY(ADCDMA_CHANNEL)
+#define ALTERNATE DMA_ALTERNATE(ADCDMA_CHANNEL)
+
+uint32_t ADCDMABuf[2][ADCDMA_BLOCKSIZE];  // ping (primary) and pong (alternate)
+void adcdmadummy(uint32_t ch17, uint32_t ch12, uint32_t ch16){};  // dummy function
+void (*ADCDMATask)(uint32_t ch17, uint32_t ch12, uint32_t ch16) = adcdmadummy; // user function
+uint32_t ADCDMAShift;
+volatile uint32_t ADCDMASeq;     // blocks completed, free running
+volatile uint32_t ADCDMALost;    // times both halves filled before the interrupt ran
+volatile uint32_t ADCDMALatest[3]; // ch17, ch12, ch16
+
+// ------------ADCDMA_Control------------
+// Build the control word for one ping-pong half
+// Input: count number of 32-bit words, 1 to 32
+// Output: DMA control word
+uint32_t ADCDMA_Control(uint32_t count){
+  return (2u<<30)            // DST_INC  word
+        |(2u<<28)            // DST_SIZE word
+        |(2u<<26)            // SRC_INC  word, ADC14MEM0 to ADC14MEMn
+        |(2u<<24)            // SRC_SIZE word
+        |(5<<14)             // R_POWER  rearbitrate after 32, the whole block per request
+        |((count-1)<<4)      // N_MINUS_1
+        |3;                  // CYCLE_CTRL ping-pong
+}
+
+// ------------ADCDMA_Descriptor------------
+// Arm one half of the ping-pong with a full ADC sequence
+// Input: d descriptor, src address of ADC14MEM0, dst block buffer
+// Output: none
+void ADCDMA_Descriptor(struct DMADescriptor *d, const volatile uint32_t *src, uint32_t *dst){
+  d->SrcEnd = &src[ADCDMA_BLOCKSIZE-1];  // end pointers, not start
+  d->DstEnd = &dst[ADCDMA_BLOCKSIZE-1];
+  d->Control = ADCDMA_Control(ADCDMA_BLOCKSIZE);
+}
+
+// ------------ADCDMA_Decimate------------
+// Sum each channel over a block and shift the sums
+// Input: block ADCDMA_BLOCKSIZE words, ch17, ch12, ch16 repeated
+//        shift right shift applied to each sum
+// Output: decimated channels stored through the pointers
+void ADCDMA_Decimate(const uint32_t *block, uint32_t shift,
+                     uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
+  uint32_t s17=0, s12=0, s16=0;
+  int i;
+  for(i=0; i<ADCDMA_BLOCKSIZE; i=i+3){
+    s17 = s17+(block[i]&0x3FFF);
+    s12 = s12+(block[i+1]&0x3FFF);
+    s16 = s16+(block[i+2]&0x3FFF);
+  }
+  *ch17 = s17>>shift;
+  *ch12 = s12>>shift;
+  *ch16 = s16>>shift;
+}
+
+// P9.0 = A17
+// P4.1 = A12
+// P9.1 = A16
+// Timer A1 trigger, repeat sequence, 3.3V reference, DMA channel 7
+// Input: task is a user function run once per block (0 for none)
+//        period is Timer A1 counts (SMCLK) between conversions
+//        shift applied to the block sums
+// Output: none
+// Uses Timer A1 and DMA channel 7
+void ADC0_InitDMACh17_12_16(void(*task)(uint32_t ch17, uint32_t ch12, uint32_t ch16), uint16_t period, uint32_t shift){
+  int i;
+  if(task){
+    ADCDMATask = task;
+  }else{
+    ADCDMATask = adcdmadummy;
+  }
+  if(period < ADCDMA_MINPERIOD){
+    period = ADCDMA_MINPERIOD;
+  }
+  ADCDMAShift = shift;
+  ADCDMASeq = 0;
+  ADCDMALost = 0;
+  TIMER_A1->CTL &= ~0x0030;        // halt Timer A1
+  ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0 to allow programming
+  while(ADC14->CTL0&0x00010000){}; // wait for BUSY to be zero
+  ADC14->CTL0 = 0x1C263310;        // repeat sequence, TA1 CCR1 trigger, SMCLK, on, disabled, /1, 32 SHM
+  ADC14->CTL1 = 0x00000030;        // ADC14MEM0, 14-bit, ref on, regular power
+  for(i=0; i<ADCDMA_BLOCKSIZE; i=i+3){
+    ADC14->MCTL[i] = 0x00000011;   // 0 to 3.3V, channel 17 (Right IR Sensor)
+    ADC14->MCTL[i+1] = 0x0000000C; // 0 to 3.3V, channel 12 (Center IR Sensor)
+    ADC14->MCTL[i+2] = 0x00000010; // 0 to 3.3V, channel 16 (Left IR Sensor)
+  }
+  ADC14->MCTL[ADCDMA_BLOCKSIZE-1] |= 0x00000080; // end of sequence, DMA request
+  ADC14->IER0 = 0;                 // the DMA reads the results, no ADC14 interrupt
+  ADC14->IER1 = 0;
+  P4->SEL1 |= 0x02;                // analog mode on P4.1/A12
+  P4->SEL0 |= 0x02;
+  P9->SEL1 |= 0x03;                // analog mode on P9.0/A17 and P9.1/A16
+  P9->SEL0 |= 0x03;
+
+  DMA_Init();
+  ADCDMA_Descriptor(PRIMARY, ADC14->MEM, ADCDMABuf[0]);
+  ADCDMA_Descriptor(ALTERNATE, ADC14->MEM, ADCDMABuf[1]);
+  DMA_Channel->CH_SRCCFG[ADCDMA_CHANNEL] = 7;      // channel 7 source 7 is ADC14
+  DMA_Control->ALTCLR = 1<<ADCDMA_CHANNEL;         // start with the primary
+  DMA_Control->USEBURSTCLR = 1<<ADCDMA_CHANNEL;
+  DMA_Control->PRIOCLR = 1<<ADCDMA_CHANNEL;
+  DMA_Control->REQMASKCLR = 1<<ADCDMA_CHANNEL;     // allow ADC14 requests
+  DMA_Channel->INT1_SRCCFG = 0x20|ADCDMA_CHANNEL;  // DMA_INT1 on channel 7 completion
+  DMA_Control->ENASET = 1<<ADCDMA_CHANNEL;
+  // DMA_INT1 is interrupt 33, priority 2
+  NVIC->IP[8] = (NVIC->IP[8]&0xFFFF00FF)|0x00004000;
+  NVIC->ISER[1] = 0x00000002;      // enable interrupt 33 in NVIC
+
+  ADC14->CTL0 |= 0x00000002;       // enable, waits for the first trigger
+  TIMER_A1->CTL = 0x0200;          // SMCLK, /1
+  TIMER_A1->EX0 = 0x0000;          // /1
+  TIMER_A1->CCTL[0] = 0x0000;      // compare, no interrupt
+  TIMER_A1->CCR[0] = period-1;
+  TIMER_A1->CCTL[1] = 0x00E0;      // output mode 7, reset/set: rising edge at CCR0
+  TIMER_A1->CCR[1] = period>>1;
+  TIMER_A1->CTL |= 0x0014;         // reset and start Timer A1 in up mode
+}
+
+// ------------ADC0_StopDMA------------
+// Stop the DMA ping-pong sampling
+// Input: none
+// Output: none
+void ADC0_StopDMA(void){
+  TIMER_A1->CTL &= ~0x0030;        // halt Timer A1
+  ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0
+  DMA_Control->ENACLR = 1<<ADCDMA_CHANNEL;
+  NVIC->ICER[1] = 0x00000002;      // disable interrupt 33 in NVIC
+}
+
+static void blockDone(uint32_t *block){
+  uint32_t ch17, ch12, ch16;
+  ADCDMA_Decimate(block, ADCDMAShift, &ch17, &ch12, &ch16);
+  ADCDMALatest[0] = ch17;
+  ADCDMALatest[1] = ch12;
+  ADCDMALatest[2] = ch16;
+  ADCDMASeq = ADCDMASeq+1;         // publish after the data is written
+  (*ADCDMATask)(ch17, ch12, ch16); // execute user task
+}
+
+// A half is complete when its CYCLE_CTRL has returned to stop.
+// Process it and re-arm it while the DMA fills the other half.
+void DMA_INT1_IRQHandler(void){
+  uint32_t primary = ((PRIMARY->Control&DMA_CYCLE_MASK) == 0);
+  uint32_t alternate = ((ALTERNATE->Control&DMA_CYCLE_MASK) == 0);
+  DMA_Channel->INT0_CLRFLG = 1<<ADCDMA_CHANNEL;
+  if(primary && alternate){
+    // both halves filled, the channel has stopped; restart
+    // with the primary and process the halves in order
+    ADCDMALost = ADCDMALost+1;
+    DMA_Control->ALTCLR = 1<<ADCDMA_CHANNEL;
+  }
+  if(primary){
+    blockDone(ADCDMABuf[0]);
+    ADCDMA_Descriptor(PRIMARY, ADC14->MEM, ADCDMABuf[0]);
+  }
+  if(alternate){
+    blockDone(ADCDMABuf[1]);
+    ADCDMA_Descriptor(ALTERNATE, ADC14->MEM, ADCDMABuf[1]);
+  }
+  if(primary && alternate){
+    DMA_Control->ENASET = 1<<ADCDMA_CHANNEL;
+  }
+}
+
+// ------------ADCDMA_Latest------------
+// Return the most recent decimated triple, does not wait
+// Input: pointers to store the P9.0/A17, P4.1/A12 and P9.1/A16 results
+// Output: number of blocks completed so far, 0 means none yet
+uint32_t ADCDMA_Latest(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
+  uint32_t n;
+  do{
+    n = ADCDMASeq;
+    *ch17 = ADCDMALatest[0];
+    *ch12 = ADCDMALatest[1];
+    *ch16 = ADCDMALatest[2];
+  }while(n != ADCDMASeq);          // interrupted by a new block, read again
+  return n;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file      ADC14DMA.h
+ * @brief     Oversampled ADC0 on P9.0/A17, P4.1/A12, P9.1/A16 using DMA
+ * @details   Timer A1 CCR1 triggers one conversion per period.
+ * The ADC14 runs a repeat sequence of ADCDMA_TRIPLES copies of
+ * channels 17, 12, 16 through ADC14MEM0 to ADC14MEM(3*ADCDMA_TRIPLES-1).
+ * At the end of each sequence the ADC14 requests DMA channel 7,
+ * which copies the whole sequence into one half of a ping-pong
+ * buffer in a single burst. The DMA_INT1 interrupt then sums each
+ * channel over the block, shifts the sums and calls the user task,
+ * while the other half is being filled.<br>
+ * One interrupt per 3*ADCDMA_TRIPLES conversions, instead of one
+ * per triple with ADC0_InitTimerTriggerCh17_12_16().<br>
+<table>
+<caption id="adcdma_rates">Example rates, SMCLK = 12 MHz</caption>
+<tr><th>period <th>Conversions/s <th>Triples/s <th>Blocks/s (interrupts)
+<tr><td>120    <td>100,000       <td>33,333    <td>4,167
+<tr><td>240    <td>50,000        <td>16,667    <td>2,083
+<tr><td>1200   <td>10,000        <td>3,333     <td>417
+</table>
+ * The descriptor and decimation helpers do not touch hardware.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __ADC14DMA_H__ // do not include more than once
+#define __ADC14DMA_H__
+#include <stdint.h>
+#include "../inc/DMA.h"
+
+/**
+ * Number of channel 17, 12, 16 triples per DMA block.
+ * 3*ADCDMA_TRIPLES must fit in the 32 ADC14MEM registers.
+ */
+#define ADCDMA_TRIPLES 8
+
+/**
+ * Number of 32-bit words in one DMA block
+ */
+#define ADCDMA_BLOCKSIZE (3*ADCDMA_TRIPLES)
+
+/**
+ * DMA channel used by the ADC14 trigger (source 7 on channel 7)
+ */
+#define ADCDMA_CHANNEL 7
+
+/**
+ * Smallest Timer A1 period, in SMCLK cycles. At 12 MHz a
+ * conversion takes 32 sample plus 16 conversion clocks, 4 us.
+ */
+#define ADCDMA_MINPERIOD 60
+
+/**
+ * Build a DMA control word for a ping-pong half of count
+ * 32-bit words, source and destination incrementing, moved
+ * in one burst per request
+ * @param count number of words, 1 to 32
+ * @return value for DMADescriptor.Control
+ * @brief  DMA control word for one block
+ */
+uint32_t ADCDMA_Control(uint32_t count);
+
+/**
+ * Fill in a descriptor that copies one ADC sequence to a buffer
+ * @param d pointer to the descriptor to fill
+ * @param src address of ADC14MEM0
+ * @param dst buffer of ADCDMA_BLOCKSIZE words
+ * @return none
+ * @brief  Arm one half of the ping-pong
+ */
+void ADCDMA_Descriptor(struct DMADescriptor *d, const volatile uint32_t *src, uint32_t *dst);
+
+/**
+ * Sum each channel over a block and shift the sums.<br>
+ * A shift of 3 with 8 triples gives the average, 14 bits;
+ * a shift of 1 keeps 16 bits of oversampled resolution.
+ * @param block ADCDMA_BLOCKSIZE words, ch17, ch12, ch16 repeated
+ * @param shift right shift applied to each sum
+ * @param ch17 pointer to store the decimated P9.0/A17 result
+ * @param ch12 pointer to store the decimated P4.1/A12 result
+ * @param ch16 pointer to store the decimated P9.1/A16 result
+ * @return none
+ * @brief  Decimate one block
+ */
+void ADCDMA_Decimate(const uint32_t *block, uint32_t shift,
+                     uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
+
+/**
+ * Initialize ADC0, Timer A1 and DMA channel 7 for continuous,
+ * oversampled conversion of P9.0/A17, P4.1/A12 and P9.1/A16.
+ * The task runs in the DMA_INT1 interrupt once per block with
+ * the decimated values.
+ * @param task user function called with each decimated triple, 0 for none
+ * @param period Timer A1 counts between conversions, units SMCLK (83.3ns), at least ADCDMA_MINPERIOD
+ * @param shift right shift applied to the block sums, 0 to 3 for ADCDMA_TRIPLES=8
+ * @return none
+ * @note  Uses Timer A1 and DMA channel 7, so TimerA1_Init() and
+ * ADC0_InitTimerTriggerCh17_12_16() cannot be used at the same time.
+ * Interrupts are enabled in the main program.
+ * @brief  Initialize DMA ping-pong sampling of channels 17, 12, 16
+ */
+void ADC0_InitDMACh17_12_16(void(*task)(uint32_t ch17, uint32_t ch12, uint32_t ch16), uint16_t period, uint32_t shift);
+
+/**
+ * Stop DMA ping-pong sampling
+ * @param none
+ * @return none
+ * @brief  Stop Timer A1, the ADC and DMA channel 7
+ */
+void ADC0_StopDMA(void);
+
+/**
+ * Return the most recent decimated triple without waiting
+ * @param ch17 pointer to store the P9.0/A17 result
+ * @param ch12 pointer to store the P4.1/A12 result
+ * @param ch16 pointer to store the P9.1/A16 result
+ * @return number of blocks completed so far, 0 if none yet
+ * @brief  Latest oversampled channels 17+12+16 result
+ */
+uint32_t ADCDMA_Latest(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
+
+#endif // __ADC14DMA_H__
@@ -0,0 +1,27 @@
+// CRC16.c
+// Runs on any microcontroller
+// CRC-16/CCITT-FALSE, one nibble at a time.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/CRC16.h"
+
+static const uint16_t CRCTable[16] = {
+  0x0000,0x1021,0x2042,0x3063,0x4084,0x50A5,0x60C6,0x70E7,
+  0x8108,0x9129,0xA14A,0xB16B,0xC18C,0xD1AD,0xE1CE,0xF1EF
+};
+
+// ------------CRC16_Update------------
+// Continue a CRC-16/CCITT-FALSE over a block
+// Input: crc CRC16_INIT or the previous result,
+//        data bytes, size number of bytes
+// Output: CRC
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t size){
+  uint32_t c = crc;
+  uint32_t i;
+  for(i=0; i<size; i++){
+    c = ((c<<4)&0xFFFF)^CRCTable[(c>>12)^(data[i]>>4)];
+    c = ((c<<4)&0xFFFF)^CRCTable[(c>>12)^(data[i]&0x0F)];
+  }
+  return (uint16_t)c;
+}
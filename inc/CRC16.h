@@ -0,0 +1,32 @@
+/**
+ * @file      CRC16.h
+ * @brief     CRC-16/CCITT-FALSE shared by the binary stream formats
+ * @details   Polynomial 0x1021, initial value 0xFFFF, no reflection,
+ * no final XOR; the check value of "123456789" is 0x29B1.
+ * The CRC can be computed in pieces, so an interrupt can add a few
+ * bytes at a time instead of checking a whole block at once.
+ * One 16-entry table, two lookups per byte.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __CRC16_H__ // do not include more than once
+#define __CRC16_H__
+#include <stdint.h>
+
+/**
+ * Starting value of the CRC
+ */
+#define CRC16_INIT 0xFFFF
+
+/**
+ * Continue a CRC over more bytes
+ * @param crc CRC16_INIT, or the result of the previous call
+ * @param data bytes to add
+ * @param size number of bytes
+ * @return CRC including data
+ * @brief  Update CRC-16
+ */
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t size);
+
+#endif // __CRC16_H__
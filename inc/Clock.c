@@ -45,7 +45,106 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "msp.h"
 
 uint32_t ClockFrequency = 3000000; // cycles/second
-//static uint32_t SubsystemFrequency = 3000000; // cycles/second
+static uint32_t SubsystemFrequency = 3000000; // SMCLK cycles/second
+// Clock_Now() counts watchdog interval interrupts of 2^13 SMCLK
+// periods, because SMCLK and the watchdog keep running while the
+// core sleeps in WFI and the DWT cycle counter stops. The cycle
+// counter only interpolates within the current interval.
+#define WDT_PERIODS 8192           // SMCLK periods per watchdog interval
+static uint32_t WdtRunning;        // 1 once clockStart() has started the watchdog
+static uint32_t WdtCycles;         // MCLK cycles per interval, 32768 at 48 MHz
+static uint32_t WdtUs;             // whole us per interval, 682 at 12 MHz SMCLK
+static uint32_t WdtRemainder;      // and the rest, us*SubsystemFrequency
+static uint64_t NowUs;             // time at the last watchdog interrupt, us
+static uint32_t NowFraction;       // us*SubsystemFrequency not yet in NowUs, below SubsystemFrequency
+static uint32_t NowStamp;          // DWT->CYCCNT at the last watchdog interrupt
+static uint64_t NowLast;           // Clock_Now() at the last call
+
+// start the DWT cycle counter if it is not running
+static void cycleCounter(void){
+  if((DWT->CTRL&0x00000001) == 0){
+    CoreDebug->DEMCR |= 0x01000000;     // TRCENA, enable the DWT
+    DWT->CTRL |= 0x00000001;            // CYCCNTENA
+  }
+}
+
+// busy-wait until DWT->CYCCNT passes target, at most 2^31 cycles ahead
+static void waitUntil(uint32_t target){
+  while((int32_t)(DWT->CYCCNT-target) < 0){
+  }
+}
+
+// the length of a watchdog interval at the current clocks, so the
+// interrupt only adds: 2^13*10^6/SubsystemFrequency us is WdtUs and
+// a remainder below SubsystemFrequency
+static void intervalTime(void){
+  WdtCycles = WDT_PERIODS*(ClockFrequency/SubsystemFrequency);
+  WdtUs = (uint32_t)((uint64_t)WDT_PERIODS*1000000/SubsystemFrequency);
+  WdtRemainder = (uint32_t)((uint64_t)WDT_PERIODS*1000000%SubsystemFrequency);
+}
+
+// start the cycle counter and the watchdog interval timer, if they
+// are not running; call with interrupts disabled
+static void clockStart(void){
+  cycleCounter();
+  if(WdtRunning == 0){
+    WdtRunning = 1;
+    intervalTime();
+    NowStamp = DWT->CYCCNT;
+    NVIC->IP[0] = NVIC->IP[0]&0x00FFFFFF; // priority 0, the handler only adds
+    NVIC->ISER[0] = 0x00000008;         // enable interrupt 3 in NVIC
+    WDT_A->CTL = 0x5A1D;                // password, SMCLK, interval mode, clear, 2^13
+  }
+}
+
+// The watchdog interval, 683 us at 48 MHz and 2.7 ms at 3 MHz, is
+// the time base of Clock_Now(). Interrupts held off for more than
+// one interval are made up from the cycle counter, which runs then.
+// No 64-bit divide here, the usual single interval is two adds and
+// a compare.
+void WDT_A_IRQHandler(void){
+  uint32_t cycles, ticks;
+  cycles = DWT->CYCCNT-NowStamp;
+  NowStamp = NowStamp+cycles;
+  ticks = (cycles+WdtCycles/2)/WdtCycles;
+  if(ticks == 0){
+    ticks = 1;                          // the core slept through part of the interval
+  }
+  NowUs = NowUs+ticks*WdtUs;
+  while(ticks){
+    NowFraction = NowFraction+WdtRemainder;
+    if(NowFraction >= SubsystemFrequency){
+      NowFraction = NowFraction-SubsystemFrequency;
+      NowUs = NowUs+1;
+    }
+    ticks--;
+  }
+}
+
+// ------------Clock_Now------------
+// Monotonic time since the first call, counted by the watchdog
+// interval interrupt, so it runs while the core sleeps and needs no
+// periodic calls.
+// Inputs: none
+// Outputs: time in us
+uint64_t Clock_Now(void){
+  uint32_t sr, cycles;
+  uint64_t now;
+  sr = __get_PRIMASK();
+  __disable_irq();
+  clockStart();
+  cycles = DWT->CYCCNT-NowStamp;
+  if(cycles > WdtCycles){
+    cycles = WdtCycles;                 // the interrupt is pending
+  }
+  now = NowUs+(uint64_t)cycles*1000000/ClockFrequency;
+  if(now < NowLast){
+    now = NowLast;                      // never back, even across Clock_Init48MHz()
+  }
+  NowLast = now;
+  __set_PRIMASK(sr);
+  return now;
+}
 
 // ------------Clock_InitFastest------------
 // Configure the system clock to run at the fastest
@@ -61,6 +160,7 @@ uint32_t Postwait = 0;                  // loops between Current Power Mode matc
 uint32_t IFlags = 0;                    // non-zero if transition is invalid
 uint32_t Crystalstable = 0;             // loops before the crystal stabilizes (expect small)
 void Clock_Init48MHz(void){
+  uint32_t sr = 0;
   // wait for the PCMCTL0 and Clock System to be write-able by waiting for Power Control Manager to be idle
   while(PCM->CTL1&0x00000100){
 //  while(PCMCTL1&0x00000100){
@@ -119,6 +219,14 @@ void Clock_Init48MHz(void){
   FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL&~0x0000F000)|FLCTL_BANK0_RDCTL_WAIT_2;
   // configure for 2 wait states (minimum for 48 MHz operation) for flash Bank 1
   FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL&~0x0000F000)|FLCTL_BANK1_RDCTL_WAIT_2;
+  if(WdtRunning){                       // count the interval so far at the old frequency
+    sr = __get_PRIMASK();
+    __disable_irq();
+    NowUs = Clock_Now();
+    NowFraction = 0;
+    NowStamp = DWT->CYCCNT;
+    WDT_A->CTL = 0x5A1D;                // restart the interval at the new SMCLK
+  }
   CS->CTL1 = 0x20000000 |               // configure for SMCLK divider /4
            0x00100000 |                 // configure for HSMCLK divider /2
            0x00000200 |                 // configure for ACLK sourced from REFOCLK
@@ -126,7 +234,11 @@ void Clock_Init48MHz(void){
            0x00000005;                  // configure for MCLK sourced from HFXTCLK
   CS->KEY = 0;                          // lock CS module from unintended access
   ClockFrequency = 48000000;
-//  SubsystemFrequency = 12000000;
+  SubsystemFrequency = 12000000;
+  if(WdtRunning){
+    intervalTime();
+    __set_PRIMASK(sr);
+  }
 }
 
 // ------------Clock_GetFreq------------
@@ -139,35 +251,62 @@ uint32_t Clock_GetFreq(void){
 }
 
 
-// delay function
-// which delays about 6*ulCount cycles
-// ulCount=8000 => 1ms = (8000 loops)*(6 cycles/loop)*(20.83 ns/cycle)
-  //Code Composer Studio Code
-void delay(unsigned long ulCount){
-  __asm (  "pdloop:  subs    r0, #1\n"
-      "    bne    pdloop\n");
-}
-
 // ------------Clock_Delay1us------------
-// Simple delay function which delays about n microseconds.
+// Busy-wait n microseconds on the DWT cycle counter, at any
+// ClockFrequency, in steps of 1 ms so the count never overflows.
 // Inputs: n, number of us to wait
 // Outputs: none
 void Clock_Delay1us(uint32_t n){
-  n = (382*n)/100;; // 1 us, tuned at 48 MHz
-  while(n){
-    n--;
+  uint32_t target;
+  cycleCounter();
+  target = DWT->CYCCNT;
+  while(n >= 1000){
+    target = target+ClockFrequency/1000;
+    waitUntil(target);
+    n = n-1000;
   }
+  waitUntil(target+n*(ClockFrequency/1000)/1000);
 }
 
 // ------------Clock_Delay1ms------------
-// Simple delay function which delays about n milliseconds.
+// Busy-wait n milliseconds on the DWT cycle counter.
 // Inputs: n, number of msec to wait
 // Outputs: none
 void Clock_Delay1ms(uint32_t n){
+  uint32_t target;
+  cycleCounter();
+  target = DWT->CYCCNT;
   while(n){
-    delay(ClockFrequency/9162);   // 1 msec, tuned at 48 MHz
+    target = target+ClockFrequency/1000;
+    waitUntil(target);
     n--;
   }
 }
 
-
+// ------------Clock_Sleep1ms------------
+// Wait n milliseconds asleep. The core sleeps until the last
+// watchdog interval, then busy-waits the rest on Clock_Now(). If
+// another interrupt wakes it during the last interval, the time it
+// slept there is not seen until the next watchdog interrupt, so the
+// delay can be up to one interval long. Call with interrupts
+// enabled, from the foreground; other interrupts run meanwhile.
+// Inputs: n, number of msec to wait
+// Outputs: none
+void Clock_Sleep1ms(uint32_t n){
+  uint64_t target;
+  uint32_t sr, interval;
+  target = Clock_Now()+(uint64_t)n*1000; // starts the watchdog
+  interval = WdtUs+1;                   // us, rounded up
+  while(1){
+    sr = __get_PRIMASK();
+    __disable_irq();                    // so no interrupt comes between the test and WFI
+    if(Clock_Now()+interval >= target){
+      __set_PRIMASK(sr);
+      break;
+    }
+    __WFI();                            // sleep until an interrupt is pending
+    __set_PRIMASK(sr);                  // which runs now
+  }
+  while(Clock_Now() < target){
+  }
+}
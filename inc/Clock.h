@@ -1,7 +1,13 @@
 /**
  * @file      Clock.h
  * @brief     Provide functions that initialize the MSP432 clock module
- * @details   Reconfigure MSP432 to run at 48 MHz
+ * @details   Reconfigure MSP432 to run at 48 MHz. Delays count
+ * cycles of the DWT cycle counter at the current ClockFrequency, so
+ * they are right at 3 MHz and at 48 MHz whatever the optimizer
+ * does. The cycle counter stops while the core sleeps, so
+ * Clock_Now() counts watchdog interval interrupts (2^13 SMCLK
+ * periods, 683 us at 48 MHz), interpolated with the cycle counter,
+ * and Clock_Sleep1ms() sleeps between them.
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -71,33 +77,49 @@ uint32_t Clock_GetFreq(void);
 
 
 /**
- * Simple delay function which delays about n milliseconds.
- * It is implemented with a nested for-loop and is very approximate.
+ * Busy-wait delay of n milliseconds on the DWT cycle counter
  * @param  n is the number of msec to wait
  * @return none
- * @note This function assumes a 48 MHz clock.
- * This implementation is not very accurate.
- * To improve accuracy, you could tune this function
- * by adjusting the constant within the implementation
- * found in the <b>Clock.c</b> file.
- * For a more accurate time delay, you could use the SysTick module.
- * @brief  Software implementation of a busy-wait delay
+ * @note Right at any ClockFrequency; interrupts during the delay
+ * do not lengthen it unless they outlast it.
+ * @see Clock_Sleep1ms()
+ * @brief  Busy-wait delay in ms
  */
 void Clock_Delay1ms(uint32_t n);
 
 /**
- * Simple delay function which delays about n microseconds.
- * It is implemented with a nested for-loop and is very approximate.
+ * Busy-wait delay of n microseconds on the DWT cycle counter
  * @param  n is the number of usec to wait
  * @return none
- * @note This function assumes a 48 MHz clock.
- * This implementation is not very accurate.
- * To improve accuracy, you could tune this function
- * by adjusting the constant within the implementation
- * found in the <b>Clock.c</b> file.
- * For a more accurate time delay, you could use the SysTick module.
- * @brief  Software implementation of a busy-wait delay
+ * @note Right at any ClockFrequency, plus the call of about 20
+ * cycles, 0.4 us at 48 MHz or 7 us at 3 MHz.
+ * @brief  Busy-wait delay in us
  */
 void Clock_Delay1us(uint32_t n);
 
+/**
+ * Delay of n milliseconds with the core asleep, woken by the
+ * watchdog timer in interval mode, then a busy-wait of the last
+ * interval, 683 us (2.7 ms at 3 MHz), on Clock_Now()
+ * @param  n is the number of msec to wait
+ * @return none
+ * @note Call from the foreground with interrupts enabled. Up to
+ * one interval long if another interrupt wakes the core during the
+ * last one.
+ * @brief  Sleeping delay in ms
+ */
+void Clock_Sleep1ms(uint32_t n);
+
+/**
+ * Monotonic time since the first call
+ * @param none
+ * @return time in us
+ * @note The first call starts the watchdog timer in interval mode
+ * and its interrupt (priority 0, a few us every 683 us), which keep
+ * the time while the core sleeps; no periodic calls are needed.
+ * Safe to call from interrupts.
+ * @brief  Time in us
+ */
+uint64_t Clock_Now(void);
+
 
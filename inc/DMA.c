@@ -0,0 +1,26 @@
+// DMA.c
+// Runs on MSP432
+// Shared DMA controller channel control table.
+// October 16, 2026
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/DMA.h"
+
+// The control table holds a primary and an alternate descriptor
+// for each of the 8 channels and must be aligned to its size.
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(DMAControlTable, 256)
+struct DMADescriptor DMAControlTable[16];
+#else
+struct DMADescriptor DMAControlTable[16] __attribute__((aligned(256)));
+#endif
+
+// ------------DMA_Init------------
+// Enable the DMA controller with the shared control table
+// Input: none
+// Output: none
+void DMA_Init(void){
+  DMA_Control->CFG = 0x00000001;   // master enable
+  DMA_Control->CTLBASE = (uint32_t)(uintptr_t)DMAControlTable;
+}
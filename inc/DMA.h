@@ -0,0 +1,63 @@
+/**
+ * @file      DMA.h
+ * @brief     Shared DMA controller channel control table
+ * @details   The MSP432 DMA has one control table for all 8
+ * channels, so drivers that use DMA share it through this file.
+ * Each channel has a primary and an alternate descriptor.<br>
+<table>
+<caption id="dma_channels">Channels in use</caption>
+<tr><th>Channel <th>Source <th>Trigger   <th>Interrupt <th>Driver
+<tr><td>0       <td>1      <td>EUSCI_A0 TX <td>DMA_INT2 <td>UART0.c
+<tr><td>6       <td>1      <td>EUSCI_A3 TX <td>DMA_INT3 <td>Nokia5110.c
+<tr><td>7       <td>7      <td>ADC14     <td>DMA_INT1  <td>ADC14DMA.c
+</table>
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __DMA_H__ // do not include more than once
+#define __DMA_H__
+#include <stdint.h>
+
+/**
+ * \struct DMADescriptor
+ * \brief One entry of the DMA channel control table
+ */
+struct DMADescriptor{
+  const volatile void *SrcEnd; /**< address of the last source item */
+  volatile void *DstEnd;       /**< address of the last destination item */
+  volatile uint32_t Control;   /**< cycle type, size, increments and count */
+  uint32_t Spare;              /**< unused */
+};
+
+/**
+ * Primary and alternate descriptors for channels 0 to 7
+ */
+extern struct DMADescriptor DMAControlTable[16];
+
+/**
+ * Primary descriptor of a channel
+ */
+#define DMA_PRIMARY(ch)   (&DMAControlTable[(ch)])
+
+/**
+ * Alternate descriptor of a channel
+ */
+#define DMA_ALTERNATE(ch) (&DMAControlTable[8+(ch)])
+
+/**
+ * Mask of the cycle type in DMADescriptor.Control,
+ * 0 when the descriptor has finished
+ */
+#define DMA_CYCLE_MASK 0x00000007
+
+/**
+ * Enable the DMA controller and point it at DMAControlTable.
+ * Safe to call from every driver that uses DMA.
+ * @param none
+ * @return none
+ * @brief  Initialize the DMA controller
+ */
+void DMA_Init(void);
+
+#endif // __DMA_H__
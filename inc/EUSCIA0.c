@@ -48,6 +48,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 // UCA0TXD (VCP transmit) connected to P1.3
 #include <stdint.h>
 #include "../inc/FIFO0.h"
+#include "../inc/Format.h"
 #include "EUSCIA0.h"
 #include "msp.h"
 
@@ -179,70 +180,9 @@ char character;
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void EUSCIA0_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    EUSCIA0_OutUDec(n/10);
-    n = n%10;
-  }
-  EUSCIA0_OutChar(n+'0'); /* n is between 0 and 9 */
+  Format_OutUDec(&EUSCIA0_OutString, n);
 }
 
-uint32_t Messageindexc;
-char Messagec[8];
-void static fillmessagec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessagec(n/10);
-    n = n%10;
-  }
-  Messagec[Messageindexc] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindexc<7)Messageindexc++;
-}
-void static fillmessage4b(uint32_t n){
-  if(n>=1000){  // 1000 to 9999
-    Messageindexc = 0;
-  } else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }
-  fillmessagec(n);
-}
-void static fillmessage5b(uint32_t n){
-  if(n>99999)n=99999;
-  if(n>=10000){  // 10000 to 99999
-    Messageindexc = 0;
-  } else if(n>=1000){  // 1000 to 9999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messagec[3] = ' ';
-    Messageindexc = 4;
-  }
-  fillmessagec(n);
-}
 
 //-----------------------EUSCIA0_OutUDec4-----------------------
 // Output a 32-bit number in unsigned decimal format
@@ -250,14 +190,7 @@ void static fillmessage5b(uint32_t n){
 // Output: none
 // Fixed format 4 digits with no space before or after
 void EUSCIA0_OutUDec4(uint32_t n){
-  if(n>9999){
-    EUSCIA0_OutString("****");
-  }else{
-    Messageindexc = 0;
-    fillmessage4b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  Format_OutUDecWidth(&EUSCIA0_OutString, n, 4);
 }
 
 //-----------------------EUSCIA0_OutUDec5-----------------------
@@ -266,14 +199,7 @@ void EUSCIA0_OutUDec4(uint32_t n){
 // Output: none
 // Fixed format 5 digits with no space before or after
 void EUSCIA0_OutUDec5(uint32_t n){
-  if(n>99999){
-    EUSCIA0_OutString("*****");
-  }else{
-    Messageindexc = 0;
-    fillmessage5b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  Format_OutUDecWidth(&EUSCIA0_OutString, n, 5);
 }
 
 //-----------------------EUSCIA0_OutUFix1-----------------------
@@ -282,9 +208,7 @@ void EUSCIA0_OutUDec5(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit> with no space before or after
 void EUSCIA0_OutUFix1(uint32_t n){
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutChar('.');
-  EUSCIA0_OutUDec(n%10);
+  Format_OutUFix(&EUSCIA0_OutString, n, 1);
 }
 
 //-----------------------EUSCIA0_OutUFix2-----------------------
@@ -293,11 +217,7 @@ void EUSCIA0_OutUFix1(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit><digit> with no space before or after
 void EUSCIA0_OutUFix2(uint32_t n){
-  EUSCIA0_OutUDec(n/100);
-  EUSCIA0_OutChar('.');
-  n = n%100;
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutUDec(n%10);
+  Format_OutUFix(&EUSCIA0_OutString, n, 2);
 }
 
 //---------------------EUSCIA0_InUHex----------------------------------------
@@ -348,20 +268,7 @@ char character;
 // Output: none
 // Variable format 1 to 8 digits with no space before or after
 void EUSCIA0_OutUHex(uint32_t number){
-// This function uses recursion to convert the number of
-//   unspecified length as an ASCII string
-  if(number >= 0x10){
-    EUSCIA0_OutUHex(number/0x10);
-    EUSCIA0_OutUHex(number%0x10);
-  }
-  else{
-    if(number < 0xA){
-      EUSCIA0_OutChar(number+'0');
-     }
-    else{
-      EUSCIA0_OutChar((number-0x0A)+'A');
-    }
-  }
+  Format_OutUHex(&EUSCIA0_OutString, number);
 }
 
 //--------------------------EUSCIA0_OutUHex2----------------------------
@@ -369,17 +276,8 @@ void EUSCIA0_OutUHex(uint32_t number){
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 2 digits with no space before or after
-void EUSCIA0outnibble(uint32_t n){
-  if(n < 0xA){
-    EUSCIA0_OutChar(n+'0');
-  }
-  else{
-    EUSCIA0_OutChar((n-0x0A)+'A');
-  }
-}
 void EUSCIA0_OutUHex2(uint32_t number){
-  EUSCIA0outnibble(number/0x10); // ms digit
-  EUSCIA0outnibble(number%0x10); // ls digit
+  Format_OutUHexWidth(&EUSCIA0_OutString, number, 2);
 }
 
 //------------EUSCIA0_InString------------
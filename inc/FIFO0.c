@@ -1,6 +1,7 @@
 // FIFO0.c
 // Runs on any microcontroller
-// Two first in first out queues
+// Single-producer single-consumer byte queues, and the
+// two first in first out queues used by EUSCIA0.c
 // These will be implemented as part of Lab 18
 // Daniel and Jonathan Valvano
 // October 29, 2017
@@ -46,168 +47,188 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "..\inc\FIFO0.h"
 
-// Implementation of the transmit FIFO, TxFifo0
-// can hold 0 to TXFIFOSIZE-1 elements
-// you are allowed to restrict TXFIFOSIZE to a power of 2
-
-// add static, volatile, global variables here this as part of Lab 18
+// Put and Get are free running; Put-Get is the number of
+// elements, 0 to Size, so the whole buffer is usable and
+// Put==Get always means empty. The index is masked on each
+// access, so Size must be a power of 2.
+// Only the producer writes PutI and only the consumer writes
+// GetI. The data is stored before PutI is advanced (and read
+// before GetI is advanced), so one side can be an ISR without
+// disabling interrupts.
+
+// ------------Fifo_Init------------
+// Initialize an empty queue
+// Input: f is the queue
+//        buf is the storage, size bytes
+//        size power of 2
+// Output: none
+void Fifo_Init(struct Fifo *f, uint8_t *buf, uint32_t size){
+  f->Data = buf;
+  f->Mask = size-1;
+  f->PutI = f->GetI = 0;
+  f->HighWater = 0;
+  f->Lost = 0;
+#if FIFO_HISTOGRAM
+  f->Histogram = 0;
+#endif
+}
 
-//OHL
-//#define FIFO_SIZE 64
-//#define TX0FIFOSIZE FIFO_SIZE
-//#define RX0FIFOSIZE FIFO_SIZE
+#if FIFO_HISTOGRAM
+// ------------Fifo_SetHistogram------------
+// Record the occupancy at each Fifo_Put call
+// Input: f is the queue
+//        histogram Size+1 counters, cleared here, 0 to stop
+// Output: none
+void Fifo_SetHistogram(struct Fifo *f, uint32_t *histogram){ uint32_t i;
+  if(histogram){
+    for(i=0; i<=f->Mask+1; i++){
+      histogram[i] = 0;
+    }
+  }
+  f->Histogram = histogram;
+}
+#endif
+
+// ------------Fifo_Put------------
+// Add one element, producer only
+// Input: f is the queue, data to add
+// Output: FIFOSUCCESS if ok, FIFOFAIL if full
+int Fifo_Put(struct Fifo *f, uint8_t data){
+  uint32_t put = f->PutI;
+  uint32_t n = put-f->GetI;          // current size
+#if FIFO_HISTOGRAM
+  if(f->Histogram){
+    f->Histogram[n]++;               // probability mass function
+  }
+#endif
+  if(n > f->Mask){
+    f->Lost++;
+    return FIFOFAIL;                 // full
+  }
+  f->Data[put&f->Mask] = data;
+  f->PutI = put+1;                   // publish after the data is stored
+  if(n+1 > f->HighWater){
+    f->HighWater = n+1;
+  }
+  return FIFOSUCCESS;
+}
 
-typedef struct fifo{
-  char      Put;        //FIFO Put Index
-  char      Get;        //FIFO Get Index
-  char      Data[TX0FIFOSIZE];
-}fifo_t;
+// ------------Fifo_Get------------
+// Remove the oldest element, consumer only
+// Input: f is the queue, datapt where to store it
+// Output: FIFOSUCCESS if ok, FIFOFAIL if empty
+int Fifo_Get(struct Fifo *f, uint8_t *datapt){
+  uint32_t get = f->GetI;
+  if(get == f->PutI){
+    return FIFOFAIL;                 // empty
+  }
+  *datapt = f->Data[get&f->Mask];
+  f->GetI = get+1;                   // release after the data is read
+  return FIFOSUCCESS;
+}
 
-fifo_t TxFifo0, RxFifo0;
+// ------------Fifo_PutN------------
+// Add up to n elements, producer only
+// Input: f is the queue, src elements to add, n how many
+// Output: number added, less than n if the queue filled
+uint32_t Fifo_PutN(struct Fifo *f, const uint8_t *src, uint32_t n){
+  uint32_t put = f->PutI;
+  uint32_t room = (f->Mask+1)-(put-f->GetI);
+  uint32_t i;
+  if(n > room){
+    f->Lost = f->Lost+(n-room);
+    n = room;
+  }
+  for(i=0; i<n; i++){
+    f->Data[(put+i)&f->Mask] = src[i];
+  }
+  f->PutI = put+n;                   // publish all n at once
+  if((put+n-f->GetI) > f->HighWater){
+    f->HighWater = put+n-f->GetI;
+  }
+  return n;
+}
 
-//volatile uint8_t *SEM_Size =(volatile uint8_t *) 0x42098040;
+// ------------Fifo_GetN------------
+// Remove up to n elements, consumer only
+// Input: f is the queue, dst where to store them, n most to remove
+// Output: number removed, less than n if the queue emptied
+uint32_t Fifo_GetN(struct Fifo *f, uint8_t *dst, uint32_t n){
+  uint32_t get = f->GetI;
+  uint32_t size = f->PutI-get;
+  uint32_t i;
+  if(n > size){
+    n = size;
+  }
+  for(i=0; i<n; i++){
+    dst[i] = f->Data[(get+i)&f->Mask];
+  }
+  f->GetI = get+n;                   // release all n at once
+  return n;
+}
 
-//OHL
+// ------------Fifo_Size------------
+// Number of elements in the queue, either side
+// Input: f is the queue
+// Output: 0 to Size
+uint32_t Fifo_Size(struct Fifo *f){
+  return f->PutI-f->GetI;
+}
 
-uint32_t TxHistogram[TX0FIFOSIZE]; 
+// Implementation of the transmit FIFO, TxFifo0
+// can hold 0 to TX0FIFOSIZE elements
+struct Fifo TxFifo0;
+uint8_t TxFifo0Buf[TX0FIFOSIZE];
+#if FIFO_HISTOGRAM
+uint32_t TxHistogram[TX0FIFOSIZE+1];
 // probability mass function of the number of times TxFifo0 as this size
 // as a function of FIFO size at the beginning of call to TxFifo0_Put
-// initialize index TxFifo0
-void TxFifo0_Init(void){int i;
+#endif
 
-// write this as part of Lab 18
-
-TxFifo0.Get = TxFifo0.Put = 0;
-
-  for(i=0;i<TX0FIFOSIZE;i++){
-      TxHistogram[i] = 0;
-  }
+// initialize index TxFifo0
+void TxFifo0_Init(void){
+  Fifo_Init(&TxFifo0, TxFifo0Buf, TX0FIFOSIZE);
+#if FIFO_HISTOGRAM
+  Fifo_SetHistogram(&TxFifo0, TxHistogram);
+#endif
 }
 // add element to end of index TxFifo0
 // return FIFOSUCCESS if successful, else return FIFOFAIL
 int TxFifo0_Put(char data){
-  TxHistogram[TxFifo0_Size()]++;  // probability mass function
-
-// write this as part of Lab 18
-
-  // Check for FIFO Full
-  if((TxFifo0.Put+1)%TX0FIFOSIZE != TxFifo0.Get){
-
-      // Put Data at End of TX0FIFO
-      TxFifo0.Data[TxFifo0.Put] = data;
-
-      //Increment End ptr, wrap around if required
-      TxFifo0.Put = (TxFifo0.Put+1)%TX0FIFOSIZE;
-
-      return(FIFOSUCCESS);
-  }
-  else{
-      return(FIFOFAIL);
-  }
-
-
+  return Fifo_Put(&TxFifo0, (uint8_t)data);
 }
 // remove element from front of TxFifo0
-// return TXFIFOSUCCESS if successful
+// return FIFOSUCCESS if successful
 int TxFifo0_Get(char *datapt){
-
-// write this as part of Lab 18
-
-    // Check for FIFO Empty
-    if(TxFifo0.Get != TxFifo0.Put){
-
-        // Get Data from Start of TX0FIFO
-        *datapt = TxFifo0.Data[TxFifo0.Get];
-
-        //Increment Start ptr, wrap around if required
-        TxFifo0.Get = (TxFifo0.Get+1)%TX0FIFOSIZE;
-
-        return(FIFOSUCCESS);
-    }
-    else{
-        return(FIFOFAIL);
-    }
+  return Fifo_Get(&TxFifo0, (uint8_t *)datapt);
 }
 // number of elements in TxFifo0
-// 0 to TXFIFOSIZE-1
+// 0 to TX0FIFOSIZE
 uint16_t TxFifo0_Size(void){
-
-    // write this as part of Lab 18
-    uint16_t FifoSize;
-
-    if(TxFifo0.Put>TxFifo0.Get)FifoSize = TxFifo0.Put - TxFifo0.Get + 1;
-    else FifoSize = TxFifo0.Get - TxFifo0.Put + 1;
-    if(FifoSize > (TX0FIFOSIZE-1)) FifoSize = TX0FIFOSIZE-1;
-    if(FifoSize < 0) FifoSize = 0;
-    return(FifoSize);
+  return Fifo_Size(&TxFifo0);
 }
 
 // Implementation of the receive FIFO, RxFifo0
-// can hold 0 to RXFIFOSIZE-1 elements
-// you are allowed to restrict RXFIFOSIZE to a power of 2
-
-// add static, volatile, global variables here this as part of Lab 18
+// can hold 0 to RX0FIFOSIZE elements
+struct Fifo RxFifo0;
+uint8_t RxFifo0Buf[RX0FIFOSIZE];
 
 // initialize RxFifo0
 void RxFifo0_Init(void){
-
-// write this as part of Lab 18
-    RxFifo0.Get = RxFifo0.Put = 0;
-
+  Fifo_Init(&RxFifo0, RxFifo0Buf, RX0FIFOSIZE);
 }
 // add element to end of RxFifo0
 // return FIFOSUCCESS if successful
 int RxFifo0_Put(char data){
-
-  // write this as part of Lab 18
-
-    // Check for FIFO Full
-    if((RxFifo0.Put+1)%RX0FIFOSIZE != RxFifo0.Get){
-
-        // Put Data at End of RX0FIFO
-        RxFifo0.Data[RxFifo0.Put] = data;
-
-        //Increment End ptr, wrap around if required
-        RxFifo0.Put = (RxFifo0.Put+1)%RX0FIFOSIZE;
-
-        return(FIFOSUCCESS);
-    }
-    else{
-        return(FIFOFAIL);
-    }
+  return Fifo_Put(&RxFifo0, (uint8_t)data);
 }
 // remove element from front of RxFifo0
 // return FIFOSUCCESS if successful
 int RxFifo0_Get(char *datapt){
-
-  // write this as part of Lab 18
-
-    // Check for FIFO Empty
-    if(RxFifo0.Get != RxFifo0.Put){
-
-        // Get Data from Start of RX0FIFO
-        *datapt = RxFifo0.Data[RxFifo0.Get];
-
-        //Increment Start ptr, wrap around if required
-        RxFifo0.Get = (RxFifo0.Get+1)%RX0FIFOSIZE;
-
-        return(FIFOSUCCESS);
-    }
-    else{
-        return(FIFOFAIL);
-    }
-
+  return Fifo_Get(&RxFifo0, (uint8_t *)datapt);
 }
 // number of elements in RxFifo0
-// 0 to RXFIFOSIZE-1
+// 0 to RX0FIFOSIZE
 uint16_t RxFifo0_Size(void){
-// write this as part of Lab 18
-
-    uint16_t FifoSize;
-
-    if(TxFifo0.Put>TxFifo0.Get)FifoSize = TxFifo0.Put - TxFifo0.Get + 1;
-    else FifoSize = TxFifo0.Get - TxFifo0.Put + 1;
-    return(FifoSize);
+  return Fifo_Size(&RxFifo0);
 }
-
-
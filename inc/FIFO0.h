@@ -54,10 +54,17 @@ policies, either expressed or implied, of the FreeBSD Project.
 
 #ifndef __FIFO0_H__
 #define __FIFO0_H__
+#include <stdint.h>
 
+/**
+ * \brief 1 to compile the occupancy histogram into Fifo_Put, 0 to leave it out
+ */
+#ifndef FIFO_HISTOGRAM
+#define FIFO_HISTOGRAM 0
+#endif
 
 /**
- * \brief Size of the TxFifo0, can hold 0 to TX0FIFOSIZE-1 elements, must be a power of 2
+ * \brief Size of the TxFifo0, can hold 0 to TX0FIFOSIZE elements, must be a power of 2
  */
 #define TX0FIFOSIZE 128    // must be a power of 2
 
@@ -71,10 +78,95 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 #define FIFOFAIL    0     // return value on failure
 
+/**
+ * \struct Fifo
+ * \brief Single-producer single-consumer byte queue.
+ * One side may be an ISR; neither side disables interrupts.
+ */
+struct Fifo{
+  volatile uint8_t *Data;      /**< storage, Mask+1 bytes */
+  uint32_t Mask;               /**< size-1, size is a power of 2 */
+  volatile uint32_t PutI;      /**< elements ever put, free running, written by producer only */
+  volatile uint32_t GetI;      /**< elements ever got, free running, written by consumer only */
+  uint32_t HighWater;          /**< most elements ever in the queue */
+  uint32_t Lost;               /**< elements rejected because the queue was full */
+#if FIFO_HISTOGRAM
+  uint32_t *Histogram;         /**< Mask+2 counters of the size at each Fifo_Put, 0 for none */
+#endif
+};
+
+/**
+ * @details   Initialize an empty queue, which holds 0 to size elements
+ * @param  f pointer to the queue
+ * @param  buf storage of size bytes
+ * @param  size number of elements, must be a power of 2
+ * @return none
+ * @brief  Initialize a Fifo
+ */
+void Fifo_Init(struct Fifo *f, uint8_t *buf, uint32_t size);
+
+#if FIFO_HISTOGRAM
+/**
+ * @details   Count the queue size at the start of each Fifo_Put
+ * @param  f pointer to the queue
+ * @param  histogram size+1 counters, cleared here, or 0 to stop counting
+ * @return none
+ * @brief  Attach an occupancy histogram to a Fifo
+ */
+void Fifo_SetHistogram(struct Fifo *f, uint32_t *histogram);
+#endif
+
+/**
+ * @details   Add one element, called by the producer only
+ * @param  f pointer to the queue
+ * @param  data value to store
+ * @return FIFOSUCCESS if ok, FIFOFAIL if full (counted in Lost)
+ * @brief  Put into a Fifo
+ */
+int Fifo_Put(struct Fifo *f, uint8_t data);
+
+/**
+ * @details   Remove the oldest element, called by the consumer only
+ * @param  f pointer to the queue
+ * @param  datapt pointer to where to store the removed data
+ * @return FIFOSUCCESS if ok, FIFOFAIL if empty
+ * @brief  Get from a Fifo
+ */
+int Fifo_Get(struct Fifo *f, uint8_t *datapt);
+
+/**
+ * @details   Add up to n elements, called by the producer only.
+ * @details   The consumer sees all of them at once.
+ * @param  f pointer to the queue
+ * @param  src elements to store
+ * @param  n number of elements
+ * @return number stored, less than n if the queue filled (the rest are counted in Lost)
+ * @brief  Put several into a Fifo
+ */
+uint32_t Fifo_PutN(struct Fifo *f, const uint8_t *src, uint32_t n);
+
+/**
+ * @details   Remove up to n elements, called by the consumer only
+ * @param  f pointer to the queue
+ * @param  dst where to store the removed elements
+ * @param  n most elements to remove
+ * @return number removed, less than n if the queue emptied
+ * @brief  Get several from a Fifo
+ */
+uint32_t Fifo_GetN(struct Fifo *f, uint8_t *dst, uint32_t n);
+
+/**
+ * @details   Return the number of elements in the queue, from either side
+ * @param  f pointer to the queue
+ * @return 0 to size
+ * @brief  Current size of a Fifo
+ */
+uint32_t Fifo_Size(struct Fifo *f);
+
 
 /**
  * @details   The TxFifo0 FIFO is used by the transmit channel. Outgoing data are stored into this FIFO.
- * @details   Can hold 0 to TX0FIFOSIZE-1 elements, first in first out.
+ * @details   Can hold 0 to TX0FIFOSIZE elements, first in first out.
  * @param  none
  * @return none
  * @brief  Initialize TxFifo0
@@ -83,7 +175,7 @@ void TxFifo0_Init(void);
 
 /**
  * @details   Add one 8-bit element to TxFifo0.
- * @details   Can hold 0 to TX0FIFOSIZE-1 elements, first in first out
+ * @details   Can hold 0 to TX0FIFOSIZE elements, first in first out
  * @warning  TxFifo0_Put itself need not be reentrant, but TxFifo0_Put must be thread-safe with TxFifo0_Get
  * @param  data 8-bit value to store into TxFifo0
  * @return FIFOSUCCESS if ok, FIFOFAIL if full and could not be saved
@@ -103,7 +195,7 @@ int TxFifo0_Get(char *datapt);
 
 /**
  * @details   Return the number of elements in TxFifo0.
- * @details   Can hold 0 to TX0FIFOSIZE-1 elements
+ * @details   Can hold 0 to TX0FIFOSIZE elements
  * @param  none
  * @return number of elements in TxFifo0
  * @brief  Current size of TxFifo0
@@ -111,13 +203,13 @@ int TxFifo0_Get(char *datapt);
 uint16_t TxFifo0_Size(void);
 
 /**
- * \brief Size of the RxFifo0, can hold 0 to RX0FIFOSIZE-1 elements, must be a power of 2
+ * \brief Size of the RxFifo0, can hold 0 to RX0FIFOSIZE elements, must be a power of 2
  */
 #define RX0FIFOSIZE 128 // must be a power of 2
 
 /**
  * @details   The RxFifo0 FIFO is used by the receive channel. Incoming data are stored into this FIFO.
- * @details   Can hold 0 to RX0FIFOSIZE-1 elements, first in first out.
+ * @details   Can hold 0 to RX0FIFOSIZE elements, first in first out.
  * @param  none
  * @return none
  * @brief  Initialize RxFifo0
@@ -126,7 +218,7 @@ void RxFifo0_Init(void);
 
 /**
  * @details   Add one 8-bit element to RxFifo0.
- * @details   Can hold 0 to RX0FIFOSIZE-1 elements, first in first out
+ * @details   Can hold 0 to RX0FIFOSIZE elements, first in first out
  * @warning  RxFifo0_Put itself need not be reentrant, but RxFifo0_Put must be thread-safe with RxFifo0_Get
  * @param  data 8-bit value to store into RxFifo0
  * @return FIFOSUCCESS if ok, FIFOFAIL if full and could not be saved
@@ -147,7 +239,7 @@ int RxFifo0_Get(char *datapt);
 
 /**
  * @details   Return the number of elements in RxFifo0.
- * @details   Can hold 0 to RX0FIFOSIZE-1 elements
+ * @details   Can hold 0 to RX0FIFOSIZE elements
  * @param  none
  * @return number of elements in RxFifo0
  * @brief  Current size of RxFifo0
@@ -0,0 +1,148 @@
+// FilterBank.c
+// Runs on MSP432
+// Selectable IIR, median, Kalman and moving average filters
+// with a common interface, for the IR distance channels.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/LPF.h"
+#include "../inc/FilterBank.h"
+
+// ------------Filter_InitLPF------------
+// Initialize a moving average filter
+// Input: filter is the filter object
+//        buf is the MACQ storage, at least size elements
+//        size depth of the filter, 1 to 1024
+//        initial value to preload
+// Output: none
+void Filter_InitLPF(struct Filter *filter, uint16_t *buf, uint32_t size, uint32_t initial){
+  filter->Type = FILTER_LPF;
+  LPF_Create(&filter->u.Lpf, buf, size, initial);
+}
+
+// ------------Filter_InitIIR------------
+// Initialize a first-order low pass filter
+// y(n) = y(n-1) + (x(n)-y(n-1))/2^shift, kept in 16.16 fixed point
+// so small steps are not lost to truncation
+// Input: filter is the filter object
+//        shift 0 to 15
+//        initial value to preload
+// Output: none
+void Filter_InitIIR(struct Filter *filter, uint32_t shift, uint32_t initial){
+  if(shift>15) shift=15; // max
+  filter->Type = FILTER_IIR;
+  filter->u.Iir.Shift = shift;
+  filter->u.Iir.Y = initial<<16;
+}
+
+// ------------Filter_InitMedian------------
+// Initialize a median filter
+// Input: filter is the filter object
+//        size 3, 5 or 7
+//        initial value to preload
+// Output: none
+void Filter_InitMedian(struct Filter *filter, uint32_t size, uint32_t initial){ uint32_t i;
+  if(size<3) size=3;                               // min
+  if(size>FILTER_MEDIANMAX) size=FILTER_MEDIANMAX; // max
+  size = size|1;                                   // odd, so there is a middle
+  filter->Type = FILTER_MEDIAN;
+  filter->u.Median.Size = size;
+  filter->u.Median.Index = 0;
+  for(i=0; i<FILTER_MEDIANMAX; i++){
+    filter->u.Median.X[i] = initial;
+  }
+}
+
+// ------------Filter_InitKalman------------
+// Initialize a 1-D constant-velocity Kalman filter
+// state is value X and change per sample V, time step 1 sample
+// Input: filter is the filter object
+//        q process noise
+//        r measurement noise variance
+//        initial value to preload
+// Output: none
+void Filter_InitKalman(struct Filter *filter, float q, float r, uint32_t initial){
+  struct FilterKalman *k = &filter->u.Kalman;
+  filter->Type = FILTER_KALMAN;
+  k->X = (float)initial;
+  k->V = 0.0f;
+  k->Pxx = r;            // value known to about one measurement
+  k->Pxv = 0.0f;
+  k->Pvx = 0.0f;
+  k->Pvv = q;
+  k->Q = q;
+  k->R = r;
+}
+
+static uint32_t iirCalc(struct FilterIIR *f, uint32_t newdata){
+  int32_t err = (int32_t)((newdata<<16)-f->Y);
+  f->Y = f->Y + (err>>f->Shift);       // arithmetic shift keeps the sign
+  return (f->Y+0x8000)>>16;            // round to nearest
+}
+
+static uint32_t medianCalc(struct FilterMedian *f, uint32_t newdata){
+  uint16_t sorted[FILTER_MEDIANMAX];
+  uint16_t t;
+  uint32_t i, j, n = f->Size;
+  f->X[f->Index] = newdata;            // replace oldest
+  f->Index = f->Index+1;
+  if(f->Index == n){
+    f->Index = 0;                      // wrap
+  }
+  for(i=0; i<n; i++){                  // insertion sort, at most 7 elements
+    t = f->X[i];
+    j = i;
+    while((j>0) && (sorted[j-1]>t)){
+      sorted[j] = sorted[j-1];
+      j--;
+    }
+    sorted[j] = t;
+  }
+  return sorted[n>>1];
+}
+
+static uint32_t kalmanCalc(struct FilterKalman *k, uint32_t newdata){
+  float pxx, pxv, pvx, pvv, s, k0, k1, y;
+  // predict, F = [1 1; 0 1], Q = q*[1/4 1/2; 1/2 1]
+  k->X = k->X+k->V;
+  pxx = k->Pxx+k->Pxv+k->Pvx+k->Pvv+0.25f*k->Q;
+  pxv = k->Pxv+k->Pvv+0.5f*k->Q;
+  pvx = k->Pvx+k->Pvv+0.5f*k->Q;
+  pvv = k->Pvv+k->Q;
+  // update, H = [1 0]
+  s = pxx+k->R;
+  k0 = pxx/s;
+  k1 = pvx/s;
+  y = (float)newdata-k->X;
+  k->X = k->X+k0*y;
+  k->V = k->V+k1*y;
+  k->Pxx = (1.0f-k0)*pxx;
+  k->Pxv = (1.0f-k0)*pxv;
+  k->Pvx = pvx-k1*pxx;
+  k->Pvv = pvv-k1*pxv;
+  if(k->X < 0.0f){
+    return 0;
+  }
+  if(k->X > 65535.0f){
+    return 65535;
+  }
+  return (uint32_t)(k->X+0.5f);
+}
+
+// ------------Filter_Calc------------
+// calculate one filter output, called at sampling rate
+// Input: filter is an initialized filter object
+//        newdata is new ADC data
+// Output: filter output
+uint32_t Filter_Calc(struct Filter *filter, uint32_t newdata){
+  switch(filter->Type){
+    case FILTER_IIR:
+      return iirCalc(&filter->u.Iir, newdata);
+    case FILTER_MEDIAN:
+      return medianCalc(&filter->u.Median, newdata);
+    case FILTER_KALMAN:
+      return kalmanCalc(&filter->u.Kalman, newdata);
+    default:
+      return LPF_Filter(&filter->u.Lpf, newdata);
+  }
+}
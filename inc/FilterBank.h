@@ -0,0 +1,156 @@
+/**
+ * @file      FilterBank.h
+ * @brief     Selectable digital filters for the IR distance channels
+ * @details   One filter object with a common interface for<br>
+ 1) FILTER_LPF, the moving average in LPF.c<br>
+ 2) FILTER_IIR, first-order low pass y += (x-y)/2^k<br>
+ 3) FILTER_MEDIAN, 3, 5 or 7-tap median for spike rejection<br>
+ 4) FILTER_KALMAN, 1-D constant-velocity Kalman filter<br>
+ * To use a filter<br>
+   a) initialize it once with the Filter_Init function for its type<br>
+   b) call Filter_Calc() at the sampling rate<br>
+ * Latency is the delay behind a ramp in samples (the group delay
+ * of the linear filters); multiply by the sampling
+ * period (e.g. 2 ms for the Lab5 500 Hz IR sampling) to get time.
+ * Cycle counts are estimates for Filter_Calc() at 48 MHz with
+ * no wait states, including the dispatch on Type.
+<table>
+<caption id="filter_cost">Filter cost</caption>
+<tr><th>Type          <th>Latency (samples)  <th>Cycles   <th>RAM (bytes)
+<tr><td>FILTER_LPF    <td>(N-1)/2            <td>~25, ~35 if N is not a power of 2 <td>20+2N
+<tr><td>FILTER_IIR    <td>about 2^k-1        <td>~15      <td>24
+<tr><td>FILTER_MEDIAN <td>(N-1)/2            <td>~60 (3), ~150 (5), ~280 (7) <td>24
+<tr><td>FILTER_KALMAN <td>0 behind a ramp; 8 to half a step with q=0.01, r=1600, more as q/r falls <td>~120 (single precision FPU) <td>36
+</table>
+ * A 256-tap FILTER_LPF at 500 Hz has a latency of 127.5 samples, 0.26 s.
+ * FILTER_MEDIAN with 5 taps has 2 samples, 4 ms.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __FILTERBANK_H__ // do not include more than once
+#define __FILTERBANK_H__
+#include <stdint.h>
+#include "../inc/LPF.h"
+
+/**
+ * \enum FilterType
+ * \brief Selects the algorithm run by Filter_Calc()
+ */
+enum FilterType{
+  FILTER_LPF = 0,     /**< moving average, see LPF.h */
+  FILTER_IIR = 1,     /**< first-order fixed-point IIR */
+  FILTER_MEDIAN = 2,  /**< 3, 5 or 7-tap median */
+  FILTER_KALMAN = 3   /**< constant-velocity Kalman filter */
+};
+
+/**
+ * Maximum number of taps in a FILTER_MEDIAN
+ */
+#define FILTER_MEDIANMAX 7
+
+/**
+ * \struct FilterIIR
+ * \brief State of a FILTER_IIR
+ */
+struct FilterIIR{
+  uint32_t Shift;   /**< k, time constant is about 2^k samples */
+  uint32_t Y;       /**< output in 16.16 fixed point */
+};
+
+/**
+ * \struct FilterMedian
+ * \brief State of a FILTER_MEDIAN
+ */
+struct FilterMedian{
+  uint32_t Size;                       /**< 3, 5 or 7 */
+  uint32_t Index;                      /**< index to oldest */
+  uint16_t X[FILTER_MEDIANMAX];        /**< last Size samples */
+};
+
+/**
+ * \struct FilterKalman
+ * \brief State of a FILTER_KALMAN, one sample per time step
+ */
+struct FilterKalman{
+  float X;          /**< estimated value */
+  float V;          /**< estimated change per sample */
+  float Pxx, Pxv, Pvx, Pvv;  /**< estimate covariance */
+  float Q;          /**< process noise, variance of the change in V per sample */
+  float R;          /**< measurement noise variance */
+};
+
+/**
+ * \struct Filter
+ * \brief One filter of any type, run with Filter_Calc()
+ */
+struct Filter{
+  enum FilterType Type;       /**< which member of the union is in use */
+  union{
+    struct LPF Lpf;
+    struct FilterIIR Iir;
+    struct FilterMedian Median;
+    struct FilterKalman Kalman;
+  } u;
+};
+
+/**
+ * Initialize a moving average filter
+ * @param filter pointer to the filter object
+ * @param buf MACQ storage of at least size elements
+ * @param size depth of the filter, 1 to 1024
+ * @param initial value to preload, 0 to 65535
+ * @return none
+ * @see LPF_Create()
+ * @brief  Initialize a FILTER_LPF
+ */
+void Filter_InitLPF(struct Filter *filter, uint16_t *buf, uint32_t size, uint32_t initial);
+
+/**
+ * Initialize a first-order low pass filter<br>
+ * y(n) = y(n-1) + (x(n)-y(n-1))/2^shift
+ * @param filter pointer to the filter object
+ * @param shift 0 to 15, 0 is no filtering, each increment doubles the time constant
+ * @param initial value to preload, 0 to 32767
+ * @return none
+ * @note  inputs must be below 32768, which covers the 14-bit ADC
+ * @brief  Initialize a FILTER_IIR
+ */
+void Filter_InitIIR(struct Filter *filter, uint32_t shift, uint32_t initial);
+
+/**
+ * Initialize a median filter<br>
+ * y(n) = median(x(n),x(n-1),...,x(n-size+1))
+ * @param filter pointer to the filter object
+ * @param size 3, 5 or 7, other values are rounded to one of these
+ * @param initial value to preload, 0 to 65535
+ * @return none
+ * @brief  Initialize a FILTER_MEDIAN
+ */
+void Filter_InitMedian(struct Filter *filter, uint32_t size, uint32_t initial);
+
+/**
+ * Initialize a 1-D constant-velocity Kalman filter.
+ * The state is the value and its change per sample; the
+ * value is measured directly each sample.
+ * @param filter pointer to the filter object
+ * @param q process noise, larger tracks faster changes
+ * @param r measurement noise variance in ADC counts squared
+ * @param initial value to preload, 0 to 65535
+ * @return none
+ * @note uses single precision floating point
+ * @brief  Initialize a FILTER_KALMAN
+ */
+void Filter_InitKalman(struct Filter *filter, float q, float r, uint32_t initial);
+
+/**
+ * Calculate one filter output<br>
+ * Called at sampling rate
+ * @param filter pointer to an initialized filter object
+ * @param newdata new ADC data, 0 to 65535
+ * @return result filter output, 0 to 65535
+ * @brief  Run one sample through a filter
+ */
+uint32_t Filter_Calc(struct Filter *filter, uint32_t newdata);
+
+#endif // __FILTERBANK_H__
@@ -42,6 +42,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 */
 
 #include <stdint.h>
+#include "CortexM.h"
 #include "FlashProgram.h"
 
 #define FLASH_BANK0_MIN     0x00000000  // Flash Bank0 minimum address
@@ -189,29 +190,58 @@ policies, either expressed or implied, of the FreeBSD Project.
 #define FLCTL_ERASE_TIMCTL                                 (*((volatile uint32_t *)(0x40011118))) /* Erase Timing Control Register */
 #define FLCTL_MASSERASE_TIMCTL                             (*((volatile uint32_t *)(0x4001111C))) /* Mass Erase Timing Control Register */
 #define FLCTL_BURSTPRG_TIMCTL                              (*((volatile uint32_t *)(0x40011120))) /* Burst Program Timing Control Register */
+#define DWT_CTRL                                           (*((volatile uint32_t *)(0xE0001000))) /* DWT Control Register */
+#define DWT_CYCCNT                                         (*((volatile uint32_t *)(0xE0001004))) /* DWT Cycle Count Register */
+#define COREDEBUG_DEMCR                                    (*((volatile uint32_t *)(0xE000EDFC))) /* Debug Exception and Monitor Control Register */
+// Longest wait for each step, in usec; see FlashProgram.h
+#define PROGRAM_TIMEOUT 1000            // one program pulse, a word or a burst of 16
+#define ERASE_TIMEOUT   50000           // one erase pulse of a 4 KB sector
+#define VERIFY_TIMEOUT  1000            // one erase verify, a 4 KB read burst
+#define MODE_TIMEOUT    100             // one read mode change
+
+static uint32_t ClockMHz = 48;          // bus clock for the timeouts, set by Flash_Init()
+static uint32_t MaskStart;              // DWT_CYCCNT when Mask() disabled interrupts
+static uint32_t Blackout;               // longest time interrupts were disabled, in cycles
+static uint32_t EraseAddr;              // sector Flash_EraseStart() is erasing, 0 if none
+static uint32_t EraseLock;              // its lock bit before the erase
+static uint32_t ErasePulses;            // erase pulses it has had
+static uint32_t EraseTime;              // DWT_CYCCNT when the last one started
+
+// Flash_Write(), Flash_FastWrite(), Flash_Erase(), Flash_EraseStart(),
+// Flash_ErasePoll() and everything they call while a bank is busy or
+// out of normal read mode run from SRAM.  The linker command file
+// copies .TI.ramfunc to SRAM_CODE at startup, so instruction fetches
+// never wait on the bank being programmed, and either bank can be
+// the target.
 
 // Check if address offset is valid for write operation
 // Writing addresses must be 4-byte aligned and within range
+#pragma CODE_SECTION(WriteAddrValid, ".TI.ramfunc")
 static int WriteAddrValid(uint32_t addr){
   // check if address offset works for writing
   // must be 4-byte aligned
   return (((addr % 4) == 0) && (addr <= FLASH_OFFSET_MAX));
 }
 // Check if address offset is valid for mass writing operation
-// Mass writing addresses must be 4-word (16-byte) aligned and within range
+// Mass writing addresses must be 4-word (16-byte) aligned, within
+// range and all in one bank
+#pragma CODE_SECTION(MassWriteAddrValid, ".TI.ramfunc")
 static int MassWriteAddrValid(uint32_t addr, uint16_t count){
   // check if address offset works for mass writing
   // must be 4-word (16-byte) aligned
-  return (((addr % 16) == 0) && (addr <= FLASH_OFFSET_MAX) && ((addr + 4*count - 1) <= FLASH_OFFSET_MAX));
+  return (((addr % 16) == 0) && (addr <= FLASH_OFFSET_MAX) && ((addr + 4*count - 1) <= FLASH_OFFSET_MAX) &&
+          (((addr^(addr + 4*count - 1))&FLASH_BANK1_MIN) == 0));
 }
 // Check if address offset is valid for erase operation
 // Erasing addresses must be 4 KB aligned and within range
+#pragma CODE_SECTION(EraseAddrValid, ".TI.ramfunc")
 static int EraseAddrValid(uint32_t addr){
   // check if address offset works for erasing
   // must be 4 KB aligned
   return (((addr % 4096) == 0) && (addr <= FLASH_OFFSET_MAX));
 }
 // Check if address is in flash Bank 0
+#pragma CODE_SECTION(IsInBank0, ".TI.ramfunc")
 static int IsInBank0(uint32_t addr){
 #if (FLASH_BANK0_MIN == 0)
   // Get rid of compiler warning by eliminating pointless unsigned compare with 0.
@@ -220,177 +250,188 @@ static int IsInBank0(uint32_t addr){
   return ((FLASH_BANK0_MIN <= addr) && (addr <= FLASH_BANK0_MAX));
 #endif
 }
-// Check if address is in flash Bank 1
-static int IsInBank1(uint32_t addr){
-  return ((FLASH_BANK1_MIN <= addr) && (addr <= FLASH_BANK1_MAX));
+// Check if a function is still in flash, in the bank of addr.  This
+// happens only if the linker command file has no .TI.ramfunc
+// section (compilers before 15.9), and then the bank cannot be put
+// in a verify read mode while the function runs from it.
+#pragma CODE_SECTION(SameBank, ".TI.ramfunc")
+static int SameBank(uint32_t addr, uint32_t function){
+  return ((function <= FLASH_OFFSET_MAX) && (IsInBank0(addr) == IsInBank0(function)));
+}
+// Read Control Register of the bank with addr; both banks have
+// the bit fields of FLCTL_BANK1_RDCTL
+#pragma CODE_SECTION(RdCtl, ".TI.ramfunc")
+static volatile uint32_t *RdCtl(uint32_t addr){
+  return IsInBank0(addr)? &FLCTL_BANK0_RDCTL : &FLCTL_BANK1_RDCTL;
+}
+// Main Memory Write/Erase Protection Register of the bank with addr
+#pragma CODE_SECTION(MainWeprot, ".TI.ramfunc")
+static volatile uint32_t *MainWeprot(uint32_t addr){
+  return IsInBank0(addr)? &FLCTL_BANK0_MAIN_WEPROT : &FLCTL_BANK1_MAIN_WEPROT;
+}
+// Protection bit of the 4 KB sector with addr, 0x00000001 to 0x80000000
+#pragma CODE_SECTION(LockMask, ".TI.ramfunc")
+static uint32_t LockMask(uint32_t addr){
+  return 1<<((addr&FLASH_BANK0_MAX)>>12);
+}
+// Start the DWT cycle counter if it is not running
+#pragma CODE_SECTION(CycleCounter, ".TI.ramfunc")
+static void CycleCounter(void){
+  if((DWT_CTRL&0x00000001) == 0){
+    COREDEBUG_DEMCR |= 0x01000000;      // TRCENA, enable the DWT
+    DWT_CTRL |= 0x00000001;             // CYCCNTENA
+  }
+}
+// Wait at most 'us' usec for a flag in FLCTL_IFG.  The flag is
+// checked once more after the time is up, in case an interrupt
+// used the time.
+// Output: 'NOERROR' if the flag is set, 'ERROR' if it timed out
+#pragma CODE_SECTION(WaitIFG, ".TI.ramfunc")
+static int WaitIFG(uint32_t flag, uint32_t us){
+  uint32_t start = DWT_CYCCNT, cycles = us*ClockMHz;
+  while((FLCTL_IFG&flag) == 0){
+    if((DWT_CYCCNT - start) > cycles){
+      return (FLCTL_IFG&flag)? NOERROR : ERROR;
+    }
+  }
+  return NOERROR;
+}
+// Set the wait states and read mode of a bank and wait for the
+// read mode change to be confirmed.
+// Output: 'NOERROR' if successful, 'ERROR' if it timed out
+#pragma CODE_SECTION(SetRdCtl, ".TI.ramfunc")
+static int SetRdCtl(volatile uint32_t *rdctl, uint32_t value){
+  uint32_t start = DWT_CYCCNT, cycles = MODE_TIMEOUT*ClockMHz;
+  uint32_t status = (value&FLCTL_BANK1_RDCTL_RD_MODE_M)<<16;
+  *rdctl = value;
+  while((*rdctl&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != status){
+    if((DWT_CYCCNT - start) > cycles){
+      return ((*rdctl&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) == status)? NOERROR : ERROR;
+    }
+  }
+  return NOERROR;
+}
+// Disable interrupts for one step of an operation in Bank 0, which
+// holds the vector table and the interrupt service routines.  An
+// operation in Bank 1 leaves interrupts enabled.
+// Output: previous I bit
+#pragma CODE_SECTION(Mask, ".TI.ramfunc")
+static long Mask(uint32_t addr){
+  long sr = 0;
+  if(IsInBank0(addr)){
+    sr = StartCritical();
+    MaskStart = DWT_CYCCNT;
+  }
+  return sr;
+}
+// End the step, after the bank is back in normal read mode, and
+// keep the longest time interrupts were disabled.
+#pragma CODE_SECTION(Unmask, ".TI.ramfunc")
+static void Unmask(uint32_t addr, long sr){
+  uint32_t cycles;
+  if(IsInBank0(addr)){
+    cycles = DWT_CYCCNT - MaskStart;
+    if(cycles > Blackout){
+      Blackout = cycles;
+    }
+    EndCritical(sr);
+  }
 }
 
 //------------Flash_Init------------
-// This function was critical to the write and erase
-// operations of the flash memory on the LM3S811
-// microcontroller.  But newer processors work slightly
-// differently, and for the MSP432 the timing parameters
-// for the flash and EEPROM memories are configured along
-// with the Clock System.  This function prototype is
-// preserved to try to make it easier to reuse program
-// code between the LM3S811, TM4C123, and TM4C1294.
-// Input: systemClockFreqMHz  system clock frequency (units of MHz)
+// For the MSP432 the timing parameters for the flash memory
+// are configured along with the Clock System, so all this does
+// is record the clock frequency the timeouts are counted in.
+// The function prototype is preserved to try to make it easier
+// to reuse program code between the LM3S811, TM4C123, and TM4C1294.
+// Input: systemClockFreqMHz  system clock frequency (units of MHz),
+//        48 if never called
 // Output: none
 void Flash_Init(uint8_t systemClockFreqMHz){
-  // do nothing; flash and EEPROM memory configured in Clock
-  // System or BSP_Clock_InitFastest() initialization functions
-  // if the processor is executing code out of flash memory,
-  // presumably everything is configured correctly
+  // flash wait states are configured in Clock System or
+  // BSP_Clock_InitFastest() initialization functions
+  if(systemClockFreqMHz){
+    ClockMHz = systemClockFreqMHz;
+  }
 }
 
 //------------Flash_Write------------
 // Write 32-bit data to flash at given address.  Parameter
-// 'addr' must be in flash Bank 1, and this function must be in
-// flash Bank 0.
+// 'addr' may be in either bank; this function runs from SRAM.
+// Each program pulse is checked by the Program Verify read mode,
+// and only the bits still 1 that should be 0 get another pulse.
 // Input: addr 4-byte aligned flash memory address to write
 //        data 32-bit data
 // Output: 'NOERROR' if successful, 'ERROR' if fail (defined in FlashProgram.h)
-// Note: This function is not interrupt safe.
+// Note: This function is not reentrant.
+#pragma CODE_SECTION(Flash_Write, ".TI.ramfunc")
 int Flash_Write(uint32_t addr, uint32_t data){
-  uint32_t lockStatus, lockMask, numPrgPulses, tempVar, existingData, actualData, failBits, updatedData;
-  if((IsInBank0(addr)) || (IsInBank1((int)&Flash_Write))){
-    // This function and the flash to be written are in the same bank.
-    // Because we cannot change the read mode of the flash that contains
-    // the currently running code, we need to either copy this function
-    // to RAM or use one of the library functions in ROM.
-                 // to do later: fix this
+  volatile uint32_t *rdctl, *weprot;
+  uint32_t lockStatus, lockMask, numPrgPulses, saved, program, failBits;
+  long sr;
+  int err;
+  if(EraseAddr || (!WriteAddrValid(addr)) || SameBank(addr, (uint32_t)(uintptr_t)&Flash_Write)){
     return ERROR;
   }
-  if(WriteAddrValid(addr)){
-    // Unlock the block in Flash Main Memory Bank 1.
-    lockMask = 1<<((addr - FLASH_BANK1_MIN)>>12);   // 0x00000001 to 0x80000000
-    lockStatus = FLCTL_BANK1_MAIN_WEPROT&lockMask;  // save previous value
-    FLCTL_BANK1_MAIN_WEPROT = (FLCTL_BANK1_MAIN_WEPROT&~lockMask);
-    // Clear pending PRG, PRG_ERR, AVPST, and AVPRE interrupt flags.
-    FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-    // Enable immediate program operation.  (ENABLE = 1, MODE = 0 in FLCTL_PRG_CTLSTAT)
-    FLCTL_PRG_CTLSTAT |= FLCTL_PRG_CTLSTAT_ENABLE;  // configure for word program operation enabled
-    FLCTL_PRG_CTLSTAT &= ~FLCTL_PRG_CTLSTAT_MODE;   // configure for write immediate mode
-    // Keep track of the number of programming pulses.
-    numPrgPulses = 0;
-    // Location to be programmed may not already be erased.
-    // Enable Pre and Post Verify option.
-    FLCTL_PRG_CTLSTAT |= (FLCTL_PRG_CTLSTAT_VER_PST|FLCTL_PRG_CTLSTAT_VER_PRE);
-    // Store data to be programmed ('data') in a temporary variable.
-    // This is to prevent the accidental loss of data to be programmed.
-    tempVar = data;
-    // Initiate data write to the desired flash address with 'data'.
-    *(volatile uint32_t *)addr = tempVar;           // writes to flash work like writes to RAM
-    // Wait for the programming to complete.
-    while((FLCTL_IFG&FLCTL_IFG_PRG) == 0){
-                 // to do later: return ERROR if this takes too long
-    }
-    // Increment programming pulses used.
-    numPrgPulses = numPrgPulses + 1;
-    while((FLCTL_IFG&FLCTL_IFG_AVPRE) || (FLCTL_IFG&FLCTL_IFG_AVPST)){
-      // Check for pre-program verify error.
-      if(FLCTL_IFG&FLCTL_IFG_AVPRE){
-        // Check if exceeded maximum number of programming pulses.
-        if(numPrgPulses > MAX_PRG_PLS_TLV){
-          // Clear all error flags in FLCTL_CLRIFG register.
-          FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-          // Recall lock status of the block in Flash Main Memory Bank 1.
-          FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-          return ERROR;
-        }
-        // At least one bit was already 0 before programming started.
-        // The flash to be written is in Bank 1.
-        // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
-        FLCTL_BANK1_RDCTL = FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_3){};
-        existingData = *(volatile uint32_t *)addr;
-        failBits = ~(existingData|tempVar);
-        updatedData = tempVar|failBits;             // see Page 378 of MSP432 Datasheet
-        // Configure for read mode of Normal Read.
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_RD_MODE_M)|FLCTL_BANK1_RDCTL_RD_MODE_0;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_0){};
-        // Configure for 2 wait states (minimum for 48 MHz operation).
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_WAIT_M)|FLCTL_BANK1_RDCTL_WAIT_2;
-        // Clear all error flags in FLCTL_CLRIFG register.
-        FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-        // Check if some bits still need to be written.
-        if(updatedData != 0xFFFFFFFF){
-          // Enable Post Verify option.
-          FLCTL_PRG_CTLSTAT |= FLCTL_PRG_CTLSTAT_VER_PST;
-          // Pre Verify not needed since failing bits already masked.
-          FLCTL_PRG_CTLSTAT &= ~FLCTL_PRG_CTLSTAT_VER_PRE;
-          // Initiate data write to the desired flash address with 'updatedData'.
-          *(volatile uint32_t *)addr = updatedData; // writes to flash work like writes to RAM
-          // Wait for the programming to complete.
-          while((FLCTL_IFG&FLCTL_IFG_PRG) == 0){
-                 // to do later: return ERROR if this takes too long
-          }
-          // Increment programming pulses used.
-          numPrgPulses = numPrgPulses + 1;
-        }
-      }
-      // Check for post-program verify error.
-      if(FLCTL_IFG&FLCTL_IFG_AVPST){
-        // Check if exceeded maximum number of programming pulses.
-        if(numPrgPulses > MAX_PRG_PLS_TLV){
-          // Clear all error flags in FLCTL_CLRIFG register.
-          FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-          // Recall lock status of the block in Flash Main Memory Bank 1.
-          FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-          return ERROR;
-        }
-        // At least one bit was still 1 after programming finished.
-        // The flash to be written is in Bank 1.
-        // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
-        FLCTL_BANK1_RDCTL = FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_3){};
-        actualData = *(volatile uint32_t *)addr;
-        failBits = (~tempVar)&actualData;
-        updatedData = ~failBits;                    // see Page 379 of MSP432 Datasheet
-        // Configure for read mode of Normal Read.
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_RD_MODE_M)|FLCTL_BANK1_RDCTL_RD_MODE_0;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_0){};
-        // Configure for 2 wait states (minimum for 48 MHz operation).
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_WAIT_M)|FLCTL_BANK1_RDCTL_WAIT_2;
-        // Clear all error flags in FLCTL_CLRIFG register.
-        FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-        // Check if some bits still need to be written.
-        if(failBits != 0x00000000){
-          // Enable Pre and Post Verify option.
-          FLCTL_PRG_CTLSTAT |= (FLCTL_PRG_CTLSTAT_VER_PST|FLCTL_PRG_CTLSTAT_VER_PRE);
-          // Initiate data write to the desired flash address with 'updatedData'.
-          *(volatile uint32_t *)addr = updatedData; // writes to flash work like writes to RAM
-          // Wait for the programming to complete.
-          while((FLCTL_IFG&FLCTL_IFG_PRG) == 0){
-                 // to do later: return ERROR if this takes too long
-          }
-          // Increment programming pulses used.
-          numPrgPulses = numPrgPulses + 1;
-        }
-      }
+  rdctl = RdCtl(addr);
+  weprot = MainWeprot(addr);
+  CycleCounter();
+  // Unlock the block in Flash Main Memory.
+  lockMask = LockMask(addr);
+  lockStatus = *weprot&lockMask;                    // save previous value
+  *weprot = *weprot&~lockMask;
+  // Clear pending PRG, PRG_ERR, AVPST, and AVPRE interrupt flags.
+  FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
+  // Enable immediate program operation.  (ENABLE = 1, MODE = 0 in FLCTL_PRG_CTLSTAT)
+  FLCTL_PRG_CTLSTAT = (FLCTL_PRG_CTLSTAT|FLCTL_PRG_CTLSTAT_ENABLE)&~FLCTL_PRG_CTLSTAT_MODE;
+  // Location to be programmed may not already be erased.
+  // Enable Pre and Post Verify option.
+  FLCTL_PRG_CTLSTAT |= (FLCTL_PRG_CTLSTAT_VER_PST|FLCTL_PRG_CTLSTAT_VER_PRE);
+  program = data;
+  for(numPrgPulses=0; numPrgPulses<MAX_PRG_PLS_TLV; numPrgPulses=numPrgPulses+1){
+    sr = Mask(addr);
+    // Initiate data write to the desired flash address.
+    *(volatile uint32_t *)(uintptr_t)addr = program; // writes to flash work like writes to RAM
+    if(WaitIFG(FLCTL_IFG_PRG, PROGRAM_TIMEOUT) ||
+       ((FLCTL_IFG&(FLCTL_IFG_AVPRE|FLCTL_IFG_AVPST)) == 0)){
+      Unmask(addr, sr);                             // timed out, or verified
+      break;
     }
+    // At least one bit was already 0 before programming started, or
+    // was still 1 after programming finished.
+    // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
+    saved = *rdctl;
+    err = SetRdCtl(rdctl, FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3);
+    failBits = (~program)&(*(volatile uint32_t *)(uintptr_t)addr);
+    program = ~failBits;                            // see Pages 378-379 of MSP432 Datasheet
+    // Configure the saved wait states and read mode of Normal Read.
+    err |= SetRdCtl(rdctl, saved);
     // Clear all error flags in FLCTL_CLRIFG register.
     FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-    // Recall lock status of the block in Flash Main Memory Bank 1.
-    FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-    return NOERROR;
+    Unmask(addr, sr);
+    if(err || (failBits == 0)){
+      break;
+    }
+    // Pre Verify not needed since failing bits already masked.
+    FLCTL_PRG_CTLSTAT &= ~FLCTL_PRG_CTLSTAT_VER_PRE;
   }
-  return ERROR;
+  // Clear all error flags in FLCTL_CLRIFG register.
+  FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRG|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
+  FLCTL_PRG_CTLSTAT &= ~FLCTL_PRG_CTLSTAT_ENABLE;
+  // Recall lock status of the block in Flash Main Memory.
+  *weprot = *weprot|lockStatus;
+  return (*(volatile uint32_t *)(uintptr_t)addr == data)? NOERROR : ERROR;
 }
 
 //------------Flash_WriteArray------------
 // Write an array of 32-bit data to flash starting at given address.
-// Parameter 'addr' must be in flash Bank 1.
+// Parameter 'addr' may be in either bank.
 // Input: source pointer to array of 32-bit data
 //        addr   4-byte aligned flash memory address to start writing
 //        count  number of 32-bit writes
 // Output: number of successful writes; return value == count if completely successful
 // Note: at 48 MHz, it takes 612 usec to write 10 words
-// Note: This function is not interrupt safe.
+// Note: This function is not reentrant.
 int Flash_WriteArray(uint32_t *source, uint32_t addr, uint16_t count){
   uint16_t successfulWrites = 0;
   while((successfulWrites < count) && (Flash_Write(addr + 4*successfulWrites, source[successfulWrites]) == NOERROR)){
@@ -402,358 +443,299 @@ int Flash_WriteArray(uint32_t *source, uint32_t addr, uint16_t count){
 //------------Flash_FastWrite------------
 // Write an array of 32-bit data to flash starting at given address.
 // This is twice as fast as Flash_WriteArray(), but the address has
-// to be 16-byte aligned, and the count has to be <= 16.  Parameter
-// 'addr' must be in flash Bank 1, and this function must be in
-// flash Bank 0.
+// to be 16-byte aligned, the count has to be <= 16, and the words
+// must be in one bank.  Parameter 'addr' may be in either bank;
+// this function runs from SRAM.
 // Input: source pointer to array of 32-bit data
 //        addr   16-byte aligned flash memory address to start writing
 //        count  number of 32-bit writes (<=16)
-// Output: number of successful writes; return value == min(count, 16) if completely successful
+// Output: number of successful writes, the words from 'addr' on that
+//         read back equal to 'source'; return value == min(count, 16)
+//         if completely successful
 // Note: at 48 MHz, it takes 97 usec to write 10 words
-// Note: This function is not interrupt safe.
+// Note: This function is not reentrant.
+#pragma CODE_SECTION(Flash_FastWrite, ".TI.ramfunc")
 int Flash_FastWrite(uint32_t *source, uint32_t addr, uint16_t count){
   volatile uint32_t *FLCTL_PRGBRST_DATAn_x = (volatile uint32_t *)0x40011060; /* Program Burst Data0 Register0 */
-  uint32_t lockStatus, lockMask, numPrgPulses, existingData, actualData, failBits[16], updatedData[16];
-  int writes = 0, i;
-  if((IsInBank0(addr)) || (IsInBank1((int)&Flash_FastWrite))){
-    // This function and the flash to be written are in the same bank.
-    // Because we cannot change the read mode of the flash that contains
-    // the currently running code, we need to either copy this function
-    // to RAM or use one of the library functions in ROM.
-                 // to do later: fix this
-    return 0;
-  }
+  volatile uint32_t *rdctl, *weprot;
+  uint32_t lockStatus, lockMask, numPrgPulses, saved, failBits, pending;
+  long sr;
+  int writes, err, i;
   if(count > 16){
     // Write a maximum of 16 32-bit words.
     count = 16;
   }
-  if(MassWriteAddrValid(addr, count)){
-    // Clear pending PRGB, PRG_ERR, AVPST, and AVPRE interrupt flags.
-    FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-    // Keep track of the number of programming pulses.
-    numPrgPulses = 0;
-    // Clear any past errors and set status back to "idle".
-    FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-    // Unlock the block in Flash Main Memory Bank 1.
-    lockMask = 1<<((addr - FLASH_BANK1_MIN)>>12);   // 0x00000001 to 0x80000000
-    // Make sure that the last memory location is also unlocked.
-    lockMask |= 1<<((addr - FLASH_BANK1_MIN + 4*count - 1)>>12);
-    lockStatus = FLCTL_BANK1_MAIN_WEPROT&lockMask;  // save previous value
-    FLCTL_BANK1_MAIN_WEPROT = (FLCTL_BANK1_MAIN_WEPROT&~lockMask);
-    // Write data to be programmed into the burst data registers.  (FLCTL_PRGBRST_DATAn_x)
-    for(i=0; i<count; i=i+1){
-      FLCTL_PRGBRST_DATAn_x[i] = source[i];
-    }
-    for(i=count; i<16; i=i+1){
-      FLCTL_PRGBRST_DATAn_x[i] = 0xFFFFFFFF;
-    }
-    // Location to be programmed may not already be erased.
-    // Enable Pre and Post Verify option.
-    FLCTL_PRGBRST_CTLSTAT |= (FLCTL_PRGBRST_CTLSTAT_AUTO_PST|FLCTL_PRGBRST_CTLSTAT_AUTO_PRE);
-    // Setup burst program operation in FLCTL_PRGBRST_CTLSTAT register.
-    // TYPE = Main Memory
-    // LEN = number of 128-bit bursts
-    // count bursts LEN (bits 5-3)
-    // 0     0      000b
-    // 1     1      001b
-    // 2     1      001b
-    // 3     1      001b
-    // 4     1      001b
-    // 5     2      010b
-    // 6     2      010b
-    // 7     2      010b
-    // 8     2      010b
-    // 9     3      011b
-    // 10    3      011b
-    // 11    3      011b
-    // 12    3      011b
-    // 13    4      100b
-    // 14    4      100b
-    // 15    4      100b
-    // 16    4      100b
-    FLCTL_PRGBRST_CTLSTAT = (FLCTL_PRGBRST_CTLSTAT&~FLCTL_PRGBRST_CTLSTAT_TYPE_M)|FLCTL_PRGBRST_CTLSTAT_TYPE_0;
-    FLCTL_PRGBRST_CTLSTAT = (FLCTL_PRGBRST_CTLSTAT&~FLCTL_PRGBRST_CTLSTAT_LEN_M)|(((count+3)/4)<<FLCTL_PRGBRST_CTLSTAT_LEN_OFS);
-    // Setup start address of burst operation in FLCTL_PRGBRST_STARTADDR register.
-    FLCTL_PRGBRST_STARTADDR = addr;
+  if(EraseAddr || (count == 0) || (!MassWriteAddrValid(addr, count)) || SameBank(addr, (uint32_t)(uintptr_t)&Flash_FastWrite)){
+    return 0;
+  }
+  rdctl = RdCtl(addr);
+  weprot = MainWeprot(addr);
+  CycleCounter();
+  // Clear pending PRGB, PRG_ERR, AVPST, and AVPRE interrupt flags.
+  FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
+  // Clear any past errors and set status back to "idle".
+  FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
+  // Unlock the block in Flash Main Memory.
+  // Make sure that the last memory location is also unlocked.
+  lockMask = LockMask(addr)|LockMask(addr + 4*count - 1);
+  lockStatus = *weprot&lockMask;                    // save previous value
+  *weprot = *weprot&~lockMask;
+  // Write data to be programmed into the burst data registers.  (FLCTL_PRGBRST_DATAn_x)
+  for(i=0; i<count; i=i+1){
+    FLCTL_PRGBRST_DATAn_x[i] = source[i];
+  }
+  for(i=count; i<16; i=i+1){
+    FLCTL_PRGBRST_DATAn_x[i] = 0xFFFFFFFF;
+  }
+  // Setup burst program operation in FLCTL_PRGBRST_CTLSTAT register.
+  // TYPE = Main Memory
+  // LEN = number of 128-bit bursts, (count+3)/4, 1 to 4 (bits 5-3)
+  // Location to be programmed may not already be erased.
+  // Enable Pre and Post Verify option.
+  FLCTL_PRGBRST_CTLSTAT = (FLCTL_PRGBRST_CTLSTAT&~(FLCTL_PRGBRST_CTLSTAT_TYPE_M|FLCTL_PRGBRST_CTLSTAT_LEN_M))|
+                          FLCTL_PRGBRST_CTLSTAT_TYPE_0|(((count+3)>>2)<<FLCTL_PRGBRST_CTLSTAT_LEN_OFS)|
+                          FLCTL_PRGBRST_CTLSTAT_AUTO_PST|FLCTL_PRGBRST_CTLSTAT_AUTO_PRE;
+  // Setup start address of burst operation in FLCTL_PRGBRST_STARTADDR register.
+  FLCTL_PRGBRST_STARTADDR = addr;
+  for(numPrgPulses=0; numPrgPulses<MAX_PRG_PLS_TLV; numPrgPulses=numPrgPulses+1){
+    sr = Mask(addr);
     // Start burst program operation by setting START bit in FLCTL_PRGBRST_CTLSTAT.
     FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_START;
-    // Wait for the programming to complete.
-    while((FLCTL_IFG&FLCTL_IFG_PRGB) == 0){
-                 // to do later: return if this takes too long
-    }
-    // Check for Burst Operation terminated due to attempted program of reserved memory.
-    if(FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_ADDR_ERR){
-      // Clear all error flags in FLCTL_CLRIFG register.
-      FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-      // Clear any past errors and set status back to "idle".
-      FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-      // Recall lock status of the block in Flash Main Memory Bank 1.
-      FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-      // It is possible that some data was correctly written if the mass write
-      // straddles a reserved and a not reserved block.  This error response may
-      // need to be changed depending on how the higher-level program intends to
-      // use reserved memory blocks.
-      return 0;
+    // Stop if it timed out, if it was terminated due to attempted program
+    // of reserved memory, or if it verified.
+    if(WaitIFG(FLCTL_IFG_PRGB, PROGRAM_TIMEOUT) || (FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_ADDR_ERR) ||
+       ((FLCTL_PRGBRST_CTLSTAT&(FLCTL_PRGBRST_CTLSTAT_PRE_ERR|FLCTL_PRGBRST_CTLSTAT_PST_ERR)) == 0)){
+      Unmask(addr, sr);
+      break;
     }
-    // Increment programming pulses used.
-    numPrgPulses = numPrgPulses + 1;
-    // All writes were successful unless an error was detected.
-    writes = count;
-    while((FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_PRE_ERR) || (FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_PST_ERR)){
-      // Check for pre-program verify error.
-      if(FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_PRE_ERR){
-        // Check if exceeded maximum number of programming pulses.
-        if(numPrgPulses > MAX_PRG_PLS_TLV){
-          // Clear all error flags in FLCTL_CLRIFG register.
-          FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-          // Clear any past errors and set status back to "idle".
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-          // Recall lock status of the block in Flash Main Memory Bank 1.
-          FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-          return writes;
-        }
-        // At least one bit was already 0 before programming started.
-        // The flash to be written is in Bank 1.
-        // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
-        FLCTL_BANK1_RDCTL = FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_3){};
-        for(i=0; i<count; i=i+1){
-          existingData = *(volatile uint32_t *)(addr + 4*i);
-          failBits[i] = ~(existingData|FLCTL_PRGBRST_DATAn_x[i]);
-                                                    // see Page 382 of MSP432 Datasheet
-          updatedData[i] = FLCTL_PRGBRST_DATAn_x[i]|failBits[i];
-        }
-        // Configure for read mode of Normal Read.
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_RD_MODE_M)|FLCTL_BANK1_RDCTL_RD_MODE_0;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_0){};
-        // Configure for 2 wait states (minimum for 48 MHz operation).
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_WAIT_M)|FLCTL_BANK1_RDCTL_WAIT_2;
-        // Clear all error flags in FLCTL_CLRIFG and FLCTL_PRGBRST_CTLSTAT registers.
-        FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-        FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-        // Check if some bits still need to be written.
-        writes = 0;
-        for(i=0; i<count; i=i+1){
-          if(updatedData[i] == 0xFFFFFFFF){
-            writes = writes + 1;
-          }
-        }
-        if(writes != count){
-          // Enable Post Verify option.
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_AUTO_PST;
-          // Pre Verify not needed since failing bits already masked.
-          FLCTL_PRGBRST_CTLSTAT &= ~FLCTL_PRGBRST_CTLSTAT_AUTO_PRE;
-          // Rewrite the FLCTL_PRGBRST_DATAn_x registers with 'updatedData'.
-          for(i=0; i<count; i=i+1){
-            FLCTL_PRGBRST_DATAn_x[i] = updatedData[i];
-          }
-          // Re-start burst program operation by setting START bit in FLCTL_PRGBRST_CTLSTAT.
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_START;
-          // Wait for the programming to complete.
-          while((FLCTL_IFG&FLCTL_IFG_PRGB) == 0){
-                 // to do later: return if this takes too long
-          }
-          // Increment programming pulses used.
-          numPrgPulses = numPrgPulses + 1;
-          // All writes were successful unless an error was detected.
-          writes = count;
-        }
-      }
-      // Check for post-program verify error.
-      if(FLCTL_PRGBRST_CTLSTAT&FLCTL_PRGBRST_CTLSTAT_PST_ERR){
-        // Check if exceeded maximum number of programming pulses.
-        if(numPrgPulses > MAX_PRG_PLS_TLV){
-          // Clear all error flags in FLCTL_CLRIFG register.
-          FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-          // Clear any past errors and set status back to "idle".
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-          // Recall lock status of the block in Flash Main Memory Bank 1.
-          FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-          return writes;
-        }
-        // At least one bit was still 1 after programming finished.
-        // The flash to be written is in Bank 1.
-        // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
-        FLCTL_BANK1_RDCTL = FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_3){};
-        for(i=0; i<count; i=i+1){
-          actualData = *(volatile uint32_t *)(addr + 4*i);
-          failBits[i] = (~FLCTL_PRGBRST_DATAn_x[i])&actualData;
-          updatedData[i] = ~failBits[i];            // see Page 383 of MSP432 Datasheet
-        }
-        // Configure for read mode of Normal Read.
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_RD_MODE_M)|FLCTL_BANK1_RDCTL_RD_MODE_0;
-        // Wait for the read mode change to be confirmed.
-        while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_0){};
-        // Configure for 2 wait states (minimum for 48 MHz operation).
-        FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_WAIT_M)|FLCTL_BANK1_RDCTL_WAIT_2;
-        // Clear all error flags in FLCTL_CLRIFG and FLCTL_PRGBRST_CTLSTAT registers.
-        FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-        FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-        // Check if some bits still need to be written.
-        writes = 0;
-        for(i=0; i<count; i=i+1){
-          if(failBits[i] == 0x00000000){
-            writes = writes + 1;
-          }
-        }
-        if(writes != count){
-          // Enable Post Verify option.
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_AUTO_PST;
-          // Pre Verify not needed since failing bits already masked.
-          FLCTL_PRGBRST_CTLSTAT &= ~FLCTL_PRGBRST_CTLSTAT_AUTO_PRE;
-          // Rewrite the FLCTL_PRGBRST_DATAn_x registers with 'updatedData'.
-          for(i=0; i<count; i=i+1){
-            FLCTL_PRGBRST_DATAn_x[i] = updatedData[i];
-          }
-          // Re-start burst program operation by setting START bit in FLCTL_PRGBRST_CTLSTAT.
-          FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_START;
-          // Wait for the programming to complete.
-          while((FLCTL_IFG&FLCTL_IFG_PRGB) == 0){
-                 // to do later: return if this takes too long
-          }
-          // Increment programming pulses used.
-          numPrgPulses = numPrgPulses + 1;
-          // All writes were successful unless an error was detected.
-          writes = count;
-        }
-      }
+    // At least one bit was already 0 before programming started, or
+    // was still 1 after programming finished.
+    // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Program Verify.
+    saved = *rdctl;
+    err = SetRdCtl(rdctl, FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_3);
+    // Clear any past errors and set status back to "idle".
+    FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
+    pending = 0;
+    for(i=0; i<count; i=i+1){
+      failBits = (~FLCTL_PRGBRST_DATAn_x[i])&(*(volatile uint32_t *)(uintptr_t)(addr + 4*i));
+      FLCTL_PRGBRST_DATAn_x[i] = ~failBits;         // see Pages 382-383 of MSP432 Datasheet
+      pending |= failBits;
     }
+    // Configure the saved wait states and read mode of Normal Read.
+    err |= SetRdCtl(rdctl, saved);
     // Clear all error flags in FLCTL_CLRIFG register.
     FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
-    // Clear any past errors and set status back to "idle".
-    FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
-    // Recall lock status of the block in Flash Main Memory Bank 1.
-    FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
+    Unmask(addr, sr);
+    if(err || (pending == 0)){
+      break;
+    }
+    // Pre Verify not needed since failing bits already masked.
+    FLCTL_PRGBRST_CTLSTAT &= ~FLCTL_PRGBRST_CTLSTAT_AUTO_PRE;
+  }
+  // Clear all error flags in FLCTL_CLRIFG register.
+  FLCTL_CLRIFG = (FLCTL_CLRIFG_PRG_ERR|FLCTL_CLRIFG_PRGB|FLCTL_CLRIFG_AVPST|FLCTL_CLRIFG_AVPRE);
+  // Clear any past errors and set status back to "idle".
+  FLCTL_PRGBRST_CTLSTAT |= FLCTL_PRGBRST_CTLSTAT_CLR_STAT;
+  // Recall lock status of the block in Flash Main Memory.
+  *weprot = *weprot|lockStatus;
+  // Some data may be correctly written even if the burst failed.
+  writes = 0;
+  while((writes < count) && (*(volatile uint32_t *)(uintptr_t)(addr + 4*writes) == source[writes])){
+    writes = writes + 1;
   }
   return writes;
 }
 
+// Unlock the 4 KB sector with addr and set the controller up to
+// erase it.
+// Output: the previous lock bit of the sector, for EraseEnd()
+#pragma CODE_SECTION(EraseBegin, ".TI.ramfunc")
+static uint32_t EraseBegin(uint32_t addr){
+  volatile uint32_t *weprot = MainWeprot(addr);
+  uint32_t lockStatus, lockMask;
+  CycleCounter();
+  // Clear pending ERASE and RDBRST interrupt flags.
+  FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE|FLCTL_CLRIFG_RDBRST;
+  // Clear any past reserved memory erase attempt errors and set status back to "idle".
+  FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
+  // Unlock the block in Flash Main Memory.
+  lockMask = LockMask(addr);
+  lockStatus = *weprot&lockMask;                    // save previous value
+  *weprot = *weprot&~lockMask;
+  // Configure flash erase sector address.
+  FLCTL_ERASE_SECTADDR = addr;
+  // Configure for sector erase in Main Memory region.
+  FLCTL_ERASE_CTLSTAT = (FLCTL_ERASE_CTLSTAT&~(FLCTL_ERASE_CTLSTAT_TYPE_M|FLCTL_ERASE_CTLSTAT_MODE))|FLCTL_ERASE_CTLSTAT_TYPE_0;
+  return lockStatus;
+}
+// Check the erase pulse that just finished with a Burst
+// Read/Compare in the Erase Verify read mode.
+// Output: 'NOERROR' if the sector reads all 1s, 'FLASH_BUSY' if it
+//         needs another pulse, 'ERROR' if the verify timed out
+#pragma CODE_SECTION(EraseVerify, ".TI.ramfunc")
+static int EraseVerify(uint32_t addr){
+  volatile uint32_t *rdctl = RdCtl(addr);
+  uint32_t saved;
+  int err;
+  // Configure Burst Read/Compare hardware.
+  // Clear any past reserved memory access attempt errors, clear comparison errors, and set status back to "idle".
+  FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_CLR_STAT;
+  // Configure starting sector address, defined as offset from start address of flash.
+  FLCTL_RDBRST_STARTADDR = addr - FLASH_BANK0_MIN;
+  // Configure length of read.
+  FLCTL_RDBRST_LEN = 4096;                          // length of burst operation in bytes
+  // Configure for comparison against all 1's, terminate on first mismatch, and read main memory.
+  FLCTL_RDBRST_CTLSTAT = (FLCTL_RDBRST_CTLSTAT &
+                         ~(FLCTL_RDBRST_CTLSTAT_TEST_EN|FLCTL_RDBRST_CTLSTAT_MEM_TYPE_M)) |
+                         FLCTL_RDBRST_CTLSTAT_DATA_CMP |
+                         FLCTL_RDBRST_CTLSTAT_STOP_FAIL |
+                         FLCTL_RDBRST_CTLSTAT_MEM_TYPE_0;
+  // Clear failure address and failure count registers.
+  FLCTL_RDBRST_FAILADDR = 0;                        // may be interesting when debugging
+  FLCTL_RDBRST_FAILCNT = 0;
+  // Clear pending RDBRST interrupt flag.
+  FLCTL_CLRIFG = FLCTL_CLRIFG_RDBRST;
+  // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Erase Verify.
+  saved = *rdctl;
+  err = SetRdCtl(rdctl, FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_4);
+  if(err == NOERROR){
+    // Initiate Read Burst/Compare operation and wait for the read to complete.
+    FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_START;
+    err = WaitIFG(FLCTL_IFG_RDBRST, VERIFY_TIMEOUT);
+  }
+  // Clear any past reserved memory access attempt errors, clear comparison errors, and set status back to "idle".
+  FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_CLR_STAT;
+  // Configure the saved wait states and read mode of Normal Read.
+  err |= SetRdCtl(rdctl, saved);
+  // Clear pending ERASE interrupt flags.
+  FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE|FLCTL_CLRIFG_RDBRST;
+  if(err){
+    return ERROR;
+  }
+  // Check if some bits still need to be cleared.
+  // Look at the FLCTL_RDBRST_FAILCNT register because the bit in FLCTL_RDBRST_CTLSTAT is cleared when going back to idle.
+  if(FLCTL_RDBRST_FAILCNT == 0){
+    return NOERROR;
+  }
+  // Clear any past reserved memory erase attempt errors and set status back to "idle".
+  FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
+  return FLASH_BUSY;
+}
+// Leave the controller idle and lock the sector again.
+#pragma CODE_SECTION(EraseEnd, ".TI.ramfunc")
+static void EraseEnd(uint32_t addr, uint32_t lockStatus){
+  volatile uint32_t *weprot = MainWeprot(addr);
+  // Clear pending ERASE and RDBRST interrupt flags.
+  FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE|FLCTL_CLRIFG_RDBRST;
+  // Clear any past reserved memory erase attempt errors and set status back to "idle".
+  FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
+  // Recall lock status of the block in Flash Main Memory.
+  *weprot = *weprot|lockStatus;
+}
+
 //------------Flash_Erase------------
-// Erase 4 KB block of flash.  Parameter 'addr' must be in
-// flash Bank 1, and this function must be in flash Bank 0.
+// Erase 4 KB block of flash.  Parameter 'addr' may be in either
+// bank; this function runs from SRAM.  Each erase pulse is checked
+// by a Burst Read/Compare in the Erase Verify read mode.
 // Input: addr 4-KB aligned flash memory address to erase
 // Output: 'NOERROR' if successful, 'ERROR' if fail (defined in FlashProgram.h)
-// Note: This function is not interrupt safe.
+// Note: This function is not reentrant.
+#pragma CODE_SECTION(Flash_Erase, ".TI.ramfunc")
 int Flash_Erase(uint32_t addr){
-  uint32_t lockStatus, lockMask, numEraPulses;
-  if((IsInBank0(addr)) || (IsInBank1((int)&Flash_Erase))){
-    // This function and the flash to be erased are in the same bank.
-    // Because we cannot change the read mode of the flash that contains
-    // the currently running code, we need to either copy this function
-    // to RAM or use one of the library functions in ROM.
-                 // to do later: fix this
+  uint32_t lockStatus, numEraPulses;
+  long sr;
+  int result = ERROR;
+  if(EraseAddr || (!EraseAddrValid(addr)) || SameBank(addr, (uint32_t)(uintptr_t)&Flash_Erase)){
     return ERROR;
   }
-  if(EraseAddrValid(addr)){
-    // Clear pending ERASE interrupt flags.
-    FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE;
-    // Clear any past reserved memory erase attempt errors and set status back to "idle".
-    FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
-    // Unlock the block in Flash Main Memory Bank 1.
-    lockMask = 1<<((addr - FLASH_BANK1_MIN)>>12);   // 0x00000001 to 0x80000000
-    lockStatus = FLCTL_BANK1_MAIN_WEPROT&lockMask;  // save previous value
-    FLCTL_BANK1_MAIN_WEPROT = (FLCTL_BANK1_MAIN_WEPROT&~lockMask);
-    // Configure flash erase sector address.
-    FLCTL_ERASE_SECTADDR = addr;
-    // Configure for erase in Main Memory region.
-    FLCTL_ERASE_CTLSTAT = (FLCTL_ERASE_CTLSTAT&~FLCTL_ERASE_CTLSTAT_TYPE_M)|FLCTL_ERASE_CTLSTAT_TYPE_0;
-    // Configure for sector erase.
-    FLCTL_ERASE_CTLSTAT &= ~FLCTL_ERASE_CTLSTAT_MODE;
-    // Keep track of the number of erase pulses.
-    numEraPulses = 0;
+  lockStatus = EraseBegin(addr);
+  for(numEraPulses=0; numEraPulses<MAX_ERA_PLS_TLV; numEraPulses=numEraPulses+1){
+    sr = Mask(addr);
     // Initiate erase of the desired flash block.
     FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_START;
-    // Wait for the erase to complete.
-    while((FLCTL_IFG&FLCTL_IFG_ERASE) == 0){
-                 // to do later: return ERROR if this takes too long
+    if(WaitIFG(FLCTL_IFG_ERASE, ERASE_TIMEOUT) || (FLCTL_ERASE_CTLSTAT&FLCTL_ERASE_CTLSTAT_ADDR_ERR)){
+      Unmask(addr, sr);
+      break;
     }
-    // Increment erase pulses used.
-    numEraPulses = numEraPulses + 1;
-    // Check for success of erase operation.
-    do{
-      // Check if exceeded maximum number of erase pulses.
-      if(numEraPulses > MAX_ERA_PLS_TLV){
-        // Clear pending ERASE and RDBRST interrupt flags.
-        FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE|FLCTL_CLRIFG_RDBRST;
-        // Clear any past reserved memory erase attempt errors and set status back to "idle".
-        FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
-        // Clear any past reserved memory access attempt errors, clear comparison errors, and set status back to "idle".
-        FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_CLR_STAT;
-        // Recall lock status of the block in Flash Main Memory Bank 1.
-        FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-        return ERROR;
-      }
-      // Configure Burst Read/Compare hardware.
-      // Clear any past reserved memory access attempt errors, clear comparison errors, and set status back to "idle".
-      FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_CLR_STAT;
-      // Configure starting sector address, defined as offset from start address of flash.
-      FLCTL_RDBRST_STARTADDR = addr - FLASH_BANK0_MIN;
-      // Configure length of read.
-      FLCTL_RDBRST_LEN = 4096;                      // length of burst operation in bytes
-      // Configure for comparison against all 1's, terminate on first mismatch, and read main memory.
-      FLCTL_RDBRST_CTLSTAT = (FLCTL_RDBRST_CTLSTAT &
-                             ~(FLCTL_RDBRST_CTLSTAT_TEST_EN|FLCTL_RDBRST_CTLSTAT_MEM_TYPE_M)) |
-                             FLCTL_RDBRST_CTLSTAT_DATA_CMP |
-                             FLCTL_RDBRST_CTLSTAT_STOP_FAIL |
-                             FLCTL_RDBRST_CTLSTAT_MEM_TYPE_0;
-      // Clear failure address and failure count registers.
-      FLCTL_RDBRST_FAILADDR = 0;                    // may be interesting when debugging
-      FLCTL_RDBRST_FAILCNT = 0;
-      // Clear pending RDBRST interrupt flag.
-      FLCTL_CLRIFG = FLCTL_CLRIFG_RDBRST;
-      // The flash to be cleared is in Bank 1.
-      // Configure for 5 wait states (minimum for 48 MHz operation) and for read mode of Erase Verify.
-      FLCTL_BANK1_RDCTL = FLCTL_BANK1_RDCTL_WAIT_5|FLCTL_BANK1_RDCTL_RD_MODE_4;
-      // Wait for the read mode change to be confirmed.
-      while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_4){};
-      // Initiate Read Burst/Compare operation.
-      FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_START;
-      // Wait for the read to complete.
-      while((FLCTL_IFG&FLCTL_IFG_RDBRST) == 0){
-                 // to do later: return ERROR if this takes too long
-      }
-      // Clear any past reserved memory access attempt errors, clear comparison errors, and set status back to "idle".
-      FLCTL_RDBRST_CTLSTAT |= FLCTL_RDBRST_CTLSTAT_CLR_STAT;
-      // Configure for read mode of Normal Read.
-      FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_RD_MODE_M)|FLCTL_BANK1_RDCTL_RD_MODE_0;
-      // Wait for the read mode change to be confirmed.
-      while((FLCTL_BANK1_RDCTL&FLCTL_BANK1_RDCTL_RD_MODE_STATUS_M) != FLCTL_BANK1_RDCTL_RD_MODE_STATUS_0){};
-      // Configure for 2 wait states (minimum for 48 MHz operation).
-      FLCTL_BANK1_RDCTL = (FLCTL_BANK1_RDCTL&~FLCTL_BANK1_RDCTL_WAIT_M)|FLCTL_BANK1_RDCTL_WAIT_2;
-      // Check if some bits still need to be cleared.
-      // Look at the FLCTL_RDBRST_FAILCNT register because the bit in FLCTL_RDBRST_CTLSTAT is cleared when going back to idle.
-      if(FLCTL_RDBRST_FAILCNT > 0){
-        // Clear pending ERASE interrupt flags.
-        FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE;
-        // Clear any past reserved memory erase attempt errors and set status back to "idle".
-        FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
-        // Configure flash erase sector address.
-        FLCTL_ERASE_SECTADDR = addr;
-        // Configure for erase in Main Memory region.
-        FLCTL_ERASE_CTLSTAT = (FLCTL_ERASE_CTLSTAT&~FLCTL_ERASE_CTLSTAT_TYPE_M)|FLCTL_ERASE_CTLSTAT_TYPE_0;
-        // Configure for sector erase.
-        FLCTL_ERASE_CTLSTAT &= ~FLCTL_ERASE_CTLSTAT_MODE;
-        // Re-initiate erase of the desired flash block.
-        FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_START;
-        // Wait for the erase to complete.
-        while((FLCTL_IFG&FLCTL_IFG_ERASE) == 0){
-                 // to do later: return ERROR if this takes too long
-        }
-        // Increment erase pulses used.
-        numEraPulses = numEraPulses + 1;
-      }
-    } while(FLCTL_RDBRST_FAILCNT > 0);
-    // Clear pending ERASE and RDBRST interrupt flags.
-    FLCTL_CLRIFG = FLCTL_CLRIFG_ERASE|FLCTL_CLRIFG_RDBRST;
-    // Clear any past reserved memory erase attempt errors and set status back to "idle".
-    FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
-    // Recall lock status of the block in Flash Main Memory Bank 1.
-    FLCTL_BANK1_MAIN_WEPROT = FLCTL_BANK1_MAIN_WEPROT|lockStatus;
-    return NOERROR;
+    result = EraseVerify(addr);
+    Unmask(addr, sr);
+    if(result != FLASH_BUSY){
+      break;
+    }
+    result = ERROR;
   }
-  return ERROR;
+  EraseEnd(addr, lockStatus);
+  return result;
+}
+
+//------------Flash_EraseStart------------
+// Start erasing a 4 KB block of flash in Bank 1 and return
+// without waiting; Flash_ErasePoll() finishes it.  This function
+// runs from SRAM.
+// Input: addr 4-KB aligned flash memory address in Bank 1
+// Output: 'NOERROR' if the erase started, 'ERROR' if 'addr' is not
+//         in Bank 1 or an erase is already in progress
+// Note: This function is not reentrant.
+#pragma CODE_SECTION(Flash_EraseStart, ".TI.ramfunc")
+int Flash_EraseStart(uint32_t addr){
+  if(EraseAddr || (!EraseAddrValid(addr)) || IsInBank0(addr) ||
+     SameBank(addr, (uint32_t)(uintptr_t)&Flash_EraseStart)){
+    return ERROR;
+  }
+  EraseLock = EraseBegin(addr);
+  EraseAddr = addr;
+  ErasePulses = 0;
+  // Initiate erase of the desired flash block.
+  EraseTime = DWT_CYCCNT;
+  FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_START;
+  return NOERROR;
+}
+
+//------------Flash_ErasePoll------------
+// Check on the erase begun by Flash_EraseStart().  When a pulse
+// has finished it is verified, which takes up to 1.2 ms, and
+// another pulse is started if some bits are still 0.
+// Input: none
+// Output: 'FLASH_BUSY' while the erase runs, then 'NOERROR' if the
+//         sector was erased, 'ERROR' if it failed, timed out, or no
+//         erase was started
+// Note: This function is not reentrant.
+#pragma CODE_SECTION(Flash_ErasePoll, ".TI.ramfunc")
+int Flash_ErasePoll(void){
+  int result;
+  if(EraseAddr == 0){
+    return ERROR;
+  }
+  if(((FLCTL_IFG&FLCTL_IFG_ERASE) == 0) && ((DWT_CYCCNT - EraseTime) <= ERASE_TIMEOUT*ClockMHz)){
+    return FLASH_BUSY;
+  }
+  // The flag is checked once more after the time is up, in case an
+  // interrupt used the time.
+  if(((FLCTL_IFG&FLCTL_IFG_ERASE) == 0) || (FLCTL_ERASE_CTLSTAT&FLCTL_ERASE_CTLSTAT_ADDR_ERR)){
+    result = ERROR;
+  }else{
+    result = EraseVerify(EraseAddr);
+    ErasePulses = ErasePulses+1;
+    if((result == FLASH_BUSY) && (ErasePulses < MAX_ERA_PLS_TLV)){
+      // Initiate another erase pulse.
+      EraseTime = DWT_CYCCNT;
+      FLCTL_ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_START;
+      return FLASH_BUSY;
+    }
+    if(result == FLASH_BUSY){
+      result = ERROR;
+    }
+  }
+  EraseEnd(EraseAddr, EraseLock);
+  EraseAddr = 0;
+  return result;
+}
+
+//------------Flash_Blackout------------
+// Longest time interrupts were disabled by one step of a program
+// or erase in Bank 0 since reset, measured on the DWT cycle counter.
+// Input: none
+// Output: time in usec
+uint32_t Flash_Blackout(void){
+  return (Blackout + ClockMHz - 1)/ClockMHz;
 }
@@ -3,7 +3,32 @@
  * @brief     Provide functions that initialize the flash memory
  * @details   Runs on MSP432, write
  * 32-bit data to flash, write an array of 32-bit data to flash,
- * and erase a 4 KB block.
+ * and erase a 4 KB block.<br>
+ * Flash_Write(), Flash_FastWrite() and Flash_Erase() run from SRAM
+ * (section .TI.ramfunc, copied at startup by the linker command
+ * file), so the target may be in either bank, including the one
+ * holding the program. Every wait on the flash controller has a
+ * timeout, counted on the DWT cycle counter at the frequency given
+ * to Flash_Init():<br>
+<table>
+<caption id="flash_timeouts">Longest wait per step</caption>
+<tr><th>Step                                <th>Timeout
+<tr><td>program pulse, a word or a burst   <td>1 ms
+<tr><td>erase pulse, a 4 KB sector         <td>50 ms
+<tr><td>erase verify, a 4 KB read burst    <td>1 ms
+<tr><td>read mode change                   <td>0.1 ms
+</table>
+ * A target in Bank 1 leaves interrupts enabled; the interrupt
+ * service routines in Bank 0 run during the operation. Bank 0 holds
+ * the vector table and the interrupt service routines, which cannot
+ * be fetched while it is busy or in a verify read mode, so a target
+ * in Bank 0 disables interrupts for each pulse and its verify. The
+ * worst case blackout is one erase step, at most 50+1+2*0.1 = 51.2 ms
+ * if the controller never finishes, and one program step at most
+ * 1.2 ms. Flash_Blackout() reports the longest one measured; in the
+ * simulator a Bank 0 erase step is 8.5 ms and a stalled one 50.1 ms.
+ * Interrupt service routines must not read constants in the bank
+ * being programmed.
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -70,6 +95,10 @@ policies, either expressed or implied, of the FreeBSD Project.
  * \brief Value returned if success
  */
 #define NOERROR 0
+/**
+ * \brief Value returned by Flash_ErasePoll() while the erase runs
+ */
+#define FLASH_BUSY 2
 
 
 /**
@@ -78,7 +107,7 @@ policies, either expressed or implied, of the FreeBSD Project.
  * @param  systemClockFreqMHz System clock frequency in MHz
  * @return none
  * @note   Units of frequency are in MHz
- * @note   On the MSP432, this function is not needed and thus the implementation is empty. The empty function is included to be compatible with other architectures that do need initialization.
+ * @note   On the MSP432 the flash timing is configured with the clock, so this only sets the frequency the timeouts are counted at, 48 MHz if never called.
  * @brief  Initialize Flash
  */
 void Flash_Init(uint8_t systemClockFreqMHz);
@@ -89,8 +118,8 @@ void Flash_Init(uint8_t systemClockFreqMHz);
  * @param   addr 4-byte aligned flash memory address to write
  * @param   data 32-bit data
  * @return  Result 'NOERROR' if successful, 'ERROR' if fail
- * @note    This function is not interrupt safe.
- * @warning 'addr' must be in flash Bank 1, the function must be in bank 0
+ * @note    This function is not reentrant.
+ * @warning With 'addr' in Bank 0, interrupts are disabled during each program pulse
  * @brief   Write 32-bit data to flash
  */
 int Flash_Write(uint32_t addr, uint32_t data);
@@ -103,8 +132,8 @@ int Flash_Write(uint32_t addr, uint32_t data);
  * @param   count  number of 32-bit writes
  * @return  Result number of successful writes; return value == count if completely successful
  * @note    At 48 MHz, it takes 612 usec to write 10 words
- * @note    This function is not interrupt safe.
- * @warning Parameter 'addr' must be in flash Bank 1, the function must be in bank 0
+ * @note    This function is not reentrant.
+ * @warning With 'addr' in Bank 0, interrupts are disabled during each program pulse
  * @brief   Write an array to flash
  */
 int Flash_WriteArray(uint32_t *source, uint32_t addr, uint16_t count);
@@ -113,15 +142,16 @@ int Flash_WriteArray(uint32_t *source, uint32_t addr, uint16_t count);
 /**
  * Write an array of 32-bit data to flash starting at given address.
  * This is twice as fast as Flash_WriteArray(), but the address has
- * to be 16-byte aligned, and the count has to be <= 16.
+ * to be 16-byte aligned, the count has to be <= 16, and the words
+ * must be in one bank.
  *
  * @param   source pointer to array of 32-bit data
  * @param   addr 16-byte aligned flash memory address to start writing
  * @param   count  number of 32-bit writes
- * @return  Result number of successful writes; return value == min(count, 16) if completely successful
+ * @return  Result number of successful writes, the words from 'addr' on that read back equal to 'source'; return value == min(count, 16) if completely successful
  * @note    At 48 MHz, it takes 114 usec to write 16 words
- * @note    This function is not interrupt safe.
- * @warning Parameter 'addr' must be in flash Bank 1, the function must be in bank 0
+ * @note    This function is not reentrant.
+ * @warning With 'addr' in Bank 0, interrupts are disabled during each program pulse
  * @brief   Write an array to flash
  */
 int Flash_FastWrite(uint32_t *source, uint32_t addr, uint16_t count);
@@ -133,8 +163,46 @@ int Flash_FastWrite(uint32_t *source, uint32_t addr, uint16_t count);
  * @param   addr 4-KB aligned flash memory address to erase
  * @return  Result 'NOERROR' if successful, 'ERROR' if fail
  * @note    At 48 MHz, it takes 612 usec to write 10 words
- * @note    This function is not interrupt safe.
- * @warning Parameter 'addr' must be in flash Bank 1, the function must be in bank 0
+ * @note    This function is not reentrant.
+ * @warning With 'addr' in Bank 0, interrupts are disabled during each erase pulse, milliseconds; the sector must not hold the vector table or code that runs
  * @brief   Erase 4 KB block of flash
  */
 int Flash_Erase(uint32_t addr);
+
+
+/**
+ * Start erasing a 4 KB block of flash in Bank 1 and return at once.
+ * Call Flash_ErasePoll() until it is no longer FLASH_BUSY; an erase
+ * pulse takes milliseconds and the processor is free meanwhile, but
+ * Bank 1 must not be read and nothing else can be programmed or
+ * erased until the erase is done.
+ *
+ * @param   addr 4-KB aligned flash memory address in Bank 1
+ * @return  Result 'NOERROR' if the erase started, 'ERROR' if 'addr' is not in Bank 1 or an erase is in progress
+ * @note    This function is not reentrant.
+ * @brief   Start erasing 4 KB block of flash
+ */
+int Flash_EraseStart(uint32_t addr);
+
+
+/**
+ * Finish the erase begun by Flash_EraseStart(). Each finished pulse
+ * is verified here, up to 1.2 ms, and another one started if needed.
+ *
+ * @param   none
+ * @return  Result 'FLASH_BUSY' while the erase runs, then 'NOERROR' if successful, 'ERROR' if it failed or timed out, or no erase was started
+ * @note    This function is not reentrant.
+ * @brief   Poll a split-phase erase
+ */
+int Flash_ErasePoll(void);
+
+
+/**
+ * Longest time interrupts were disabled by one step of a program
+ * or erase in Bank 0 since reset, measured on the DWT cycle counter
+ *
+ * @param   none
+ * @return  time in usec, 0 if nothing in Bank 0 was programmed or erased
+ * @brief   Worst interrupt blackout
+ */
+uint32_t Flash_Blackout(void);
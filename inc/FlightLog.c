@@ -0,0 +1,320 @@
+// FlightLog.c
+// Runs on MSP432
+// Append-only ring of sensor snapshots in flash Bank 1, programmed
+// in 64-byte bursts, with CRCs and recovery of the write head after
+// a power cut.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/CRC16.h"
+#include "../inc/FlashProgram.h"
+#include "../inc/Telemetry.h"
+#include "../inc/FlightLog.h"
+
+#define BANK1_MIN 0x00020000
+#define BANK1_END 0x00040000
+#define WORDS     8            // 32-bit words in a header or a record
+
+static uint32_t Base, Sectors; // region, Sectors=0 until FlightLog_Init succeeds
+static uint32_t Current;       // sector being filled
+static uint32_t Slot;          // next free slot in it, FLIGHTLOG_RECORDS+1 when full
+static uint32_t Seq;           // sequence number of the next record
+static uint32_t Erases;        // highest erase count seen
+static uint32_t Lost;
+static uint32_t Stage[FLIGHTLOG_BURST*WORDS];
+static uint32_t Staged;        // records in Stage, for slots Slot, Slot+1, ...
+static uint32_t Next;          // sector to follow Current, erased ahead of time
+static uint32_t NextErases;    // its erase count, once erased
+static uint32_t NextState;     // NEXT_DIRTY, NEXT_ERASING or NEXT_READY
+#define NEXT_DIRTY   0         // not erased yet
+#define NEXT_ERASING 1         // Flash_EraseStart() has begun, Bank 1 must not be read
+#define NEXT_READY   2         // erased, waiting for its header
+
+static uint32_t address(uint32_t sector, uint32_t slot){
+  return Base + FLIGHTLOG_SECTOR*sector + 32*slot;
+}
+
+// 1 if the 30 bytes before the CRC match it
+static int check(const void *pt, uint16_t crc){
+  return CRC16_Update(CRC16_INIT, (const uint8_t *)pt, 30) == crc;
+}
+
+static const struct FlightHeader *header(uint32_t sector){
+  const struct FlightHeader *h = (const struct FlightHeader *)(uintptr_t)address(sector, 0);
+  return ((h->Magic == FLIGHTLOG_MAGIC) && check(h, h->Crc))? h : 0;
+}
+
+// 1 if the slot has never been programmed since the erase
+static int erased(uint32_t sector, uint32_t slot){
+  const uint32_t *pt = (const uint32_t *)(uintptr_t)address(sector, slot);
+  uint32_t i;
+  for(i=0; i<WORDS; i=i+1){
+    if(pt[i] != 0xFFFFFFFF){
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// 1 if the whole sector has never been programmed since the erase
+static int blank(uint32_t sector){
+  uint32_t slot;
+  for(slot=0; slot<=FLIGHTLOG_RECORDS; slot=slot+1){
+    if(erased(sector, slot) == 0){
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Give up on Next, it could not be erased, and use the one after.
+static void skip(void){
+  Next = (Next+1)%Sectors;
+  if(Next == Current){
+    Next = (Next+1)%Sectors;
+  }
+  NextState = NEXT_DIRTY;
+}
+
+// One step of erasing Next ahead of time, so the erase pulses run
+// while the task is idle rather than in the call that needs the
+// sector: start the erase, or see if it has finished.
+static void prepare(void){
+  const struct FlightHeader *old;
+  int result;
+  if(NextState == NEXT_DIRTY){
+    old = header(Next);
+    NextErases = (old? old->Erases : Erases)+1;
+    if(Flash_EraseStart(address(Next, 0)) == NOERROR){
+      NextState = NEXT_ERASING;
+    }else{
+      skip();
+    }
+  }else if(NextState == NEXT_ERASING){
+    result = Flash_ErasePoll();
+    if(result == NOERROR){
+      NextState = NEXT_READY;
+    }else if(result == ERROR){
+      skip();
+    }
+  }
+}
+
+// Wait for an erase in progress, before Bank 1 is read or programmed
+static void settle(void){
+  while(NextState == NEXT_ERASING){
+    prepare();
+  }
+}
+
+//------------FlightLog_Init------------
+// Check the region, then find the newest sector by the sequence
+// numbers in the headers and its first free slot from the end.
+// Input: base 4 KB aligned address in Bank 1, sectors count
+// Output: NOERROR or ERROR
+int FlightLog_Init(uint32_t base, uint32_t sectors){
+  const struct FlightHeader *h, *newest = 0;
+  uint32_t s;
+  Sectors = 0;
+  Staged = 0;
+  Lost = 0;
+  if((base%FLIGHTLOG_SECTOR) || (base < BANK1_MIN) || (sectors < 2) ||
+     (sectors > (BANK1_END-BANK1_MIN)/FLIGHTLOG_SECTOR) || (base+FLIGHTLOG_SECTOR*sectors > BANK1_END)){
+    return ERROR;
+  }
+  Base = base;
+  Sectors = sectors;
+  Erases = 0;
+  Current = sectors-1;                // nothing logged: the first record starts sector 0
+  Slot = FLIGHTLOG_RECORDS+1;
+  Seq = 0;
+  for(s=0; s<sectors; s=s+1){
+    h = header(s);
+    if(h){
+      if(h->Erases > Erases){
+        Erases = h->Erases;
+      }
+      if((newest == 0) || ((int32_t)(h->FirstSeq-newest->FirstSeq) > 0)){
+        newest = h;
+        Current = s;
+      }
+    }
+  }
+  if(newest){
+    // a torn record is not erased, so the head goes after it
+    for(Slot=FLIGHTLOG_RECORDS+1; (Slot > 1) && erased(Current, Slot-1); Slot=Slot-1){};
+    Seq = newest->FirstSeq+Slot-1;
+  }
+  Next = (Current+1)%sectors;
+  NextState = blank(Next)? NEXT_READY : NEXT_DIRTY;
+  NextErases = Erases+1;
+  return NOERROR;
+}
+
+// Start the next sector of the ring with a header. It is normally
+// erased already; if not, it is erased now, and a sector that
+// fails is skipped, full, for the next one.
+static int advance(void){
+  struct FlightHeader h;
+  uint32_t tries;
+  for(tries=0; tries<Sectors; tries=tries+1){
+    if(NextState != NEXT_READY){
+      prepare();
+      settle();
+      if(NextState != NEXT_READY){
+        continue;
+      }
+    }
+    Current = Next;
+    Slot = FLIGHTLOG_RECORDS+1;
+    h.Magic = FLIGHTLOG_MAGIC;
+    h.FirstSeq = Seq;
+    h.Erases = NextErases;
+    h.Spare[0] = h.Spare[1] = h.Spare[2] = h.Spare[3] = 0xFFFFFFFF;
+    h.Reserved = 0xFFFF;
+    h.Crc = CRC16_Update(CRC16_INIT, (const uint8_t *)&h, 30);
+    if(NextErases > Erases){
+      Erases = NextErases;
+    }
+    Next = (Current+1)%Sectors;
+    NextState = NEXT_DIRTY;
+    if(Flash_FastWrite((uint32_t *)&h, address(Current, 0), WORDS) == WORDS){
+      Slot = 1;
+      return NOERROR;
+    }
+  }
+  return ERROR;
+}
+
+//------------FlightLog_Add------------
+// Stage a record with its sequence number and CRC, program the
+// burst when it is full or reaches the end of the sector. Right
+// after a burst the erase of the next sector is started, and later
+// calls see it finish, so no call waits for an erase pulse.
+// Input: r snapshot
+// Output: NOERROR or ERROR
+int FlightLog_Add(const struct TelemetryRecord *r){
+  struct FlightRecord *rec;
+  int result = NOERROR;
+  if(Sectors == 0){
+    return ERROR;
+  }
+  if((Staged == 0) && (Slot > FLIGHTLOG_RECORDS) && advance()){
+    Lost = Lost+1;
+    Seq = Seq+1;
+    return ERROR;
+  }
+  rec = (struct FlightRecord *)&Stage[WORDS*Staged];
+  rec->Data = *r;
+  rec->Seq = (uint16_t)Seq;
+  rec->Crc = CRC16_Update(CRC16_INIT, (const uint8_t *)rec, 30);
+  Seq = Seq+1;
+  Staged = Staged+1;
+  if((Staged == FLIGHTLOG_BURST) || (Slot+Staged > FLIGHTLOG_RECORDS)){
+    result = FlightLog_Flush();
+  }
+  if((Staged == 0) || (NextState == NEXT_ERASING)){
+    prepare();
+  }
+  return result;
+}
+
+//------------FlightLog_Flush------------
+// Program the staged records in one burst; the slots are used
+// even if it fails. An erase still running is waited for.
+// Input: none
+// Output: NOERROR or ERROR
+int FlightLog_Flush(void){
+  uint32_t n = Staged;
+  int words = (int)(WORDS*n);  // at most FLIGHTLOG_BURST*WORDS = 16
+  if(n == 0){
+    return NOERROR;
+  }
+  settle();
+  Staged = 0;
+  Slot = Slot+n;
+  if(Flash_FastWrite(Stage, address(Current, Slot-n), words) != words){
+    Lost = Lost+n;
+    return ERROR;
+  }
+  return NOERROR;
+}
+
+//------------FlightLog_Walk------------
+// Visit the records with a good CRC and sequence number, sector by
+// sector from the one after Current, which is the oldest, around
+// to Current.
+// Input: visit function
+// Output: number of records visited
+uint32_t FlightLog_Walk(void (*visit)(uint32_t seq, const struct TelemetryRecord *r)){
+  const struct FlightHeader *h;
+  const struct FlightRecord *rec;
+  uint32_t i, s, slot, end, count = 0;
+  settle();
+  for(i=1; i<=Sectors; i=i+1){
+    s = (Current+i)%Sectors;
+    h = header(s);
+    if(h == 0){
+      continue;
+    }
+    end = (s == Current)? Slot : FLIGHTLOG_RECORDS+1;
+    for(slot=1; slot<end; slot=slot+1){
+      rec = (const struct FlightRecord *)(uintptr_t)address(s, slot);
+      if((rec->Seq == (uint16_t)(h->FirstSeq+slot-1)) && check(rec, rec->Crc)){
+        visit(h->FirstSeq+slot-1, &rec->Data);
+        count = count+1;
+      }
+    }
+  }
+  return count;
+}
+
+//------------FlightLog_Next------------
+// Sequence number of the next record
+// Input: none
+// Output: sequence number
+uint32_t FlightLog_Next(void){
+  return Seq;
+}
+
+//------------FlightLog_Lost------------
+// Records lost since FlightLog_Init
+// Input: none
+// Output: count
+uint32_t FlightLog_Lost(void){
+  return Lost;
+}
+
+//------------FlightLog_Erases------------
+// Highest erase count of a sector
+// Input: none
+// Output: count
+uint32_t FlightLog_Erases(void){
+  return Erases;
+}
+
+//------------FlightLog_Clear------------
+// Erase every sector; the first record then starts sector 0
+// Input: none
+// Output: NOERROR or ERROR
+int FlightLog_Clear(void){
+  uint32_t s;
+  int result = NOERROR;
+  if(Sectors == 0){
+    return ERROR;
+  }
+  Staged = 0;
+  settle();
+  for(s=0; s<Sectors; s=s+1){
+    if(Flash_Erase(address(s, 0)) != NOERROR){
+      result = ERROR;
+    }
+  }
+  Current = Sectors-1;
+  Slot = FLIGHTLOG_RECORDS+1;
+  Seq = 0;
+  Next = 0;
+  NextState = (result == NOERROR)? NEXT_READY : NEXT_DIRTY;
+  NextErases = Erases+1;
+  return result;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file      FlightLog.h
+ * @brief     Append-only flight recorder in flash Bank 1
+ * @details   Sensor snapshots (struct TelemetryRecord) are kept in a
+ * ring of 4 KB flash sectors so a run's data survives power-off.
+ * Records are staged in RAM and programmed two at a time, one 64-byte
+ * Flash_FastWrite() burst. The sector after the current one is
+ * erased ahead of time, in steps between bursts, and the oldest
+ * records in it are lost; so the ring holds at least sectors-2 full
+ * sectors of history, every sector is erased once per trip around
+ * the ring and the wear is level. Each sector starts with a header and holds
+ * FLIGHTLOG_RECORDS records:<br>
+<table>
+<caption id="flightlog_sector">Sector</caption>
+<tr><th>Offset       <th>Contents
+<tr><td>0            <td>struct FlightHeader: magic, sequence number of its first record, erase count, CRC
+<tr><td>32*n, n=1-127 <td>struct FlightRecord: snapshot, low 16 bits of its sequence number, CRC
+</table>
+ * The sequence number counts records from the first one ever
+ * logged; record n of a sector has the sequence number
+ * FirstSeq+n-1. A slot is used once it is not all 1s, so a power
+ * cut costs at most what was being programmed plus what was
+ * staged:<br>
+ 1) cut while programming a burst: the slots fail their CRC and are
+    skipped, later records go after them<br>
+ 2) cut during an erase, or before the new header is written: the
+    sector has no valid header, the previous one stays current and
+    the erase is done again<br>
+ 3) up to one staged record in RAM is lost; call FlightLog_Flush()
+    to program it early<br>
+ * FlightLog_Init() finds the write head again from the headers and
+ * the last used slot of the newest sector; it reads flash only.<br>
+ * Timing at 48 MHz: FlightLog_Add() takes ~5 us, ~120 us when it
+ * programs a burst, and ~1 ms when it verifies an erase pulse. The
+ * pulse itself runs between calls (Flash_EraseStart()), so a call
+ * only waits for an erase if one is still running when the next
+ * burst is due, or the next sector was not erased ahead of time
+ * (the first sector after FlightLog_Init() of a log that is not
+ * blank there). The flash functions run from SRAM, so interrupts
+ * stay enabled throughout.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __FLIGHTLOG_H__ // do not include more than once
+#define __FLIGHTLOG_H__
+#include <stdint.h>
+#include "../inc/Telemetry.h"
+
+/**
+ * Bytes in a flash sector, the unit of erase
+ */
+#define FLIGHTLOG_SECTOR 4096
+
+/**
+ * Records per sector, after the header
+ */
+#define FLIGHTLOG_RECORDS (FLIGHTLOG_SECTOR/32-1)
+
+/**
+ * Records staged in RAM and programmed together, 64 bytes
+ */
+#define FLIGHTLOG_BURST 2
+
+/**
+ * First word of a valid sector header, "FLOG"
+ */
+#define FLIGHTLOG_MAGIC 0x474F4C46
+
+/**
+ * \struct FlightHeader
+ * \brief First 32 bytes of a sector
+ */
+struct FlightHeader{
+  uint32_t Magic;         /**< FLIGHTLOG_MAGIC */
+  uint32_t FirstSeq;      /**< sequence number of the record in slot 1 */
+  uint32_t Erases;        /**< times this sector has been erased */
+  uint32_t Spare[4];      /**< 0xFFFFFFFF */
+  uint16_t Reserved;      /**< 0xFFFF */
+  uint16_t Crc;           /**< CRC16_Update() of the 30 bytes before it */
+};
+
+/**
+ * \struct FlightRecord
+ * \brief One 32-byte slot
+ */
+struct FlightRecord{
+  struct TelemetryRecord Data;  /**< snapshot */
+  uint16_t Seq;                 /**< low 16 bits of the sequence number */
+  uint16_t Crc;                 /**< CRC16_Update() of the 30 bytes before it */
+};
+
+/**
+ * Use a region of flash Bank 1 and find the write head. Records
+ * already there are kept. Nothing is programmed or erased.
+ * @param base 4 KB aligned address in Bank 1, 0x00020000 to 0x0003E000
+ * @param sectors number of 4 KB sectors, at least 2, all in Bank 1
+ * @return NOERROR, or ERROR if the region is not valid
+ * @brief  Initialize the flight log
+ */
+int FlightLog_Init(uint32_t base, uint32_t sectors);
+
+/**
+ * Append a snapshot. It is staged in RAM; every FLIGHTLOG_BURST
+ * records are programmed in one burst, after which the next sector
+ * is erased a step at a time, a step per call. Not interrupt safe;
+ * call from one task.
+ * @param r snapshot to log
+ * @return NOERROR, or ERROR if the flash could not be programmed
+ * or erased and records were lost
+ * @brief  Log a record
+ */
+int FlightLog_Add(const struct TelemetryRecord *r);
+
+/**
+ * Program the staged records now, after any erase in progress
+ * @param none
+ * @return NOERROR, or ERROR if records were lost
+ * @brief  Program staged records
+ */
+int FlightLog_Flush(void);
+
+/**
+ * Call a function for each valid record in flash, oldest first.
+ * Records still staged are not included; call FlightLog_Flush()
+ * first.
+ * @param visit called with the sequence number and the snapshot
+ * @return number of records visited
+ * @brief  Read the log
+ */
+uint32_t FlightLog_Walk(void (*visit)(uint32_t seq, const struct TelemetryRecord *r));
+
+/**
+ * Sequence number the next record will get, the number of records
+ * logged since the flash was first used
+ * @param none
+ * @return sequence number
+ * @brief  Records logged
+ */
+uint32_t FlightLog_Next(void);
+
+/**
+ * Records lost to failed programming or erasing since
+ * FlightLog_Init()
+ * @param none
+ * @return records lost
+ * @brief  Lost records
+ */
+uint32_t FlightLog_Lost(void);
+
+/**
+ * Highest sector erase count seen, a measure of wear; flash is
+ * specified for at least 20,000 cycles
+ * @param none
+ * @return erase count
+ * @brief  Wear
+ */
+uint32_t FlightLog_Erases(void);
+
+/**
+ * Erase the whole region, losing every record; the sequence
+ * numbers start again at 0
+ * @param none
+ * @return NOERROR, or ERROR if a sector could not be erased
+ * @brief  Clear the log
+ */
+int FlightLog_Clear(void);
+
+#endif // __FLIGHTLOG_H__
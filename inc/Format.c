@@ -0,0 +1,204 @@
+// Format.c
+// Runs on any microcontroller
+// Non-recursive integer to ASCII conversion into a caller
+// buffer, shared by UART0, EUSCIA0 and Nokia5110.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Format.h"
+
+// n/10 for any 32-bit n, one UMULL and a shift instead of UDIV
+static uint32_t div10(uint32_t n){
+  return (uint32_t)(((uint64_t)n*0xCCCCCCCDu)>>35);
+}
+
+// digits of n in reverse order, returns how many (1 to 10)
+static uint32_t reverseDigits(char *rev, uint32_t n){
+  uint32_t len = 0, q;
+  do{
+    q = div10(n);
+    rev[len] = (char)('0'+(n-q*10));  // n%10
+    len++;
+    n = q;
+  }while(n);
+  return len;
+}
+
+// ------------Format_UDec------------
+// Unsigned decimal, variable length
+// Input: buf at least FORMAT_MAXLEN bytes, n number
+// Output: length of the string in buf
+uint32_t Format_UDec(char *buf, uint32_t n){
+  char rev[10];
+  uint32_t len = reverseDigits(rev, n);
+  uint32_t i;
+  for(i=0; i<len; i++){
+    buf[i] = rev[len-1-i];
+  }
+  buf[len] = 0;
+  return len;
+}
+
+// ------------Format_SDec------------
+// Signed decimal, variable length
+// Input: buf at least FORMAT_MAXLEN bytes, n number
+// Output: length of the string in buf
+uint32_t Format_SDec(char *buf, int32_t n){
+  if(n < 0){
+    buf[0] = '-';
+    return 1+Format_UDec(&buf[1], 0u-(uint32_t)n); // also right for -2147483648
+  }
+  return Format_UDec(buf, (uint32_t)n);
+}
+
+// fill width characters: spaces, sign, digits; '*' if too long
+static uint32_t fixedWidth(char *buf, uint32_t n, uint32_t negative, uint32_t width){
+  char rev[10];
+  uint32_t len = reverseDigits(rev, n);
+  uint32_t i;
+  if(len+negative > width){
+    for(i=0; i<width; i++){
+      buf[i] = '*';                   // does not fit
+    }
+  }else{
+    for(i=0; i<len; i++){
+      buf[width-1-i] = rev[i];
+    }
+    i = width-len;
+    if(negative){
+      i--;
+      buf[i] = '-';
+    }
+    while(i){
+      i--;
+      buf[i] = ' ';
+    }
+  }
+  buf[width] = 0;
+  return width;
+}
+
+// ------------Format_UDecWidth------------
+// Unsigned decimal, right-justified in width characters
+// Input: buf at least width+1 bytes, n number, width 1 to 11
+// Output: width
+uint32_t Format_UDecWidth(char *buf, uint32_t n, uint32_t width){
+  return fixedWidth(buf, n, 0, width);
+}
+
+// ------------Format_SDecWidth------------
+// Signed decimal, right-justified in width characters
+// Input: buf at least width+1 bytes, n number, width 1 to 11
+// Output: width
+uint32_t Format_SDecWidth(char *buf, int32_t n, uint32_t width){
+  if(n < 0){
+    return fixedWidth(buf, 0u-(uint32_t)n, 1, width);
+  }
+  return fixedWidth(buf, (uint32_t)n, 0, width);
+}
+
+// ------------Format_UHexWidth------------
+// Hexadecimal with leading zeros
+// Input: buf at least width+1 bytes, n number, width 1 to 8
+// Output: width
+uint32_t Format_UHexWidth(char *buf, uint32_t n, uint32_t width){
+  uint32_t i, d;
+  for(i=width; i>0; i--){
+    d = n&0x0F;
+    if(d < 0xA){
+      buf[i-1] = (char)(d+'0');
+    }else{
+      buf[i-1] = (char)((d-0x0A)+'A');
+    }
+    n = n>>4;
+  }
+  buf[width] = 0;
+  return width;
+}
+
+// ------------Format_UHex------------
+// Hexadecimal, variable length
+// Input: buf at least FORMAT_MAXLEN bytes, n number
+// Output: length of the string in buf
+uint32_t Format_UHex(char *buf, uint32_t n){
+  uint32_t width = 1;
+  while((width < 8) && (n>>(4*width))){
+    width++;
+  }
+  return Format_UHexWidth(buf, n, width);
+}
+
+// ------------Format_UFix------------
+// Unsigned fixed point n*10^-decimals
+// Input: buf at least FORMAT_MAXLEN bytes, n number, decimals 1 to 9
+// Output: length of the string in buf
+uint32_t Format_UFix(char *buf, uint32_t n, uint32_t decimals){
+  char frac[9];
+  uint32_t i, q, len;
+  for(i=decimals; i>0; i--){
+    q = div10(n);
+    frac[i-1] = (char)('0'+(n-q*10));
+    n = q;
+  }
+  len = Format_UDec(buf, n);
+  buf[len] = '.';
+  len++;
+  for(i=0; i<decimals; i++){
+    buf[len] = frac[i];
+    len++;
+  }
+  buf[len] = 0;
+  return len;
+}
+
+//-----------------------Format_Out-----------------------
+// Convert on the stack and output through a string sink
+// Input: sink output function, then as the Format function
+// Output: none
+void Format_OutUDec(FormatSink sink, uint32_t n){
+  char buf[FORMAT_MAXLEN];
+  Format_UDec(buf, n);
+  (*sink)(buf);
+}
+void Format_OutSDec(FormatSink sink, int32_t n){
+  char buf[FORMAT_MAXLEN];
+  Format_SDec(buf, n);
+  (*sink)(buf);
+}
+void Format_OutUDecWidth(FormatSink sink, uint32_t n, uint32_t width){
+  char buf[FORMAT_MAXLEN];
+  if(width > FORMAT_MAXLEN-1){
+    width = FORMAT_MAXLEN-1;
+  }
+  Format_UDecWidth(buf, n, width);
+  (*sink)(buf);
+}
+void Format_OutSDecWidth(FormatSink sink, int32_t n, uint32_t width){
+  char buf[FORMAT_MAXLEN];
+  if(width > FORMAT_MAXLEN-1){
+    width = FORMAT_MAXLEN-1;
+  }
+  Format_SDecWidth(buf, n, width);
+  (*sink)(buf);
+}
+void Format_OutUHex(FormatSink sink, uint32_t n){
+  char buf[FORMAT_MAXLEN];
+  Format_UHex(buf, n);
+  (*sink)(buf);
+}
+void Format_OutUHexWidth(FormatSink sink, uint32_t n, uint32_t width){
+  char buf[FORMAT_MAXLEN];
+  if(width > 8){
+    width = 8;
+  }
+  Format_UHexWidth(buf, n, width);
+  (*sink)(buf);
+}
+void Format_OutUFix(FormatSink sink, uint32_t n, uint32_t decimals){
+  char buf[FORMAT_MAXLEN];
+  if(decimals > 9){
+    decimals = 9;
+  }
+  Format_UFix(buf, n, decimals);
+  (*sink)(buf);
+}
@@ -0,0 +1,173 @@
+/**
+ * @file      Format.h
+ * @brief     Integer to ASCII conversion shared by the output drivers
+ * @details   Converts into a caller buffer without recursion and
+ * without a divide instruction; n/10 is a 32x32 to 64-bit multiply
+ * by 0xCCCCCCCD and a shift, exact for every 32-bit n.<br>
+ * The Format_Out functions convert on the stack and send the
+ * string to a sink, any function that outputs a string, such as
+ * UART0_OutString(), EUSCIA0_OutString() or Nokia5110_OutString().<br>
+ * Approximate cost at 48 MHz, 10 digits:<br>
+<table>
+<caption id="format_cost">Format cost</caption>
+<tr><th>Method                         <th>Cycles  <th>Stack (bytes)
+<tr><td>recursive n/10, n%10 (old)     <td>~450    <td>~160 (10 frames)
+<tr><td>Format_UDec()                  <td>~120    <td>~24
+</table>
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __FORMAT_H__ // do not include more than once
+#define __FORMAT_H__
+#include <stdint.h>
+
+/**
+ * Buffer size that holds any result, "-2147483648" plus the null
+ */
+#define FORMAT_MAXLEN 12
+
+/**
+ * A function that outputs a null-terminated string
+ */
+typedef void (*FormatSink)(char *string);
+
+/**
+ * Convert to unsigned decimal, 1 to 10 digits, no spaces
+ * @param buf at least FORMAT_MAXLEN bytes, null terminated on return
+ * @param n number to convert
+ * @return number of characters, not counting the null
+ * @brief  Unsigned decimal
+ */
+uint32_t Format_UDec(char *buf, uint32_t n);
+
+/**
+ * Convert to signed decimal, '-' and 1 to 10 digits, no spaces
+ * @param buf at least FORMAT_MAXLEN bytes, null terminated on return
+ * @param n number to convert
+ * @return number of characters, not counting the null
+ * @brief  Signed decimal
+ */
+uint32_t Format_SDec(char *buf, int32_t n);
+
+/**
+ * Convert to unsigned decimal, right-justified with spaces in a
+ * fixed width. If n does not fit, the field is filled with '*'.
+ * @param buf at least width+1 bytes, null terminated on return
+ * @param n number to convert
+ * @param width field width, 1 to FORMAT_MAXLEN-1
+ * @return width
+ * @brief  Fixed-width unsigned decimal
+ */
+uint32_t Format_UDecWidth(char *buf, uint32_t n, uint32_t width);
+
+/**
+ * Convert to signed decimal, right-justified with spaces in a
+ * fixed width. If n does not fit, the field is filled with '*'.
+ * @param buf at least width+1 bytes, null terminated on return
+ * @param n number to convert
+ * @param width field width, 1 to FORMAT_MAXLEN-1
+ * @return width
+ * @brief  Fixed-width signed decimal
+ */
+uint32_t Format_SDecWidth(char *buf, int32_t n, uint32_t width);
+
+/**
+ * Convert to unsigned hexadecimal, 1 to 8 digits 0-9 A-F, no spaces
+ * @param buf at least FORMAT_MAXLEN bytes, null terminated on return
+ * @param n number to convert
+ * @return number of characters, not counting the null
+ * @brief  Unsigned hexadecimal
+ */
+uint32_t Format_UHex(char *buf, uint32_t n);
+
+/**
+ * Convert the low width nibbles to hexadecimal with leading zeros
+ * @param buf at least width+1 bytes, null terminated on return
+ * @param n number to convert
+ * @param width number of digits, 1 to 8
+ * @return width
+ * @brief  Fixed-width unsigned hexadecimal
+ */
+uint32_t Format_UHexWidth(char *buf, uint32_t n, uint32_t width);
+
+/**
+ * Convert unsigned fixed point n*10^-decimals to
+ * <digits>.<decimals digits>, for example n=1234, decimals=2
+ * gives "12.34" and n=5, decimals=2 gives "0.05"
+ * @param buf at least FORMAT_MAXLEN bytes, null terminated on return
+ * @param n number to convert
+ * @param decimals digits after the point, 1 to 9
+ * @return number of characters, not counting the null
+ * @brief  Unsigned decimal fixed point
+ */
+uint32_t Format_UFix(char *buf, uint32_t n, uint32_t decimals);
+
+/**
+ * Convert with Format_UDec() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @return none
+ * @brief  Output unsigned decimal
+ */
+void Format_OutUDec(FormatSink sink, uint32_t n);
+
+/**
+ * Convert with Format_SDec() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @return none
+ * @brief  Output signed decimal
+ */
+void Format_OutSDec(FormatSink sink, int32_t n);
+
+/**
+ * Convert with Format_UDecWidth() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @param width field width, 1 to FORMAT_MAXLEN-1
+ * @return none
+ * @brief  Output fixed-width unsigned decimal
+ */
+void Format_OutUDecWidth(FormatSink sink, uint32_t n, uint32_t width);
+
+/**
+ * Convert with Format_SDecWidth() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @param width field width, 1 to FORMAT_MAXLEN-1
+ * @return none
+ * @brief  Output fixed-width signed decimal
+ */
+void Format_OutSDecWidth(FormatSink sink, int32_t n, uint32_t width);
+
+/**
+ * Convert with Format_UHex() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @return none
+ * @brief  Output unsigned hexadecimal
+ */
+void Format_OutUHex(FormatSink sink, uint32_t n);
+
+/**
+ * Convert with Format_UHexWidth() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @param width number of digits, 1 to 8
+ * @return none
+ * @brief  Output fixed-width unsigned hexadecimal
+ */
+void Format_OutUHexWidth(FormatSink sink, uint32_t n, uint32_t width);
+
+/**
+ * Convert with Format_UFix() and output through sink
+ * @param sink string output function
+ * @param n number to convert
+ * @param decimals digits after the point, 1 to 9
+ * @return none
+ * @brief  Output unsigned decimal fixed point
+ */
+void Format_OutUFix(FormatSink sink, uint32_t n, uint32_t decimals);
+
+#endif // __FORMAT_H__
@@ -0,0 +1,268 @@
+// Graphics.c
+// Runs on MSP432
+// Lines, rectangles, scrolling, sprites and text drawn a byte
+// column at a time into the Nokia5110 screen buffer.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Nokia5110.h"
+#include "../inc/Graphics.h"
+
+#define SCREENW 84
+#define SCREENH 48
+#define BANKS   (SCREENH/8)
+
+static int32_t CursorX, CursorY;
+static uint32_t CursorMode;
+
+// combine bits into one byte of Screen; mask holds the rows
+// GRAPHICS_COPY sets and clears within
+static void combine(uint8_t *pt, uint8_t bits, uint8_t mask, uint32_t mode){
+  switch(mode){
+    case GRAPHICS_CLEAR:  *pt &= ~bits; break;
+    case GRAPHICS_SET:    *pt |= bits; break;
+    case GRAPHICS_INVERT: *pt ^= bits; break;
+    default:              *pt = (*pt&~mask)|bits; break;
+  }
+}
+
+// clip [*lo, *hi) to [0, max); 0 if nothing is left
+static int clip(int32_t *lo, int32_t *hi, int32_t max){
+  if(*lo < 0){
+    *lo = 0;
+  }
+  if(*hi > max){
+    *hi = max;
+  }
+  return *lo < *hi;
+}
+
+// mark banks b0 to b1 of columns x0 to x1-1 for the display
+static void dirty(int32_t b0, int32_t b1, int32_t x0, int32_t x1){
+  int32_t b;
+  for(b=b0; b<=b1; b=b+1){
+    Nokia5110_Dirty(b, x0, x1-1);
+  }
+}
+
+//------------Graphics_FillRect------------
+// Fill a rectangle, one mask per bank applied to each column
+// Input: x,y top left, w,h size
+//        mode GRAPHICS_CLEAR, GRAPHICS_SET or GRAPHICS_INVERT
+// Output: none
+void Graphics_FillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t mode){
+  int32_t x1 = x+w, y1 = y+h, b, b0, b1, c;
+  uint8_t mask, *pt;
+  if(!clip(&x, &x1, SCREENW) || !clip(&y, &y1, SCREENH)){
+    return;
+  }
+  b0 = y/8;
+  b1 = (y1-1)/8;
+  for(b=b0; b<=b1; b=b+1){
+    mask = 0xFF;
+    if(b == b0){
+      mask &= 0xFF<<(y%8);             // rows from y down
+    }
+    if(b == b1){
+      mask &= 0xFF>>(7-(y1-1)%8);      // rows to y1-1
+    }
+    pt = &Screen[SCREENW*b];
+    switch(mode){                      // one loop per mode, nothing else in it
+      case GRAPHICS_CLEAR:
+        for(c=x; c<x1; c=c+1) pt[c] &= ~mask;
+        break;
+      case GRAPHICS_INVERT:
+        for(c=x; c<x1; c=c+1) pt[c] ^= mask;
+        break;
+      default:
+        for(c=x; c<x1; c=c+1) pt[c] |= mask;
+        break;
+    }
+  }
+  dirty(b0, b1, x, x1);
+}
+
+//------------Graphics_HLine------------
+// Draw a horizontal line
+// Input: x,y left end, w length, mode as for Graphics_FillRect
+// Output: none
+void Graphics_HLine(int32_t x, int32_t y, int32_t w, uint32_t mode){
+  Graphics_FillRect(x, y, w, 1, mode);
+}
+
+//------------Graphics_VLine------------
+// Draw a vertical line
+// Input: x,y top end, h length, mode as for Graphics_FillRect
+// Output: none
+void Graphics_VLine(int32_t x, int32_t y, int32_t h, uint32_t mode){
+  Graphics_FillRect(x, y, 1, h, mode);
+}
+
+//------------Graphics_Rect------------
+// Draw the outline of a rectangle; with GRAPHICS_INVERT each
+// pixel is toggled once, the corners too
+// Input: x,y top left, w,h size, mode as for Graphics_FillRect
+// Output: none
+void Graphics_Rect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t mode){
+  if((w <= 0) || (h <= 0)){
+    return;
+  }
+  Graphics_HLine(x, y, w, mode);
+  if(h > 1){
+    Graphics_HLine(x, y+h-1, w, mode);
+  }
+  if(h > 2){
+    Graphics_VLine(x, y+1, h-2, mode);
+    if(w > 1){
+      Graphics_VLine(x+w-1, y+1, h-2, mode);
+    }
+  }
+}
+
+// banks b0 to b1 of a column as one number, bit 0 the top of b0
+static uint64_t column(int32_t c, int32_t b0, int32_t b1){
+  uint64_t value = 0;
+  int32_t b;
+  for(b=b1; b>=b0; b=b-1){
+    value = (value<<8)|Screen[SCREENW*b+c];
+  }
+  return value;
+}
+
+//------------Graphics_Scroll------------
+// Move the contents of a rectangle by dx columns and dy rows.
+// Each column of the banks it covers is read as one number,
+// shifted by dy and merged back under the rows of the
+// rectangle; with dy=0 the bytes of each bank just move. The
+// columns go in the order that reads each source before it is
+// overwritten.
+// Input: x,y top left, w,h size, dx,dy distance
+// Output: none
+void Graphics_Scroll(int32_t x, int32_t y, int32_t w, int32_t h, int32_t dx, int32_t dy){
+  int32_t x1 = x+w, y1 = y+h, b, b0, b1, c, step, end, src;
+  uint64_t rows, value;
+  uint8_t mask, *pt;
+  if(!clip(&x, &x1, SCREENW) || !clip(&y, &y1, SCREENH) || ((dx == 0) && (dy == 0))){
+    return;
+  }
+  b0 = y/8;
+  b1 = (y1-1)/8;
+  rows = ((1ull<<(y1-y))-1)<<(y-8*b0);
+  if(dx > 0){
+    c = x1-1; end = x-1; step = -1;   // moving right, start at the right
+  }else{
+    c = x; end = x1; step = 1;
+  }
+  if(dy == 0){
+    for(b=b0; b<=b1; b=b+1){
+      mask = (uint8_t)(rows>>(8*(b-b0)));
+      pt = &Screen[SCREENW*b];
+      for(c=(dx > 0)? x1-1 : x; c!=end; c=c+step){
+        src = c-dx;
+        pt[c] = (pt[c]&~mask)|(((src >= x) && (src < x1))? pt[src]&mask : 0);
+      }
+    }
+    dirty(b0, b1, x, x1);
+    return;
+  }
+  for(; c!=end; c=c+step){
+    src = c-dx;
+    value = 0;
+    if((src >= x) && (src < x1) && (dy < h) && (dy > -h)){
+      value = column(src, b0, b1)&rows;
+      value = (dy >= 0)? value<<dy : value>>(-dy);
+    }
+    value = (column(c, b0, b1)&~rows)|(value&rows);
+    for(b=b0; b<=b1; b=b+1){
+      Screen[SCREENW*b+c] = (uint8_t)value;
+      value = value>>8;
+    }
+  }
+  dirty(b0, b1, x, x1);
+}
+
+// draw w columns of h rows in the layout of Screen, each sprite
+// bank shifted down into two screen banks
+static void blit(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *bits, uint32_t mode){
+  int32_t x0 = x, x1 = x+w, y0 = y, y1 = y+h, shift, top, r, c, banks;
+  uint8_t *upper, *lower;
+  uint16_t v, mask;
+  if((h <= 0) || (h > 255) || !clip(&x0, &x1, SCREENW) || !clip(&y0, &y1, SCREENH)){
+    return;
+  }
+  // y may be negative; y+256 is not, so / and % round down
+  top = (y+256)/8-32;
+  shift = (y+256)%8;
+  banks = (h+7)/8;
+  for(r=0; r<banks; r=r+1){
+    mask = (r == banks-1)? 0xFF>>(8*banks-h) : 0xFF;
+    mask = mask<<shift;
+    upper = ((top+r >= 0) && (top+r < BANKS))? &Screen[SCREENW*(top+r)] : 0;
+    lower = ((top+r+1 >= 0) && (top+r+1 < BANKS) && (mask > 0xFF))? &Screen[SCREENW*(top+r+1)] : 0;
+    for(c=x0; c<x1; c=c+1){
+      v = (bits[w*r+c-x]<<shift)&mask;
+      if(upper){
+        combine(&upper[c], (uint8_t)v, (uint8_t)mask, mode);
+      }
+      if(lower){
+        combine(&lower[c], v>>8, mask>>8, mode);
+      }
+    }
+  }
+  dirty(y0/8, (y1-1)/8, x0, x1);
+}
+
+//------------Graphics_Sprite------------
+// Draw a sprite
+// Input: x,y top left, s sprite
+//        mode GRAPHICS_CLEAR, GRAPHICS_SET, GRAPHICS_INVERT or GRAPHICS_COPY
+// Output: none
+void Graphics_Sprite(int32_t x, int32_t y, const struct Sprite *s, uint32_t mode){
+  blit(x, y, s->Width, s->Height, s->Bits, mode);
+}
+
+//------------Graphics_Char------------
+// Draw a character of the Nokia5110 font and a blank column
+// Input: x,y top left, c character, mode as for Graphics_Sprite
+// Output: x of the next character
+int32_t Graphics_Char(int32_t x, int32_t y, char c, uint32_t mode){
+  const uint8_t *glyph = Nokia5110_Glyph(c);
+  uint8_t bits[GRAPHICS_CHARW];
+  int32_t i;
+  for(i=0; i<5; i=i+1){
+    bits[i] = glyph[i];
+  }
+  bits[5] = 0x00;                    // blank vertical line padding
+  blit(x, y, GRAPHICS_CHARW, 8, bits, mode);
+  return x+GRAPHICS_CHARW;
+}
+
+//------------Graphics_String------------
+// Draw a string on one line
+// Input: x,y top left, pt string, mode as for Graphics_Sprite
+// Output: x after the last character
+int32_t Graphics_String(int32_t x, int32_t y, const char *pt, uint32_t mode){
+  while(*pt){
+    x = Graphics_Char(x, y, *pt, mode);
+    pt = pt+1;
+  }
+  return x;
+}
+
+//------------Graphics_SetCursor------------
+// Set where Graphics_OutString draws
+// Input: x,y top left of the next character, mode for the text
+// Output: none
+void Graphics_SetCursor(int32_t x, int32_t y, uint32_t mode){
+  CursorX = x;
+  CursorY = y;
+  CursorMode = mode;
+}
+
+//------------Graphics_OutString------------
+// Draw a string at the cursor and move the cursor past it
+// Input: pt string
+// Output: none
+void Graphics_OutString(char *pt){
+  CursorX = Graphics_String(CursorX, CursorY, pt, CursorMode);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file      Graphics.h
+ * @brief     Lines, rectangles, scrolling, sprites and text in the Nokia5110 screen buffer
+ * @details   Draws into Screen of Nokia5110.c a byte column at a
+ * time rather than a pixel at a time. Screen holds the 48 rows in 6
+ * banks of 8, one byte per column per bank with bit 0 at the top,
+ * so a rectangle is one mask per bank applied to each of its
+ * columns, and a sprite stored the same way is shifted into two
+ * banks and combined a whole byte at a time. Everything drawn is
+ * marked with Nokia5110_Dirty(), and Nokia5110_DisplayBuffer() sends
+ * it.<br>
+ * x is the column, 0 on the left to 83, and y the row, 0 at the top
+ * to 47. Shapes and sprites may lie partly off the screen; the part
+ * that is off is not drawn.<br>
+ * tools/graphics/bmp2sprite converts a BMP or PBM/PGM image to a
+ * struct Sprite in C.<br>
+ * Approximate cost at 48 MHz:<br>
+<table>
+<caption id="graphics_cost">Graphics cost</caption>
+<tr><th>Operation                               <th>Time
+<tr><td>84 by 48 rectangle, SetPxl per pixel    <td>~5 ms
+<tr><td>84 by 48 rectangle                      <td>~35 us
+<tr><td>character at a multiple of 8 rows       <td>~3 us
+<tr><td>character at any row                    <td>~4.5 us
+<tr><td>scroll 84 by 48 one column sideways     <td>~50 us
+<tr><td>scroll 84 by 48 one row up or down      <td>~150 us
+</table>
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __GRAPHICS_H__ // do not include more than once
+#define __GRAPHICS_H__
+#include <stdint.h>
+
+/**
+ * Drawing modes
+ */
+#define GRAPHICS_CLEAR  0   /**< turn pixels off */
+#define GRAPHICS_SET    1   /**< turn pixels on */
+#define GRAPHICS_INVERT 2   /**< toggle pixels */
+#define GRAPHICS_COPY   3   /**< sprites and text: on and off as drawn, shapes: as GRAPHICS_SET */
+
+/**
+ * Width of a character drawn by Graphics_Char(), 5 columns and a
+ * blank one
+ */
+#define GRAPHICS_CHARW  6
+
+/**
+ * \struct Sprite
+ * \brief A 1-bit image in the layout of Screen
+ */
+struct Sprite{
+  uint8_t Width;          /**< columns */
+  uint8_t Height;         /**< rows */
+  const uint8_t *Bits;    /**< (Height+7)/8 banks of Width bytes, bit 0 at the top */
+};
+
+/**
+ * Fill a rectangle
+ * @param x left column
+ * @param y top row
+ * @param w width in columns
+ * @param h height in rows
+ * @param mode GRAPHICS_CLEAR, GRAPHICS_SET or GRAPHICS_INVERT
+ * @return none
+ * @brief  Filled rectangle
+ */
+void Graphics_FillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t mode);
+
+/**
+ * Draw the outline of a rectangle, one pixel wide
+ * @param x left column
+ * @param y top row
+ * @param w width in columns
+ * @param h height in rows
+ * @param mode GRAPHICS_CLEAR, GRAPHICS_SET or GRAPHICS_INVERT
+ * @return none
+ * @brief  Rectangle
+ */
+void Graphics_Rect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t mode);
+
+/**
+ * Draw a horizontal line
+ * @param x left column
+ * @param y row
+ * @param w length in columns
+ * @param mode GRAPHICS_CLEAR, GRAPHICS_SET or GRAPHICS_INVERT
+ * @return none
+ * @brief  Horizontal line
+ */
+void Graphics_HLine(int32_t x, int32_t y, int32_t w, uint32_t mode);
+
+/**
+ * Draw a vertical line
+ * @param x column
+ * @param y top row
+ * @param h length in rows
+ * @param mode GRAPHICS_CLEAR, GRAPHICS_SET or GRAPHICS_INVERT
+ * @return none
+ * @brief  Vertical line
+ */
+void Graphics_VLine(int32_t x, int32_t y, int32_t h, uint32_t mode);
+
+/**
+ * Move the contents of a rectangle; the pixels that move in from
+ * outside it are off, and nothing outside it changes. For
+ * example dx=-1 moves a strip chart one column to the left and
+ * dy=-8 scrolls text up one line.
+ * @param x left column
+ * @param y top row
+ * @param w width in columns
+ * @param h height in rows
+ * @param dx columns to move right, negative to move left
+ * @param dy rows to move down, negative to move up
+ * @return none
+ * @brief  Scroll part of the screen
+ */
+void Graphics_Scroll(int32_t x, int32_t y, int32_t w, int32_t h, int32_t dx, int32_t dy);
+
+/**
+ * Draw a sprite
+ * @param x column of its left edge
+ * @param y row of its top edge
+ * @param s sprite, for example from tools/graphics/bmp2sprite
+ * @param mode GRAPHICS_SET draws its on pixels, GRAPHICS_CLEAR
+ * erases them, GRAPHICS_INVERT toggles them and GRAPHICS_COPY
+ * draws its off pixels too
+ * @return none
+ * @brief  Sprite
+ */
+void Graphics_Sprite(int32_t x, int32_t y, const struct Sprite *s, uint32_t mode);
+
+/**
+ * Draw a character of the Nokia5110 font, 5 by 8 pixels and a
+ * blank column on the right
+ * @param x column of its left edge
+ * @param y row of its top edge, any row
+ * @param c character 0x20 to 0x7F
+ * @param mode as for Graphics_Sprite(), GRAPHICS_COPY overwrites
+ * what was there
+ * @return x of the next character, x+GRAPHICS_CHARW
+ * @brief  Character
+ */
+int32_t Graphics_Char(int32_t x, int32_t y, char c, uint32_t mode);
+
+/**
+ * Draw a string on one line, without wrapping
+ * @param x column of its left edge
+ * @param y row of its top edge, any row
+ * @param pt null-terminated string
+ * @param mode as for Graphics_Char()
+ * @return x after the last character
+ * @brief  String
+ */
+int32_t Graphics_String(int32_t x, int32_t y, const char *pt, uint32_t mode);
+
+/**
+ * Set where Graphics_OutString() draws, so the Format.h functions
+ * can print numbers anywhere on the screen, for example
+ * Format_OutUDecWidth(&Graphics_OutString, n, 5)
+ * @param x column of the next character
+ * @param y row of its top edge
+ * @param mode as for Graphics_Char()
+ * @return none
+ * @brief  Text position
+ */
+void Graphics_SetCursor(int32_t x, int32_t y, uint32_t mode);
+
+/**
+ * Draw a string at the position of Graphics_SetCursor() and move
+ * the position past it; a FormatSink
+ * @param pt null-terminated string
+ * @return none
+ * @brief  Text output
+ */
+void Graphics_OutString(char *pt);
+
+#endif // __GRAPHICS_H__
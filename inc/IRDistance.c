@@ -54,13 +54,164 @@ policies, either expressed or implied, of the FreeBSD Project.
 
 #include <stdint.h>
 #include "../inc/ADC14.h"
+#include "../inc/IRDistance.h"
 #include "msp.h"
 #include <math.h>
 
 
+// Piecewise-linear conversion tables, one per sensor.
+// IRTable[s][k] is the distance in mm at ADC code irCode(k):
+// every 256 codes up to IR_FINESTART, every 16 codes from there
+// to IR_FINEEND, where the curves are steep (about 250 to 800 mm),
+// and every 256 codes again above (the last knot is code 16383).
+// A shift and a mask pick the segment and the fraction within
+// it; there is no divide and the result is always between the
+// table entries, 0 to IR_MAXDIST.
+// The defaults are the Lab 4 curve fits below, saturated at
+// IR_MAXDIST where n is at or below the offset, and convert to
+// within 2% + 1 mm of them from 100 to 800 mm; run
+// IRDistance_Calibrate() to replace them for a given robot.
+uint16_t IRTable[3][IR_TABLESIZE] = {
+  { // left, 100000/(n-2630)
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,724,649,588,537,495,458,427,400,375,354,335,
+    318,303,289,276,264,253,243,234,226,218,210,204,197,191,185,180,
+    175,170,166,161,157,153,150,146,143,140,136,134,131,128,125,123,
+    121,118,116,114,112,110,108,106,104,103,101, 99, 98, 96, 95, 93,
+     92, 91, 89, 88, 87, 86, 84, 83, 82, 81, 80, 79, 78, 77, 76, 75,
+     74, 73, 72, 72, 71, 70, 69, 68, 68, 58, 50, 44, 40, 36, 33, 30,
+     28, 26, 24, 23, 22, 20, 19, 18, 17, 17, 16, 15, 15, 14, 14, 13,
+     13, 12, 12, 11, 11, 11, 10, 10, 10, 10,  9,  9,  9,  9,  8,  8,
+      8,  8,  8,  8,  7,  7,  7,  7,  7
+  },
+  { // center, 836100/(n-1558)
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,800,800,800,800,800,796,784,772,761,750,
+    739,729,719,709,700,690,681,673,664,656,648,640,632,624,617,610,
+    603,596,589,583,576,570,564,558,552,546,540,535,529,524,519,514,
+    509,504,499,494,490,485,481,476,472,468,463,459,455,451,448,444,
+    440,436,433,429,426,422,419,415,412,409,406,403,400,397,394,391,
+    388,385,382,379,376,374,371,368,366,363,361,358,356,353,351,349,
+    346,344,342,340,337,335,333,331,329,299,274,252,234,218,205,193,
+    182,172,164,156,149,142,136,131,126,121,117,112,109,105,102, 99,
+     96, 93, 90, 88, 86, 83, 81, 79, 77, 76, 74, 72, 71, 69, 68, 66,
+     65, 64, 62, 61, 60, 59, 58, 57, 56
+  },
+  { // right, 100000/(n-2390)
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,800,
+    800,800,800,800,800,800,724,649,588,537,495,458,427,400,375,354,
+    335,318,303,289,276,264,253,243,234,226,218,210,204,197,191,185,
+    180,175,170,166,161,157,153,150,146,143,140,136,134,131,128,125,
+    123,121,118,116,114,112,110,108,106,104,103,101, 99, 98, 96, 95,
+     93, 92, 91, 89, 88, 87, 86, 84, 83, 82, 81, 80, 79, 78, 77, 76,
+     75, 74, 73, 72, 72, 71, 70, 69, 68, 68, 67, 66, 66, 65, 64, 64,
+     63, 62, 62, 61, 60, 60, 59, 59, 58, 50, 45, 40, 36, 33, 30, 28,
+     26, 24, 23, 22, 20, 19, 18, 18, 17, 16, 15, 15, 14, 14, 13, 13,
+     12, 12, 11, 11, 11, 10, 10, 10, 10,  9,  9,  9,  9,  8,  8,  8,
+      8,  8,  8,  7,  7,  7,  7,  7,  7
+  }
+};
+
+#define IR_COARSE (IR_FINESTART>>8)                  // knots below IR_FINESTART
+#define IR_FINE   ((IR_FINEEND-IR_FINESTART)>>4)      // knots from IR_FINESTART to IR_FINEEND
+
+// ADC code of knot k, 0 to 16383
+static uint32_t irCode(uint32_t k){
+  uint32_t n;
+  if(k < IR_COARSE){
+    n = k<<8;
+  }else if(k < IR_COARSE+IR_FINE){
+    n = IR_FINESTART+((k-IR_COARSE)<<4);
+  }else{
+    n = IR_FINEEND+((k-IR_COARSE-IR_FINE)<<8);
+  }
+  if(n > 16383) n = 16383;
+  return n;
+}
+
+// ------------IRDistance_Convert------------
+// Convert a filtered ADC sample to distance by table lookup
+// Input: sensor is IR_LEFT, IR_CENTER or IR_RIGHT
+//        n is the 14-bit ADC sample, larger values are clamped
+// Output: distance in mm, 0 to IR_MAXDIST
+int32_t IRDistance_Convert(enum IRSensor sensor, uint32_t n){
+  const uint16_t *t = IRTable[sensor];
+  uint32_t k, f;
+  int32_t d0, d1;
+  if(n > 16383) n = 16383;
+  if(n < IR_FINESTART){
+    k = n>>8;              // segment
+    f = n&0xFF;            // fraction of the segment, in 256ths
+  }else if(n < IR_FINEEND){
+    k = IR_COARSE+((n-IR_FINESTART)>>4);
+    f = (n&0x0F)<<4;
+  }else{
+    k = IR_COARSE+IR_FINE+((n-IR_FINEEND)>>8);
+    f = n&0xFF;
+  }
+  d0 = t[k];
+  d1 = t[k+1];
+  return d0+(((d1-d0)*(int32_t)f)>>8);
+}
+
+// ------------IRDistance_Calibrate------------
+// Build the conversion table for one sensor from measured
+// points. Samples between two points are linearly
+// interpolated; samples below the smallest ADC value (farther
+// than the farthest point) read that point's distance, and
+// samples above the largest read the nearest point's distance.
+// Runs once, so the divides here do not matter.
+// Input: sensor is IR_LEFT, IR_CENTER or IR_RIGHT
+//        adc[i] is the filtered ADC sample with a wall mm[i] away
+//        count is the number of points, 2 to IR_MAXPOINTS
+// Output: 1 if the table was replaced, 0 on bad input
+int IRDistance_Calibrate(enum IRSensor sensor, const uint32_t *adc, const uint32_t *mm, uint32_t count){
+  uint32_t a[IR_MAXPOINTS], d[IR_MAXPOINTS];
+  uint32_t i, j, k, n, ta, td;
+  if((count < 2) || (count > IR_MAXPOINTS) || (sensor > IR_RIGHT)){
+    return 0;
+  }
+  for(i=0; i<count; i++){  // insertion sort by ADC value
+    ta = adc[i];
+    td = mm[i];
+    if(td > IR_MAXDIST) td = IR_MAXDIST;
+    j = i;
+    while((j > 0) && (a[j-1] > ta)){
+      a[j] = a[j-1];
+      d[j] = d[j-1];
+      j--;
+    }
+    a[j] = ta;
+    d[j] = td;
+  }
+  j = 0;
+  for(k=0; k<IR_TABLESIZE; k++){
+    n = irCode(k);
+    while((j < count-2) && (n > a[j+1])){
+      j++;                 // a[j] <= n <= a[j+1] unless n is off either end
+    }
+    if(n <= a[0]){
+      IRTable[sensor][k] = d[0];
+    }else if(n >= a[count-1]){
+      IRTable[sensor][k] = d[count-1];
+    }else if(a[j+1] == a[j]){
+      IRTable[sensor][k] = d[j];
+    }else{
+      IRTable[sensor][k] = (int32_t)d[j]+((int32_t)d[j+1]-(int32_t)d[j])*(int32_t)(n-a[j])/(int32_t)(a[j+1]-a[j]);
+    }
+  }
+  return 1;
+}
+
 /*
  * Routine to convert Filtered Raw ADC values to distance data.
  * Either via curve fitting (hyperbolic, polynomial, log etc), or piece-wise linear method.
+ * The curve fits below generated the default IRTable[];
+ * the conversion itself is now a table lookup.
  */
 int32_t LeftConvert(int32_t nl){        // returns left distance in mm
   // write this for Lab 4
@@ -68,10 +219,9 @@ int32_t LeftConvert(int32_t nl){        // returns left distance in mm
     //uint32_t length = nl;
     //uint32_t length = 90577.36/(nl-312.0392);
     //length = 100000 / (nl + 2140) * 10;
-    uint32_t length = 100000 / (nl - 2630);
-
-
-    return length;
+    //uint32_t length = 100000 / (nl - 2630);
+    if(nl < 0) nl = 0;
+    return IRDistance_Convert(IR_LEFT, nl);
 }
 
 int32_t CenterConvert(int32_t nc){   // returns center distance in mm
@@ -80,18 +230,19 @@ int32_t CenterConvert(int32_t nc){   // returns center distance in mm
     //length = 723958*pow(nc, -1.208);
     //length = 125000 / (nc + 2500) * 10;
     //uint32_t length = 100000 / (nc - 2620);
-    int32_t length = 836100 / (nc - 1558);
-
-    return length;
+    //int32_t length = 836100 / (nc - 1558);
+    if(nc < 0) nc = 0;
+    return IRDistance_Convert(IR_CENTER, nc);
 }
 
-int32_t RightConvert(uint32_t nr){      // returns right distance in mm
+int32_t RightConvert(int32_t nr){      // returns right distance in mm
   // write this for Lab 4
     //length += (-0.3179)*nr*nr*nr + 34.969*nr*nr - 1303.2*nr + 19834;
     //length = (-2)*pow(10, -18)*pow(nr, 5) + 8*pow(10, -14)*pow(nr, 4) - 2*pow(10, -9)*pow(nr, 3) + pow(10, -5)*nr*nr - 0.0722*nr + 160.09;
     //length = pow(10, 5) / (nr - 2320) * 10;
     //length = 100000 / (nr - 980) * 10;
-    uint32_t length = 100000 / (nr - 2390);
+    //uint32_t length = 100000 / (nr - 2390);
     //uint32_t length = nr;
-    return length;
+    if(nr < 0) nr = 0;
+    return IRDistance_Convert(IR_RIGHT, nr);
 }
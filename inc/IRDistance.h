@@ -62,11 +62,76 @@ policies, either expressed or implied, of the FreeBSD Project.
 #ifndef IRDISTANCE_H_
 #define IRDISTANCE_H_
 
+/**
+ * Start and end of the ADC codes with a knot every 16 codes, where
+ * the distance changes fast; elsewhere there is a knot every 256
+ */
+#define IR_FINESTART 2048
+#define IR_FINEEND   4096
+
+/**
+ * Number of knots in each conversion table
+ */
+#define IR_TABLESIZE (IR_FINESTART/256+(IR_FINEEND-IR_FINESTART)/16+(16384-IR_FINEEND)/256+1)
+
+/**
+ * Largest distance reported, units mm; the GP2Y0A21YK0F range ends near 800 mm
+ */
+#define IR_MAXDIST 800
+
+/**
+ * Largest number of points accepted by IRDistance_Calibrate()
+ */
+#define IR_MAXPOINTS 16
+
+/**
+ * \enum IRSensor
+ * \brief Selects one of the three GP2Y0A21YK0F sensors
+ */
+enum IRSensor{
+  IR_LEFT = 0,    /**< P9.1, channel 16 */
+  IR_CENTER = 1,  /**< P4.1, channel 12 */
+  IR_RIGHT = 2    /**< P9.0, channel 17 */
+};
+
+/**
+ * Conversion tables, IRTable[sensor][k] is the distance in mm at the
+ * ADC code of knot k: 256*k below IR_FINESTART, then every 16 codes
+ * to IR_FINEEND, then every 256 codes to 16383
+ */
+extern uint16_t IRTable[3][IR_TABLESIZE];
+
+/**
+ * Convert ADC sample into distance by piecewise-linear table lookup.
+ * A shift of the sample picks a segment of IRTable[sensor] and its
+ * low bits interpolate, so there is no divide and the result is
+ * saturated to 0 to IR_MAXDIST for every input.
+ * @param sensor IR_LEFT, IR_CENTER or IR_RIGHT
+ * @param n is the 14-bit ADC sample 0 to 16383, larger values are clamped
+ * @return distance from robot center to wall (units mm)
+ * @brief  Convert infrared distance measurement
+ */
+int32_t IRDistance_Convert(enum IRSensor sensor, uint32_t n);
+
+/**
+ * Replace the conversion table of one sensor with a piecewise-linear
+ * fit through measured points. Take the points by placing a wall at
+ * known distances and recording the filtered ADC sample at each.
+ * Samples beyond the farthest or nearest point saturate at that point.
+ * @param sensor IR_LEFT, IR_CENTER or IR_RIGHT
+ * @param adc array of count filtered ADC samples, any order
+ * @param mm array of count distances (units mm) matching adc[]
+ * @param count number of points, 2 to IR_MAXPOINTS
+ * @return 1 on success, 0 if count or sensor is out of range
+ * @brief  Calibrate one infrared distance sensor
+ */
+int IRDistance_Calibrate(enum IRSensor sensor, const uint32_t *adc, const uint32_t *mm, uint32_t count);
+
 
 /**
  * Convert ADC sample into distance for the GP2Y0A21YK0F
- * infrared distance sensor.  Conversion uses a calibration formula<br>
- * Dl = Al/(nl + Bl) + Cl
+ * infrared distance sensor.  Conversion uses IRDistance_Convert(), whose<br>
+ * default table follows the calibration formula Dl = Al/(nl + Bl) + Cl
  * @param nl is the 14-bit ADC sample 0 to 16383
  * @return distance from robot center to left wall (units mm)
  * @brief  Convert left infrared distance measurement
@@ -75,8 +140,8 @@ int32_t LeftConvert(int32_t nl);
 
 /**
  * Convert ADC sample into distance for the GP2Y0A21YK0F
- * infrared distance sensor.  Conversion uses a calibration formula<br>
- * Dc = Ac/(nc + Bc) + Cc
+ * infrared distance sensor.  Conversion uses IRDistance_Convert(), whose<br>
+ * default table follows the calibration formula Dc = Ac/(nc + Bc) + Cc
  * @param nc is the 14-bit ADC sample 0 to 16383
  * @return distance from robot center to center wall (units mm)
  * @brief  Convert center infrared distance measurement
@@ -85,8 +150,8 @@ int32_t CenterConvert(int32_t nc);
 
 /**
  * Convert ADC sample into distance for the GP2Y0A21YK0F
- * infrared distance sensor.  Conversion uses a calibration formula<br>
- * Dr = Ar/(nr + Br) + Cr
+ * infrared distance sensor.  Conversion uses IRDistance_Convert(), whose<br>
+ * default table follows the calibration formula Dr = Ar/(nr + Br) + Cr
  * @param nr is the 14-bit ADC sample 0 to 16383
  * @return distance from robot center to right wall (units mm)
  * @brief  Convert right infrared distance measurement
@@ -1,6 +1,6 @@
 // LPF.c
 // Runs on MSP432
-// implements three FIR low-pass filters
+// implements FIR low-pass (moving average) filters
 
 // Jonathan Valvano
 // September 12, 2017
@@ -45,95 +45,112 @@ policies, either expressed or implied, of the FreeBSD Project.
 
 #include <stdint.h>
 #include "msp.h"
+#include "../inc/LPF.h"
+
+//**************Low pass Digital filter object**************
+// The MACQ is a caller-provided uint16_t array of Size elements,
+// so any number of channels can be filtered, each costing
+// 2*Size bytes of RAM.
+// If Size is a power of 2 the average is a shift, otherwise
+// it is a divide; the result is the same either way.
+
+// ------------LPF_Create------------
+// Initialize one filter and prime its MACQ
+// Input: filter is the filter object
+//        buf is the MACQ storage, at least size elements
+//        size depth of the filter, 1 to LPF_MAXSIZE
+//        initial value to preload into MACQ, 0 to 65535
+// Output: none
+void LPF_Create(struct LPF *filter, uint16_t *buf, uint32_t size, uint32_t initial){ uint32_t i;
+  if(size>LPF_MAXSIZE) size=LPF_MAXSIZE; // max
+  if(size==0) size=1;                    // min
+  filter->Buf = buf;
+  filter->Size = size;
+  filter->Index = 0;
+  filter->Shift = LPF_NOSHIFT;
+  for(i=0; i<=10; i++){
+    if(size == (1u<<i)){
+      filter->Shift = i;                 // power of 2, average by shifting
+    }
+  }
+  filter->Sum = size*initial;            // prime MACQ with initial data
+  for(i=0; i<size; i++){
+    buf[i] = initial;
+  }
+}
 
+// ------------LPF_Filter------------
+// calculate one filter output, called at sampling rate
+// Input: filter is the filter object
+//        newdata is new ADC data, 0 to 65535
+// Output: filter output
+// y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
+uint32_t LPF_Filter(struct LPF *filter, uint32_t newdata){
+  uint32_t i = filter->Index;            // index to oldest
+  filter->Sum = filter->Sum+newdata-filter->Buf[i];   // subtract oldest, add newest
+  filter->Buf[i] = newdata;              // save new data
+  i = i+1;
+  if(i == filter->Size){
+    i = 0;                               // wrap
+  }
+  filter->Index = i;
+  if(filter->Shift != LPF_NOSHIFT){
+    return filter->Sum>>filter->Shift;
+  }
+  return filter->Sum/filter->Size;
+}
 
-//**************Low pass Digital filter**************
-uint32_t Size;      // Size-point average, Size=1 to 512
-uint32_t x[1024];   // two copies of MACQ
-uint32_t *Pt;       // pointer to current
-uint32_t I1;        // index to oldest
-uint32_t LPFSum;    // sum of the last Size samples
-
-void LPF_Init(uint32_t initial, uint32_t size){ int i;
-  if(size>1024) size=1024; // max
-  Size = size;
-  I1 = Size-1;
-  LPFSum = Size*initial; // prime MACQ with initial data
-  for(i=0; i<Size; i++){
-    x[i] = initial;
+//**************Three fixed filters**************
+// LPF_Init/LPF_Calc, LPF_Init2/LPF_Calc2 and LPF_Init3/LPF_Calc3
+// are three filter objects with LPF_FIXEDSIZE deep storage each.
+// Until an Init succeeds each one passes its input through.
+static uint16_t x[LPF_FIXEDSIZE];
+static uint16_t x2[LPF_FIXEDSIZE];
+static uint16_t x3[LPF_FIXEDSIZE];
+static struct LPF Filter1 = {x, 1, 0, 0, 0};
+static struct LPF Filter2 = {x2, 1, 0, 0, 0};
+static struct LPF Filter3 = {x3, 1, 0, 0, 0};
+
+// a size the storage cannot hold is refused rather than cut down,
+// so the caller does not get a different filter than it asked for
+static int fixedInit(struct LPF *filter, uint16_t *buf, uint32_t initial, uint32_t size){
+  if((size == 0) || (size > LPF_FIXEDSIZE)){
+    return 0;
   }
+  LPF_Create(filter, buf, size, initial);
+  return 1;
+}
+
+// Input: initial value to preload into MACQ
+//        size depth of the filter, 1 to LPF_FIXEDSIZE
+// Output: 1 if initialized, 0 if size is out of range (the
+//         filter is not changed)
+int LPF_Init(uint32_t initial, uint32_t size){
+  return fixedInit(&Filter1, x, initial, size);
 }
 // calculate one filter output, called at sampling rate
 // Input: new ADC data   Output: filter output
 // y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
 uint32_t LPF_Calc(uint32_t newdata){
-  LPFSum = LPFSum+newdata-x[I1];   // subtract oldest, add newest
-  x[I1] = newdata;     // save new data
-  if(I1 == 0){
-    I1 = Size-1;              // wrap
-  } else{
-    I1--;                     // make room for data
-  }
-  return LPFSum/Size;
+  return LPF_Filter(&Filter1, newdata);
 }
 
-//**************Low pass Digital filter**************
-uint32_t Size2;      // Size-point average, Size=1 to 512
-uint32_t x2[1024];   // two copies of MACQ
-uint32_t *Pt2;       // pointer to current
-uint32_t I2;        // index to oldest
-uint32_t LPFSum2;    // sum of the last Size samples
-
-void LPF_Init2(uint32_t initial, uint32_t size){ int i;
-  if(size>1024) size=1024; // max
-  Size2 = size;
-  I2 = Size2-1;
-  LPFSum2 = Size2*initial; // prime MACQ with initial data
-  for(i=0; i<Size2; i++){
-    x2[i] = initial;
-  }
+int LPF_Init2(uint32_t initial, uint32_t size){
+  return fixedInit(&Filter2, x2, initial, size);
 }
 // calculate one filter output, called at sampling rate
 // Input: new ADC data   Output: filter output
 // y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
 uint32_t LPF_Calc2(uint32_t newdata){
-  LPFSum2 = LPFSum2+newdata-x2[I2];   // subtract oldest, add newest
-  x2[I2] = newdata;     // save new data
-  if(I2 == 0){
-    I2 = Size2-1;              // wrap
-  } else{
-    I2--;                     // make room for data
-  }
-  return LPFSum2/Size2;
+  return LPF_Filter(&Filter2, newdata);
 }
 
-//**************Low pass Digital filter**************
-uint32_t Size3;      // Size-point average, Size=1 to 512
-uint32_t x3[1024];   // two copies of MACQ
-uint32_t *Pt3;       // pointer to current
-uint32_t I3;        // index to oldest
-uint32_t LPFSum3;    // sum of the last Size samples
-
-void LPF_Init3(uint32_t initial, uint32_t size){ int i;
-  if(size>1024) size=1024; // max
-  Size3 = size;
-  I3 = Size3-1;
-  LPFSum3 = Size3*initial; // prime MACQ with initial data
-  for(i=0; i<Size3; i++){
-    x3[i] = initial;
-  }
+int LPF_Init3(uint32_t initial, uint32_t size){
+  return fixedInit(&Filter3, x3, initial, size);
 }
 // calculate one filter output, called at sampling rate
 // Input: new ADC data   Output: filter output
 // y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
 uint32_t LPF_Calc3(uint32_t newdata){
-  LPFSum3 = LPFSum3+newdata-x3[I3];   // subtract oldest, add newest
-  x3[I3] = newdata;     // save new data
-  if(I3 == 0){
-    I3 = Size3-1;              // wrap
-  } else{
-    I3--;                     // make room for data
-  }
-  return LPFSum3/Size3;
+  return LPF_Filter(&Filter3, newdata);
 }
-
@@ -1,8 +1,10 @@
 /**
  * @file      LPF.h
- * @brief     implements three FIR low-pass filters
+ * @brief     implements FIR low-pass (moving average) filters
  * @details   Finite length LPF<br>
- 1) Size is the depth 2 to 512<br>
+ 1) Size is the depth, 1 to LPF_MAXSIZE for a filter object and
+    1 to LPF_FIXEDSIZE for the three fixed filters; a power of 2
+    avoids the divide<br>
  2) y(n) = (sum(x(n)+x(n-1)+...+x(n-size-1))/size<br>
  3) To use a filter<br>
    a) initialize it once<br>
@@ -56,16 +58,70 @@ policies, either expressed or implied, of the FreeBSD Project.
 */
 
 
+#ifndef __LPF_H__ // do not include more than once
+#define __LPF_H__
+#include <stdint.h>
+
+/**
+ * Maximum depth of a filter object
+ */
+#define LPF_MAXSIZE 1024
+
+/**
+ * Depth of the storage behind LPF_Init, LPF_Init2 and LPF_Init3
+ */
+#define LPF_FIXEDSIZE 256
+
+/**
+ * Value of LPF.Shift when Size is not a power of 2
+ */
+#define LPF_NOSHIFT 0xFFFFFFFF
+
+/**
+ * \struct LPF
+ * \brief One moving average filter, the MACQ storage is supplied by the caller
+ */
+struct LPF{
+  uint16_t *Buf;   /**< MACQ, Size elements */
+  uint32_t Size;   /**< depth of the filter */
+  uint32_t Index;  /**< index to oldest */
+  uint32_t Shift;  /**< log2(Size), or LPF_NOSHIFT */
+  uint32_t Sum;    /**< sum of the last Size samples */
+};
+
+/**
+ * Initialize a LPF object<br>
+ * Set all data to an initial value<br>
+ * @param filter pointer to the filter object
+ * @param buf MACQ storage of at least size elements
+ * @param size depth of the filter, 1 to 1024
+ * @param initial value to preload into MACQ, 0 to 65535
+ * @return none
+ * @note  a power of 2 size averages with a shift instead of a divide
+ * @brief  Initialize a LPF object
+ */
+void LPF_Create(struct LPF *filter, uint16_t *buf, uint32_t size, uint32_t initial);
+
+/**
+ * Calculate one filter output<br>
+ * Called at sampling rate
+ * @param filter pointer to the filter object
+ * @param newdata new ADC data, 0 to 65535
+ * @return result filter output
+ * @brief  FIR low pass filter
+ */
+uint32_t LPF_Filter(struct LPF *filter, uint32_t newdata);
+
 /**
  * Initialize first LPF<br>
  * Set all data to an initial value<br>
  * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
- * @return none
- * @note  all three filters share the same size
+ * @param size depth of the filter, 1 to LPF_FIXEDSIZE
+ * @return 1 if initialized, 0 if size is out of range and the filter is not changed
+ * @note  before the first successful call the filter passes its input through
  * @brief  Initialize first LPF
  */
-void LPF_Init(uint32_t initial, uint32_t size);
+int LPF_Init(uint32_t initial, uint32_t size);
 
 /**
  * First LPF, calculate one filter output<br>
@@ -81,12 +137,12 @@ uint32_t LPF_Calc(uint32_t newdata);
  * Initialize second LPF<br>
  * Set all data to an initial value<br>
  * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
- * @return none
- * @note  all three filters share the same size
+ * @param size depth of the filter, 1 to LPF_FIXEDSIZE
+ * @return 1 if initialized, 0 if size is out of range and the filter is not changed
+ * @note  before the first successful call the filter passes its input through
  * @brief  Initialize second LPF
  */
-void LPF_Init2(uint32_t initial, uint32_t size);
+int LPF_Init2(uint32_t initial, uint32_t size);
 
 /**
  * Second LPF, calculate one filter output<br>
@@ -102,12 +158,12 @@ uint32_t LPF_Calc2(uint32_t newdata);
  * Initialize third LPF<br>
  * Set all data to an initial value<br>
  * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
- * @return none
- * @note  all three filters share the same size
+ * @param size depth of the filter, 1 to LPF_FIXEDSIZE
+ * @return 1 if initialized, 0 if size is out of range and the filter is not changed
+ * @note  before the first successful call the filter passes its input through
  * @brief  Initialize third LPF
  */
-void LPF_Init3(uint32_t initial, uint32_t size);
+int LPF_Init3(uint32_t initial, uint32_t size);
 
 /**
  * Third LPF, calculate one filter output<br>
@@ -117,3 +173,5 @@ void LPF_Init3(uint32_t initial, uint32_t size);
  * @brief  FIR low pass filter
  */
 uint32_t LPF_Calc3(uint32_t newdata);
+
+#endif // __LPF_H__
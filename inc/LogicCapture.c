@@ -0,0 +1,174 @@
+// LogicCapture.c
+// Runs on MSP432
+// Timer32 1 samples two masked ports, run-length encodes the
+// samples into RAM blocks and sends full blocks by UART0 DMA.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stddef.h>
+#include "msp.h"
+#include "../inc/CortexM.h"
+#include "../inc/UART0.h"
+#include "../inc/CRC16.h"
+#include "../inc/LogicCapture.h"
+
+#define HEADERWORDS 4
+#define BLOCKWORDS (HEADERWORDS+LOGIC_BLOCKSIZE+1)  // the last word holds the CRC
+
+uint32_t LogicBuf[LOGIC_NUMBLOCKS][BLOCKWORDS];
+volatile uint8_t LogicBusy[LOGIC_NUMBLOCKS];  // filling or waiting for UART0
+volatile uint32_t LogicDropped;               // samples lost
+static const uint8_t NoPort = 0;
+static const volatile uint8_t *Port0 = &NoPort;
+static const volatile uint8_t *Port1 = &NoPort;
+static uint32_t Mask0, Mask1;
+static uint32_t Period;          // bus cycles per sample
+static uint32_t MaxRun;          // at most about 0.1 s per event
+static uint32_t Value;           // value of the current run
+static uint32_t Run;             // samples in the current run
+static uint32_t Index;           // sample index of the start of the current run
+static uint32_t *Block;          // block being filled, 0 if none
+static uint32_t Count;           // events in Block
+static uint16_t CRC;             // CRC of the events in Block
+static uint8_t Seq;
+
+static void blockDone(const void *buf){
+  LogicBusy[((const uint32_t *)buf-LogicBuf[0])/BLOCKWORDS] = 0;
+}
+
+static void openBlock(void){
+  int i;
+  for(i=0; i<LOGIC_NUMBLOCKS; i++){
+    if(LogicBusy[i] == 0){
+      LogicBusy[i] = 1;
+      Block = LogicBuf[i];
+      Block[1] = Index;
+      Block[2] = Period;
+      Block[3] = Mask0|(Mask1<<8);
+      Count = 0;
+      CRC = CRC16_INIT;
+      return;
+    }
+  }
+}
+
+static void closeBlock(void){
+  uint8_t *crc = (uint8_t *)&Block[HEADERWORDS+Count];
+  Block[0] = 0x5AA5|(Count<<16)|((uint32_t)Seq<<24);
+  CRC = CRC16_Update(CRC, &((uint8_t *)Block)[2], 4*HEADERWORDS-2);
+  crc[0] = (uint8_t)CRC;
+  crc[1] = (uint8_t)(CRC>>8);
+  if(UART0_WriteCallback(Block, 4*(HEADERWORDS+Count)+2, &blockDone) == 0){
+    LogicDropped = LogicDropped+(Index-Block[1]); // UART0 queue full
+    blockDone(Block);
+  }
+  Seq++;
+  Block = 0;
+}
+
+// add the current run as an event
+static void emit(void){
+  uint32_t *e;
+  if(Run == 0){
+    return;
+  }
+  if(Block == 0){
+    openBlock();
+    if(Block == 0){              // every buffer is waiting for UART0
+      LogicDropped = LogicDropped+Run;
+      Index = Index+Run;
+      return;
+    }
+  }
+  e = &Block[HEADERWORDS+Count];
+  *e = Value|(Run<<16);
+  CRC = CRC16_Update(CRC, (uint8_t *)e, 4);
+  Count++;
+  Index = Index+Run;
+  if((Count == LOGIC_BLOCKSIZE) || ((Index-Block[1]) >= MaxRun)){
+    closeBlock();
+  }
+}
+
+void T32_INT1_IRQHandler(void){
+  uint32_t v;
+  TIMER32_1->INTCLR = 0x00000001;  // acknowledge Timer32 Timer 1 interrupt
+  v = ((*Port0)&Mask0)|(((*Port1)&Mask1)<<8);
+  if((v == Value) && (Run < MaxRun)){
+    Run++;                         // nothing changed, the usual case
+  }else{
+    emit();
+    Value = v;
+    Run = 1;
+  }
+}
+
+//------------LogicCapture_Init------------
+// Start sampling two masked ports into run-length blocks
+// Input: port0, mask0 low 8 channels; port1, mask1 high 8 channels
+//        (port1 may be 0), freq sample rate in Hz,
+//        priority interrupt priority 0 to 6
+// Output: none
+void LogicCapture_Init(const volatile uint8_t *port0, uint8_t mask0,
+                       const volatile uint8_t *port1, uint8_t mask1,
+                       uint32_t freq, uint32_t priority){
+  int i;
+  if(freq < 1000){
+    freq = 1000;
+  }
+  if(freq > LOGIC_MAXFREQ){
+    freq = LOGIC_MAXFREQ;
+  }
+  if(priority > 6){
+    priority = 6;
+  }
+  TIMER32_1->CONTROL = 0;          // stop a previous capture
+  UART0_Flush();
+  Port0 = port0 ? port0 : &NoPort;
+  Port1 = port1 ? port1 : &NoPort;
+  Mask0 = mask0;
+  Mask1 = mask1;
+  Period = 48000000/freq;
+  MaxRun = freq/10;
+  for(i=0; i<LOGIC_NUMBLOCKS; i++){
+    LogicBusy[i] = 0;
+  }
+  LogicDropped = 0;
+  Block = 0;
+  Seq = 0;
+  Index = 0;
+  Run = 0;
+  Value = ((*Port0)&Mask0)|(((*Port1)&Mask1)<<8);
+  TIMER32_1->LOAD = Period-1;      // timer reload value
+  TIMER32_1->INTCLR = 0x00000001;  // clear Timer32 Timer 1 interrupt
+  NVIC->IP[6] = (NVIC->IP[6]&0xFFFF00FF)|(priority<<13);
+  NVIC->ISER[0] = 0x02000000;      // enable interrupt 25 in NVIC
+  TIMER32_1->CONTROL = 0x000000E2; // enable, periodic, interrupt, /1, 32-bit
+}
+
+//------------LogicCapture_Stop------------
+// Stop sampling, send the remaining events and wait for UART0
+// Input: none
+// Output: none
+void LogicCapture_Stop(void){
+  long sr;
+  TIMER32_1->CONTROL = 0;          // stop sampling
+  NVIC->ICER[0] = 0x02000000;      // disable interrupt 25 in NVIC
+  TIMER32_1->INTCLR = 0x00000001;
+  sr = StartCritical();
+  emit();
+  Run = 0;
+  if(Block){
+    closeBlock();
+  }
+  EndCritical(sr);
+  UART0_Flush();
+}
+
+//------------LogicCapture_Dropped------------
+// Samples lost since LogicCapture_Init
+// Input: none
+// Output: count
+uint32_t LogicCapture_Dropped(void){
+  return LogicDropped;
+}
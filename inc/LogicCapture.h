@@ -0,0 +1,91 @@
+/**
+ * @file      LogicCapture.h
+ * @brief     Lossless logic analyzer on up to 16 port pins
+ * @details   A Timer32 1 interrupt samples two masked 8-bit ports,
+ * run-length encodes the samples and fills blocks in RAM. Full
+ * blocks are sent by UART0 DMA while capture continues, so the UART
+ * only carries changes, not every sample as TExaS does. When every
+ * block buffer is still waiting for the UART, samples are dropped
+ * and counted; the host sees the gap from the block start index.<br>
+ * A sample is (port0&mask0)|((port1&mask1)<<8). An event is a value
+ * and the number of consecutive samples, 1 to 65535, that had it.<br>
+ * Block on the wire, little endian:<br>
+<table>
+<caption id="logic_block">Block</caption>
+<tr><th>Bytes   <th>Field
+<tr><td>2       <td>sync 0xA5, 0x5A
+<tr><td>1       <td>number of events n, 1 to LOGIC_BLOCKSIZE
+<tr><td>1       <td>sequence number, +1 per block, wraps at 256
+<tr><td>4       <td>sample index of the first event
+<tr><td>4       <td>sample period in 48 MHz bus cycles
+<tr><td>1       <td>mask0
+<tr><td>1       <td>mask1
+<tr><td>2       <td>0
+<tr><td>4n      <td>events: 16-bit value, 16-bit run length
+<tr><td>2       <td>CRC16_Update() of the events, then of bytes 2 to 15
+</table>
+ * A block is closed when it is full or about 0.1 s old, so slow
+ * signals still reach the host promptly.<br>
+ * Other UART0 output may be interleaved between blocks; the host
+ * finds blocks by the sync bytes and the CRC.<br>
+ * tools/logic/logic2vcd converts a capture to VCD.
+ * @note      Uses Timer32 1, so it cannot be linked with TExaS.c or
+ * Timer32.c. Uses UART0 transmit, UART0_Init() must be called first.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __LOGICCAPTURE_H__ // do not include more than once
+#define __LOGICCAPTURE_H__
+#include <stdint.h>
+
+/**
+ * Events per block
+ */
+#define LOGIC_BLOCKSIZE 64
+
+/**
+ * Number of block buffers
+ */
+#define LOGIC_NUMBLOCKS 4
+
+/**
+ * Highest sample rate in Hz
+ */
+#define LOGIC_MAXFREQ 200000
+
+/**
+ * Start capturing
+ * @param port0 input register of the low 8 channels, for example &P4->IN
+ * @param mask0 pins of port0 to capture
+ * @param port1 input register of the high 8 channels, 0 for none
+ * @param mask1 pins of port1 to capture
+ * @param freq sample rate, 1000 to LOGIC_MAXFREQ Hz
+ * @param priority Timer32 1 interrupt priority 0 to 6
+ * @return none
+ * @note   Assumes a 48 MHz bus clock. At 100 kHz the interrupt takes
+ * about 10% of the CPU.
+ * @brief  Start logic capture
+ */
+void LogicCapture_Init(const volatile uint8_t *port0, uint8_t mask0,
+                       const volatile uint8_t *port1, uint8_t mask1,
+                       uint32_t freq, uint32_t priority);
+
+/**
+ * Stop sampling, send the last partial block and wait until
+ * everything has been transmitted
+ * @param none
+ * @return none
+ * @brief  Stop logic capture
+ */
+void LogicCapture_Stop(void);
+
+/**
+ * Number of samples lost because no block buffer was free
+ * @param none
+ * @return samples dropped since LogicCapture_Init()
+ * @brief  Dropped samples
+ */
+uint32_t LogicCapture_Dropped(void);
+
+#endif // __LOGICCAPTURE_H__
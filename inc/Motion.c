@@ -0,0 +1,154 @@
+// Motion.c
+// Runs on MSP432
+// Non-blocking profiled moves: the profile gives each wheel a
+// position and speed, SpeedControl makes the wheel follow it.
+// October 16, 2026
+
+#include <stdint.h>
+#include <math.h>
+#include "../inc/CortexM.h"
+#include "../inc/Tachometer.h"
+#include "../inc/SpeedControl.h"
+#include "../inc/Profile.h"
+#include "../inc/Motion.h"
+
+static struct Profile Plan;
+static float MmPerStep, Wheelbase;
+static float VMax = MOTION_VMAX, AMax = MOTION_AMAX, JMax = MOTION_JMAX;
+static float LeftSign, RightSign;      // each wheel's share of the profile, 1 or -1
+static int32_t LeftStart, RightStart;  // steps at the start of the move
+static int32_t LeftLast, RightLast;    // steps at the last update
+static uint32_t Settle;                // updates left after the profile ends
+static void (*Done)(void);
+static volatile uint32_t Active;
+
+static void steps(int32_t *left, int32_t *right){
+  uint16_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  Tachometer_Get(&leftTach, &leftDir, left, &rightTach, &rightDir, right);
+}
+
+// ------------Motion_Init------------
+// Initialize speed control and set the robot geometry
+// Input: wheelbase circumference in mm, steps per turn
+// Output: none
+void Motion_Init(uint32_t wheelbase, uint32_t circumference, uint32_t steps){
+  Active = 0;
+  MmPerStep = (float)circumference/steps;
+  Wheelbase = wheelbase;
+  SpeedControl_Init();
+}
+
+// ------------Motion_SetLimits------------
+// Set the limits of later moves
+// Input: vmax mm/s, amax mm/s^2, jmax mm/s^3 or 0
+// Output: none
+void Motion_SetLimits(uint32_t vmax, uint32_t amax, uint32_t jmax){
+  VMax = vmax;
+  AMax = amax;
+  JMax = jmax;
+}
+
+static void start(float distance, float left, float right, void(*done)(void)){
+  Active = 0;                      // Motion_Update() leaves it alone
+  Profile_Plan(&Plan, distance, VMax, AMax, JMax, SPEED_RATE);
+  LeftSign = left;
+  RightSign = right;
+  steps(&LeftStart, &RightStart);
+  LeftLast = LeftStart;
+  RightLast = RightStart;
+  Settle = MOTION_SETTLE;
+  Done = done;
+  Active = 1;
+}
+
+// ------------Motion_Straight------------
+// Start a straight move from rest
+// Input: distance mm, negative is backward; done function or 0
+// Output: none
+void Motion_Straight(int32_t distance, void(*done)(void)){
+  start(distance, 1, 1, done);
+}
+
+// ------------Motion_Rotate------------
+// Start a turn in place from rest, each wheel covers an arc
+// of pi*wheelbase*degrees/360
+// Input: degrees positive is right; done function or 0
+// Output: none
+void Motion_Rotate(int32_t degrees, void(*done)(void)){
+  start(3.14159265f*Wheelbase*degrees/360, 1, -1, done);
+}
+
+// ------------Motion_Stop------------
+// Stop the move now
+// Input: none
+// Output: none
+void Motion_Stop(void){
+  Active = 0;
+  SpeedControl_Set(0, 0);
+  SpeedControl_Update();
+}
+
+// ------------Motion_Busy------------
+// Check for a move in progress
+// Input: none
+// Output: 1 during a move
+uint32_t Motion_Busy(void){
+  return Active;
+}
+
+// setpoint of one wheel: profile speed plus position feedback,
+// never against the direction of the move while the profile runs
+static int32_t wheel(float speed, float error, float direction, uint32_t running){
+  float v = speed+MOTION_KP*error;
+  if(running){
+    if(v*direction < 0){
+      v = 0;                       // ahead of the profile, wait for it
+    }
+  }else if(fabsf(error) <= MOTION_TOLERANCE){
+    v = 0;                         // there
+  }
+  return (int32_t)v;
+}
+
+// ------------Motion_Update------------
+// Step the move and the speed controllers, at SPEED_RATE Hz
+// Input: none
+// Output: none
+void Motion_Update(void){
+  int32_t left, right;
+  float leftError, rightError;
+  uint32_t running, stopped;
+  long sr;
+  if(Active == 0){
+    return;
+  }
+  running = Profile_Step(&Plan);
+  steps(&left, &right);
+  stopped = (left == LeftLast) && (right == RightLast);
+  LeftLast = left;
+  RightLast = right;
+  leftError = LeftSign*Plan.Position-(left-LeftStart)*MmPerStep;
+  rightError = RightSign*Plan.Position-(right-RightStart)*MmPerStep;
+  if(running == 0){                // done when both are there and have stopped
+    if((stopped && (fabsf(leftError) <= MOTION_TOLERANCE) && (fabsf(rightError) <= MOTION_TOLERANCE)) ||
+       (Settle == 0)){
+      Motion_Stop();
+      if(Done){
+        (*Done)();
+      }
+      return;
+    }
+    Settle = Settle-1;
+  }
+  left = wheel(LeftSign*Plan.Velocity, leftError, LeftSign*Plan.Sign, running);
+  right = wheel(RightSign*Plan.Velocity, rightError, RightSign*Plan.Sign, running);
+  // an interrupt, for example a bump, may have called Motion_Stop()
+  // since the check above; then the motors must stay stopped
+  sr = StartCritical();
+  if(Active){
+    SpeedControl_Set(left, right);
+    SpeedControl_Update();
+  }
+  EndCritical(sr);
+}
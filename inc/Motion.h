@@ -0,0 +1,123 @@
+/**
+ * @file      Motion.h
+ * @brief     Non-blocking straight moves and turns in place
+ * @details   Motion_Straight() and Motion_Rotate() plan a profile
+ * (Profile.h) from the wheel geometry and return at once.
+ * Motion_Update(), called at SPEED_RATE Hz from a periodic
+ * interrupt or task, steps the profile and gives each wheel its
+ * profile speed plus MOTION_KP times its position error as the
+ * setpoint of SpeedControl, so the wheels follow the profile in
+ * position, not only in speed, and stop on the distance.<br>
+ * A move ends when both wheels have stopped within
+ * MOTION_TOLERANCE of the end, or MOTION_SETTLE updates after the
+ * profile ends. Then the motors stop, Motion_Busy() returns 0 and the done function, if
+ * any, runs in the context of Motion_Update().<br>
+ * SpeedControl raises speeds below SPEED_MIN, so the first and last
+ * few steps of a profile run at SPEED_MIN; the position feedback
+ * holds a wheel that gets ahead.<br>
+ * Between moves Motion_Update() does nothing, so other code may
+ * drive the motors directly.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __MOTION_H__ // do not include more than once
+#define __MOTION_H__
+#include <stdint.h>
+
+/**
+ * Default speed limit in mm/s
+ */
+#define MOTION_VMAX 300
+
+/**
+ * Default acceleration limit in mm/s^2
+ */
+#define MOTION_AMAX 600
+
+/**
+ * Default jerk limit in mm/s^3, 0 for trapezoids
+ */
+#define MOTION_JMAX 6000
+
+/**
+ * mm/s of extra speed per mm a wheel is behind the profile
+ */
+#define MOTION_KP 5
+
+/**
+ * mm from the end at which a wheel counts as there
+ */
+#define MOTION_TOLERANCE 2.0f
+
+/**
+ * Updates after the profile ends before the move is given up as done
+ */
+#define MOTION_SETTLE 100
+
+/**
+ * Initialize speed control and set the robot geometry
+ * @param wheelbase distance between the wheels in mm
+ * @param circumference of a wheel in mm
+ * @param steps tachometer steps per wheel turn
+ * @return none
+ * @note   Call Motion_Update() at SPEED_RATE Hz afterwards
+ * @brief  Initialize motion
+ */
+void Motion_Init(uint32_t wheelbase, uint32_t circumference, uint32_t steps);
+
+/**
+ * Set the limits of later moves
+ * @param vmax speed in mm/s
+ * @param amax acceleration in mm/s^2
+ * @param jmax jerk in mm/s^3, 0 for trapezoids
+ * @return none
+ * @brief  Set limits
+ */
+void Motion_SetLimits(uint32_t vmax, uint32_t amax, uint32_t jmax);
+
+/**
+ * Start a straight move from rest
+ * @param distance in mm, negative is backward
+ * @param done function to run at the end, 0 for none
+ * @return none
+ * @brief  Move straight
+ */
+void Motion_Straight(int32_t distance, void(*done)(void));
+
+/**
+ * Start a turn in place from rest
+ * @param degrees positive turns right, negative left
+ * @param done function to run at the end, 0 for none
+ * @return none
+ * @brief  Turn in place
+ */
+void Motion_Rotate(int32_t degrees, void(*done)(void));
+
+/**
+ * Stop the move now, without running its done function. It may
+ * be called from an interrupt that preempts Motion_Update(), for
+ * example a bump; the motors stay stopped.
+ * @param none
+ * @return none
+ * @brief  Abort
+ */
+void Motion_Stop(void);
+
+/**
+ * Check for a move in progress
+ * @param none
+ * @return 1 during a move, 0 when done
+ * @brief  Busy
+ */
+uint32_t Motion_Busy(void);
+
+/**
+ * Step the move and the speed controllers. Call at SPEED_RATE Hz.
+ * @param none
+ * @return none
+ * @brief  Motion step
+ */
+void Motion_Update(void);
+
+#endif // __MOTION_H__
@@ -78,10 +78,15 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "Nokia5110.h"
+#include "Format.h"
+#include "CortexM.h"
+#include "DMA.h"
 
 // *************************** Screen dimensions ***************************
 #define SCREENW     84
 #define SCREENH     48
+#define BANKS       (SCREENH/8)   // rows of 8 pixels, one byte per column
+#define TXCHANNEL   6             // DMA channel 6 source 1 is EUSCI_A3 TX
 // The regular 8-bit access for P9OUT  is 0x40004C82.
 // For bit-banding of bit 6 of P9OUT, n=0x4C82 and b=6.
 //    0x42000000 + 32*4C82 + 4*6 = 0x42099040+0x18 = 0x42099058
@@ -206,6 +211,20 @@ static const uint8_t ASCII[][5] = {
 };
 
 
+uint8_t Screen[SCREENW*SCREENH/8]; // buffer stores the next image to be printed on the screen
+
+// The display RAM follows Screen. Columns DirtyLo[b] to DirtyHi[b]
+// of bank b have changed since they were last sent, none if
+// DirtyLo[b] > DirtyHi[b]. A flush takes these ranges and sends
+// them from the DMA_INT3 ISR, one DMA cycle per run of dirty bytes,
+// so the CPU only sets the address of each run.
+static uint8_t DirtyLo[BANKS], DirtyHi[BANKS];
+static uint8_t FlushLo[BANKS], FlushHi[BANKS]; // ranges being sent
+static uint32_t FlushBank;         // next bank to send
+volatile uint32_t FlushBusy;       // 1 while a flush runs
+volatile uint32_t FlushAgain;      // DisplayBuffer called during the flush
+static uint32_t Cursor;            // index in Screen of the next character
+
 // This is a helper function that sends 8-bit commands to the LCD.
 // Inputs: command  8-bit function code to transmit
 // Outputs: none
@@ -217,21 +236,116 @@ static const uint8_t ASCII[][5] = {
 // 3) Write command to TXBUF, starts SPI
 // 4) Wait for SPI to be idle (after transmission complete)
 void static lcdcommandwrite(uint8_t command){
-// write this code as part of Lab 11
+  while(EUSCI_A3->STATW&0x0001){};      // UCBUSY, a frame is shifting
+  DC = 0;
+  EUSCI_A3->TXBUF = command;
+  while(EUSCI_A3->STATW&0x0001){};
+}
 
+// mark columns lo to hi of a bank as changed
+static void dirty(uint32_t bank, uint32_t lo, uint32_t hi){
+  long sr = StartCritical();
+  if(lo < DirtyLo[bank]){
+    DirtyLo[bank] = lo;
+  }
+  if(hi > DirtyHi[bank]){
+    DirtyHi[bank] = hi;
+  }
+  EndCritical(sr);
 }
-// This is a helper function that sends 8-bit data to the LCD.
-// Inputs: data  8-bit data to transmit
+
+//********Nokia5110_Dirty*****************
+// Mark columns of one bank of Screen as changed, for code
+// that writes Screen directly.  The next
+// Nokia5110_DisplayBuffer() sends them.
+// Inputs: bank  0 to 5, rows 8*bank to 8*bank+7
+//         lo    first column, 0 to 83
+//         hi    last column, lo to 83
 // Outputs: none
-// Assumes: UCA3 and Port 9 have already been initialized and enabled
-// The Data/Command pin must be valid when the eighth bit is
-// sent.  The eUSCI module has no hardware FIFOs.
-// 1) Wait for transmitter to be empty (let previous frame finish)
-// 2) Set DC for data (1)
-// 3) Write data to TXBUF, starts SPI
-void static lcddatawrite(uint8_t data){
-// write this code as part of Lab 11
+void Nokia5110_Dirty(uint32_t bank, uint32_t lo, uint32_t hi){
+  dirty(bank, lo, hi);
+}
+
+//********Nokia5110_Glyph*****************
+// Font of the text functions, for code that draws text
+// into Screen itself.
+// Inputs: c  character 0x20 to 0x7F
+// Outputs: pointer to 5 column bytes, bit 0 at the top
+const uint8_t *Nokia5110_Glyph(char c){
+  unsigned char u = (unsigned char)c;   // char is signed on the host
+  if((u < 0x20) || (u > 0x7F)){
+    u = ' ';
+  }
+  return ASCII[u - 0x20];
+}
 
+// copy count bytes, all in one bank, into Screen at index start,
+// marking the columns that change; src 0 means zeros
+static void store(uint32_t start, const uint8_t *src, uint32_t count){
+  uint32_t k, lo = SCREENW, hi = 0;
+  uint8_t value;
+  for(k = 0; k < count; k = k+1){
+    value = src? src[k] : 0;
+    if(Screen[start+k] != value){
+      Screen[start+k] = value;
+      if(lo == SCREENW){
+        lo = k;
+      }
+      hi = k;
+    }
+  }
+  if(lo <= hi){
+    dirty(start/SCREENW, start%SCREENW+lo, start%SCREENW+hi);
+  }
+}
+
+// send the next run of dirty bytes, or finish the flush
+// a run that ends in the last column goes on in the next bank,
+// because the address wraps there in horizontal addressing
+// called with interrupts disabled or from the DMA_INT3 ISR
+static void flushNext(void){
+  struct DMADescriptor *p = DMA_PRIMARY(TXCHANNEL);
+  uint32_t first, last, start, count;
+  while((FlushBank < BANKS) && (FlushLo[FlushBank] > FlushHi[FlushBank])){
+    FlushBank = FlushBank+1;
+  }
+  if(FlushBank == BANKS){
+    FlushBusy = 0;
+    if(FlushAgain){
+      FlushAgain = 0;
+      Nokia5110_DisplayBuffer();
+    }
+    return;
+  }
+  first = last = FlushBank;
+  while((last+1 < BANKS) && (FlushHi[last] == SCREENW-1) && (FlushLo[last+1] == 0)){
+    last = last+1;
+  }
+  start = SCREENW*first+FlushLo[first];
+  count = SCREENW*last+FlushHi[last]+1-start;
+  FlushBank = last+1;
+  lcdcommandwrite(0x80|FlushLo[first]); // setting bit 7 updates X-position
+  lcdcommandwrite(0x40|first);          // setting bit 6 updates Y-position
+  DC = 1;                               // the rest is data, SPI is idle
+  p->SrcEnd = &Screen[start+count-1];
+  p->DstEnd = &EUSCI_A3->TXBUF;
+  p->Control = (3u<<30)            // DST_INC  none, always TXBUF
+              |(0<<28)             // DST_SIZE byte
+              |(0<<26)             // SRC_INC  byte
+              |(0<<24)             // SRC_SIZE byte
+              |(0<<14)             // R_POWER  one byte per TXIFG request
+              |((count-1)<<4)      // N_MINUS_1
+              |1;                  // CYCLE_CTRL basic
+  DMA_Control->ENASET = 1<<TXCHANNEL;
+  // the request is the rising edge of TXIFG, which is already set
+  EUSCI_A3->IFG &= ~0x02;
+  EUSCI_A3->IFG |= 0x02;
+}
+
+// the DMA has written the last byte of a run to TXBUF
+void DMA_INT3_IRQHandler(void){
+  DMA_Channel->INT0_CLRFLG = 1<<TXCHANNEL;
+  flushNext();
 }
 
 //********Nokia5110_Init*****************
@@ -248,6 +362,10 @@ void static lcddatawrite(uint8_t data){
 // Assumes: low-speed subsystem master clock 12 MHz
 void Nokia5110_Init(void){
   volatile uint32_t delay;
+  uint32_t bank;
+  DMA_Init();
+  DMA_Control->ENACLR = 1<<TXCHANNEL;   // stop a flush in progress
+  FlushBusy = FlushAgain = 0;
   EUSCI_A3->CTLW0 = 0x0001;             // hold the eUSCI module in reset mode
   // configure UCA3CTLW0 for:
   // bit15      UCCKPH = 1; data shifts in on first edge, out on following edge
@@ -274,7 +392,16 @@ void Nokia5110_Init(void){
   P9->SEL1 &= ~(DC_BIT|RESET_BIT);      // configure P9.3 and P9.6 as GPIO (Reset and D/C pins)
   P9->DIR |= (DC_BIT|RESET_BIT);        // make P9.3 and P9.6 out (Reset and D/C pins)
   EUSCI_A3->CTLW0 &= ~0x0001;           // enable eUSCI module
-  EUSCI_A3->IE &= ~0x0003;              // disable interrupts
+  EUSCI_A3->IE &= ~0x0003;              // disable interrupts, the DMA takes TXIFG
+  DMA_Channel->CH_SRCCFG[TXCHANNEL] = 1;     // channel 6 source 1 is EUSCI_A3 TX
+  DMA_Control->ALTCLR = 1<<TXCHANNEL;        // primary only, basic cycles
+  DMA_Control->USEBURSTCLR = 1<<TXCHANNEL;
+  DMA_Control->PRIOCLR = 1<<TXCHANNEL;
+  DMA_Control->REQMASKCLR = 1<<TXCHANNEL;    // allow TXIFG requests
+  DMA_Channel->INT3_SRCCFG = 0x20|TXCHANNEL; // DMA_INT3 on channel 6 completion
+  // DMA_INT3 is interrupt 31, priority 3
+  NVIC->IP[7] = (NVIC->IP[7]&0x00FFFFFF)|0x60000000;
+  NVIC->ISER[0] = 0x80000000;      // enable interrupt 31 in NVIC
 
   RESET = 0;                            // reset the LCD to a known state, RESET low
   for(delay=0; delay<10; delay=delay+1);// delay minimum 100 ns
@@ -288,6 +415,27 @@ void Nokia5110_Init(void){
 
   lcdcommandwrite(0x20);                // we must send 0x20 before modifying the display control mode
   lcdcommandwrite(0x0C);                // set display control to normal mode: 0x0D for inverse
+  // the display RAM is unknown after reset, so the next flush sends all of it
+  for(bank=0; bank<BANKS; bank=bank+1){
+    DirtyLo[bank] = 0;
+    DirtyHi[bank] = SCREENW-1;
+  }
+  Cursor = 0;
+}
+
+// put a character into Screen at the cursor and advance the cursor
+// seven columns; 84 is twelve characters, so one never spans banks
+static void text(char data){
+  uint8_t glyph[7];
+  const uint8_t *font = Nokia5110_Glyph(data);
+  int i;
+  glyph[0] = 0x00;           // blank vertical line padding
+  for(i=0; i<5; i=i+1){
+    glyph[i+1] = font[i];
+  }
+  glyph[6] = 0x00;           // blank vertical line padding
+  store(Cursor, glyph, 7);
+  Cursor = (Cursor+7)%(SCREENW*BANKS);
 }
 
 //********Nokia5110_OutChar*****************
@@ -299,15 +447,13 @@ void Nokia5110_Init(void){
 // of the character for readability.  Since characters are 8
 // pixels tall and 5 pixels wide, 12 characters fit per row,
 // and there are six rows.
+// The character goes into Screen and out to the LCD by DMA.
 // Inputs: data  character to print
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
-void Nokia5110_OutChar(char data){int i;
-  lcddatawrite(0x00);        // blank vertical line padding
-  for(i=0; i<5; i=i+1){
-    lcddatawrite(ASCII[data - 0x20][i]);
-  }
-  lcddatawrite(0x00);        // blank vertical line padding
+void Nokia5110_OutChar(char data){
+  text(data);
+  Nokia5110_DisplayBuffer();
 }
 
 //********Nokia5110_OutString*****************
@@ -318,8 +464,11 @@ void Nokia5110_OutChar(char data){int i;
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutString(char *ptr){
-// write this code as part of Lab 11
-
+  while(*ptr){
+    text(*ptr);
+    ptr = ptr+1;
+  }
+  Nokia5110_DisplayBuffer();
 }
 
 //********Nokia5110_OutUDec*****************
@@ -329,8 +478,7 @@ void Nokia5110_OutString(char *ptr){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutUDec(uint16_t n){
-// write this code as part of Lab 11
-
+  Format_OutUDecWidth(&Nokia5110_OutString, n, 5);
 }
 
 //********Nokia5110_OutSDec*****************
@@ -340,8 +488,7 @@ void Nokia5110_OutUDec(uint16_t n){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutSDec(int16_t n){
-// write this code as part of Lab 11
-
+  Format_OutSDecWidth(&Nokia5110_OutString, n, 6);
 }
 
 //********Nokia5110_OutUFix1*****************
@@ -378,8 +525,7 @@ void Nokia5110_SetCursor(uint8_t newX, uint8_t newY){
     return;                             // do nothing
   }
   // multiply newX by 7 because each character is 7 columns wide
-  lcdcommandwrite(0x80|(newX*7));       // setting bit 7 updates X-position
-  lcdcommandwrite(0x40|newY);           // setting bit 6 updates Y-position
+  Cursor = SCREENW*newY + newX*7;
 }
 
 //********Nokia5110_Clear*****************
@@ -388,26 +534,31 @@ void Nokia5110_SetCursor(uint8_t newX, uint8_t newY){
 // Inputs: none
 // Outputs: none
 void Nokia5110_Clear(void){
-  int i;
-  for(i=0; i<(MAX_X*MAX_Y/8); i=i+1){
-    lcddatawrite(0x00);
-  }
+  Nokia5110_ClearBuffer();
+  Nokia5110_DisplayBuffer();
   Nokia5110_SetCursor(0, 0);
 }
 
 //********Nokia5110_DrawFullImage*****************
 // Fill the whole screen by drawing a 48x84 bitmap image.
+// The image is copied into Screen, and only the bytes that
+// differ from the display are sent.  Screen itself may have
+// been written directly, so all of it is sent.
 // Inputs: ptr  pointer to 504 byte bitmap
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_DrawFullImage(const uint8_t *ptr){
-  int i;
-  Nokia5110_SetCursor(0, 0);
-  for(i=0; i<(MAX_X*MAX_Y/8); i=i+1){
-    lcddatawrite(ptr[i]);
+  uint32_t bank;
+  for(bank=0; bank<BANKS; bank=bank+1){
+    if(ptr == Screen){
+      dirty(bank, 0, SCREENW-1);
+    }else{
+      store(SCREENW*bank, &ptr[SCREENW*bank], SCREENW);
+    }
   }
+  Nokia5110_DisplayBuffer();
+  Nokia5110_SetCursor(0, 0);
 }
-uint8_t Screen[SCREENW*SCREENH/8]; // buffer stores the next image to be printed on the screen
 
 //********Nokia5110_PrintBMP*****************
 // Bitmaps defined above were created for the LM3S1968 or
@@ -485,6 +636,9 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
       }
     }
   }
+  for(screeny=(ypos-height+1)/8; (screeny<=ypos/8) && (screeny<BANKS); screeny=screeny+1){
+    dirty(screeny, xpos, xpos+width-1);
+  }
 }
 
 //********Nokia5110_ClearBuffer*****************
@@ -492,20 +646,49 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
 // This routine clears that buffer.
 // Inputs: none
 // Outputs: none
-void Nokia5110_ClearBuffer(void){int i;
-  for(i=0; i<SCREENW*SCREENH/8; i=i+1){
-    Screen[i] = 0;              // clear buffer
+void Nokia5110_ClearBuffer(void){
+  uint32_t bank;
+  for(bank=0; bank<BANKS; bank=bank+1){
+    store(SCREENW*bank, 0, SCREENW);  // clear buffer
   }
 }
 
 //********Nokia5110_DisplayBuffer*****************
-// Fill the whole screen by drawing a 48x84 screen image
-// from the RAM buffer.
+// Send the parts of the RAM buffer that changed since
+// they were last sent.  Returns at once; the DMA moves
+// the bytes and DMA_INT3 sets the address of each run.
+// Called during a flush, it starts another one when the
+// first is done.
 // Inputs: none
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_DisplayBuffer(void){
-  Nokia5110_DrawFullImage(Screen);
+  uint32_t bank;
+  long sr = StartCritical();
+  if(FlushBusy){
+    FlushAgain = 1;
+  }else{
+    for(bank=0; bank<BANKS; bank=bank+1){
+      FlushLo[bank] = DirtyLo[bank];
+      FlushHi[bank] = DirtyHi[bank];
+      DirtyLo[bank] = SCREENW;          // clean
+      DirtyHi[bank] = 0;
+    }
+    FlushBank = 0;
+    FlushBusy = 1;
+    flushNext();
+  }
+  EndCritical(sr);
+}
+
+//********Nokia5110_DisplayBusy*****************
+// Check for a flush started by Nokia5110_DisplayBuffer()
+// that is still sending.
+// Inputs: none
+// Outputs: 1 while sending, 0 when the LCD matches the buffer
+//          as it was at the last Nokia5110_DisplayBuffer()
+int Nokia5110_DisplayBusy(void){
+  return FlushBusy;
 }
 
 const unsigned char Masks[8]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80};
@@ -516,7 +699,11 @@ const unsigned char Masks[8]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80};
 //        j  the column index  (0 to 83 in this case), x-coordinate
 // Output: none
 void Nokia5110_ClrPxl(uint32_t i, uint32_t j){
-  Screen[84*(i>>3) + j] &= ~Masks[i&0x07];
+  uint8_t *pt = &Screen[84*(i>>3) + j];
+  if(*pt&Masks[i&0x07]){
+    *pt &= ~Masks[i&0x07];
+    dirty(i>>3, j, j);
+  }
 }
 
 //------------Nokia5110_SetPxl------------
@@ -526,6 +713,9 @@ void Nokia5110_ClrPxl(uint32_t i, uint32_t j){
 //        j  the column index  (0 to 83 in this case), x-coordinate
 // Output: none
 void Nokia5110_SetPxl(uint32_t i, uint32_t j){
-  Screen[84*(i>>3) + j] |= Masks[i&0x07];
+  uint8_t *pt = &Screen[84*(i>>3) + j];
+  if((*pt&Masks[i&0x07]) == 0){
+    *pt |= Masks[i&0x07];
+    dirty(i>>3, j, j);
+  }
 }
-
@@ -3,6 +3,12 @@
  * @brief     Provide simple I/O functions for the Nokia 5110
  * @details   Use eUSCI_A3 to send an 8-bit code to the Nokia5110 48x84
  * pixel LCD to display text, images, or other information.
+ * Everything is drawn into a RAM buffer that mirrors the display,
+ * and the columns that changed are sent by DMA channel 6, so a
+ * refresh costs the CPU a few microseconds for each changed bank
+ * rather than the 1 ms of sending all 504 bytes one at a time.
+ * Text, Nokia5110_Clear() and Nokia5110_DrawFullImage() send at
+ * once; the buffer functions wait for Nokia5110_DisplayBuffer().
  * @version   V1.0
  * @author    Valvano and Nathan Seidle
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -272,16 +278,60 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
 void Nokia5110_ClearBuffer(void);
 
 /**
- * Fill the whole screen by drawing a 48x84 screen image
- * from the RAM buffer.
+ * Send the parts of the RAM buffer that changed since they were
+ * last sent.  This returns at once: the DMA moves the bytes,
+ * and the DMA_INT3 ISR sets the LCD address of each run of
+ * changed columns.  Called while a flush is still sending, it
+ * starts another one when the first is done.
  * @param none
  * @return none
  * @note  LCD is in default horizontal addressing mode (V = 0)
- * @see Nokia5110_PrintBMP(), Nokia5110_ClearBuffer(), Nokia5110_SetPxl()
+ * @see Nokia5110_PrintBMP(), Nokia5110_ClearBuffer(), Nokia5110_DisplayBusy()
  * @brief  Draw internal screen buffer to the display.
  */
 void Nokia5110_DisplayBuffer(void);
 
+/**
+ * Check whether the flush started by Nokia5110_DisplayBuffer()
+ * is still sending, for example to draw the next frame only
+ * once the last one is on the display.
+ * @param none
+ * @return 1 while sending, 0 when the LCD shows the buffer as it
+ * was at the last Nokia5110_DisplayBuffer()
+ * @see Nokia5110_DisplayBuffer()
+ * @brief  Flush in progress
+ */
+int Nokia5110_DisplayBusy(void);
+
+/**
+ * The internal screen buffer, 6 banks of 84 bytes.  Byte
+ * 84*b+x holds column x of rows 8*b to 8*b+7, bit 0 at the
+ * top.  Code that writes it directly calls Nokia5110_Dirty().
+ */
+extern uint8_t Screen[];
+
+/**
+ * Mark columns of one bank of the internal screen buffer as
+ * changed, for code that writes Screen directly.  The next
+ * Nokia5110_DisplayBuffer() sends them.
+ * @param bank  0 to 5, rows 8*bank to 8*bank+7
+ * @param lo    first column, 0 to 83
+ * @param hi    last column, lo to 83
+ * @return none
+ * @see Nokia5110_DisplayBuffer()
+ * @brief  Mark part of the screen buffer to be sent.
+ */
+void Nokia5110_Dirty(uint32_t bank, uint32_t lo, uint32_t hi);
+
+/**
+ * Font of the text functions, 5 columns by 8 rows, for code
+ * that draws text into the internal screen buffer itself.
+ * @param c  character 0x20 to 0x7F, others draw a space
+ * @return pointer to 5 column bytes, bit 0 at the top
+ * @brief  Character bitmap.
+ */
+const uint8_t *Nokia5110_Glyph(char c);
+
 /**
  * Clear the internal screen buffer pixel at (i, j),
  * turning it off.
@@ -0,0 +1,196 @@
+// Odometry.c
+// Runs on any microcontroller
+// Fixed-point dead reckoning from the wheel step counts, with a
+// sine table, covariance growth and a lock-free pose snapshot.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Odometry.h"
+
+// 65536*sin(i*pi/512), a quarter turn in 256 steps and one more
+// entry so the last step can be interpolated
+static const int32_t SinQuarter[258] = {
+  0,402,804,1206,1608,2010,2412,2814,
+  3216,3617,4019,4420,4821,5222,5623,6023,
+  6424,6824,7224,7623,8022,8421,8820,9218,
+  9616,10014,10411,10808,11204,11600,11996,12391,
+  12785,13180,13573,13966,14359,14751,15143,15534,
+  15924,16314,16703,17091,17479,17867,18253,18639,
+  19024,19409,19792,20175,20557,20939,21320,21699,
+  22078,22457,22834,23210,23586,23961,24335,24708,
+  25080,25451,25821,26190,26558,26925,27291,27656,
+  28020,28383,28745,29106,29466,29824,30182,30538,
+  30893,31248,31600,31952,32303,32652,33000,33347,
+  33692,34037,34380,34721,35062,35401,35738,36075,
+  36410,36744,37076,37407,37736,38064,38391,38716,
+  39040,39362,39683,40002,40320,40636,40951,41264,
+  41576,41886,42194,42501,42806,43110,43412,43713,
+  44011,44308,44604,44898,45190,45480,45769,46056,
+  46341,46624,46906,47186,47464,47741,48015,48288,
+  48559,48828,49095,49361,49624,49886,50146,50404,
+  50660,50914,51166,51417,51665,51911,52156,52398,
+  52639,52878,53114,53349,53581,53812,54040,54267,
+  54491,54714,54934,55152,55368,55582,55794,56004,
+  56212,56418,56621,56823,57022,57219,57414,57607,
+  57798,57986,58172,58356,58538,58718,58896,59071,
+  59244,59415,59583,59750,59914,60075,60235,60392,
+  60547,60700,60851,60999,61145,61288,61429,61568,
+  61705,61839,61971,62101,62228,62353,62476,62596,
+  62714,62830,62943,63054,63162,63268,63372,63473,
+  63572,63668,63763,63854,63944,64031,64115,64197,
+  64277,64354,64429,64501,64571,64639,64704,64766,
+  64827,64884,64940,64993,65043,65091,65137,65180,
+  65220,65259,65294,65328,65358,65387,65413,65436,
+  65457,65476,65492,65505,65516,65525,65531,65535,
+  65536,65535
+};
+
+#define TWOPI_Q16 411775          // 2*pi in Q16
+
+static int32_t DistStep;          // mm per step, Q16
+static int32_t TurnStep;          // binary angle per step of difference
+static int64_t InvB;              // 1/wheelbase, Q32
+static int64_t InvB2;             // 1/wheelbase^2, Q32
+static int32_t LeftLast, RightLast;
+static int64_t X, Y;              // mm, Q32
+static uint32_t Theta;
+static int64_t Pxx, Pxy, Pyy, Pxt, Pyt, Ptt; // covariance, mm and rad, Q32
+static uint32_t Updates;
+static volatile uint32_t Seq;     // odd while Published is written
+static volatile struct Pose Published;
+
+// ------------Odometry_Sin------------
+// Sine of a binary angle, quarter-wave table and linear interpolation
+// Input: angle 2^32 per turn
+// Output: sine, Q16
+int32_t Odometry_Sin(uint32_t angle){
+  uint32_t b = angle&0x3FFFFFFF;  // angle into the quadrant
+  uint32_t i, f;
+  int32_t y;
+  if(angle&0x40000000){
+    b = 0x40000000-b;             // second and fourth quadrants mirror the first
+  }
+  i = b>>22;                      // 0 to 256
+  f = (b>>6)&0xFFFF;              // fraction between entries, Q16
+  y = SinQuarter[i]+(int32_t)(((SinQuarter[i+1]-SinQuarter[i])*(int32_t)f)>>16);
+  return (angle&0x80000000) ? -y : y;
+}
+
+// ------------Odometry_Cos------------
+// Cosine of a binary angle
+// Input: angle 2^32 per turn
+// Output: cosine, Q16
+int32_t Odometry_Cos(uint32_t angle){
+  return Odometry_Sin(angle+0x40000000);
+}
+
+// p*k with k in Q16
+static int64_t mulQ16(int64_t p, int32_t k){
+  return (p*k)>>16;
+}
+
+static int32_t saturate(int64_t n){
+  if(n > 0x7FFFFFFF){
+    return 0x7FFFFFFF;
+  }
+  if(n < -0x7FFFFFFF){
+    return -0x7FFFFFFF;
+  }
+  return (int32_t)n;
+}
+
+// copy the state to Published, odd Seq while it is inconsistent
+static void publish(void){
+  Seq = Seq+1;
+  Published.X = (int32_t)(X>>16);
+  Published.Y = (int32_t)(Y>>16);
+  Published.Theta = Theta;
+  Published.Heading = (int32_t)(((int64_t)(int32_t)Theta*TWOPI_Q16)>>32);
+  Published.Pxx = saturate(Pxx>>16);
+  Published.Pxy = saturate(Pxy>>16);
+  Published.Pyy = saturate(Pyy>>16);
+  Published.Ptt = saturate(Ptt>>16);
+  Published.Updates = Updates;
+  Seq = Seq+1;
+}
+
+// ------------Odometry_Init------------
+// Set the geometry, and the pose to the origin heading along X
+// Input: wheelbase circumference in mm, steps per turn,
+//        leftSteps rightSteps current step counts
+// Output: none
+void Odometry_Init(uint32_t wheelbase, uint32_t circumference, uint32_t steps,
+                   int32_t leftSteps, int32_t rightSteps){
+  DistStep = (int32_t)((circumference<<16)/steps);
+  // circumference/(steps*wheelbase) radians, 2^32/(2*pi) per radian
+  TurnStep = (int32_t)(((((uint64_t)circumference<<32)/(steps*wheelbase))<<16)/TWOPI_Q16);
+  InvB = (1LL<<32)/wheelbase;
+  InvB2 = InvB/wheelbase;
+  LeftLast = leftSteps;
+  RightLast = rightSteps;
+  X = Y = 0;
+  Theta = 0;
+  Pxx = Pxy = Pyy = Pxt = Pyt = Ptt = 0;
+  Updates = 0;
+  publish();
+}
+
+// ------------Odometry_Update------------
+// Move the pose by the steps since the last call
+// Input: leftSteps rightSteps step counts
+// Output: none
+void Odometry_Update(int32_t leftSteps, int32_t rightSteps){
+  int32_t dl = leftSteps-LeftLast;
+  int32_t dr = rightSteps-RightLast;
+  int32_t ds, c, s, u, v;
+  uint32_t mid, turn;
+  int64_t ptt, pxt, pyt, sum, diff;
+  LeftLast = leftSteps;
+  RightLast = rightSteps;
+  ds = ((dl+dr)*DistStep)/2;      // mm, Q16
+  turn = (uint32_t)((dr-dl)*TurnStep);
+  mid = Theta+(uint32_t)((int32_t)turn/2);
+  c = Odometry_Cos(mid);
+  s = Odometry_Sin(mid);
+  X = X+(int64_t)ds*c;
+  Y = Y+(int64_t)ds*s;
+  Theta = Theta+turn;
+  // P = F*P*F' with F the Jacobian of the pose in the old pose,
+  // u and v the change of x and y per radian of heading error
+  u = -(int32_t)(((int64_t)ds*s)>>16);
+  v = (int32_t)(((int64_t)ds*c)>>16);
+  ptt = Ptt;
+  pxt = Pxt;
+  pyt = Pyt;
+  Pxx = Pxx+2*mulQ16(pxt, u)+mulQ16(mulQ16(ptt, u), u);
+  Pxy = Pxy+mulQ16(pyt, u)+mulQ16(pxt, v)+mulQ16(mulQ16(ptt, u), v);
+  Pyy = Pyy+2*mulQ16(pyt, v)+mulQ16(mulQ16(ptt, v), v);
+  Pxt = pxt+mulQ16(ptt, u);
+  Pyt = pyt+mulQ16(ptt, v);
+  // plus G*Q*G' with Q the variance of the two wheels' travel
+  sum = (int64_t)((dl < 0) ? -dl : dl)*ODOMETRY_STEPVAR;
+  diff = (int64_t)((dr < 0) ? -dr : dr)*ODOMETRY_STEPVAR;
+  sum = sum+diff;
+  diff = diff-(sum-diff);         // right minus left
+  Pxx = Pxx+mulQ16(mulQ16(sum, c), c)/4;
+  Pxy = Pxy+mulQ16(mulQ16(sum, c), s)/4;
+  Pyy = Pyy+mulQ16(mulQ16(sum, s), s)/4;
+  diff = (diff*InvB)>>32;
+  Pxt = Pxt+mulQ16(diff, c)/2;
+  Pyt = Pyt+mulQ16(diff, s)/2;
+  Ptt = Ptt+((sum*InvB2)>>32);
+  Updates = Updates+1;
+  publish();
+}
+
+// ------------Odometry_Get------------
+// Copy a consistent pose without disabling interrupts
+// Input: pose copy of the pose
+// Output: none
+void Odometry_Get(struct Pose *pose){
+  uint32_t seq;
+  do{
+    seq = Seq;
+    *pose = Published;
+  }while((seq&1) || (seq != Seq));
+}
@@ -0,0 +1,102 @@
+/**
+ * @file      Odometry.h
+ * @brief     Differential-drive dead reckoning in fixed point
+ * @details   Odometry_Update(), called from a periodic task with
+ * the step counts of both tachometers, moves the pose by the steps
+ * since the last call: the distance is the mean of the two wheels
+ * and the turn is their difference over the wheelbase, applied at
+ * the heading half way through the turn. Position is in Q16 mm and
+ * the heading a 32-bit binary angle, 2^32 per turn, so it wraps by
+ * itself. Sine and cosine come from a quarter-wave table with
+ * linear interpolation, good to 2 in 65536; there is no
+ * floating point and no divide in the update.<br>
+ * The covariance of x, y and heading grows with the steps: each
+ * wheel adds ODOMETRY_STEPVAR of variance per step, carried through
+ * the motion as in an extended Kalman filter prediction.<br>
+ * Odometry_Get() copies a consistent pose without disabling
+ * interrupts: the update makes a sequence count odd while it
+ * writes, and the reader copies again if the count was odd or
+ * changed.<br>
+ * This file has no hardware access.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __ODOMETRY_H__ // do not include more than once
+#define __ODOMETRY_H__
+#include <stdint.h>
+
+/**
+ * Variance each step adds to its wheel's travel, mm^2 in Q32
+ * (0.01 mm^2, a standard deviation of 0.1 mm per 0.61 mm step)
+ */
+#define ODOMETRY_STEPVAR 42949673
+
+/**
+ * Binary angle of one degree, 2^32/360
+ */
+#define ODOMETRY_DEGREE 11930465
+
+/**
+ * \struct Pose
+ * \brief Position, heading and covariance at one instant
+ */
+struct Pose{
+  int32_t X;         /**< mm, Q16, forward of the start */
+  int32_t Y;         /**< mm, Q16, left of the start */
+  uint32_t Theta;    /**< heading, 2^32 per turn, counterclockwise */
+  int32_t Heading;   /**< heading in radians, Q16, -pi to pi */
+  int32_t Pxx;       /**< variance of X, mm^2, Q16 */
+  int32_t Pxy;       /**< covariance of X and Y, mm^2, Q16 */
+  int32_t Pyy;       /**< variance of Y, mm^2, Q16 */
+  int32_t Ptt;       /**< variance of the heading, rad^2, Q16 */
+  uint32_t Updates;  /**< calls to Odometry_Update() */
+};
+
+/**
+ * Sine of a binary angle
+ * @param angle 2^32 per turn
+ * @return sine, Q16
+ * @brief  Sine by table
+ */
+int32_t Odometry_Sin(uint32_t angle);
+
+/**
+ * Cosine of a binary angle
+ * @param angle 2^32 per turn
+ * @return cosine, Q16
+ * @brief  Cosine by table
+ */
+int32_t Odometry_Cos(uint32_t angle);
+
+/**
+ * Set the robot geometry and the pose to the origin, heading along X
+ * @param wheelbase distance between the wheels in mm
+ * @param circumference of a wheel in mm
+ * @param steps tachometer steps per wheel turn
+ * @param leftSteps rightSteps current step counts
+ * @return none
+ * @brief  Initialize odometry
+ */
+void Odometry_Init(uint32_t wheelbase, uint32_t circumference, uint32_t steps,
+                   int32_t leftSteps, int32_t rightSteps);
+
+/**
+ * Move the pose to new step counts. Call periodically, often enough
+ * that the heading turns well under a radian between calls.
+ * @param leftSteps rightSteps step counts, as from Tachometer_Get()
+ * @return none
+ * @brief  Update the pose
+ */
+void Odometry_Update(int32_t leftSteps, int32_t rightSteps);
+
+/**
+ * Copy a consistent pose, safe against Odometry_Update() in an
+ * interrupt
+ * @param pose copy of the pose
+ * @return none
+ * @brief  Read the pose
+ */
+void Odometry_Get(struct Pose *pose);
+
+#endif // __ODOMETRY_H__
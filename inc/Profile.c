@@ -0,0 +1,121 @@
+// Profile.c
+// Runs on any microcontroller with floating point
+// Trapezoidal and S-curve motion profiles, planned once and
+// stepped from a periodic interrupt.
+// October 16, 2026
+
+#include <stdint.h>
+#include <math.h>
+#include "../inc/Profile.h"
+
+// times to accelerate from 0 to v with the limits in p
+static void accelTimes(struct Profile *p, float v, float amax){
+  p->V = v;
+  if(p->J == 0){                   // trapezoid
+    p->A = amax;
+    p->Tj = 0;
+    p->Ta = v/amax;
+  }else if(v*p->J >= amax*amax){   // reaches amax
+    p->A = amax;
+    p->Tj = amax/p->J;
+    p->Ta = v/amax+p->Tj;
+  }else{                           // jerk up, then straight down
+    p->Tj = sqrtf(v/p->J);
+    p->A = p->J*p->Tj;
+    p->Ta = 2*p->Tj;
+  }
+}
+
+// ------------Profile_Plan------------
+// Plan a move from rest to rest
+// Input: p profile, distance negative is backward,
+//        vmax amax limits, jmax jerk limit or 0 for a trapezoid,
+//        rate steps per second
+// Output: none
+void Profile_Plan(struct Profile *p, float distance, float vmax, float amax, float jmax, uint32_t rate){
+  float d = fabsf(distance), v;
+  p->Distance = d;
+  p->Sign = (distance < 0) ? -1.0f : 1.0f;
+  p->J = jmax;
+  p->Dt = 1.0f/rate;
+  p->Tick = 0;
+  p->Position = 0;
+  p->Velocity = 0;
+  if(d == 0){
+    p->V = p->A = p->Tj = p->Ta = p->T = 0;
+    p->Ticks = 0;
+    return;
+  }
+  accelTimes(p, vmax, amax);
+  if(vmax*p->Ta > d){              // too short to reach vmax, accelerating and
+    if(jmax == 0){                 // stopping cover v*Ta
+      v = sqrtf(amax*d);
+    }else{
+      v = 0.5f*(sqrtf(amax*amax*amax*amax/(jmax*jmax)+4*amax*d)-amax*amax/jmax);
+      if(v*jmax < amax*amax){      // not even amax
+        v = cbrtf(0.25f*d*d*jmax);
+      }
+    }
+    accelTimes(p, v, amax);
+  }
+  p->T = d/p->V+p->Ta;             // 2*Ta accelerating, d/V-Ta cruising
+  p->Ticks = (uint32_t)ceilf(p->T*rate);
+}
+
+// first Ta of the move, from rest to V
+static void accelAt(const struct Profile *p, float t, float *s, float *v){
+  float u;
+  if(t < p->Tj){                   // jerk up
+    *v = 0.5f*p->J*t*t;
+    *s = p->J*t*t*t/6;
+  }else if(t <= p->Ta-p->Tj){      // constant acceleration
+    u = t-p->Tj;
+    *v = 0.5f*p->A*p->Tj+p->A*u;
+    *s = p->A*p->Tj*p->Tj/6+0.5f*p->A*p->Tj*u+0.5f*p->A*u*u;
+  }else{                           // jerk down, the mirror of jerk up
+    u = p->Ta-t;
+    *v = p->V-0.5f*p->J*u*u;
+    *s = 0.5f*p->V*p->Ta-(p->V*u-p->J*u*u*u/6);
+  }
+}
+
+// ------------Profile_At------------
+// Position and speed of a planned move at any time
+// Input: p profile, t seconds since the start
+// Output: position, velocity signed
+void Profile_At(const struct Profile *p, float t, float *position, float *velocity){
+  float s, v;
+  if(t <= 0){
+    s = v = 0;
+  }else if(t >= p->T){
+    s = p->Distance;
+    v = 0;
+  }else if(t < p->Ta){
+    accelAt(p, t, &s, &v);
+  }else if(t <= p->T-p->Ta){       // cruise
+    s = 0.5f*p->V*p->Ta+p->V*(t-p->Ta);
+    v = p->V;
+  }else{                           // stopping mirrors starting
+    accelAt(p, p->T-t, &s, &v);
+    s = p->Distance-s;
+  }
+  *position = p->Sign*s;
+  *velocity = p->Sign*v;
+}
+
+// ------------Profile_Step------------
+// Advance one step, output in p->Position and p->Velocity
+// Input: p profile
+// Output: 1 while the move continues, 0 on the last step and after
+uint32_t Profile_Step(struct Profile *p){
+  if(p->Tick < p->Ticks){
+    p->Tick = p->Tick+1;
+  }
+  if(p->Tick >= p->Ticks){         // exactly the end, whatever the rounding
+    p->Position = p->Sign*p->Distance;
+    p->Velocity = 0;
+    return 0;
+  }
+  Profile_At(p, p->Tick*p->Dt, &p->Position, &p->Velocity);
+  return 1;
+}
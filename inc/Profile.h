@@ -0,0 +1,79 @@
+/**
+ * @file      Profile.h
+ * @brief     Velocity, acceleration and jerk limited motion profiles
+ * @details   Profile_Plan() plans a move of a given distance once, in
+ * the foreground: the peak speed and acceleration and the times of
+ * the segments. Profile_Step(), called at a fixed rate from a
+ * periodic interrupt, then returns the position and speed the move
+ * should have reached, so the interrupt does no planning.<br>
+ * With a jerk limit the profile is an S-curve of seven segments:
+ * jerk up, constant acceleration, jerk down, cruise, and the same
+ * three mirrored to stop. With no jerk limit it is a trapezoid.
+ * Short moves never reach the speed limit, or with an S-curve even
+ * the acceleration limit, and the peak is lowered to fit. Speed and
+ * acceleration are continuous, and the last step returns exactly
+ * the distance and a speed of 0.<br>
+ * Units are whatever the caller uses, for example mm, mm/s, mm/s^2
+ * and mm/s^3. This file has no hardware access.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __PROFILE_H__ // do not include more than once
+#define __PROFILE_H__
+#include <stdint.h>
+
+/**
+ * \struct Profile
+ * \brief One planned move, set by Profile_Plan()
+ */
+struct Profile{
+  float Distance;    /**< length of the move, positive */
+  float Sign;        /**< 1 forward, -1 backward */
+  float V;           /**< peak speed */
+  float A;           /**< peak acceleration */
+  float J;           /**< jerk, 0 for a trapezoid */
+  float Tj;          /**< time of each jerk segment */
+  float Ta;          /**< time to accelerate from 0 to V */
+  float T;           /**< time of the whole move */
+  float Dt;          /**< time of one step, 1/rate */
+  uint32_t Tick;     /**< steps so far */
+  uint32_t Ticks;    /**< steps in the whole move */
+  float Position;    /**< output of the last step, signed */
+  float Velocity;    /**< output of the last step, signed */
+};
+
+/**
+ * Plan a move from rest to rest
+ * @param p profile to fill in
+ * @param distance length of the move, negative is backward
+ * @param vmax speed limit, above 0
+ * @param amax acceleration limit, above 0
+ * @param jmax jerk limit, 0 for a trapezoid
+ * @param rate Profile_Step() calls per second
+ * @return none
+ * @brief  Plan a move
+ */
+void Profile_Plan(struct Profile *p, float distance, float vmax, float amax, float jmax, uint32_t rate);
+
+/**
+ * Position and speed of a planned move at any time
+ * @param p planned profile
+ * @param t time since the start, clipped to 0 to p->T
+ * @param position signed position
+ * @param velocity signed speed
+ * @return none
+ * @brief  Evaluate a profile
+ */
+void Profile_At(const struct Profile *p, float t, float *position, float *velocity);
+
+/**
+ * Advance one step and set p->Position and p->Velocity. Call at
+ * the rate given to Profile_Plan().
+ * @param p planned profile
+ * @return 1 while the move continues, 0 on the last step and after
+ * @brief  Step a profile
+ */
+uint32_t Profile_Step(struct Profile *p);
+
+#endif // __PROFILE_H__
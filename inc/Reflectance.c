@@ -57,6 +57,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp432.h"
 #include "..\inc\Clock.h"
+#include "..\inc\Reflectance.h"
 
 #define RSLK_MAX 1
 
@@ -68,6 +69,21 @@ void Port5_Init(void);
 void Port7_Init(void);
 void Port7_Output_ChargeCap(void);
 void Port7_InitToInput(void);
+void Reflectance_Timer_Init(void);
+
+// split-phase (Reflectance_Start/Reflectance_End) state, owned by T32_INT2_IRQHandler
+// REFLECTANCE_BLOCKING means a blocking read in the foreground owns P5, P7 and Timer32 Timer 2
+#define REFLECTANCE_IDLE     0
+#define REFLECTANCE_CHARGING 1
+#define REFLECTANCE_DECAYING 2
+#define REFLECTANCE_BLOCKING 3
+volatile uint8_t ReflectanceState = REFLECTANCE_IDLE;
+volatile uint8_t ReflectanceSample[2];  // double buffer, newest is ReflectanceSample[ReflectanceSeq&1]
+volatile uint32_t ReflectanceSeq = 0;   // number of completed scans
+uint32_t ReflectanceDecayTime;          // decay window in us
+uint32_t ReflectanceCyclesPerUs;        // Timer32 counts per us, at the start of the scan
+uint32_t ReflectanceChargeCycles;       // 10 us in Timer32 counts
+uint32_t ReflectanceDecayCycles;        // decay window in Timer32 counts
 
 // ------------Reflectance_Init------------
 // Initialize the GPIO pins associated with the QTR-8RC reflectance sensor.
@@ -77,6 +93,33 @@ void Port7_InitToInput(void);
 // Input: none
 // Output: none
 
+// Take the sensors from REFLECTANCE_IDLE to the given state.
+// The test and set run with interrupts disabled, so a blocking read
+// and a Reflectance_Start() from an interrupt cannot both win.
+// Input: state is REFLECTANCE_CHARGING or REFLECTANCE_BLOCKING
+// Output: 1 if the sensors were idle and are now owned, 0 if busy
+static uint8_t reflectanceClaim(uint8_t state){
+  uint32_t primask;
+  uint8_t ok = 0;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if(ReflectanceState == REFLECTANCE_IDLE){
+    ReflectanceState = state;
+    ok = 1;
+  }
+  __set_PRIMASK(primask);
+  return ok;
+}
+
+// Timer32 runs from MCLK, so the counts are worked out again at the
+// start of every scan; Clock_Init48MHz() may come before or after
+// Reflectance_Init().
+static void reflectanceClock(void){
+  ReflectanceCyclesPerUs = Clock_GetFreq()/1000000;
+  ReflectanceChargeCycles = 10*ReflectanceCyclesPerUs;
+  ReflectanceDecayCycles = ReflectanceDecayTime*ReflectanceCyclesPerUs;
+}
+
 void Reflectance_Init(void){
     Port5_Init();
     Port7_Init();
@@ -84,6 +127,7 @@ void Reflectance_Init(void){
     //RSLK-MAX
     Port9_Init();
 #endif
+    Reflectance_Timer_Init();
 }
 // Initialisation Step 1.
 // Initialise Port 5 and Port 9 for Reflectance Sensing
@@ -155,10 +199,17 @@ void Port7_InitToInput(void){
 // Input: time to wait in usec
 // Output: sensor readings
 // Assumes: Reflectance_Init() has been called
-uint8_t Reflectance_Read(uint32_t time){
+// Reflectance_Start() skips its scan while this owns the sensors.
+// Output: REFLECTANCE_BUSY instead if a split-phase scan is in
+//         progress; waiting for it here would never end when called
+//         from an interrupt that preempts T32_INT2_IRQHandler
+int Reflectance_Read(uint32_t time){
   uint8_t result;
   // write this as part of Lab 2
   // Translate Step 1-8 of the reflectance read procedure to code.
+  if(reflectanceClaim(REFLECTANCE_BLOCKING) == 0){
+    return REFLECTANCE_BUSY;
+  }
 
   // Step1.  RSLK-MAX. P5.3 = HIGH and P9.2 = HIGH => IR LED ON
   P5->OUT |= 0x08;
@@ -172,8 +223,7 @@ uint8_t Reflectance_Read(uint32_t time){
   result = P7->IN;
   P5->OUT &= ~0x08;
   P9->OUT &= ~0x04;
-
-  // ....
+  ReflectanceState = REFLECTANCE_IDLE;
 
   return result;
 }
@@ -187,67 +237,310 @@ uint8_t Reflectance_Read(uint32_t time){
 // Read sensors
 // Turn off the 8 IR LEDs
 // Input: time to wait in usec
-// Output: 0 (off road), 1 off to left, 2 off to right, 3 on road
+// Output: 0 (off road), 1 off to left, 2 off to right, 3 on road,
+//         or REFLECTANCE_BUSY
 // (Left,Right) Sensors
 // 1,1          both sensors   on line
 // 0,1          just right     off to left
 // 1,0          left left      off to right
 // 0,0          neither        lost
 // Assumes: Reflectance_Init() has been called
-uint8_t Reflectance_Center(uint32_t time){
-    uint8_t result;
+int Reflectance_Center(uint32_t time){
+    int result;
     // write this as part of Lab 2
     // Use bit shifting and extraction to shift the center two bits to the
     // right to occupy the last two bits of the result variable
     result = Reflectance_Read(time);
+    if(result == REFLECTANCE_BUSY){
+        return result;
+    }
     result = result >> 3;
     result &= 0x03;
     return result;
 }
 
 
+// Sensor integration table, one entry per 8-bit reading.
+// position is the weighted average of the weights
+//   W[8] = {332, 237, 142, 47, -47, -142, -237, -332}
+// over the black bits, truncated toward zero exactly like the
+// C division num/den; it is 0 when no bit is set.
+// count is the number of black bits.
+// code classifies the pattern, see enum ReflectanceCode.
+// Generated offline from the W[] loop that Reflectance_Position
+// used to run on every call; regenerate it if W[] changes.
+#define OFF REFLECTANCE_OFFLINE
+#define LN  REFLECTANCE_LINE
+#define WD  REFLECTANCE_WIDE
+#define SP  REFLECTANCE_SPLIT
+const struct ReflectanceInfo ReflectanceTable[256] = {
+  {   0,0,OFF},{ 332,1,LN },{ 237,1,LN },{ 284,2,LN }, // 0x00-0x03
+  { 142,1,LN },{ 237,2,SP },{ 189,2,LN },{ 237,3,LN }, // 0x04-0x07
+  {  47,1,LN },{ 189,2,SP },{ 142,2,SP },{ 205,3,SP }, // 0x08-0x0B
+  {  94,2,LN },{ 173,3,SP },{ 142,3,LN },{ 189,4,LN }, // 0x0C-0x0F
+  { -47,1,LN },{ 142,2,SP },{  95,2,SP },{ 174,3,SP }, // 0x10-0x13
+  {  47,2,SP },{ 142,3,SP },{ 110,3,SP },{ 166,4,SP }, // 0x14-0x17
+  {   0,2,LN },{ 110,3,SP },{  79,3,SP },{ 142,4,SP }, // 0x18-0x1B
+  {  47,3,LN },{ 118,4,SP },{  94,4,LN },{ 142,5,WD }, // 0x1C-0x1F
+  {-142,1,LN },{  95,2,SP },{  47,2,SP },{ 142,3,SP }, // 0x20-0x23
+  {   0,2,SP },{ 110,3,SP },{  79,3,SP },{ 142,4,SP }, // 0x24-0x27
+  { -47,2,SP },{  79,3,SP },{  47,3,SP },{ 118,4,SP }, // 0x28-0x2B
+  {  15,3,SP },{  94,4,SP },{  71,4,SP },{ 123,5,SP }, // 0x2C-0x2F
+  { -94,2,LN },{  47,3,SP },{  16,3,SP },{  95,4,SP }, // 0x30-0x33
+  { -15,3,SP },{  71,4,SP },{  47,4,SP },{ 104,5,SP }, // 0x34-0x37
+  { -47,3,LN },{  47,4,SP },{  23,4,SP },{  85,5,SP }, // 0x38-0x3B
+  {   0,4,LN },{  66,5,SP },{  47,5,WD },{  94,6,WD }, // 0x3C-0x3F
+  {-237,1,LN },{  47,2,SP },{   0,2,SP },{ 110,3,SP }, // 0x40-0x43
+  { -47,2,SP },{  79,3,SP },{  47,3,SP },{ 118,4,SP }, // 0x44-0x47
+  { -95,2,SP },{  47,3,SP },{  15,3,SP },{  94,4,SP }, // 0x48-0x4B
+  { -16,3,SP },{  71,4,SP },{  47,4,SP },{ 104,5,SP }, // 0x4C-0x4F
+  {-142,2,SP },{  16,3,SP },{ -15,3,SP },{  71,4,SP }, // 0x50-0x53
+  { -47,3,SP },{  47,4,SP },{  23,4,SP },{  85,5,SP }, // 0x54-0x57
+  { -79,3,SP },{  23,4,SP },{   0,4,SP },{  66,5,SP }, // 0x58-0x5B
+  { -23,4,SP },{  47,5,SP },{  28,5,SP },{  79,6,SP }, // 0x5C-0x5F
+  {-189,2,LN },{ -15,3,SP },{ -47,3,SP },{  47,4,SP }, // 0x60-0x63
+  { -79,3,SP },{  23,4,SP },{   0,4,SP },{  66,5,SP }, // 0x64-0x67
+  {-110,3,SP },{   0,4,SP },{ -23,4,SP },{  47,5,SP }, // 0x68-0x6B
+  { -47,4,SP },{  28,5,SP },{   9,5,SP },{  63,6,SP }, // 0x6C-0x6F
+  {-142,3,LN },{ -23,4,SP },{ -47,4,SP },{  28,5,SP }, // 0x70-0x73
+  { -71,4,SP },{   9,5,SP },{  -9,5,SP },{  47,6,SP }, // 0x74-0x77
+  { -94,4,LN },{  -9,5,SP },{ -28,5,SP },{  31,6,SP }, // 0x78-0x7B
+  { -47,5,WD },{  15,6,SP },{   0,6,WD },{  47,7,WD }, // 0x7C-0x7F
+  {-332,1,LN },{   0,2,SP },{ -47,2,SP },{  79,3,SP }, // 0x80-0x83
+  { -95,2,SP },{  47,3,SP },{  15,3,SP },{  94,4,SP }, // 0x84-0x87
+  {-142,2,SP },{  15,3,SP },{ -16,3,SP },{  71,4,SP }, // 0x88-0x8B
+  { -47,3,SP },{  47,4,SP },{  23,4,SP },{  85,5,SP }, // 0x8C-0x8F
+  {-189,2,SP },{ -15,3,SP },{ -47,3,SP },{  47,4,SP }, // 0x90-0x93
+  { -79,3,SP },{  23,4,SP },{   0,4,SP },{  66,5,SP }, // 0x94-0x97
+  {-110,3,SP },{   0,4,SP },{ -23,4,SP },{  47,5,SP }, // 0x98-0x9B
+  { -47,4,SP },{  28,5,SP },{   9,5,SP },{  63,6,SP }, // 0x9C-0x9F
+  {-237,2,SP },{ -47,3,SP },{ -79,3,SP },{  23,4,SP }, // 0xA0-0xA3
+  {-110,3,SP },{   0,4,SP },{ -23,4,SP },{  47,5,SP }, // 0xA4-0xA7
+  {-142,3,SP },{ -23,4,SP },{ -47,4,SP },{  28,5,SP }, // 0xA8-0xAB
+  { -71,4,SP },{   9,5,SP },{  -9,5,SP },{  47,6,SP }, // 0xAC-0xAF
+  {-173,3,SP },{ -47,4,SP },{ -71,4,SP },{   9,5,SP }, // 0xB0-0xB3
+  { -94,4,SP },{  -9,5,SP },{ -28,5,SP },{  31,6,SP }, // 0xB4-0xB7
+  {-118,4,SP },{ -28,5,SP },{ -47,5,SP },{  15,6,SP }, // 0xB8-0xBB
+  { -66,5,SP },{   0,6,SP },{ -15,6,SP },{  33,7,SP }, // 0xBC-0xBF
+  {-284,2,LN },{ -79,3,SP },{-110,3,SP },{   0,4,SP }, // 0xC0-0xC3
+  {-142,3,SP },{ -23,4,SP },{ -47,4,SP },{  28,5,SP }, // 0xC4-0xC7
+  {-174,3,SP },{ -47,4,SP },{ -71,4,SP },{   9,5,SP }, // 0xC8-0xCB
+  { -95,4,SP },{  -9,5,SP },{ -28,5,SP },{  31,6,SP }, // 0xCC-0xCF
+  {-205,3,SP },{ -71,4,SP },{ -94,4,SP },{  -9,5,SP }, // 0xD0-0xD3
+  {-118,4,SP },{ -28,5,SP },{ -47,5,SP },{  15,6,SP }, // 0xD4-0xD7
+  {-142,4,SP },{ -47,5,SP },{ -66,5,SP },{   0,6,SP }, // 0xD8-0xDB
+  { -85,5,SP },{ -15,6,SP },{ -31,6,SP },{  20,7,SP }, // 0xDC-0xDF
+  {-237,3,LN },{ -94,4,SP },{-118,4,SP },{ -28,5,SP }, // 0xE0-0xE3
+  {-142,4,SP },{ -47,5,SP },{ -66,5,SP },{   0,6,SP }, // 0xE4-0xE7
+  {-166,4,SP },{ -66,5,SP },{ -85,5,SP },{ -15,6,SP }, // 0xE8-0xEB
+  {-104,5,SP },{ -31,6,SP },{ -47,6,SP },{   6,7,SP }, // 0xEC-0xEF
+  {-189,4,LN },{ -85,5,SP },{-104,5,SP },{ -31,6,SP }, // 0xF0-0xF3
+  {-123,5,SP },{ -47,6,SP },{ -63,6,SP },{  -6,7,SP }, // 0xF4-0xF7
+  {-142,5,WD },{ -63,6,SP },{ -79,6,SP },{ -20,7,SP }, // 0xF8-0xFB
+  { -94,6,WD },{ -33,7,SP },{ -47,7,WD },{   0,8,WD }  // 0xFC-0xFF
+};
+#undef OFF
+#undef LN
+#undef WD
+#undef SP
+
 // Perform sensor integration
 // Input: data is 8-bit result from line sensor
 // Output: position in 0.1mm relative to center of line
 int32_t Reflectance_Position(uint8_t data){
-    uint32_t position;
-
     // write this as part of Lab 2
     // Extract the appropriate bits from the reflectance read data
     // to multiply to the corresponding weights in W[].
-    // Bit shifting and extraction.
-    int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
-      int32_t num = 0;  // Numerator
-      int32_t den = 0;  // Denominator (# black readings)
-      for (int i = 0; i < 8; i++) {
-        int32_t b = (data >> i) & 0x01;  // Extract bit i
-        num += b * W[i];
-        den += b;
+    // The weighted average is precomputed in ReflectanceTable[].
+    return ReflectanceTable[data].position;
+}
+
+// Number of black sensors
+// Input: data is 8-bit result from line sensor
+// Output: 0 to 8
+uint8_t Reflectance_Count(uint8_t data){
+    return ReflectanceTable[data].count;
+}
+
+// Classify the line sensor pattern
+// Input: data is 8-bit result from line sensor
+// Output: enum ReflectanceCode, REFLECTANCE_OFFLINE to REFLECTANCE_SPLIT
+uint8_t Reflectance_Code(uint8_t data){
+    return ReflectanceTable[data].code;
+}
+
+
+// ------------Reflectance_ReadTimes------------
+// Read the eight sensors as decay times instead of bits
+// Turn on the 8 IR LEDs
+// Pulse the 8 sensors high for 10 us
+// Make the sensor pins input
+// Poll P7 until every pin has fallen or the budget runs out,
+//   recording when each pin first reads low
+// Turn off the 8 IR LEDs
+// Timer32 Timer 2 runs free (no interrupt) as the timebase, so
+// nothing is measured while a Reflectance_Start/Reflectance_End
+// scan owns the sensors; try again after Reflectance_End.
+// Each poll is a few bus cycles, so the resolution is well under
+// 1 us at 48 MHz; interrupts taken during the scan only delay the
+// times of pins that fall while the ISR runs.
+// Input: times is an 8 element array, times[i] is the decay time of
+//          P7.i in us, white reads short, black reads long
+//        budget is the longest time to poll in us, at most 65535
+//          (larger values are cut to 65535, the most times[] holds);
+//          pins that are still high at the end report budget
+// Output: pins still high at the end of the budget, same format
+//         as Reflectance_Read(budget), or REFLECTANCE_BUSY if a
+//         scan is in progress (times[] is not changed)
+// Assumes: Reflectance_Init() has been called
+int Reflectance_ReadTimes(uint16_t times[8], uint32_t budget){
+  uint32_t cycles[8];
+  uint32_t start, now, limit;
+  uint8_t high, in, fell;
+  int i;
+  if(reflectanceClaim(REFLECTANCE_BLOCKING) == 0){
+    return REFLECTANCE_BUSY;
+  }
+  if(budget > 65535){
+    budget = 65535;
+  }
+  reflectanceClock();
+  limit = budget*ReflectanceCyclesPerUs;
+  P5->OUT |= 0x08;
+#if(RSLK_MAX)
+  P9->OUT |= 0x04;
+#endif
+  Port7_Output_ChargeCap();
+  Clock_Delay1us(10);
+  TIMER32_2->CONTROL = 0;
+  TIMER32_2->LOAD = 0xFFFFFFFF;
+  TIMER32_2->CONTROL = 0x00000082;     // enable, free-running, 32-bit, no interrupt
+  Port7_InitToInput();
+  start = TIMER32_2->VALUE;            // counts down
+  high = 0xFF;
+  do{
+    in = P7->IN;
+    now = start - TIMER32_2->VALUE;
+    fell = high&~in;
+    if(fell){                          // at most 8 times per scan
+      high &= ~fell;
+      for(i=0; i<8; i++){
+        if(fell&(1<<i)){
+          cycles[i] = now;
+        }
       }
-      if (den == 0) return 0;  // Off line
-      return num / den;
+    }
+  }while(high && (now < limit));
+  TIMER32_2->CONTROL = 0;
+  P5->OUT &= ~0x08;
+#if(RSLK_MAX)
+  P9->OUT &= ~0x04;
+#endif
+  ReflectanceState = REFLECTANCE_IDLE;
+  for(i=0; i<8; i++){
+    if(high&(1<<i)){
+      times[i] = budget;
+    }else{
+      times[i] = cycles[i]/ReflectanceCyclesPerUs;
+    }
+  }
+  return high;
+}
+
+// Perform sensor integration on decay times
+// Each sensor is weighted by how much longer than the white
+// level it took to decay, so a line between two sensors lands
+// between their weights instead of snapping to one of them.
+// Input: times is the 8 element result of Reflectance_ReadTimes
+//        white is the decay time in us of a white surface;
+//          shorter times count as no line
+// Output: position in 0.1mm relative to center of line
+int32_t Reflectance_PositionTimes(const uint16_t times[8], uint16_t white){
+  static const int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+  int32_t num = 0;  // Numerator
+  int32_t den = 0;  // Denominator (total darkness)
+  int32_t d;
+  int i;
+  for(i=0; i<8; i++){
+    d = (int32_t)times[i] - white;
+    if(d > 0){
+      num += d*W[i];
+      den += d;
+    }
+  }
+  if(den == 0) return 0;  // Off line
+  return num/den;
+}
+
+// ------------Reflectance_Timer_Init------------
+// Configure Timer32 Timer 2 as the one-shot timebase for
+// Reflectance_Start/Reflectance_End.
+// Input: none
+// Output: none
+void Reflectance_Timer_Init(void){
+    TIMER32_2->CONTROL = 0;                       // disable during setup
+    TIMER32_2->INTCLR = 0x00000001;               // clear Timer32 Timer 2 interrupt
+    ReflectanceState = REFLECTANCE_IDLE;
+    Reflectance_SetTime(REFLECTANCE_DEFAULTTIME);
+    // priority 3, one below the TimerA/Timer32 periodic tasks
+    NVIC->IP[6] = (NVIC->IP[6]&0xFF00FFFF)|0x00600000;
+    NVIC->ISER[0] = 0x04000000;                   // enable interrupt 26 in NVIC
 }
 
+// ------------Reflectance_SetTime------------
+// Set the decay window used by Reflectance_Start.
+// Input: time to wait in usec
+// Output: none
+void Reflectance_SetTime(uint32_t time){
+    ReflectanceDecayTime = time;
+}
+
+// arm Timer32 Timer 2 for one shot of the given number of bus cycles
+static void reflectanceTimerArm(uint32_t cycles){
+    // bits31-8=X...X,   reserved
+    // bit7=1,           timer enable
+    // bit6=0,           free-running mode
+    // bit5=1,           interrupt enable
+    // bit4=X,           reserved
+    // bits3-2=00,       input clock divider /1
+    // bit1=1,           32-bit counter
+    // bit0=1,           one-shot mode
+    TIMER32_2->CONTROL = 0;
+    TIMER32_2->LOAD = cycles;
+    TIMER32_2->CONTROL = 0x000000A3;
+}
 
 // ------------Reflectance_Start------------
 // Begin the process of reading the eight sensors
 // Turn on the 8 IR LEDs
-// Pulse the 8 sensors high for 10 us
-// Make the sensor pins input
+// Charge the 8 sensors high and arm Timer32 Timer 2
+// The rest of the scan runs in T32_INT2_IRQHandler:
+//   after 10 us the pins are made input,
+//   after the decay time P7->IN is latched and the LEDs turned off.
+// Does nothing while a scan or a blocking read owns the sensors;
+// Reflectance_End then returns the previous scan.
 // Input: none
 // Output: none
 // Assumes: Reflectance_Init() has been called
 void Reflectance_Start(void){
     // write this as part of Lab 3
     // Step 1-4 of the Reflectance Read in Lab2.
-
+    if(reflectanceClaim(REFLECTANCE_CHARGING) == 0){
+        return;
+    }
+    reflectanceClock();
+    P5->OUT |= 0x08;
+#if(RSLK_MAX)
+    P9->OUT |= 0x04;
+#endif
+    Port7_Output_ChargeCap();
+    reflectanceTimerArm(ReflectanceChargeCycles);
 }
 
 
 // ------------Reflectance_End------------
 // Finish reading the eight sensors
-// Read sensors
-// Turn off the 8 IR LEDs
+// Return the most recent completed scan, does not wait
 // Input: none
 // Output: sensor readings
 // Assumes: Reflectance_Init() has been called
@@ -256,10 +549,51 @@ uint8_t Reflectance_End(void){
     uint8_t result;
     // write this as part of Lab 3
     // Step 6-7 of Reflectance Read in Lab2.
-
+    result = ReflectanceSample[ReflectanceSeq&1];
     return result;
 }
 
+// ------------Reflectance_Latest------------
+// Return the most recent completed scan and its sequence number.
+// The sequence number only changes when a new scan is latched,
+// so a caller can tell a fresh sample from a repeated one.
+// Input: seq is where to store the sequence number (may be 0)
+// Output: sensor readings
+uint8_t Reflectance_Latest(uint32_t *seq){
+    uint32_t n;
+    uint8_t result;
+    do{
+        n = ReflectanceSeq;
+        result = ReflectanceSample[n&1];
+    }while(n != ReflectanceSeq);  // ISR latched a new scan in between
+    if(seq){
+        *seq = n;
+    }
+    return result;
+}
 
+// ------------Reflectance_Busy------------
+// Input: none
+// Output: nonzero while a split-phase scan or a blocking read is in progress
+uint8_t Reflectance_Busy(void){
+    return (ReflectanceState != REFLECTANCE_IDLE);
+}
 
-
+void T32_INT2_IRQHandler(void){
+    TIMER32_2->INTCLR = 0x00000001;      // acknowledge Timer32 Timer 2 interrupt
+    if(ReflectanceState == REFLECTANCE_CHARGING){
+        Port7_InitToInput();             // Step 4, let the capacitors decay
+        ReflectanceState = REFLECTANCE_DECAYING;
+        reflectanceTimerArm(ReflectanceDecayCycles);
+    }
+    else if(ReflectanceState == REFLECTANCE_DECAYING){
+        ReflectanceSample[(ReflectanceSeq+1)&1] = P7->IN;   // Step 6, into the idle buffer
+        ReflectanceSeq = ReflectanceSeq+1;                  // then publish it
+        P5->OUT &= ~0x08;                                   // Step 7, IR LEDs off
+#if(RSLK_MAX)
+        P9->OUT &= ~0x04;
+#endif
+        ReflectanceState = REFLECTANCE_IDLE;
+        TIMER32_2->CONTROL = 0;
+    }
+}
@@ -96,11 +96,17 @@ void Reflectance_Init(void);
   5) Read sensors (white is 0, black is 1)<br>
   6) Turn off the 8 IR LEDs<br>
  * @param  time delay value in us
- * @return 8-bit result
+ * @return 8-bit result, or REFLECTANCE_BUSY if a Reflectance_Start() scan is in progress
  * @note Assumes Reflectance_Init() has been called
  * @brief  Read the eight sensors.
  */
-uint8_t Reflectance_Read(uint32_t time);
+int Reflectance_Read(uint32_t time);
+
+/**
+ * Reflectance_Read(), Reflectance_Center() and Reflectance_ReadTimes()
+ * result when the sensors are in use and nothing was measured.
+ */
+#define REFLECTANCE_BUSY (-1)
 
 /**
  * <b>Read the two center sensors</b>:<br>
@@ -119,11 +125,12 @@ uint8_t Reflectance_Read(uint32_t time);
 <tr><td>0,0          <td>neither        <td>lost
 </table>
  * @param  time delay value in us
- * @return 2-bit result, 0 (off road), 1 off to left, 2 off to right, 3 on road
+ * @return 2-bit result, 0 (off road), 1 off to left, 2 off to right, 3 on road,
+ *         or REFLECTANCE_BUSY
  * @note Assumes Reflectance_Init() has been called
  * @brief  Read the two center sensors.
 */
-uint8_t Reflectance_Center(uint32_t time);
+int Reflectance_Center(uint32_t time);
 
 
 /**
@@ -143,18 +150,107 @@ uint8_t Reflectance_Center(uint32_t time);
  * @param  data is 8-bit result from line sensor
  * @return position in 0.1mm relative to center of line
  * @brief  Perform sensor integration.
- * @note returns 333 if data is zero (off the line)
+ * @note returns 0 if data is zero (off the line)
+ * @note Constant time, a single lookup in ReflectanceTable[]
  * */
 int32_t Reflectance_Position(uint8_t data);
 
+/**
+ * \enum ReflectanceCode
+ * \brief Classification of an 8-bit line sensor reading
+ */
+enum ReflectanceCode{
+  REFLECTANCE_OFFLINE = 0, /**< no sensor sees the line */
+  REFLECTANCE_LINE = 1,    /**< one contiguous group of 1 to 4 sensors, position is reliable */
+  REFLECTANCE_WIDE = 2,    /**< one contiguous group of 5 to 8 sensors, crossing line or parking area */
+  REFLECTANCE_SPLIT = 3    /**< black sensors are not contiguous (e.g. 0x81), fork or noise, position is unreliable */
+};
+
+/**
+ * \struct ReflectanceInfo
+ * \brief Precomputed sensor integration for one 8-bit reading
+ */
+struct ReflectanceInfo{
+  int16_t position; /**< Reflectance_Position() of this reading, 0.1mm */
+  uint8_t count;    /**< number of black sensors, 0 to 8 */
+  uint8_t code;     /**< enum ReflectanceCode */
+};
+
+/**
+ * Sensor integration table indexed by the 8-bit line sensor reading
+ */
+extern const struct ReflectanceInfo ReflectanceTable[256];
+
+/**
+ * Count the black sensors in a reading.
+ * @param  data is 8-bit result from line sensor
+ * @return number of bits set, 0 to 8
+ * @brief  Number of sensors on the line.
+ */
+uint8_t Reflectance_Count(uint8_t data);
+
+/**
+ * Classify a reading, see enum ReflectanceCode.
+ * @param  data is 8-bit result from line sensor
+ * @return REFLECTANCE_OFFLINE, REFLECTANCE_LINE, REFLECTANCE_WIDE or REFLECTANCE_SPLIT
+ * @brief  Confidence in the position of a reading.
+ */
+uint8_t Reflectance_Code(uint8_t data);
+
+/**
+ * <b>Read the eight sensors as decay times</b>:<br>
+  1) Turn on the 8 IR LEDs<br>
+  2) Pulse the 8 sensors high for 10 us<br>
+  3) Make the sensor pins input<br>
+  4) Poll the pins, recording when each one first reads low<br>
+  5) Stop when all pins are low or <b>budget</b> us have passed<br>
+  6) Turn off the 8 IR LEDs<br>
+ * A white surface decays quickly and a black one slowly, so times[]
+ * is an analog-like intensity rather than a single bit per sensor.
+ * @param  times 8 element array, times[i] is the decay time of P7.i in us
+ * @param  budget maximum time to poll in us, at most 65535, pins still high report this value
+ * @return pins still high at the end of the budget, same format as Reflectance_Read(budget),
+ *         or REFLECTANCE_BUSY if a Reflectance_Start() scan is in progress
+ * @note Assumes Reflectance_Init() has been called
+ * @note Blocks for up to budget+10 us; uses Timer32 Timer 2, so it refuses to overlap Reflectance_Start()
+ * @brief  Read the eight sensor decay times.
+ */
+int Reflectance_ReadTimes(uint16_t times[8], uint32_t budget);
+
+/**
+ * <b>Calculate the darkness-weighted average of the decay times</b>:<br>
+ * Same weights and units as Reflectance_Position(), but each sensor
+ * contributes times[i]-white (if positive) instead of 0 or 1,
+ * so the position is resolved between sensors.
+ * @param  times 8 element result of Reflectance_ReadTimes()
+ * @param  white decay time in us of a white surface
+ * @return position in 0.1mm relative to center of line, 0 if no sensor is darker than white
+ * @brief  Perform sensor integration on decay times.
+ */
+int32_t Reflectance_PositionTimes(const uint16_t times[8], uint16_t white);
+
+/**
+ * Default decay window used by Reflectance_Start(), in us.
+ * Together with the 10 us charge pulse it completes before a
+ * Reflectance_End() issued 1 ms after Reflectance_Start().
+ */
+#define REFLECTANCE_DEFAULTTIME 900
+
 /**
  * <b>Begin the process of reading the eight sensors</b>:<br>
   1) Turn on the 8 IR LEDs<br>
   2) Pulse the 8 sensors high for 10 us<br>
   3) Make the sensor pins input<br>
+  4) Wait the decay time set by Reflectance_SetTime()<br>
+  5) Read sensors into the sample buffer (white is 0, black is 1)<br>
+  6) Turn off the 8 IR LEDs<br>
+ * Only step 1 and the start of step 2 run in the caller; the rest
+ * runs in the Timer32 Timer 2 interrupt, so this returns immediately.
  * @param  none
  * @return none
  * @note Assumes Reflectance_Init() has been called
+ * @note Uses Timer32 Timer 2 (interrupt 26, priority 3)
+ * @note Skips the scan if the previous one or a Reflectance_Read() is still in progress
  * @brief  Beging reading the eight sensors.
  */
 void Reflectance_Start(void);
@@ -162,8 +258,9 @@ void Reflectance_Start(void);
 
 /**
  * <b>Finish reading the eight sensors</b>:<br>
-  5) Read sensors (white is 0, black is 1)<br>
-  6) Turn off the 8 IR LEDs<br>
+ * Return the sensor readings latched by the most recent completed
+ * scan (white is 0, black is 1). Does not wait; if the scan started
+ * by Reflectance_Start() is still in progress the previous one is returned.
  * @param  none
  * @return 8-bit result
  * @note Assumes Reflectance_Init() has been called
@@ -172,4 +269,33 @@ void Reflectance_Start(void);
  */
 uint8_t Reflectance_End(void);
 
+/**
+ * Set the decay window used by Reflectance_Start().
+ * @param  time delay value in us
+ * @return none
+ * @note Reflectance_Init() sets this to REFLECTANCE_DEFAULTTIME
+ * @note Converted to timer counts at the start of each scan, from the bus clock at that time
+ * @brief  Set the split-phase decay time.
+ */
+void Reflectance_SetTime(uint32_t time);
+
+/**
+ * Return the most recent completed scan and its sequence number.
+ * The sequence number increments once per scan latched by the interrupt,
+ * so it tells a new sample from one already seen.
+ * @param  seq pointer to where the sequence number is stored, may be 0
+ * @return 8-bit result
+ * @note Assumes Reflectance_Init() has been called
+ * @brief  Read the latest split-phase scan.
+ */
+uint8_t Reflectance_Latest(uint32_t *seq);
+
+/**
+ * Check for a split-phase scan in progress.
+ * @param  none
+ * @return 0 if idle, nonzero if a scan started by Reflectance_Start() or a Reflectance_Read() has not finished
+ * @brief  Split-phase scan status.
+ */
+uint8_t Reflectance_Busy(void);
+
 #endif /* REFLECTANCE_H_ */
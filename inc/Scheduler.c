@@ -0,0 +1,126 @@
+// Scheduler.c
+// Runs on any microcontroller
+// Cooperative scheduler: releases periodic tasks from the tick
+// interrupt and runs them later by priority.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Scheduler.h"
+
+static struct SchedTask *Table;
+static uint32_t NumTasks;
+static uint32_t (*Cycles)(void);
+static volatile uint32_t Now;    // ticks
+static uint32_t NextDue;         // earliest NextRelease in the table
+
+static uint32_t noCycles(void){
+  return 0;
+}
+
+// ------------Scheduler_Init------------
+// Start the scheduler at tick 0
+// Input: table tasks, n number of tasks,
+//        cycles cycle counter for the statistics, 0 for none
+// Output: none
+void Scheduler_Init(struct SchedTask *table, uint32_t n, uint32_t (*cycles)(void)){
+  uint32_t i;
+  Table = table;
+  NumTasks = n;
+  Cycles = cycles ? cycles : noCycles;
+  Now = 0;
+  NextDue = 0xFFFFFFFF;
+  for(i=0; i<n; i++){
+    if(table[i].Period == 0){
+      table[i].Period = 1;
+    }
+    table[i].NextRelease = table[i].Phase;
+    table[i].Released = 0;
+    table[i].Done = 0;
+    if(table[i].Phase < NextDue){
+      NextDue = table[i].Phase;
+    }
+  }
+  Scheduler_ResetStats();
+}
+
+// ------------Scheduler_Tick------------
+// Advance one tick and release the tasks that are due
+// Input: none
+// Output: 1 if anything was released
+uint32_t Scheduler_Tick(void){
+  uint32_t now = Now;             // this tick, the first is tick 0
+  uint32_t next, i;
+  struct SchedTask *t;
+  Now = now+1;
+  if((int32_t)(now-NextDue) < 0){
+    return 0;                      // nothing due, the usual case
+  }
+  next = now+0x7FFFFFFF;
+  for(i=0; i<NumTasks; i++){
+    t = &Table[i];
+    if((int32_t)(now-t->NextRelease) >= 0){
+      if(t->Released != t->Done){
+        t->Overruns = t->Overruns+1; // previous release has not run yet
+      }
+      t->Released = t->Released+1;
+      t->NextRelease = t->NextRelease+t->Period;
+    }
+    if((int32_t)(t->NextRelease-next) < 0){
+      next = t->NextRelease;
+    }
+  }
+  NextDue = next;
+  return 1;
+}
+
+// ------------Scheduler_Run------------
+// Run released tasks by priority until none are left
+// Input: none
+// Output: none
+void Scheduler_Run(void){
+  struct SchedTask *t, *best;
+  uint32_t i, start, elapsed;
+  while(1){
+    best = 0;
+    for(i=0; i<NumTasks; i++){
+      t = &Table[i];
+      if((t->Released != t->Done) && ((best == 0) || (t->Priority < best->Priority))){
+        best = t;
+      }
+    }
+    if(best == 0){
+      return;
+    }
+    best->Done = best->Released;   // run once however many releases were missed
+    start = (*Cycles)();
+    (*best->Task)();
+    elapsed = (*Cycles)()-start;
+    best->Runs = best->Runs+1;
+    best->Cycles = best->Cycles+elapsed;
+    if(elapsed > best->WCET){
+      best->WCET = elapsed;
+    }
+  }
+}
+
+// ------------Scheduler_Now------------
+// Ticks since Scheduler_Init
+// Input: none
+// Output: tick count
+uint32_t Scheduler_Now(void){
+  return Now;
+}
+
+// ------------Scheduler_ResetStats------------
+// Clear the statistics of every task
+// Input: none
+// Output: none
+void Scheduler_ResetStats(void){
+  uint32_t i;
+  for(i=0; i<NumTasks; i++){
+    Table[i].Runs = 0;
+    Table[i].Overruns = 0;
+    Table[i].WCET = 0;
+    Table[i].Cycles = 0;
+  }
+}
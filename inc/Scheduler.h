@@ -0,0 +1,92 @@
+/**
+ * @file      Scheduler.h
+ * @brief     Cooperative scheduler for a static table of periodic tasks
+ * @details   The tick interrupt calls Scheduler_Tick(), which only
+ * compares the tick count with each task's next release time and
+ * counts the release; no modulo, and nothing at all when no task
+ * is due. The tasks run later, to completion, in
+ * Scheduler_Run(), highest priority first. On the robot the tick
+ * ISR pends PendSV, and PendSV_Handler at the lowest priority calls
+ * Scheduler_Run(), so the tick and every other interrupt stay short
+ * and can preempt the tasks.<br>
+ * A task released again before it ran counts an overrun and runs
+ * once, not once per missed release.<br>
+ * Per task the scheduler measures runs, the worst-case execution
+ * time and the total time with a cycle counter supplied by the
+ * caller, so it runs unchanged on a host with a simulated tick.<br>
+ * This file has no hardware access.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __SCHEDULER_H__ // do not include more than once
+#define __SCHEDULER_H__
+#include <stdint.h>
+
+/**
+ * \struct SchedTask
+ * \brief One entry of the task table. The first five fields are
+ * set by the user, the rest by the scheduler.
+ */
+struct SchedTask{
+  const char *Name;          /**< for reports */
+  void (*Task)(void);        /**< function to run */
+  uint32_t Period;           /**< ticks between releases, at least 1 */
+  uint32_t Phase;            /**< tick of the first release */
+  uint32_t Priority;         /**< 0 is the highest */
+  uint32_t NextRelease;      /**< tick of the next release */
+  volatile uint32_t Released;/**< releases, written only by Scheduler_Tick() */
+  uint32_t Done;             /**< releases handled, written only by Scheduler_Run() */
+  uint32_t Runs;             /**< times the task ran */
+  volatile uint32_t Overruns;/**< releases while the previous one was waiting */
+  uint32_t WCET;             /**< longest run in cycles */
+  uint32_t Cycles;           /**< total cycles in the task */
+};
+
+/**
+ * Start the scheduler at tick 0
+ * @param table tasks, kept by the scheduler
+ * @param n number of tasks
+ * @param cycles free-running cycle counter used for the statistics,
+ *        for example DWT->CYCCNT, 0 for no statistics
+ * @return none
+ * @brief  Initialize the scheduler
+ */
+void Scheduler_Init(struct SchedTask *table, uint32_t n, uint32_t (*cycles)(void));
+
+/**
+ * Advance time by one tick and release due tasks. Call from the
+ * tick interrupt.
+ * @param none
+ * @return 1 if a task was released and Scheduler_Run() should be
+ *         triggered, 0 if not
+ * @brief  Tick
+ */
+uint32_t Scheduler_Tick(void);
+
+/**
+ * Run released tasks, highest priority first, until none are left.
+ * Call from PendSV_Handler, or from a loop on a host.
+ * @param none
+ * @return none
+ * @brief  Run released tasks
+ */
+void Scheduler_Run(void);
+
+/**
+ * Ticks since Scheduler_Init()
+ * @param none
+ * @return tick count
+ * @brief  Current tick
+ */
+uint32_t Scheduler_Now(void);
+
+/**
+ * Clear the run, overrun and time statistics of every task
+ * @param none
+ * @return none
+ * @brief  Reset statistics
+ */
+void Scheduler_ResetStats(void);
+
+#endif // __SCHEDULER_H__
@@ -0,0 +1,228 @@
+// SpeedControl.c
+// Runs on MSP432
+// Per-wheel PI speed control with feed-forward, using the
+// tachometer periods and a reciprocal table instead of a divide.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Motor.h"
+#include "../inc/Tachometer.h"
+#include "../inc/SpeedControl.h"
+
+// 2^32/(32768+256*i), 1/m for m = 2^15 to 2^16 in 128 steps
+static const uint32_t Reciprocal[129] = {
+  131072,130056,129056,128070,127100,126144,125203,124276,
+  123362,122461,121574,120699,119837,118987,118149,117323,
+  116508,115705,114912,114131,113360,112599,111848,111107,
+  110376,109655,108943,108240,107546,106861,106185,105517,
+  104858,104206,103563,102928,102300,101680,101068,100462,
+  99864,99273,98690,98112,97542,96978,96421,95870,
+  95325,94787,94254,93727,93207,92692,92183,91679,
+  91181,90688,90200,89718,89241,88768,88301,87839,
+  87381,86929,86480,86037,85598,85164,84733,84308,
+  83886,83469,83056,82646,82241,81840,81443,81049,
+  80660,80274,79892,79513,79138,78766,78398,78034,
+  77672,77314,76960,76608,76260,75915,75573,75234,
+  74898,74565,74235,73908,73584,73263,72944,72629,
+  72316,72005,71698,71392,71090,70790,70493,70198,
+  69905,69615,69327,69042,68759,68478,68200,67924,
+  67650,67378,67109,66841,66576,66313,66052,65793,
+  65536
+};
+
+// Measured on the floor with a charged battery, see SpeedControl.h
+uint16_t SpeedFeedForward[SPEED_FFSIZE] = {
+  1250, 2583, 3917, 5250, 6583, 7917, 9250, 10583, 11917, 13250
+};
+
+struct SpeedPI SpeedLeftPI = {5120, 512, 0};   // Kp = 20, Ki = 2, tuned with tools/speedsim
+struct SpeedPI SpeedRightPI = {5120, 512, 0};
+volatile int32_t SpeedLeftSetpoint, SpeedRightSetpoint;  // mm/s
+volatile int32_t SpeedLeft, SpeedRight;                  // measured mm/s
+
+// ------------SpeedControl_Divide------------
+// k/period from the reciprocal table, no divide instruction
+// Input: k below 2^31, period any 32-bit value
+// Output: k/period, 0 if period is 0
+uint32_t SpeedControl_Divide(uint32_t k, uint32_t period){
+  uint32_t m = period, i, f, r;
+  int32_t s = 0;
+  if(period == 0){
+    return 0;
+  }
+  // normalize to 2^15 <= m < 2^16, period = m/2^s
+  if(m >= 0x01000000){ m = m>>8; s = s-8; }
+  if(m >= 0x00100000){ m = m>>4; s = s-4; }
+  if(m >= 0x00040000){ m = m>>2; s = s-2; }
+  if(m >= 0x00020000){ m = m>>1; s = s-1; }
+  if(m >= 0x00010000){ m = m>>1; s = s-1; }
+  if(m < 0x0100){ m = m<<8; s = s+8; }
+  if(m < 0x1000){ m = m<<4; s = s+4; }
+  if(m < 0x4000){ m = m<<2; s = s+2; }
+  if(m < 0x8000){ m = m<<1; s = s+1; }
+  i = (m>>8)-128;
+  f = m&0xFF;
+  r = Reciprocal[i]-(((Reciprocal[i]-Reciprocal[i+1])*f)>>8);  // 2^32/m
+  // k/period = k*2^s/m = k*r/2^(32-s), rounded
+  return (uint32_t)((((uint64_t)k*r)+(1ull<<(31-s)))>>(32-s));
+}
+
+// ------------SpeedControl_PeriodToSpeed------------
+// Tachometer period to mm/s
+// Input: period in 1/12 us
+// Output: speed in mm/s
+uint32_t SpeedControl_PeriodToSpeed(uint32_t period){
+  return SpeedControl_Divide(SPEED_K, period);
+}
+
+// ------------SpeedControl_PeriodToRPM------------
+// Tachometer period to rpm
+// Input: period in 1/12 us
+// Output: speed in rpm
+uint32_t SpeedControl_PeriodToRPM(uint32_t period){
+  return SpeedControl_Divide(RPM_K, period);
+}
+
+// ------------SpeedControl_FeedForward------------
+// Interpolate SpeedFeedForward[] for a speed
+// Input: speed in mm/s, negative is backward
+// Output: duty with the sign of speed
+int32_t SpeedControl_FeedForward(int32_t speed){
+  uint32_t v = (speed < 0) ? (uint32_t)-speed : (uint32_t)speed;
+  uint32_t i = v/SPEED_FFSTEP;     // a shift
+  int32_t duty;
+  if(i >= SPEED_FFSIZE-1){
+    duty = SpeedFeedForward[SPEED_FFSIZE-1];
+  }else{
+    duty = SpeedFeedForward[i]+
+      ((int32_t)(SpeedFeedForward[i+1]-SpeedFeedForward[i])*(int32_t)(v%SPEED_FFSTEP))/SPEED_FFSTEP;
+  }
+  return (speed < 0) ? -duty : duty;
+}
+
+// ------------SpeedControl_PI------------
+// Feed-forward plus PI, limited to the direction of the setpoint
+// Input: c controller, setpoint and measured speed in mm/s
+// Output: duty, negative is backward
+int32_t SpeedControl_PI(struct SpeedPI *c, int32_t setpoint, int32_t measured){
+  int32_t e, u, lo, hi;
+  if(setpoint == 0){
+    c->Integral = 0;
+    return 0;
+  }
+  if(setpoint > 0){                // never drive against the setpoint
+    lo = 0;
+    hi = SPEED_MAXDUTY;
+  }else{
+    lo = -SPEED_MAXDUTY;
+    hi = 0;
+  }
+  e = setpoint-measured;
+  u = SpeedControl_FeedForward(setpoint)+((c->Kp*e+c->Integral)>>8);
+  if((e > SPEED_IBAND) || (e < -SPEED_IBAND)){
+    // large errors are left to P and feed-forward, so starting from
+    // rest does not wind up the integrator
+    e = 0;
+  }
+  if(u > hi){                      // every duty is limited, PWM.c ignores 15000 or more
+    u = hi;
+    if(e < 0){                     // integrate only out of saturation
+      c->Integral = c->Integral+c->Ki*e;
+    }
+  }else if(u < lo){
+    u = lo;
+    if(e > 0){
+      c->Integral = c->Integral+c->Ki*e;
+    }
+  }else{
+    c->Integral = c->Integral+c->Ki*e;
+  }
+  if(c->Integral > (SPEED_MAXDUTY<<8)){
+    c->Integral = SPEED_MAXDUTY<<8;
+  }else if(c->Integral < -(SPEED_MAXDUTY<<8)){
+    c->Integral = -(SPEED_MAXDUTY<<8);
+  }
+  return u;
+}
+
+// signed duty to the four Motor functions
+static void motorOut(int32_t left, int32_t right){
+  if((left == 0) && (right == 0)){
+    Motor_Stop();
+  }else if(left >= 0){
+    if(right >= 0){
+      Motor_Forward(left, right);
+    }else{
+      Motor_Right(left, -right);
+    }
+  }else{
+    if(right >= 0){
+      Motor_Left(-left, right);
+    }else{
+      Motor_Backward(-left, -right);
+    }
+  }
+}
+
+// signed speed from the average period, 0 when stopped
+static int32_t measure(uint32_t period, enum TachDirection dir){
+  uint32_t v = SpeedControl_PeriodToSpeed(period);
+  return (dir == REVERSE) ? -(int32_t)v : (int32_t)v;
+}
+
+// ------------SpeedControl_Init------------
+// Initialize the motors and tachometers, stopped
+// Input: none
+// Output: none
+void SpeedControl_Init(void){
+  Motor_Init();
+  Tachometer_Init();
+  SpeedLeftSetpoint = 0;
+  SpeedRightSetpoint = 0;
+  SpeedLeftPI.Integral = 0;
+  SpeedRightPI.Integral = 0;
+}
+
+static int32_t limit(int32_t v){
+  int32_t max = SPEED_FFSTEP*(SPEED_FFSIZE-1);
+  if(v > max) return max;
+  if(v < -max) return -max;
+  if((v > 0) && (v < SPEED_MIN)) return SPEED_MIN;
+  if((v < 0) && (v > -SPEED_MIN)) return -SPEED_MIN;
+  return v;
+}
+
+// ------------SpeedControl_Set------------
+// Set the wheel speeds
+// Input: left, right in mm/s, negative is backward
+// Output: none
+void SpeedControl_Set(int32_t left, int32_t right){
+  SpeedLeftSetpoint = limit(left);
+  SpeedRightSetpoint = limit(right);
+}
+
+// ------------SpeedControl_Get------------
+// Measured wheel speeds
+// Input: pointers to store left, right in mm/s
+// Output: none
+void SpeedControl_Get(int32_t *left, int32_t *right){
+  *left = SpeedLeft;
+  *right = SpeedRight;
+}
+
+// ------------SpeedControl_Update------------
+// Run both controllers, call at SPEED_RATE Hz
+// Input: none
+// Output: none
+void SpeedControl_Update(void){
+  uint16_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  uint32_t leftPeriod, rightPeriod;
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Tachometer_GetPeriod(&leftPeriod, &rightPeriod);
+  SpeedLeft = measure(leftPeriod, leftDir);
+  SpeedRight = measure(rightPeriod, rightDir);
+  motorOut(SpeedControl_PI(&SpeedLeftPI, SpeedLeftSetpoint, SpeedLeft),
+           SpeedControl_PI(&SpeedRightPI, SpeedRightSetpoint, SpeedRight));
+}
@@ -0,0 +1,168 @@
+/**
+ * @file      SpeedControl.h
+ * @brief     Closed-loop wheel speed control in mm/s
+ * @details   SpeedControl_Update(), called at SPEED_RATE Hz, reads
+ * the tachometers and runs one PI controller per wheel with
+ * feed-forward, so the wheels hold their speed as the battery sags
+ * or the surface changes.<br>
+ * Speed is SPEED_K/period: 360 steps per 220 mm wheel turn, period
+ * in 1/12 us. Instead of a divide, 1/period comes from a 129-entry
+ * reciprocal table indexed by the normalized period and linearly
+ * interpolated, within 0.01%.<br>
+ * Feed-forward is the duty that holds each speed on the floor,
+ * SpeedFeedForward[], every SPEED_FFSTEP mm/s, linearly
+ * interpolated. The PI only corrects the rest. The integrator stops
+ * while the output is saturated in the direction of the error
+ * (anti-windup).<br>
+ * The period is the 32-bit average of Tachometer_GetPeriod(), so
+ * it does not wrap at slow speeds; a wheel with no step for
+ * TACH_TIMEOUT reads as stopped.<br>
+ * Only Motor and Tachometer functions are used, so this file also
+ * runs on a host against a simulated motor (tools/speedsim).
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __SPEEDCONTROL_H__ // do not include more than once
+#define __SPEEDCONTROL_H__
+#include <stdint.h>
+
+/**
+ * Rate SpeedControl_Update() must be called at, in Hz
+ */
+#define SPEED_RATE 100
+
+/**
+ * Speed in mm/s times period in 1/12 us, 220/360*12000000
+ */
+#define SPEED_K 7333333
+
+/**
+ * Wheel rpm times period in 1/12 us, 60/360*12000000
+ */
+#define RPM_K 2000000
+
+/**
+ * Slowest speed held in mm/s, three steps per TACH_TIMEOUT
+ */
+#define SPEED_MIN 20
+
+/**
+ * Errors in mm/s beyond which the integrator holds
+ */
+#define SPEED_IBAND 100
+
+/**
+ * Largest duty cycle
+ */
+#define SPEED_MAXDUTY 14998
+
+/**
+ * Spacing of SpeedFeedForward[] in mm/s, a power of 2
+ */
+#define SPEED_FFSTEP 64
+
+/**
+ * Number of entries in SpeedFeedForward[], 0 to 576 mm/s
+ */
+#define SPEED_FFSIZE 10
+
+/**
+ * Duty that holds 0, 64, 128, ... mm/s with no controller. Measure
+ * on the robot with the controller off and replace.
+ */
+extern uint16_t SpeedFeedForward[SPEED_FFSIZE];
+
+/**
+ * \struct SpeedPI
+ * \brief State of one wheel's PI controller, gains in Q8
+ */
+struct SpeedPI{
+  int32_t Kp;        /**< duty per mm/s of error, Q8 */
+  int32_t Ki;        /**< duty per mm/s of error per sample, Q8 */
+  int32_t Integral;  /**< integrator, duty in Q8 */
+};
+
+/**
+ * 1/period times k without a divide
+ * @param k constant, below 2^31
+ * @param period timer counts
+ * @return k/period, 0 if period is 0
+ * @brief  Reciprocal by table
+ */
+uint32_t SpeedControl_Divide(uint32_t k, uint32_t period);
+
+/**
+ * Convert a tachometer period to wheel speed
+ * @param period time between steps in 1/12 us
+ * @return speed in mm/s, 0 if period is 0
+ * @brief  Period to mm/s
+ */
+uint32_t SpeedControl_PeriodToSpeed(uint32_t period);
+
+/**
+ * Convert a tachometer period to wheel rpm
+ * @param period time between steps in 1/12 us
+ * @return speed in rpm, 0 if period is 0
+ * @brief  Period to rpm
+ */
+uint32_t SpeedControl_PeriodToRPM(uint32_t period);
+
+/**
+ * Duty from SpeedFeedForward[] for a speed
+ * @param speed in mm/s, sign gives the direction
+ * @return duty with the same sign
+ * @brief  Feed-forward duty
+ */
+int32_t SpeedControl_FeedForward(int32_t speed);
+
+/**
+ * One PI step with feed-forward and anti-windup. A setpoint of 0
+ * returns 0 and clears the integrator.
+ * @param c controller state
+ * @param setpoint desired speed in mm/s, negative is backward
+ * @param measured speed in mm/s, negative is backward
+ * @return duty, -SPEED_MAXDUTY to SPEED_MAXDUTY
+ * @brief  PI controller step
+ */
+int32_t SpeedControl_PI(struct SpeedPI *c, int32_t setpoint, int32_t measured);
+
+/**
+ * Initialize the motors and tachometers and stop
+ * @param none
+ * @return none
+ * @note   Call SpeedControl_Update() at SPEED_RATE Hz afterwards,
+ * for example with TimerA1_Init(&SpeedControl_Update, 5000)
+ * @brief  Initialize speed control
+ */
+void SpeedControl_Init(void);
+
+/**
+ * Set the wheel speeds. Speeds between 0 and SPEED_MIN are raised
+ * to SPEED_MIN.
+ * @param left speed in mm/s, negative is backward
+ * @param right speed in mm/s, negative is backward
+ * @return none
+ * @brief  Set speed
+ */
+void SpeedControl_Set(int32_t left, int32_t right);
+
+/**
+ * Measured wheel speeds from the last update
+ * @param left speed in mm/s, negative is backward
+ * @param right speed in mm/s, negative is backward
+ * @return none
+ * @brief  Get speed
+ */
+void SpeedControl_Get(int32_t *left, int32_t *right);
+
+/**
+ * Read the tachometers, run both controllers and set the motors.
+ * Call at SPEED_RATE Hz from a periodic interrupt.
+ * @param none
+ * @return none
+ * @brief  Controller step
+ */
+void SpeedControl_Update(void);
+
+#endif // __SPEEDCONTROL_H__
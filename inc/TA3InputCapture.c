@@ -55,6 +55,9 @@ policies, either expressed or implied, of the FreeBSD Project.
 void ta3dummy(uint16_t t){};       // dummy function
 void (*CaptureTask0)(uint16_t time) = ta3dummy;// user function
 void (*CaptureTask2)(uint16_t time) = ta3dummy;// user function
+void (*Capture32Task0)(uint32_t time);  // user functions of TimerA3Capture_Init32
+void (*Capture32Task2)(uint32_t time);
+volatile uint32_t TimerA3Capture_Overflows;  // upper 16 bits of the 32-bit time
 
 //------------TimerA3Capture_Init------------
 // Initialize Timer A3 in edge time mode to request interrupts on
@@ -151,6 +154,58 @@ void TimerA3Capture_Init(void(*task0)(uint16_t time), void(*task2)(uint16_t time
 
 }
 
+// 32-bit time of a capture. A capture in the first half of the count
+// with the overflow still pending came after the overflow, so its
+// upper half is one more than counted so far.
+static uint32_t extend(uint16_t time){
+  uint32_t high = TimerA3Capture_Overflows;
+  if((TIMER_A3->CTL&0x0001) && (time < 0x8000)){
+    high = high+1;
+  }
+  return (high<<16)|time;
+}
+static void extend0(uint16_t time){
+  (*Capture32Task0)(extend(time));
+}
+static void extend2(uint16_t time){
+  (*Capture32Task2)(extend(time));
+}
+
+//------------TimerA3Capture_Init32------------
+// Same as TimerA3Capture_Init, but the overflow interrupt extends
+// the timer to 32 bits, which wraps after 358 seconds.
+// Input: task0 is a pointer to a user function called when P10.4 (TA3CCP0) edge occurs
+//              parameter is 32-bit up-counting time when the edge occurred (units of 0.083 usec)
+//        task2 is a pointer to a user function called when P8.2 (TA3CCP2) edge occurs
+//              parameter is 32-bit up-counting time when the edge occurred (units of 0.083 usec)
+// Output: none
+// Assumes: low-speed subsystem master clock is 12 MHz
+void TimerA3Capture_Init32(void(*task0)(uint32_t time), void(*task2)(uint32_t time)){
+  Capture32Task0 = task0;
+  Capture32Task2 = task2;
+  TimerA3Capture_Overflows = 0;
+  TimerA3Capture_Init(&extend0, &extend2);
+  TIMER_A3->CTL |= 0x0002;         // bit1=1, interrupt on rollover
+}
+
+//------------TimerA3Capture_Now------------
+// Current 32-bit time of Timer A3, after TimerA3Capture_Init32
+// Input: none
+// Output: time in units of 0.083 usec
+uint32_t TimerA3Capture_Now(void){
+  uint32_t high, pending;
+  uint16_t low;
+  do{
+    high = TimerA3Capture_Overflows;
+    low = TIMER_A3->R;
+    pending = TIMER_A3->CTL&0x0001;  // rolled over, not yet counted
+  }while(high != TimerA3Capture_Overflows);
+  if(pending && (low < 0x8000)){
+    high = high+1;
+  }
+  return (high<<16)|low;
+}
+
 void TA3_0_IRQHandler(void){
   // write this as part of lab 4
     TIMER_A3->CCTL[0] &= ~0x0001;             // acknowledge capture/compare interrupt 0
@@ -160,11 +215,19 @@ void TA3_0_IRQHandler(void){
 void TA3_N_IRQHandler(void){
   // write this as part of lab 4
 #if (RSLK_MAX==0)
+  if(TIMER_A3->CCTL[2]&0x0001){               // capture before rollover, extend() handles both pending
     TIMER_A3->CCTL[2] &= ~0x0001;             // acknowledge capture/compare interrupt 2
     (*CaptureTask2)(TIMER_A3->CCR[2]);         // execute user task
+  }
 #else
+  if(TIMER_A3->CCTL[1]&0x0001){               // capture before rollover, extend() handles both pending
     TIMER_A3->CCTL[1] &= ~0x0001;             // acknowledge capture/compare interrupt 2
     (*CaptureTask2)(TIMER_A3->CCR[1]);         // execute user task
+  }
 #endif
+  if(TIMER_A3->CTL&0x0001){                   // rollover, only with TimerA3Capture_Init32
+    TIMER_A3->CTL &= ~0x0001;                 // acknowledge
+    TimerA3Capture_Overflows = TimerA3Capture_Overflows+1;
+  }
 }
 
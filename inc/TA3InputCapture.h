@@ -72,4 +72,28 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 void TimerA3Capture_Init(void(*task0)(uint16_t time), void(*task2)(uint16_t time));
 
+/**
+ * Same as TimerA3Capture_Init(), but the rollover interrupt extends
+ * Timer A3 to 32 bits, so edges more than 5.46 ms apart are timed
+ * correctly. The 32-bit time wraps after 358 seconds.
+ * @param task0 is a pointer to a user function called when P10.4 (TA3CCP0) edge occurs<br>
+ *        parameter is 32-bit up-counting time when P10.4 (TA3CCP0) edge occurred (units of 0.083 usec)<br>
+ * @param task2 is a pointer to a user function called when P8.2 (TA3CCP2) edge occurs<br>
+ *        parameter is 32-bit up-counting time when P8.2 (TA3CCP2) edge occurred (units of 0.083 usec)
+ * @return none
+ * @note  Assumes low-speed subsystem master clock is 12 MHz
+ * @brief  Initialize Timer A3 with 32-bit times
+ */
+void TimerA3Capture_Init32(void(*task0)(uint32_t time), void(*task2)(uint32_t time));
+
+/**
+ * Current 32-bit time of Timer A3, on the same clock as the
+ * captures of TimerA3Capture_Init32()
+ * @param none
+ * @return time (units of 0.083 usec)
+ * @note  Assumes TimerA3Capture_Init32() has been called
+ * @brief  Read the 32-bit time
+ */
+uint32_t TimerA3Capture_Now(void);
+
 #endif /* TA3INPUTCAPTURE_H_ */
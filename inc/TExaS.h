@@ -2,6 +2,9 @@
  * @file      TExaS.h
  * @brief     Test Execute and Simulate
  * @details   Virtual 7-bit logic analyzer or 8-bit scope sampling J3.26/P4.4/A9
+ * @note      The logic analyzer writes TXBUF without waiting, so samples
+ * are lost whenever the UART is busy. LogicCapture.h is a lossless,
+ * timestamped alternative for up to 16 pins at up to 200 kHz.
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -56,42 +56,100 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "../inc/Clock.h"
 #include "../inc/TA3InputCapture.h"
+#include "../inc/CortexM.h"
 #include "msp.h"
 #include "Tachometer.h"
 
-uint16_t Tachometer_FirstRightTime, Tachometer_SecondRightTime;
-uint16_t Tachometer_FirstLeftTime, Tachometer_SecondLeftTime;
+#define TACH_MASK (TACH_EDGES-1)
+
+// 32-bit capture times of the newest edges of one wheel, all in the
+// same direction
+struct TachEdges{
+  uint32_t Time[TACH_EDGES];
+  uint32_t Newest;                 // index of the newest edge
+  uint32_t Count;                  // edges in Time[], up to TACH_EDGES
+};
+struct TachEdges Tachometer_RightEdges, Tachometer_LeftEdges;
 int Tachometer_RightSteps = 0;     // incremented with every step forward; decremented with every step backward
 int Tachometer_LeftSteps = 0;      // incremented with every step forward; decremented with every step backward
 enum TachDirection Tachometer_RightDir = STOPPED;
 enum TachDirection Tachometer_LeftDir = STOPPED;
 
-void tachometerRightInt(uint16_t currenttime){
-  Tachometer_FirstRightTime = Tachometer_SecondRightTime;
-  Tachometer_SecondRightTime = currenttime;
+// add an edge; after a reversal only the last edge of the old
+// direction stays, as the start of the first period
+static void addEdge(struct TachEdges *e, uint32_t time, enum TachDirection dir, enum TachDirection last){
+  if((dir != last) && (e->Count > 1)){
+    e->Count = 1;
+  }
+  e->Newest = (e->Newest+1)&TACH_MASK;
+  e->Time[e->Newest] = time;
+  if(e->Count < TACH_EDGES){
+    e->Count = e->Count+1;
+  }
+}
+
+void tachometerRightInt(uint32_t currenttime){
+  enum TachDirection dir;
   if((P10->IN&0x20) == 0){
     // Encoder B is low, so this is a step backward
     Tachometer_RightSteps = Tachometer_RightSteps - 1;
-    Tachometer_RightDir = REVERSE;
+    dir = REVERSE;
   }else{
     // Encoder B is high, so this is a step forward
     Tachometer_RightSteps = Tachometer_RightSteps + 1;
-    Tachometer_RightDir = FORWARD;
+    dir = FORWARD;
   }
+  addEdge(&Tachometer_RightEdges, currenttime, dir, Tachometer_RightDir);
+  Tachometer_RightDir = dir;
 }
 
-void tachometerLeftInt(uint16_t currenttime){
-  Tachometer_FirstLeftTime = Tachometer_SecondLeftTime;
-  Tachometer_SecondLeftTime = currenttime;
+void tachometerLeftInt(uint32_t currenttime){
+  enum TachDirection dir;
   if((P9->IN&0x04) == 0){
     // Encoder B is low, so this is a step backward
     Tachometer_LeftSteps = Tachometer_LeftSteps - 1;
-    Tachometer_LeftDir = REVERSE;
+    dir = REVERSE;
   }else{
-    // Encoder B is high, so this is a step backward
+    // Encoder B is high, so this is a step forward
     Tachometer_LeftSteps = Tachometer_LeftSteps + 1;
-    Tachometer_LeftDir = FORWARD;
+    dir = FORWARD;
+  }
+  addEdge(&Tachometer_LeftEdges, currenttime, dir, Tachometer_LeftDir);
+  Tachometer_LeftDir = dir;
+}
+
+// Average period of the newest edges no more than TACH_WINDOW older
+// than the newest, at least one period. If the wheel has gone longer
+// than that without a step, the time since the last step. 0 with no
+// period yet or no step for TACH_TIMEOUT.
+static uint32_t period(struct TachEdges *e, uint32_t now){
+  uint32_t newest, oldest, t, k, n, p;
+  long sr;
+  sr = StartCritical();            // the ring changes in the capture interrupts
+  if(e->Count < 2){
+    EndCritical(sr);
+    return 0;
+  }
+  newest = e->Time[e->Newest];
+  oldest = newest;
+  n = 0;
+  for(k=1; k<e->Count; k++){
+    t = e->Time[(e->Newest-k)&TACH_MASK];
+    if((n > 0) && ((newest-t) > TACH_WINDOW)){
+      break;
+    }
+    oldest = t;
+    n = k;
+  }
+  EndCritical(sr);
+  if((now-newest) > TACH_TIMEOUT){
+    return 0;                      // stopped
+  }
+  p = (newest-oldest)/n;
+  if((now-newest) > p){
+    p = now-newest;                // slowing down, at most this fast
   }
+  return p;
 }
 
 // ------------Tachometer_Init------------
@@ -110,26 +168,42 @@ void Tachometer_Init(void){
   P10->SEL0 &= ~0x20;
   P10->SEL1 &= ~0x20;              // configure P10.5 as GPIO
   P10->DIR &= ~0x20;               // make P10.5 in
-  TimerA3Capture_Init(&tachometerRightInt, &tachometerLeftInt);
+  TimerA3Capture_Init32(&tachometerRightInt, &tachometerLeftInt);
 }
 
 // ------------Tachometer_Get------------
 // Get the most recent tachometer measurements.
-// Input: leftTach   is pointer to store last measured tachometer period of left wheel (units of 0.083 usec)
+// Input: leftTach   is pointer to store average tachometer period of left wheel (units of 0.083 usec)
 //        leftDir    is pointer to store enumerated direction of last movement of left wheel
 //        leftSteps  is pointer to store total number of forward steps measured for left wheel (360 steps per ~220 mm circumference)
-//        rightTach  is pointer to store last measured tachometer period of right wheel (units of 0.083 usec)
+//        rightTach  is pointer to store average tachometer period of right wheel (units of 0.083 usec)
 //        rightDir   is pointer to store enumerated direction of last movement of right wheel
 //        rightSteps is pointer to store total number of forward steps measured for right wheel (360 steps per ~220 mm circumference)
 // Output: none
+// Periods longer than 16 bits read 65535, and a wheel with no step
+// for TACH_TIMEOUT reads STOPPED with a period of 65535.
 // Assumes: Tachometer_Init() has been called
 // Assumes: Clock_Init48MHz() has been called
 void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
                     uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
-  *leftTach = (Tachometer_SecondLeftTime - Tachometer_FirstLeftTime);
-  *leftDir = Tachometer_LeftDir;
+  uint32_t left, right;
+  Tachometer_GetPeriod(&left, &right);
+  *leftTach = ((left == 0) || (left > 0xFFFF)) ? 0xFFFF : left;
+  *leftDir = left ? Tachometer_LeftDir : STOPPED;
   *leftSteps = Tachometer_LeftSteps;
-  *rightTach = (Tachometer_SecondRightTime - Tachometer_FirstRightTime);
-  *rightDir = Tachometer_RightDir;
+  *rightTach = ((right == 0) || (right > 0xFFFF)) ? 0xFFFF : right;
+  *rightDir = right ? Tachometer_RightDir : STOPPED;
   *rightSteps = Tachometer_RightSteps;
 }
+
+// ------------Tachometer_GetPeriod------------
+// Average periods over the newest edges, 32 bits.
+// Input: leftPeriod  is pointer to store period of left wheel (units of 0.083 usec), 0 if stopped
+//        rightPeriod is pointer to store period of right wheel (units of 0.083 usec), 0 if stopped
+// Output: none
+// Assumes: Tachometer_Init() has been called
+void Tachometer_GetPeriod(uint32_t *leftPeriod, uint32_t *rightPeriod){
+  uint32_t now = TimerA3Capture_Now();
+  *leftPeriod = period(&Tachometer_LeftEdges, now);
+  *rightPeriod = period(&Tachometer_RightEdges, now);
+}
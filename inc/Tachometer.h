@@ -69,6 +69,21 @@ policies, either expressed or implied, of the FreeBSD Project.
 #ifndef TACHOMETER_H_
 #define TACHOMETER_H_
 
+/**
+ * Edges kept per wheel for the average period, a power of 2
+ */
+#define TACH_EDGES 8
+
+/**
+ * Longest span of edges averaged, 20 ms in 0.083 usec units
+ */
+#define TACH_WINDOW 240000
+
+/**
+ * Time without a step after which a wheel reads as stopped,
+ * 100 ms in 0.083 usec units, so the slowest speed is about 6 mm/s
+ */
+#define TACH_TIMEOUT 1200000
 
 /**
  * \brief specifies the direction of the motor rotation, relative to the front of the robot
@@ -92,13 +107,15 @@ void Tachometer_Init(void);
 
 /**
  * Get the most recent tachometer measurements.
- * @param leftTach is pointer to store last measured tachometer period of left wheel (units of 0.083 usec)
+ * @param leftTach is pointer to store average tachometer period of left wheel (units of 0.083 usec)
  * @param leftDir is pointer to store enumerated direction of last movement of left wheel
  * @param leftSteps is pointer to store total number of forward steps measured for left wheel (360 steps per ~220 mm circumference)
- * @param rightTach is pointer to store last measured tachometer period of right wheel (units of 0.083 usec)
+ * @param rightTach is pointer to store average tachometer period of right wheel (units of 0.083 usec)
  * @param rightDir is pointer to store enumerated direction of last movement of right wheel
  * @param rightSteps is pointer to store total number of forward steps measured for right wheel (360 steps per ~220 mm circumference)
  * @return none
+ * @note Periods longer than 16 bits read 65535, and a wheel with no
+ * step for TACH_TIMEOUT reads STOPPED with a period of 65535<br>
  * @note Assumes Tachometer_Init() has been called<br>
  * @note Assumes Clock_Init48MHz() has been called
  * @brief Get the most recent tachometer measurement
@@ -106,4 +123,21 @@ void Tachometer_Init(void);
 void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
                     uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps);
 
+/**
+ * Get the average periods in 32 bits. Timer A3 is extended to 32
+ * bits, and each wheel keeps the times of its last TACH_EDGES edges
+ * in one direction. The period is the time from the oldest edge
+ * within TACH_WINDOW of the newest to the newest, over the number of
+ * steps between them. When the time since the newest edge is longer,
+ * the wheel is slowing down and that time is the period.
+ * @param leftPeriod is pointer to store period of left wheel (units of 0.083 usec), 0 if stopped
+ * @param rightPeriod is pointer to store period of right wheel (units of 0.083 usec), 0 if stopped
+ * @return none
+ * @note A wheel with no step for TACH_TIMEOUT, or only one step
+ * since Tachometer_Init(), reads 0<br>
+ * @note Assumes Tachometer_Init() has been called
+ * @brief Get the average periods
+ */
+void Tachometer_GetPeriod(uint32_t *leftPeriod, uint32_t *rightPeriod);
+
 #endif /* TACHOMETER_H_ */
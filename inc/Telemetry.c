@@ -0,0 +1,199 @@
+// Telemetry.c
+// Runs on MSP432
+// Delta-coded sensor snapshots in CRC-checked, COBS-framed
+// batches, sent over UART0 by DMA without waiting.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../inc/UART0.h"
+#include "../inc/CRC16.h"
+#include "../inc/Telemetry.h"
+
+uint8_t TelemetryRaw[TELEMETRY_RAWMAX];        // frame being built
+uint32_t TelemetryRawLen;
+uint32_t TelemetryCount;                       // samples in the frame
+struct TelemetryRecord TelemetryPrev;          // last sample in the frame
+uint8_t TelemetryTx[2][TELEMETRY_FRAMEMAX];    // encoded frames, owned by the DMA while busy
+volatile uint8_t TelemetryTxBusy[2];
+uint8_t TelemetrySeq;
+volatile uint32_t TelemetryDropped;
+
+// ------------Telemetry_CRC16------------
+// CRC-16/CCITT-FALSE of a block
+// Input: data bytes, size number of bytes
+// Output: CRC
+uint16_t Telemetry_CRC16(const uint8_t *data, uint32_t size){
+  return CRC16_Update(CRC16_INIT, data, size);
+}
+
+// ------------Telemetry_COBSEncode------------
+// Replace every 0x00 with the distance to the next one
+// Input: dst output, src input bytes, size number of input bytes
+// Output: number of bytes written to dst, no terminating 0x00
+uint32_t Telemetry_COBSEncode(uint8_t *dst, const uint8_t *src, uint32_t size){
+  uint32_t code = 0;     // index of the current code byte
+  uint32_t out = 1;
+  uint32_t i;
+  for(i=0; i<size; i++){
+    if(src[i] == 0){
+      dst[code] = (uint8_t)(out-code);
+      code = out;
+      out++;
+    }else{
+      dst[out] = src[i];
+      out++;
+      if(out-code == 0xFF){  // 254 data bytes, start a new block
+        dst[code] = 0xFF;
+        code = out;
+        out++;
+      }
+    }
+  }
+  dst[code] = (uint8_t)(out-code);
+  return out;
+}
+
+// zigzag varint, 7 bits per byte, low bits first
+static uint32_t putVarint(uint8_t *dst, int32_t delta){
+  uint32_t z = ((uint32_t)delta<<1)^(uint32_t)(delta>>31);
+  uint32_t n = 0;
+  while(z >= 0x80){
+    dst[n] = (uint8_t)(z|0x80);
+    z = z>>7;
+    n++;
+  }
+  dst[n] = (uint8_t)z;
+  return n+1;
+}
+
+// ------------Telemetry_EncodeSample------------
+// Changed-field mask, then a varint difference per changed field
+// Input: dst output buffer, r sample, prev previous sample
+// Output: number of bytes written to dst
+uint32_t Telemetry_EncodeSample(uint8_t *dst, const struct TelemetryRecord *r,
+                                const struct TelemetryRecord *prev){
+  int32_t delta[TELEMETRY_FIELDS];
+  uint32_t mask = 0, n = 2;
+  int i;
+  delta[0] = (int32_t)(r->Time-prev->Time);  // wraps correctly
+  delta[1] = (int32_t)r->Reflectance-prev->Reflectance;
+  delta[2] = (int32_t)r->Bumps-prev->Bumps;
+  delta[3] = (int32_t)r->IR[0]-prev->IR[0];
+  delta[4] = (int32_t)r->IR[1]-prev->IR[1];
+  delta[5] = (int32_t)r->IR[2]-prev->IR[2];
+  delta[6] = (int32_t)r->Period[0]-prev->Period[0];
+  delta[7] = (int32_t)r->Period[1]-prev->Period[1];
+  delta[8] = (int32_t)((uint32_t)r->Steps[0]-(uint32_t)prev->Steps[0]);
+  delta[9] = (int32_t)((uint32_t)r->Steps[1]-(uint32_t)prev->Steps[1]);
+  delta[10] = (int32_t)r->Duty[0]-prev->Duty[0];
+  delta[11] = (int32_t)r->Duty[1]-prev->Duty[1];
+  for(i=0; i<TELEMETRY_FIELDS; i++){
+    if(delta[i]){
+      mask |= 1u<<i;
+      n += putVarint(&dst[n], delta[i]);
+    }
+  }
+  dst[0] = (uint8_t)mask;
+  dst[1] = (uint8_t)(mask>>8);
+  return n;
+}
+
+static void startFrame(void){
+  static const struct TelemetryRecord zero;
+  TelemetryRaw[0] = TelemetrySeq;
+  TelemetryRawLen = 2;
+  TelemetryCount = 0;
+  TelemetryPrev = zero;
+}
+
+static void txDone(const void *buf){
+  if(buf == TelemetryTx[0]){
+    TelemetryTxBusy[0] = 0;
+  }else{
+    TelemetryTxBusy[1] = 0;
+  }
+}
+
+// close the frame and queue it on UART0, or drop it if there is no room
+static void sendFrame(void){
+  uint16_t crc;
+  uint32_t i, len;
+  TelemetryRaw[1] = (uint8_t)TelemetryCount;
+  crc = Telemetry_CRC16(TelemetryRaw, TelemetryRawLen);
+  TelemetryRaw[TelemetryRawLen] = (uint8_t)crc;
+  TelemetryRaw[TelemetryRawLen+1] = (uint8_t)(crc>>8);
+  if(TelemetryTxBusy[0] == 0){
+    i = 0;
+  }else if(TelemetryTxBusy[1] == 0){
+    i = 1;
+  }else{
+    TelemetryDropped = TelemetryDropped+1;
+    TelemetrySeq++;                  // the host sees the gap
+    return;
+  }
+  len = Telemetry_COBSEncode(TelemetryTx[i], TelemetryRaw, TelemetryRawLen+2);
+  TelemetryTx[i][len] = 0;           // frame delimiter
+  TelemetryTxBusy[i] = 1;
+  if(UART0_WriteCallback(TelemetryTx[i], len+1, &txDone) == 0){
+    TelemetryTxBusy[i] = 0;          // UART0 queue full
+    TelemetryDropped = TelemetryDropped+1;
+  }
+  TelemetrySeq++;
+}
+
+// ------------Telemetry_Init------------
+// Start an empty frame, UART0_Init must have been called
+// Input: none
+// Output: none
+void Telemetry_Init(void){
+  UART0_Flush();                     // frames from a previous run
+  TelemetryTxBusy[0] = 0;
+  TelemetryTxBusy[1] = 0;
+  TelemetrySeq = 0;
+  TelemetryDropped = 0;
+  startFrame();
+}
+
+// ------------Telemetry_Add------------
+// Add a snapshot, queue the frame when it is full
+// Input: r snapshot
+// Output: none
+void Telemetry_Add(const struct TelemetryRecord *r){
+  TelemetryRawLen += Telemetry_EncodeSample(&TelemetryRaw[TelemetryRawLen], r, &TelemetryPrev);
+  TelemetryPrev = *r;
+  TelemetryCount++;
+  if(TelemetryCount == TELEMETRY_BATCH){
+    sendFrame();
+    startFrame();
+  }
+}
+
+// ------------Telemetry_Wait------------
+// Wait until a frame buffer is free
+// Input: none
+// Output: none
+void Telemetry_Wait(void){
+  while(TelemetryTxBusy[0] && TelemetryTxBusy[1]){};
+}
+
+// ------------Telemetry_Flush------------
+// Queue a partial frame and wait until UART0 is idle
+// Input: none
+// Output: none
+void Telemetry_Flush(void){
+  if(TelemetryCount){
+    Telemetry_Wait();                // do not drop the last frame
+    sendFrame();
+    startFrame();
+  }
+  UART0_Flush();
+}
+
+// ------------Telemetry_Dropped------------
+// Frames dropped since Telemetry_Init
+// Input: none
+// Output: count
+uint32_t Telemetry_Dropped(void){
+  return TelemetryDropped;
+}
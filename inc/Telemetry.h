@@ -0,0 +1,157 @@
+/**
+ * @file      Telemetry.h
+ * @brief     Compact binary sensor telemetry over UART0
+ * @details   Sensor snapshots are batched into frames, delta coded,
+ * protected by a CRC and framed with COBS so the host can find the
+ * start of the next frame after any lost or corrupted byte.<br>
+ * Frame before COBS, all multi-byte fields little endian:<br>
+<table>
+<caption id="telemetry_frame">Frame</caption>
+<tr><th>Bytes <th>Field
+<tr><td>1     <td>sequence number, +1 per frame, wraps at 256
+<tr><td>1     <td>number of samples, 1 to TELEMETRY_BATCH
+<tr><td>n     <td>samples
+<tr><td>2     <td>CRC-16/CCITT-FALSE of everything before it
+</table>
+ * The frame is COBS encoded, so it contains no 0x00, and a 0x00
+ * ends it on the wire.<br>
+ * Each sample is a 16-bit mask followed by one zigzag varint per
+ * set bit. Bit i set means field i changed, and the varint is the
+ * field minus the same field of the previous sample in the frame.
+ * The first sample is coded against all zeros, so every frame
+ * decodes on its own. Field order is the order of TelemetryRecord:<br>
+<table>
+<caption id="telemetry_fields">Fields</caption>
+<tr><th>Bit <th>Field
+<tr><td>0   <td>Time
+<tr><td>1   <td>Reflectance
+<tr><td>2   <td>Bumps
+<tr><td>3-5 <td>IR[0] left, IR[1] center, IR[2] right
+<tr><td>6-7 <td>Period[0] left, Period[1] right
+<tr><td>8-9 <td>Steps[0] left, Steps[1] right
+<tr><td>10-11 <td>Duty[0] left, Duty[1] right
+</table>
+ * A text snapshot is about 120 bytes. A typical sample here is
+ * 8 to 12 bytes, so the same 115200 bps link carries more than
+ * 10 times as many samples.<br>
+ * tools/telemetry has the host decoder and a CSV converter.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __TELEMETRY_H__ // do not include more than once
+#define __TELEMETRY_H__
+#include <stdint.h>
+
+/**
+ * \struct TelemetryRecord
+ * \brief One sensor snapshot
+ */
+struct TelemetryRecord{
+  uint32_t Time;         /**< time in ms */
+  uint8_t Reflectance;   /**< line sensor, 1 bit per sensor */
+  uint8_t Bumps;         /**< bump switches, 1 bit per switch */
+  uint16_t IR[3];        /**< IR distance left, center, right */
+  uint16_t Period[2];    /**< tachometer period left, right, 1/12 us (0.083 us) units, 65535 when stopped */
+  int32_t Steps[2];      /**< tachometer steps left, right */
+  int16_t Duty[2];       /**< motor duty left, right, negative is backward */
+};
+
+/**
+ * Number of fields in a TelemetryRecord
+ */
+#define TELEMETRY_FIELDS 12
+
+/**
+ * Samples per frame
+ */
+#define TELEMETRY_BATCH 8
+
+/**
+ * Largest frame before COBS: 2 header bytes, a 2-byte mask and
+ * 12 varints of at most 5 bytes per sample, 2 CRC bytes
+ */
+#define TELEMETRY_RAWMAX (2+TELEMETRY_BATCH*(2+5*TELEMETRY_FIELDS)+2)
+
+/**
+ * Largest frame on the wire: COBS adds 1 byte per 254, plus the 0x00
+ */
+#define TELEMETRY_FRAMEMAX (TELEMETRY_RAWMAX+TELEMETRY_RAWMAX/254+2)
+
+/**
+ * Initialize the encoder. Call UART0_Init() first.
+ * @param none
+ * @return none
+ * @brief  Initialize telemetry
+ */
+void Telemetry_Init(void);
+
+/**
+ * Add one snapshot to the current frame. When the frame is full
+ * it is queued on UART0 without waiting. If both frame buffers are
+ * still being sent, the frame is dropped and counted.
+ * @param r snapshot to add
+ * @return none
+ * @brief  Add a sample
+ */
+void Telemetry_Add(const struct TelemetryRecord *r);
+
+/**
+ * Wait until a frame buffer is free, so the frame that the next
+ * Telemetry_Add() may complete is queued rather than dropped. For
+ * bulk transfers such as the flight log dump, which would rather
+ * wait than lose samples.
+ * @param none
+ * @return none
+ * @brief  Wait for room
+ */
+void Telemetry_Wait(void);
+
+/**
+ * Queue a partly filled frame, then wait for all frames to be sent
+ * @param none
+ * @return none
+ * @brief  Send everything
+ */
+void Telemetry_Flush(void);
+
+/**
+ * Number of frames dropped because the link could not keep up
+ * @param none
+ * @return frames dropped since Telemetry_Init()
+ * @brief  Dropped frames
+ */
+uint32_t Telemetry_Dropped(void);
+
+/**
+ * CRC-16/CCITT-FALSE, polynomial 0x1021, initial value 0xFFFF
+ * @param data bytes to check
+ * @param size number of bytes
+ * @return CRC
+ * @brief  CRC-16
+ */
+uint16_t Telemetry_CRC16(const uint8_t *data, uint32_t size);
+
+/**
+ * Consistent Overhead Byte Stuffing. The output has no 0x00 and is
+ * at most size+size/254+1 bytes. The terminating 0x00 is not added.
+ * @param dst output buffer
+ * @param src input bytes
+ * @param size number of input bytes
+ * @return number of bytes written to dst
+ * @brief  COBS encode
+ */
+uint32_t Telemetry_COBSEncode(uint8_t *dst, const uint8_t *src, uint32_t size);
+
+/**
+ * Delta code one sample
+ * @param dst output, at least 2+5*TELEMETRY_FIELDS bytes
+ * @param r sample to code
+ * @param prev previous sample in the frame, or all zeros
+ * @return number of bytes written to dst
+ * @brief  Encode a sample
+ */
+uint32_t Telemetry_EncodeSample(uint8_t *dst, const struct TelemetryRecord *r,
+                                const struct TelemetryRecord *prev);
+
+#endif // __TELEMETRY_H__
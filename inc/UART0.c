@@ -1,6 +1,7 @@
 // UART0.c
 // Runs on MSP432
-// Busy-wait device driver for the UART UCA0.
+// Device driver for the UART UCA0, busy-wait receive and
+// DMA transmit from a queue of buffers.
 // Daniel Valvano
 // September 23, 2017
 // Modified by EE345L students Charlie Gough && Matt Hawk
@@ -48,9 +49,34 @@ policies, either expressed or implied, of the FreeBSD Project.
 // UCA0TXD (VCP transmit) connected to P1.3
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
 #include "UART0.h"
 #include "msp.h"
+#include "../inc/CortexM.h"
+#include "../inc/DMA.h"
+#include "../inc/Format.h"
+
+#define TXCHANNEL 0     // DMA channel 0 source 1 is EUSCI_A0 TX
+#define TXMAXDMA 1024   // most bytes in one DMA cycle
+
+// One queued transmission. The bytes are not copied: Pt points
+// into the caller's buffer, or is 0 for bytes in TxBuf put there
+// by UART0_OutChar. Consecutive UART0_OutChar calls grow the same
+// descriptor.
+struct UART0Desc{
+  const uint8_t *Pt;               // next byte to send, 0 means from TxBuf
+  uint32_t Size;                   // bytes left to send
+  void (*Done)(const void *buf);   // called once the last byte is in TXBUF
+  const void *Buf;                 // buffer given to UART0_WriteCallback
+};
+struct UART0Desc TxQ[UART0_TXQSIZE];
+volatile uint32_t TxQPut;          // descriptors put, free running
+volatile uint32_t TxQGet;          // descriptors finished, free running
+uint8_t TxBuf[UART0_TXBUFSIZE];    // bytes from UART0_OutChar
+volatile uint32_t TxBufPut;        // bytes put, free running
+volatile uint32_t TxBufGet;        // bytes sent, free running
+volatile uint32_t TxBusy;          // bytes in the running DMA cycle, 0 if idle
 
 //------------UART0_Init------------
 // Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
@@ -81,6 +107,157 @@ void UART0_Init(void){
   P1->SEL1 &= ~0x0C;             // configure P1.3 and P1.2 as primary module function
   EUSCI_A0->CTLW0 &= ~0x0001;    // enable the USCI module
   EUSCI_A0->IE &= ~0x000F;       // disable interrupts (transmit ready, start received, transmit empty, receive full)
+  TxQPut = TxQGet = 0;
+  TxBufPut = TxBufGet = 0;
+  TxBusy = 0;
+  DMA_Init();
+  DMA_Control->ENACLR = 1<<TXCHANNEL;
+  DMA_Channel->CH_SRCCFG[TXCHANNEL] = 1;     // channel 0 source 1 is EUSCI_A0 TX
+  DMA_Control->ALTCLR = 1<<TXCHANNEL;        // primary only, basic cycles
+  DMA_Control->USEBURSTCLR = 1<<TXCHANNEL;
+  DMA_Control->PRIOCLR = 1<<TXCHANNEL;
+  DMA_Control->REQMASKCLR = 1<<TXCHANNEL;    // allow TXIFG requests
+  DMA_Channel->INT2_SRCCFG = 0x20|TXCHANNEL; // DMA_INT2 on channel 0 completion
+  // DMA_INT2 is interrupt 32, priority 3
+  NVIC->IP[8] = (NVIC->IP[8]&0xFFFFFF00)|0x00000060;
+  NVIC->ISER[1] = 0x00000001;      // enable interrupt 32 in NVIC
+}
+
+// start a DMA cycle for the oldest descriptor,
+// at most TXMAXDMA bytes and never across the end of TxBuf
+// called with interrupts disabled or from the DMA_INT2 ISR
+static void txStart(struct UART0Desc *d){
+  const uint8_t *src;
+  uint32_t count, n, control;
+  struct DMADescriptor *p = DMA_PRIMARY(TXCHANNEL);
+  count = d->Size;
+  if(count > TXMAXDMA){
+    count = TXMAXDMA;
+  }
+  if(d->Pt){
+    src = d->Pt;
+  }else{
+    src = &TxBuf[TxBufGet&(UART0_TXBUFSIZE-1)];
+    n = UART0_TXBUFSIZE-(TxBufGet&(UART0_TXBUFSIZE-1)); // bytes before the wrap
+    if(count > n){
+      count = n;
+    }
+  }
+  p->SrcEnd = &src[count-1];
+  p->DstEnd = &EUSCI_A0->TXBUF;
+  control = (3u<<30)               // DST_INC  none, always TXBUF
+           |(0<<28)                // DST_SIZE byte
+           |(0<<26)                // SRC_INC  byte
+           |(0<<24)                // SRC_SIZE byte
+           |(0<<14)                // R_POWER  one byte per TXIFG request
+           |((count-1)<<4)         // N_MINUS_1
+           |1;                     // CYCLE_CTRL basic
+  p->Control = control;
+  TxBusy = count;
+  DMA_Control->ENASET = 1<<TXCHANNEL;
+  // the request is the rising edge of TXIFG; if the transmitter
+  // is already empty, make an edge so the first byte moves. If
+  // TXIFG rose after the enable, the DMA took that edge and has
+  // moved the first byte, and a second edge would overwrite it
+  if((EUSCI_A0->IFG&0x02) && (p->Control == control)){
+    EUSCI_A0->IFG &= ~0x02;
+    EUSCI_A0->IFG |= 0x02;
+  }
+}
+
+// retire a finished DMA cycle and start the next one
+// does nothing while a cycle is still running, so it is
+// safe to call from both the ISR and the waiting loops
+// called with interrupts disabled or from the DMA_INT2 ISR
+static void txService(void){
+  struct UART0Desc *d;
+  if(TxBusy){
+    if(DMA_Control->ENASET&(1<<TXCHANNEL)){
+      return;                      // still moving bytes
+    }
+    DMA_Channel->INT0_CLRFLG = 1<<TXCHANNEL;
+    d = &TxQ[TxQGet&(UART0_TXQSIZE-1)];
+    if(d->Pt){
+      d->Pt = d->Pt+TxBusy;
+    }else{
+      TxBufGet = TxBufGet+TxBusy;  // frees room for UART0_OutChar
+    }
+    d->Size = d->Size-TxBusy;
+    TxBusy = 0;
+    if(d->Size == 0){
+      TxQGet = TxQGet+1;
+      if(d->Done){
+        (*d->Done)(d->Buf);        // caller may reuse the buffer now
+      }
+    }
+  }
+  if(TxQPut != TxQGet){
+    txStart(&TxQ[TxQGet&(UART0_TXQSIZE-1)]);
+  }
+}
+
+void DMA_INT2_IRQHandler(void){
+  txService();
+}
+
+//------------UART0_WriteCallback------------
+// Queue a buffer for transmission without copying it
+// Input: buf is the data, not changed until done is called
+//        size is the number of bytes
+//        done is called from the DMA interrupt with buf after
+//          the last byte is in TXBUF, 0 for none
+// Output: 1 if queued, 0 if the queue is full (try again later)
+int UART0_WriteCallback(const void *buf, size_t size, void(*done)(const void *buf)){
+  struct UART0Desc *d;
+  long sr;
+  if(size == 0){
+    if(done){
+      (*done)(buf);
+    }
+    return 1;
+  }
+  sr = StartCritical();
+  if((TxQPut-TxQGet) >= UART0_TXQSIZE){
+    EndCritical(sr);
+    return 0;                      // full, back-pressure on the caller
+  }
+  d = &TxQ[TxQPut&(UART0_TXQSIZE-1)];
+  d->Pt = (const uint8_t *)buf;
+  d->Size = size;
+  d->Done = done;
+  d->Buf = buf;
+  TxQPut = TxQPut+1;
+  if(TxBusy == 0){
+    txService();                   // transmitter was idle, start it
+  }
+  EndCritical(sr);
+  return 1;
+}
+
+//------------UART0_Write------------
+// Queue a buffer for transmission without copying it
+// Input: buf is the data, not changed until UART0_Flush returns
+//        size is the number of bytes
+// Output: 1 if queued, 0 if the queue is full (try again later)
+int UART0_Write(const void *buf, size_t size){
+  return UART0_WriteCallback(buf, size, 0);
+}
+
+//------------UART0_Flush------------
+// Wait until everything queued has been transmitted
+// Works with interrupts disabled
+// Input: none
+// Output: none
+void UART0_Flush(void){
+  long sr;
+  sr = StartCritical();
+  while(TxQPut != TxQGet){
+    txService();                   // in case interrupts are disabled
+    EndCritical(sr);
+    sr = StartCritical();
+  }
+  EndCritical(sr);
+  while(EUSCI_A0->STATW&0x01){};   // UCBUSY, last byte still shifting out
 }
 
 //------------UART0_InChar------------
@@ -94,11 +271,37 @@ char UART0_InChar(void){
 
 //------------UART0_OutChar------------
 // Output 8-bit to serial port
+// Copies into TxBuf and returns, waits only if TxBuf
+// or the descriptor queue is full
 // Input: letter is an 8-bit ASCII character to be transferred
 // Output: none
 void UART0_OutChar(char letter){
-  while((EUSCI_A0->IFG&0x02) == 0);
-  EUSCI_A0->TXBUF = letter;
+  struct UART0Desc *d;
+  long sr;
+  sr = StartCritical();
+  while(((TxBufPut-TxBufGet) >= UART0_TXBUFSIZE)
+     ||((TxQPut-TxQGet) >= UART0_TXQSIZE)){
+    txService();                   // in case interrupts are disabled
+    EndCritical(sr);
+    sr = StartCritical();
+  }
+  TxBuf[TxBufPut&(UART0_TXBUFSIZE-1)] = letter;
+  TxBufPut = TxBufPut+1;
+  d = &TxQ[(TxQPut-1)&(UART0_TXQSIZE-1)];
+  if((TxQPut != TxQGet) && (d->Pt == 0)){
+    d->Size = d->Size+1;           // append to the newest TxBuf descriptor
+  }else{
+    d = &TxQ[TxQPut&(UART0_TXQSIZE-1)];
+    d->Pt = 0;
+    d->Size = 1;
+    d->Done = 0;
+    d->Buf = 0;
+    TxQPut = TxQPut+1;
+  }
+  if(TxBusy == 0){
+    txService();                   // transmitter was idle, start it
+  }
+  EndCritical(sr);
 }
 
 //------------UART0_OutString------------
@@ -150,68 +353,7 @@ char character;
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void UART0_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    UART0_OutUDec(n/10);
-    n = n%10;
-  }
-  UART0_OutChar(n+'0'); /* n is between 0 and 9 */
-}
-uint32_t Messageindexb;
-char Messageb[8];
-void static fillmessageb(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessageb(n/10);
-    n = n%10;
-  }
-  Messageb[Messageindexb] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindexb<7)Messageindexb++;
-}
-void static fillmessage4b(uint32_t n){
-  if(n>=1000){  // 1000 to 9999
-    Messageindexb = 0;
-  } else if(n>=100){  // 100 to 999
-    Messageb[0] = ' ';
-    Messageindexb = 1;
-  }else if(n>=10){ //
-    Messageb[0] = ' '; /* n is between 10 and 99 */
-    Messageb[1] = ' ';
-    Messageindexb = 2;
-  }else{
-    Messageb[0] = ' '; /* n is between 0 and 9 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageindexb = 3;
-  }
-  fillmessageb(n);
-}
-void static fillmessage5b(uint32_t n){
-  if(n>99999)n=99999;
-  if(n>=10000){  // 10000 to 99999
-    Messageindexb = 0;
-  } else if(n>=1000){  // 1000 to 9999
-    Messageb[0] = ' ';
-    Messageindexb = 1;
-  }else if(n>=100){  // 100 to 999
-    Messageb[0] = ' ';
-    Messageb[1] = ' ';
-    Messageindexb = 2;
-  }else if(n>=10){ //
-    Messageb[0] = ' '; /* n is between 10 and 99 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageindexb = 3;
-  }else{
-    Messageb[0] = ' '; /* n is between 0 and 9 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageb[3] = ' ';
-    Messageindexb = 4;
-  }
-  fillmessageb(n);
+  Format_OutUDec(&UART0_OutString, n);
 }
 //-----------------------UART0_OutUDec4-----------------------
 // Output a 32-bit number in unsigned decimal format
@@ -219,14 +361,7 @@ void static fillmessage5b(uint32_t n){
 // Output: none
 // Fixed format 4 digits with no space before or after
 void UART0_OutUDec4(uint32_t n){
-  if(n>9999){
-    UART0_OutString("****");
-  }else{
-    Messageindexb = 0;
-    fillmessage4b(n);
-    Messageb[Messageindexb] = 0; // terminate
-    UART0_OutString(Messageb);
-  }
+  Format_OutUDecWidth(&UART0_OutString, n, 4);
 }
 //-----------------------UART0_OutUDec5-----------------------
 // Output a 32-bit number in unsigned decimal format
@@ -234,14 +369,7 @@ void UART0_OutUDec4(uint32_t n){
 // Output: none
 // Fixed format 5 digits with no space before or after
 void UART0_OutUDec5(uint32_t n){
-  if(n>99999){
-    UART0_OutString("*****");
-  }else{
-    Messageindexb = 0;
-    fillmessage5b(n);
-    Messageb[Messageindexb] = 0; // terminate
-    UART0_OutString(Messageb);
-  }
+  Format_OutUDecWidth(&UART0_OutString, n, 5);
 }
 //-----------------------UART0_OutUFix1-----------------------
 // Output a 32-bit number in unsigned decimal format
@@ -249,9 +377,7 @@ void UART0_OutUDec5(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit> with no space before or after
 void UART0_OutUFix1(uint32_t n){
-  UART0_OutUDec(n/10);
-  UART0_OutChar('.');
-  UART0_OutUDec(n%10);
+  Format_OutUFix(&UART0_OutString, n, 1);
 }
 //-----------------------UART0_OutUFix2-----------------------
 // Output a 32-bit number in unsigned decimal format
@@ -259,11 +385,7 @@ void UART0_OutUFix1(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit><digit> with no space before or after
 void UART0_OutUFix2(uint32_t n){
-  UART0_OutUDec(n/100);
-  UART0_OutChar('.');
-  n = n%100;
-  UART0_OutUDec(n/10);
-  UART0_OutUDec(n%10);
+  Format_OutUFix(&UART0_OutString, n, 2);
 }
 //---------------------UART0_InUHex----------------------------------------
 // Accepts ASCII input in unsigned hexadecimal (base 16) format
@@ -313,37 +435,15 @@ char character;
 // Output: none
 // Variable format 1 to 8 digits with no space before or after
 void UART0_OutUHex(uint32_t number){
-// This function uses recursion to convert the number of
-//   unspecified length as an ASCII string
-  if(number >= 0x10){
-    UART0_OutUHex(number/0x10);
-    UART0_OutUHex(number%0x10);
-  }
-  else{
-    if(number < 0xA){
-      UART0_OutChar(number+'0');
-     }
-    else{
-      UART0_OutChar((number-0x0A)+'A');
-    }
-  }
+  Format_OutUHex(&UART0_OutString, number);
 }
 //--------------------------UART0_OutUHex2----------------------------
 // Output a 32-bit number in unsigned hexadecimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 2 digits with no space before or after
-void outnibble(uint32_t n){
-    if(n < 0xA){
-   UART0_OutChar(n+'0');
-  }
-  else{
-    UART0_OutChar((n-0x0A)+'A');
-  }
-}
 void UART0_OutUHex2(uint32_t number){
-  outnibble(number/0x10); // ms digit
-  outnibble(number%0x10); // ls digit
+  Format_OutUHexWidth(&UART0_OutString, number, 2);
 }
 //------------UART0_InString------------
 // Accepts ASCII characters from the serial port
@@ -9,7 +9,10 @@
  * 4) Call UART0_Initprintf()
  * @remark    UCA0RXD (VCP receive) connected to P1.2
  * @remark    UCA0TXD (VCP transmit) connected to P1.3
- * @remark    Busy-wait device driver for the EUSCI A0 UART
+ * @remark    Busy-wait receive for the EUSCI A0 UART
+ * @remark    Transmit is queued and moved by DMA channel 0 (see DMA.h);
+ * UART0_OutChar() copies into a buffer, UART0_Write() queues the
+ * caller's buffer without copying. Add DMA.c and CortexM.c to the project.
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -85,6 +88,16 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 #define DEL  0x7F
 
+#include <stddef.h>
+/**
+ * \brief Number of buffers that can be queued for transmission, a power of 2
+ */
+#define UART0_TXQSIZE 16
+/**
+ * \brief Bytes buffered for UART0_OutChar(), a power of 2
+ */
+#define UART0_TXBUFSIZE 512
+
 /**
  * @details   Initialize EUSCI_A0 for UART operation
  * @details   115,200 baud rate (assuming 12 MHz SMCLK clock),
@@ -124,8 +137,8 @@ char UART0_InChar(void);
 
 /**
  * @details   Transmit a character to EUSCI_A0 UART
- * @details   Busy-wait synchronization,
- * @details   blocking, wait for UART to be ready
+ * @details   Copies into a UART0_TXBUFSIZE buffer sent by DMA,
+ * @details   waits only if the buffer or the queue is full
  * @param  letter is the ASCII code for key to send
  * @return none
  * @note   UART0_Init must be called once prior
@@ -134,6 +147,44 @@ char UART0_InChar(void);
 void UART0_OutChar(char letter);
 
 
+/**
+ * @details   Queue a buffer for transmission on EUSCI_A0 UART
+ * @details   The bytes are not copied; DMA reads them from buf,
+ * @details   in order with UART0_OutChar() output
+ * @param  buf is the data, which must not change until UART0_Flush() returns
+ * @param  size is the number of bytes
+ * @return 1 if queued, 0 if UART0_TXQSIZE buffers are already queued
+ * @note   UART0_Init must be called once prior
+ * @brief  Transmit buffer out of MSP432 without waiting
+ */
+int UART0_Write(const void *buf, size_t size);
+
+
+/**
+ * @details   Queue a buffer for transmission on EUSCI_A0 UART
+ * @details   Same as UART0_Write(), and calls done from the DMA
+ * @details   interrupt once the last byte of buf is in TXBUF
+ * @param  buf is the data, which must not change until done is called
+ * @param  size is the number of bytes
+ * @param  done is called with buf when the buffer may be reused, 0 for none
+ * @return 1 if queued, 0 if UART0_TXQSIZE buffers are already queued
+ * @note   UART0_Init must be called once prior
+ * @brief  Transmit buffer out of MSP432 with completion callback
+ */
+int UART0_WriteCallback(const void *buf, size_t size, void(*done)(const void *buf));
+
+
+/**
+ * @details   Wait until everything queued on EUSCI_A0 UART has been sent
+ * @details   Works with interrupts disabled
+ * @param  none
+ * @return none
+ * @note   UART0_Init must be called once prior
+ * @brief  Wait for transmission to finish
+ */
+void UART0_Flush(void);
+
+
 /**
  * @details   Transmit a string to EUSCI_A0 UART
  * @param  pt is pointer to null-terminated ASCII string to be transferred
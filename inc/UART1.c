@@ -54,39 +54,18 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "UART1.h"
 #include "msp.h"
 
+#include "../inc/FIFO0.h"
+
 #define FIFOSIZE   256       // size of the FIFOs (must be power of 2)
-#define FIFOSUCCESS 1        // return value on success
-#define FIFOFAIL    0        // return value on failure
-uint32_t RxPutI;      // should be 0 to SIZE-1
-uint32_t RxGetI;      // should be 0 to SIZE-1 
-uint32_t RxFifoLost;  // should be 0 
-uint8_t RxFIFO[FIFOSIZE];
-void RxFifo_Init(void){
-  RxPutI = RxGetI = 0;                      // empty
-  RxFifoLost = 0; // occurs on overflow
-}
-int RxFifo_Put(uint8_t data){
-  if(((RxPutI+1)&(FIFOSIZE-1)) == RxGetI){
-    RxFifoLost++;
-    return FIFOFAIL; // fail if full  
-  }    
-  RxFIFO[RxPutI] = data;                    // save in FIFO
-  RxPutI = (RxPutI+1)&(FIFOSIZE-1);         // next place to put
-  return FIFOSUCCESS;
-}
-int RxFifo_Get(uint8_t *datapt){ 
-  if(RxPutI == RxGetI) return 0;            // fail if empty
-  *datapt = RxFIFO[RxGetI];                 // retrieve data
-  RxGetI = (RxGetI+1)&(FIFOSIZE-1);         // next place to get
-  return FIFOSUCCESS; 
-}
-                    
+struct Fifo RxFifo1;         // RxFifo1.Lost should be 0
+uint8_t RxFifo1Buf[FIFOSIZE];
+
 //------------UART1_InStatus------------
 // Returns how much data available for reading
 // Input: none
 // Output: number of bytes in receive FIFO
 uint32_t UART1_InStatus(void){  
- return ((RxPutI - RxGetI)&(FIFOSIZE-1));  
+ return Fifo_Size(&RxFifo1);
 }
 //------------UART1_Init------------
 // Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
@@ -94,7 +73,7 @@ uint32_t UART1_InStatus(void){
 // Input: none
 // Output: none
 void UART1_Init(void){
-  RxFifo_Init();              // initialize FIFOs
+  Fifo_Init(&RxFifo1, RxFifo1Buf, FIFOSIZE); // initialize FIFOs
   EUSCI_A2->CTLW0 = 0x0001;         // hold the USCI module in reset mode
   // bit15=0,      no parity bits
   // bit14=x,      not used when parity is disabled
@@ -133,7 +112,7 @@ void UART1_Init(void){
 // spin if RxFifo is empty
 uint8_t UART1_InChar(void){
   uint8_t letter;
-  while(RxFifo_Get(&letter) == FIFOFAIL){};
+  while(Fifo_Get(&RxFifo1, &letter) == FIFOFAIL){};
   return(letter);
 }
 
@@ -150,7 +129,7 @@ void UART1_OutChar(uint8_t data){
 // vector at 0x00000088 in startup_msp432.s
 void EUSCIA2_IRQHandler(void){
   if(EUSCI_A2->IFG&0x01){             // RX data register full
-    RxFifo_Put((uint8_t)EUSCI_A2->RXBUF);// clears UCRXIFG
+    Fifo_Put(&RxFifo1, (uint8_t)EUSCI_A2->RXBUF);// clears UCRXIFG
   } 
 }
 
@@ -7,7 +7,8 @@
  * @remark    J1.3  from Bluetooth (DIO3_TXD) to LaunchPad (UART RxD){MSP432 P3.2}
  * @remark    J1.4  from LaunchPad to Bluetooth (DIO2_RXD) (UART TxD){MSP432 P3.3}
  * @remark    Busy-wait device driver for the EUSCI A2 UART output
- * @remark    Interrupting device driver for the EUSCI A2 UART input
+ * @remark    Interrupting device driver for the EUSCI A2 UART input,
+ * received bytes go through a struct Fifo, so add FIFO0.c to the project
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
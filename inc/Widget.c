@@ -0,0 +1,130 @@
+// Widget.c
+// Runs on MSP432
+// Strip charts, bar gauges and a reflectance bar that redraw only
+// what changed in the Nokia5110 screen buffer.
+// October 16, 2026
+
+#include <stdint.h>
+#include "../inc/Graphics.h"
+#include "../inc/Widget.h"
+
+// value clamped to [min, max] and scaled to 0 to n, rounded
+static int32_t scale(int32_t value, int32_t min, int32_t max, int32_t n){
+  if(value <= min){
+    return 0;
+  }
+  if(value >= max){
+    return n;
+  }
+  return (int32_t)(((int64_t)(value-min)*n + (max-min)/2)/(max-min));
+}
+
+//------------Widget_InitChart------------
+// Clear the area of a strip chart
+// Input: c chart, x,y top left, w,h size, min,max value range
+//        traces values per sample
+// Output: none
+void Widget_InitChart(struct Chart *c, int32_t x, int32_t y, int32_t w, int32_t h,
+                      int32_t min, int32_t max, uint32_t traces){
+  uint32_t i;
+  c->X = x; c->Y = y; c->W = w; c->H = h;
+  c->Min = min; c->Max = max;
+  c->Traces = (traces > WIDGET_TRACES)? WIDGET_TRACES : traces;
+  for(i=0; i<WIDGET_TRACES; i=i+1){
+    c->Last[i] = -1;
+  }
+  Graphics_FillRect(x, y, w, h, GRAPHICS_CLEAR);
+}
+
+//------------Widget_Chart------------
+// Scroll the plot one column left and draw the new column, a
+// vertical run from each trace's previous row to its new one
+// Input: c chart, values one per trace
+// Output: none
+void Widget_Chart(struct Chart *c, const int32_t *values){
+  int32_t column = c->X+c->W-1, row, top, bottom;
+  uint32_t i;
+  Graphics_Scroll(c->X, c->Y, c->W, c->H, -1, 0);
+  for(i=0; i<c->Traces; i=i+1){
+    row = c->Y+c->H-1-scale(values[i], c->Min, c->Max, c->H-1);
+    top = bottom = row;
+    if(c->Last[i] >= 0){
+      if(c->Last[i] < top){
+        top = c->Last[i];
+      }else{
+        bottom = c->Last[i];
+      }
+    }
+    Graphics_VLine(column, top, bottom-top+1, GRAPHICS_SET);
+    c->Last[i] = row;
+  }
+}
+
+//------------Widget_InitGauge------------
+// Draw the frame of an empty bar gauge
+// Input: g gauge, x,y top left, w,h size of the frame
+//        min,max value range, vertical 1 for up, 0 for right
+// Output: none
+void Widget_InitGauge(struct Gauge *g, int32_t x, int32_t y, int32_t w, int32_t h,
+                      int32_t min, int32_t max, uint32_t vertical){
+  g->X = x; g->Y = y; g->W = w; g->H = h;
+  g->Min = min; g->Max = max;
+  g->Vertical = vertical;
+  g->Level = 0;
+  Graphics_FillRect(x+1, y+1, w-2, h-2, GRAPHICS_CLEAR);
+  Graphics_Rect(x, y, w, h, GRAPHICS_SET);
+}
+
+//------------Widget_Gauge------------
+// Fill or clear the pixels between the old and the new level
+// Input: g gauge, value to show
+// Output: none
+void Widget_Gauge(struct Gauge *g, int32_t value){
+  int32_t level, lo, n;
+  uint32_t mode;
+  level = scale(value, g->Min, g->Max, g->Vertical? g->H-2 : g->W-2);
+  if(level == g->Level){
+    return;
+  }
+  if(level > g->Level){
+    lo = g->Level; n = level-g->Level; mode = GRAPHICS_SET;
+  }else{
+    lo = level; n = g->Level-level; mode = GRAPHICS_CLEAR;
+  }
+  if(g->Vertical){                   // level counts up from the bottom row inside
+    Graphics_FillRect(g->X+1, g->Y+g->H-1-lo-n, g->W-2, n, mode);
+  }else{
+    Graphics_FillRect(g->X+1+lo, g->Y+1, n, g->H-2, mode);
+  }
+  g->Level = level;
+}
+
+//------------Widget_InitReflect------------
+// Draw eight empty cells side by side, neighbors sharing a side
+// Input: r bar, x,y top left, w,h size of a cell with its frame
+// Output: none
+void Widget_InitReflect(struct Reflect *r, int32_t x, int32_t y, int32_t w, int32_t h){
+  int32_t i;
+  r->X = x; r->Y = y; r->W = w; r->H = h;
+  r->Data = 0;
+  Graphics_FillRect(x, y, 8*(w-1)+1, h, GRAPHICS_CLEAR);
+  for(i=0; i<8; i=i+1){
+    Graphics_Rect(x+i*(w-1), y, w, h, GRAPHICS_SET);
+  }
+}
+
+//------------Widget_Reflect------------
+// Invert the inside of each cell whose bit changed
+// Input: r bar, data sensor bits, bit 7 the left cell
+// Output: none
+void Widget_Reflect(struct Reflect *r, uint8_t data){
+  uint8_t changed = data^r->Data;
+  int32_t i;
+  for(i=0; changed; i=i+1){
+    if(changed&0x80){
+      Graphics_FillRect(r->X+i*(r->W-1)+1, r->Y+1, r->W-2, r->H-2, GRAPHICS_INVERT);
+    }
+    changed = changed<<1;
+  }
+  r->Data = data;
+}
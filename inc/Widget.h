@@ -0,0 +1,148 @@
+/**
+ * @file      Widget.h
+ * @brief     Strip charts, bar gauges and a reflectance bar on the Nokia5110
+ * @details   Live sensor displays drawn with Graphics.c into Screen
+ * of Nokia5110.c, for watching the robot without a laptop on the
+ * UART. Each widget is an object in caller storage that remembers
+ * what it last drew, so an update touches only what changed:<br>
+ 1) strip chart, Widget_Chart() moves the plot one column left with
+    Graphics_Scroll(), a byte move per column per bank, and draws
+    only the new right-hand column<br>
+ 2) bar gauge, Widget_Gauge() fills or clears only the pixels
+    between the old and the new level<br>
+ 3) reflectance bar, Widget_Reflect() inverts only the cells whose
+    sensor bit changed<br>
+ * To use a widget<br>
+   a) draw it once with its Widget_Init function<br>
+   b) call the update from a periodic task, then
+      Nokia5110_DisplayBuffer() to send what changed<br>
+ * Widgets must not overlap; nothing else should draw inside one.
+ * Values are clamped to the range of the widget.<br>
+ * Approximate cost at 48 MHz:<br>
+<table>
+<caption id="widget_cost">Widget cost</caption>
+<tr><th>Update                                  <th>Time
+<tr><td>Widget_Chart(), 60 by 40, two traces    <td>~35 us
+<tr><td>Widget_Gauge(), level unchanged         <td>~1 us
+<tr><td>Widget_Gauge(), 40 pixel change         <td>~4 us
+<tr><td>Widget_Reflect(), per changed sensor    <td>~2 us
+</table>
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __WIDGET_H__ // do not include more than once
+#define __WIDGET_H__
+#include <stdint.h>
+
+/**
+ * Maximum number of traces in a strip chart
+ */
+#define WIDGET_TRACES 4
+
+/**
+ * \struct Chart
+ * \brief A rolling strip chart, newest sample on the right
+ */
+struct Chart{
+  int32_t X, Y, W, H;           /**< plot area, without a frame */
+  int32_t Min, Max;             /**< values at the bottom and top rows */
+  uint32_t Traces;              /**< number of traces, 1 to WIDGET_TRACES */
+  int32_t Last[WIDGET_TRACES];  /**< row of each trace in the newest column, -1 before the first */
+};
+
+/**
+ * \struct Gauge
+ * \brief A bar gauge in a one-pixel frame
+ */
+struct Gauge{
+  int32_t X, Y, W, H;           /**< frame */
+  int32_t Min, Max;             /**< values of an empty and a full bar */
+  uint32_t Vertical;            /**< 1 fills up from the bottom, 0 right from the left */
+  int32_t Level;                /**< pixels filled */
+};
+
+/**
+ * \struct Reflect
+ * \brief Eight cells showing the bits of Reflectance_Read(), the
+ * left sensor, bit 7, on the left
+ */
+struct Reflect{
+  int32_t X, Y, W, H;           /**< first cell; the next is W-1 to the right, sharing a side */
+  uint8_t Data;                 /**< bits shown */
+};
+
+/**
+ * Clear the area of a strip chart and start it empty
+ * @param c chart object in caller storage
+ * @param x left column
+ * @param y top row
+ * @param w width in columns
+ * @param h height in rows, 2 to 48
+ * @param min value shown on the bottom row
+ * @param max value shown on the top row, greater than min
+ * @param traces number of values per sample, 1 to WIDGET_TRACES
+ * @return none
+ * @brief  Initialize a strip chart
+ */
+void Widget_InitChart(struct Chart *c, int32_t x, int32_t y, int32_t w, int32_t h,
+                      int32_t min, int32_t max, uint32_t traces);
+
+/**
+ * Add a sample to a strip chart: move the plot one column left and
+ * draw each trace in the new column, joined to its previous point
+ * @param c chart object
+ * @param values one value per trace
+ * @return none
+ * @brief  Add a sample
+ */
+void Widget_Chart(struct Chart *c, const int32_t *values);
+
+/**
+ * Draw the frame of a bar gauge, empty
+ * @param g gauge object in caller storage
+ * @param x left column of the frame
+ * @param y top row of the frame
+ * @param w width of the frame, at least 3
+ * @param h height of the frame, at least 3
+ * @param min value of an empty bar
+ * @param max value of a full bar, greater than min
+ * @param vertical 1 to fill up from the bottom, 0 to fill right from the left
+ * @return none
+ * @brief  Initialize a bar gauge
+ */
+void Widget_InitGauge(struct Gauge *g, int32_t x, int32_t y, int32_t w, int32_t h,
+                      int32_t min, int32_t max, uint32_t vertical);
+
+/**
+ * Show a value on a bar gauge
+ * @param g gauge object
+ * @param value new value
+ * @return none
+ * @brief  Set a bar gauge
+ */
+void Widget_Gauge(struct Gauge *g, int32_t value);
+
+/**
+ * Draw the eight empty cells of a reflectance bar, 8*(w-1)+1
+ * columns wide
+ * @param r bar object in caller storage
+ * @param x left column
+ * @param y top row
+ * @param w width of a cell with its frame, at least 3
+ * @param h height of a cell with its frame, at least 3
+ * @return none
+ * @brief  Initialize a reflectance bar
+ */
+void Widget_InitReflect(struct Reflect *r, int32_t x, int32_t y, int32_t w, int32_t h);
+
+/**
+ * Show the sensors, a filled cell for each 1 (black)
+ * @param r bar object
+ * @param data 8-bit result of Reflectance_Read() or Reflectance_End()
+ * @return none
+ * @brief  Set a reflectance bar
+ */
+void Widget_Reflect(struct Reflect *r, uint8_t data);
+
+#endif // __WIDGET_H__
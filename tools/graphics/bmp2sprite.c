@@ -0,0 +1,234 @@
+// bmp2sprite.c
+// Runs on the host PC
+// Convert a picture to a struct Sprite of inc/Graphics.h, packed
+// in the layout of the Nokia5110 screen buffer: banks of 8 rows,
+// one byte per column, bit 0 at the top.
+// October 16, 2026
+//
+// Build from this directory:
+//   gcc -std=c99 -O2 -o bmp2sprite bmp2sprite.c
+// Usage:
+//   bmp2sprite [-t threshold] [-i] [-n name] picture > name.c
+// Reads uncompressed BMP (1, 4, 8, 24 or 32 bits per pixel) and
+// netpbm PBM or PGM (P1, P2, P4, P5). A pixel darker than the
+// threshold, 0 to 255 and 128 by default, is on, as the LCD shows
+// dark on light; -i turns the light pixels on instead. The name of
+// the sprite is the file name without its extension unless -n
+// gives one. Other formats such as PNG convert with any image tool
+// first, for example: convert art.png art.pbm
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+struct Picture{
+  int Width, Height;
+  uint8_t *Gray;           // Width*Height, row 0 at the top, 0 black
+};
+
+static void fail(const char *message){
+  fprintf(stderr, "bmp2sprite: %s\n", message);
+  exit(1);
+}
+
+static uint32_t get16(const uint8_t *p){
+  return p[0]|(p[1]<<8);
+}
+static uint32_t get32(const uint8_t *p){
+  return p[0]|(p[1]<<8)|(p[2]<<16)|((uint32_t)p[3]<<24);
+}
+
+static uint8_t *load(const char *name, long *size){
+  FILE *file = fopen(name, "rb");
+  uint8_t *data;
+  if(file == 0){
+    perror(name);
+    exit(1);
+  }
+  fseek(file, 0, SEEK_END);
+  *size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(*size+1);
+  if((data == 0) || (fread(data, 1, *size, file) != (size_t)*size)){
+    fail("cannot read the file");
+  }
+  fclose(file);
+  data[*size] = 0;
+  return data;
+}
+
+static int bmp(const uint8_t *d, long size, struct Picture *p){
+  uint32_t offset, bits, colors, stride, x, y, row;
+  int32_t height;
+  const uint8_t *palette, *line;
+  if((size < 54) || (d[0] != 'B') || (d[1] != 'M')){
+    return 0;
+  }
+  offset = get32(&d[10]);
+  p->Width = (int32_t)get32(&d[18]);
+  height = (int32_t)get32(&d[22]);
+  bits = get16(&d[28]);
+  if(get32(&d[30]) != 0 && get32(&d[30]) != 3){
+    fail("compressed BMP");
+  }
+  if((bits != 1) && (bits != 4) && (bits != 8) && (bits != 24) && (bits != 32)){
+    fail("BMP must have 1, 4, 8, 24 or 32 bits per pixel");
+  }
+  p->Height = (height < 0)? -height : height;
+  colors = get32(&d[46]);
+  if((colors == 0) && (bits <= 8)){
+    colors = 1u<<bits;
+  }
+  palette = &d[14+get32(&d[14])];
+  stride = ((p->Width*bits+31)/32)*4;
+  if((p->Width <= 0) || (offset+stride*p->Height > (uint32_t)size)){
+    fail("BMP is cut short");
+  }
+  p->Gray = malloc(p->Width*p->Height);
+  for(y = 0; y < (uint32_t)p->Height; y++){
+    row = (height < 0)? y : p->Height-1-y;      // bottom-up unless the height is negative
+    line = &d[offset+stride*row];
+    for(x = 0; x < (uint32_t)p->Width; x++){
+      uint32_t index = 0, r, g, b;
+      if(bits == 1)      index = (line[x/8]>>(7-x%8))&1;
+      else if(bits == 4) index = (line[x/2]>>((x%2)? 0 : 4))&0xF;
+      else if(bits == 8) index = line[x];
+      if(bits <= 8){
+        if(index >= colors){
+          index = 0;
+        }
+        b = palette[4*index]; g = palette[4*index+1]; r = palette[4*index+2];
+      }else{
+        b = line[x*bits/8]; g = line[x*bits/8+1]; r = line[x*bits/8+2];
+      }
+      p->Gray[p->Width*y+x] = (uint8_t)((77*r+150*g+29*b)>>8);
+    }
+  }
+  return 1;
+}
+
+// skip white space and comments of a netpbm file
+static void skip(const uint8_t *d, long size, long *at){
+  while(*at < size){
+    if(d[*at] == '#'){
+      while((*at < size) && (d[*at] != '\n')) *at = *at+1;
+    }else if(isspace(d[*at])){
+      *at = *at+1;
+    }else{
+      break;
+    }
+  }
+}
+
+// next decimal number of a netpbm header or plain raster
+static long number(const uint8_t *d, long size, long *at){
+  long n = 0;
+  skip(d, size, at);
+  if((*at >= size) || !isdigit(d[*at])){
+    fail("bad PBM/PGM");
+  }
+  while((*at < size) && isdigit(d[*at])){
+    n = 10*n+(d[*at]-'0');
+    *at = *at+1;
+  }
+  return n;
+}
+
+static int pnm(const uint8_t *d, long size, struct Picture *p){
+  long at = 2, max = 1, x, y, v;
+  char kind;
+  if((size < 3) || (d[0] != 'P') || !strchr("1245", d[1])){
+    return 0;
+  }
+  kind = d[1];
+  p->Width = number(d, size, &at);
+  p->Height = number(d, size, &at);
+  if((kind == '2') || (kind == '5')){
+    max = number(d, size, &at);
+  }
+  if((kind == '4') || (kind == '5')){
+    at = at+1;                                  // the one white space before a raw raster
+  }
+  if((p->Width <= 0) || (p->Height <= 0) || (max <= 0)){
+    fail("bad PBM/PGM");
+  }
+  p->Gray = malloc(p->Width*p->Height);
+  for(y = 0; y < p->Height; y++){
+    for(x = 0; x < p->Width; x++){
+      if(kind == '4'){
+        long i = at+y*((p->Width+7)/8)+x/8;
+        if(i >= size) fail("PBM is cut short");
+        v = ((d[i]>>(7-x%8))&1)? 0 : 255;       // 1 is black
+      }else if(kind == '5'){
+        if(at >= size) fail("PGM is cut short");
+        v = d[at++]*255/max;
+      }else if(kind == '1'){
+        skip(d, size, &at);                     // bits need not be separated
+        if(at >= size) fail("PBM is cut short");
+        v = (d[at++] == '1')? 0 : 255;
+      }else{
+        v = number(d, size, &at)*255/max;
+      }
+      p->Gray[p->Width*y+x] = (uint8_t)v;
+    }
+  }
+  return 1;
+}
+
+int main(int argc, char **argv){
+  struct Picture p;
+  const char *file = 0, *name = 0;
+  char base[64];
+  int threshold = 128, invert = 0, i, x, b, banks;
+  long size;
+  uint8_t *data;
+  for(i = 1; i < argc; i++){
+    if((strcmp(argv[i], "-t") == 0) && (i+1 < argc))      threshold = atoi(argv[++i]);
+    else if(strcmp(argv[i], "-i") == 0)                   invert = 1;
+    else if((strcmp(argv[i], "-n") == 0) && (i+1 < argc)) name = argv[++i];
+    else if(file == 0)                                    file = argv[i];
+    else fail("usage: bmp2sprite [-t threshold] [-i] [-n name] picture");
+  }
+  if(file == 0){
+    fail("usage: bmp2sprite [-t threshold] [-i] [-n name] picture");
+  }
+  if(name == 0){
+    const char *slash = strrchr(file, '/');
+    snprintf(base, sizeof(base), "%s", slash? slash+1 : file);
+    if(strchr(base, '.')){
+      *strchr(base, '.') = 0;
+    }
+    for(i = 0; base[i]; i++){
+      if(!isalnum((unsigned char)base[i])) base[i] = '_';
+    }
+    name = base;
+  }
+  data = load(file, &size);
+  if(!bmp(data, size, &p) && !pnm(data, size, &p)){
+    fail("not a BMP, PBM or PGM file");
+  }
+  if((p.Width > 255) || (p.Height > 255)){
+    fail("a sprite is at most 255 by 255");
+  }
+  banks = (p.Height+7)/8;
+  printf("// %s, %d by %d, from %s by bmp2sprite\n", name, p.Width, p.Height, file);
+  printf("#include <stdint.h>\n#include \"../inc/Graphics.h\"\n\n");
+  printf("static const uint8_t %sBits[%d] = {", name, banks*p.Width);
+  for(b = 0; b < banks; b++){
+    for(x = 0; x < p.Width; x++){
+      uint8_t byte = 0;
+      int row;
+      for(row = 0; row < 8; row++){
+        int y = 8*b+row;
+        if((y < p.Height) && ((p.Gray[p.Width*y+x] < threshold) != invert)){
+          byte |= 1<<row;
+        }
+      }
+      printf("%s0x%02X", (x%12)? ", " : (b || x)? ",\n  " : "\n  ", byte);
+    }
+  }
+  printf("\n};\nconst struct Sprite %s = {%d, %d, %sBits};\n", name, p.Width, p.Height, name);
+  return 0;
+}
@@ -0,0 +1,191 @@
+// logic2vcd.cpp
+// Runs on the host PC
+// Convert a LogicCapture stream (inc/LogicCapture.c) to a VCD file
+// for GTKWave or any other waveform viewer.
+// October 16, 2026
+//
+// Build from this directory:
+//   g++ -std=c++17 -O2 -o logic2vcd logic2vcd.cpp
+// Usage:
+//   logic2vcd [-0 name] [-1 name] [capture.bin] > capture.vcd
+// -0 and -1 name the ports the robot sampled, for example -0 P4 -1 P7,
+// so channel 3 shows up as P4.3. Reads standard input when no file is
+// given. Lost samples appear as x. Statistics go to standard error.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t HeaderSize = 16;
+const size_t BlockSize = 64;    // LOGIC_BLOCKSIZE
+
+uint16_t crc16(uint16_t crc, const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    crc ^= static_cast<uint16_t>(data[i] << 8);
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+uint32_t get32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+class VcdWriter {
+public:
+  VcdWriter(std::string name0, std::string name1)
+    : names{std::move(name0), std::move(name1)} {}
+
+  // one good block: start sample index, period, masks, events
+  void Block(uint32_t start, uint32_t period, uint16_t mask, const uint8_t *events, unsigned n) {
+    if (!started) {
+      header(period, mask);
+      sample = start;
+    }
+    uint64_t first = unwrap(start);
+    if (first > sample) {                      // samples lost before this block
+      lost += first - sample;
+      changeAll(sample, true, 0);
+      sample = first;
+    }
+    for (unsigned i = 0; i < n; i++) {
+      const uint8_t *e = &events[4 * i];
+      uint16_t value = static_cast<uint16_t>(e[0] | (e[1] << 8));
+      uint16_t run = static_cast<uint16_t>(e[2] | (e[3] << 8));
+      changeAll(sample, false, value);
+      sample += run;
+    }
+  }
+
+  void Finish() {
+    if (started) {
+      std::printf("#%llu\n", static_cast<unsigned long long>(ns(sample)));
+    }
+  }
+
+  uint64_t Lost() const { return lost; }
+  uint64_t Samples() const { return sample - origin; }
+
+private:
+  void header(uint32_t p, uint16_t mask) {
+    started = true;
+    period = p;
+    std::printf("$date LogicCapture $end\n$timescale 1ns $end\n$scope module logic $end\n");
+    for (int bit = 0; bit < 16; bit++) {
+      if (mask & (1u << bit)) {
+        const std::string &port = names[bit >> 3];
+        std::printf("$var wire 1 %c %s.%d $end\n", id(bit), port.c_str(), bit & 7);
+        channels.push_back(bit);
+      }
+    }
+    std::printf("$upscope $end\n$enddefinitions $end\n");
+  }
+
+  // sample index of a 32-bit start, across wraparound
+  uint64_t unwrap(uint32_t start) {
+    if (origin == UINT64_MAX) {
+      origin = start;
+      return start;
+    }
+    uint64_t s = (sample & ~0xFFFFFFFFull) | start;
+    if (s + 0x80000000ull < sample) {
+      s += 0x100000000ull;
+    }
+    return s;
+  }
+
+  void changeAll(uint64_t at, bool unknown, uint16_t value) {
+    bool stamped = false;
+    for (int bit : channels) {
+      char v = unknown ? 'x' : ((value >> bit) & 1) ? '1' : '0';
+      if (!valid || current[bit] != v) {
+        if (!stamped) {
+          std::printf("#%llu\n", static_cast<unsigned long long>(ns(at)));
+          stamped = true;
+        }
+        std::printf("%c%c\n", v, id(bit));
+        current[bit] = v;
+      }
+    }
+    valid = true;
+  }
+
+  uint64_t ns(uint64_t s) const { return (s - origin) * period * 125 / 6; }  // 48 MHz cycles to ns
+  static char id(int bit) { return static_cast<char>('!' + bit); }
+
+  std::string names[2];
+  std::vector<int> channels;
+  char current[16] = {};
+  bool started = false;
+  bool valid = false;
+  uint32_t period = 1;
+  uint64_t origin = UINT64_MAX;
+  uint64_t sample = 0;
+  uint64_t lost = 0;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string name0 = "a", name1 = "b";
+  FILE *in = stdin;
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "-0") && i + 1 < argc) {
+      name0 = argv[++i];
+    } else if (!std::strcmp(argv[i], "-1") && i + 1 < argc) {
+      name1 = argv[++i];
+    } else if ((in = std::fopen(argv[i], "rb")) == nullptr) {
+      std::perror(argv[i]);
+      return 1;
+    }
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+    data.insert(data.end(), buf, buf + n);
+  }
+  VcdWriter vcd(name0, name1);
+  unsigned blocks = 0, badCRC = 0, missing = 0;
+  bool haveSeq = false;
+  uint8_t lastSeq = 0;
+  size_t i = 0;
+  while (i + HeaderSize + 2 <= data.size()) {
+    const uint8_t *b = &data[i];
+    unsigned count = b[2];
+    size_t size = HeaderSize + 4 * count + 2;
+    if (b[0] != 0xA5 || b[1] != 0x5A || count == 0 || count > BlockSize || i + size > data.size()) {
+      i++;                                     // not a block, text or noise
+      continue;
+    }
+    uint16_t crc = crc16(0xFFFF, b + HeaderSize, 4 * count);
+    crc = crc16(crc, b + 2, HeaderSize - 2);
+    if (crc != (b[size - 2] | (b[size - 1] << 8))) {
+      badCRC++;
+      i++;
+      continue;
+    }
+    if (haveSeq) {
+      missing += static_cast<uint8_t>(b[3] - lastSeq - 1);
+    }
+    haveSeq = true;
+    lastSeq = b[3];
+    vcd.Block(get32(b + 4), get32(b + 8), static_cast<uint16_t>(b[12] | (b[13] << 8)), b + HeaderSize, count);
+    blocks++;
+    i += size;
+  }
+  vcd.Finish();
+  std::fprintf(stderr, "blocks %u, bad CRC %u, missing blocks %u, samples %llu, lost samples %llu\n",
+               blocks, badCRC, missing, static_cast<unsigned long long>(vcd.Samples()),
+               static_cast<unsigned long long>(vcd.Lost()));
+  if (in != stdin) {
+    std::fclose(in);
+  }
+  return 0;
+}
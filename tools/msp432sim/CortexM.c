@@ -0,0 +1,52 @@
+// CortexM.c
+// Runs on the host, Linux x86-64
+// CortexM.h for the MSP432 simulator: the functions of inc/CortexM.c,
+// whose bodies are Cortex M assembly, on top of the simulated PRIMASK
+// and WFI of Sim.c.
+// October 16, 2026
+
+#include <stdint.h>
+#include "msp.h"
+#include "../../inc/CortexM.h"
+
+//*********** DisableInterrupts ***************
+// disable interrupts
+// inputs:  none
+// outputs: none
+void DisableInterrupts(void){
+  __disable_irq();
+}
+
+//*********** EnableInterrupts ***************
+// enable interrupts
+// inputs:  none
+// outputs: none
+void EnableInterrupts(void){
+  __enable_irq();
+}
+
+//*********** StartCritical ************************
+// make a copy of previous I bit, disable interrupts
+// inputs:  none
+// outputs: previous I bit
+long StartCritical(void){
+  long sr = __get_PRIMASK();
+  __disable_irq();
+  return sr;
+}
+
+//*********** EndCritical ************************
+// using the copy of previous I bit, restore I bit to previous value
+// inputs:  previous I bit
+// outputs: none
+void EndCritical(long sr){
+  __set_PRIMASK(sr);
+}
+
+//*********** WaitForInterrupt ************************
+// go to low power mode while waiting for the next interrupt
+// inputs:  none
+// outputs: none
+void WaitForInterrupt(void){
+  __WFI();
+}
@@ -0,0 +1,885 @@
+// Sim.c
+// Runs on the host, Linux x86-64
+// Core of the MSP432 simulator: maps the register file at the
+// MSP432 addresses, traps each access into the models, keeps
+// simulated time and the clocks, and runs the NVIC, dispatching
+// interrupts to the *_IRQHandler functions of the program.
+// October 16, 2026
+
+// Every device page is mapped twice from one memory file: at its
+// MSP432 address with no access, and elsewhere read/write for the
+// models. An access by the program faults; the SIGSEGV handler
+// brings the models up to date, opens the page and sets the trap
+// flag, the access executes, and the SIGTRAP handler closes the
+// page again and runs the model's hook for the write or read. A read
+// opens the page for reading only, so an instruction that reads and
+// writes, such as x86's and/or/xor on memory, faults a second time
+// at the write and runs both hooks.
+// SIGALRM every 50 us of host time advances the models, runs the
+// script and dispatches interrupts between accesses. SIGALRM is
+// blocked while any model code runs, so the models need no locks;
+// it is unblocked while an interrupt handler runs, so interrupts
+// of higher priority preempt it as on the Cortex-M4.
+// An access to the bit-band alias of a register runs the hooks of
+// the register: a read first copies the bit into the alias word,
+// and a write copies bit 0 of the alias word into the register.
+// The flash is mapped for reading between accesses, so only a write
+// traps (see SimFlash.c). Where vm.mmap_min_addr is above 0x1000 it
+// starts at 0x10000 instead.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+#include "Sim.h"
+
+#define TF          0x100   // x86 trap flag, in EFLAGS
+#define TICK_US     50      // host us between SIGALRMs
+#define THREAD      8       // execution priority of the main program
+#define EVERY_MAX   8
+
+struct Region{
+  uintptr_t Base;           // MSP432 address
+  uint32_t Size;
+  uint8_t *Model;           // the same memory, without traps
+  int Closed;               // access between traps
+};
+static struct Region Regions[] = {
+  {0x40000000, 0x13000, 0, PROT_NONE}, // Timer_A to ADC14
+  {0xE0001000, 0x1000, 0, PROT_NONE},  // DWT
+  {0xE000E000, 0x1000, 0, PROT_NONE},  // SysTick, NVIC, SCB, CoreDebug
+  {0xE0043000, 0x1000, 0, PROT_NONE},  // SYSCTL
+  {0x00001000, 0x3F000, 0, PROT_READ}, // flash, all but the page at 0
+  {0x42000000, 0x13000*32, 0, PROT_NONE}, // bit-band alias of the first, a word per bit
+};
+#define REGIONS (sizeof(Regions)/sizeof(Regions[0]))
+#define FLASH   (&Regions[REGIONS-2])
+#define BITBAND (&Regions[REGIONS-1])
+
+// the access between SIGSEGV and SIGTRAP
+static struct{
+  struct Region *Region;
+  uintptr_t Addr;
+  int Write;
+  int Read;
+  int AlarmBlocked;         // SIGALRM was blocked where the access happened
+} Fault;
+
+// simulated time; a host stall longer than STALL, the process
+// descheduled or stopped in a debugger, counts as STALL only, so the
+// timers do not run whole periods the program had no chance to see
+#define STALL 250000
+static double Speed = 1.0;
+static uint64_t HostBase, HostLast, SimBase;
+
+// NVIC and system exceptions
+static uint32_t Enabled[2];                 // shadow of ISER, written with 1s
+static volatile uint8_t Level[IRQ_COUNT];   // request lines from the models
+static volatile uint8_t Latched[IRQ_COUNT]; // edge requests, cleared on entry
+static volatile uint8_t Active[IRQ_COUNT];
+static volatile int32_t CurrentLevel = THREAD;
+static volatile uint32_t Primask;
+static volatile uint32_t Sleeping;          // in __WFI(), the core clock and DWT->CYCCNT stop
+
+// DMA requests raised by the hooks, carried out afterwards
+static uint32_t Requests[64];
+static uint32_t RequestCount, Servicing;
+
+static struct SimCount Cycles;
+
+// Sim_Every() tasks and script events
+static struct{
+  uint64_t Period, Next;
+  void(*Task)(void);
+} Every[EVERY_MAX];
+static uint32_t EveryCount;
+
+struct Event{
+  uint64_t Time;            // ns
+  char Kind;                // a adc, p pin, c capture, r rx, s speed, l lcd, f flashcut, F flashstall, q quit
+  uint32_t A, B;
+  int32_t Level;
+  double Value;
+  char *Text;
+};
+static struct Event *Events;
+static uint32_t EventCount, EventNext;
+
+void WDT_A_IRQHandler(void) __attribute__((weak));
+void TA0_0_IRQHandler(void) __attribute__((weak));
+void TA0_N_IRQHandler(void) __attribute__((weak));
+void TA1_0_IRQHandler(void) __attribute__((weak));
+void TA1_N_IRQHandler(void) __attribute__((weak));
+void TA2_0_IRQHandler(void) __attribute__((weak));
+void TA2_N_IRQHandler(void) __attribute__((weak));
+void TA3_0_IRQHandler(void) __attribute__((weak));
+void TA3_N_IRQHandler(void) __attribute__((weak));
+void EUSCIA0_IRQHandler(void) __attribute__((weak));
+void EUSCIA1_IRQHandler(void) __attribute__((weak));
+void EUSCIA2_IRQHandler(void) __attribute__((weak));
+void EUSCIA3_IRQHandler(void) __attribute__((weak));
+void EUSCIB0_IRQHandler(void) __attribute__((weak));
+void EUSCIB1_IRQHandler(void) __attribute__((weak));
+void EUSCIB2_IRQHandler(void) __attribute__((weak));
+void EUSCIB3_IRQHandler(void) __attribute__((weak));
+void ADC14_IRQHandler(void) __attribute__((weak));
+void T32_INT1_IRQHandler(void) __attribute__((weak));
+void T32_INT2_IRQHandler(void) __attribute__((weak));
+void DMA_INT3_IRQHandler(void) __attribute__((weak));
+void DMA_INT2_IRQHandler(void) __attribute__((weak));
+void DMA_INT1_IRQHandler(void) __attribute__((weak));
+void DMA_INT0_IRQHandler(void) __attribute__((weak));
+void PORT1_IRQHandler(void) __attribute__((weak));
+void PORT2_IRQHandler(void) __attribute__((weak));
+void PORT3_IRQHandler(void) __attribute__((weak));
+void PORT4_IRQHandler(void) __attribute__((weak));
+void PORT5_IRQHandler(void) __attribute__((weak));
+void PORT6_IRQHandler(void) __attribute__((weak));
+void SysTick_Handler(void) __attribute__((weak));
+void PendSV_Handler(void) __attribute__((weak));
+
+static void(*const Vectors[IRQ_COUNT])(void) = {
+  [IRQ_WDT_A] = WDT_A_IRQHandler,
+  [8] = TA0_0_IRQHandler, [9] = TA0_N_IRQHandler,
+  [10] = TA1_0_IRQHandler, [11] = TA1_N_IRQHandler,
+  [12] = TA2_0_IRQHandler, [13] = TA2_N_IRQHandler,
+  [14] = TA3_0_IRQHandler, [15] = TA3_N_IRQHandler,
+  [16] = EUSCIA0_IRQHandler, [17] = EUSCIA1_IRQHandler,
+  [18] = EUSCIA2_IRQHandler, [19] = EUSCIA3_IRQHandler,
+  [20] = EUSCIB0_IRQHandler, [21] = EUSCIB1_IRQHandler,
+  [22] = EUSCIB2_IRQHandler, [23] = EUSCIB3_IRQHandler,
+  [IRQ_ADC14] = ADC14_IRQHandler,
+  [IRQ_T32_INT1] = T32_INT1_IRQHandler, [IRQ_T32_INT2] = T32_INT2_IRQHandler,
+  [IRQ_DMA_INT3] = DMA_INT3_IRQHandler, [IRQ_DMA_INT2] = DMA_INT2_IRQHandler,
+  [IRQ_DMA_INT1] = DMA_INT1_IRQHandler, [IRQ_DMA_INT0] = DMA_INT0_IRQHandler,
+  [35] = PORT1_IRQHandler, [36] = PORT2_IRQHandler, [37] = PORT3_IRQHandler,
+  [38] = PORT4_IRQHandler, [39] = PORT5_IRQHandler, [40] = PORT6_IRQHandler,
+  [IRQ_SYSTICK] = SysTick_Handler,
+  [IRQ_PENDSV] = PendSV_Handler,
+};
+
+//------------Time------------
+static uint64_t hostTime(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec*1000000000u + t.tv_nsec;
+}
+
+uint64_t Sim_Now(void){
+  uint64_t host = hostTime();
+  if(host - HostLast > STALL){
+    HostBase = HostBase + (host - HostLast - STALL);
+  }
+  HostLast = host;
+  return SimBase + (uint64_t)((double)(host - HostBase)*Speed);
+}
+
+uint64_t Sim_Periods(struct SimCount *c, uint64_t now, uint32_t hz){
+  unsigned __int128 total;
+  uint64_t periods;
+  if(now <= c->Last){
+    return 0;
+  }
+  total = (unsigned __int128)(now - c->Last)*hz + c->Fraction;
+  periods = (uint64_t)(total/1000000000u);
+  c->Fraction = (uint64_t)(total%1000000000u);
+  c->Last = now;
+  return periods;
+}
+
+// lock out SIGALRM, and so every model, while the caller works
+static void lock(sigset_t *old){
+  sigset_t alarm;
+  sigemptyset(&alarm);
+  sigaddset(&alarm, SIGALRM);
+  sigprocmask(SIG_BLOCK, &alarm, old);
+}
+static void unlock(const sigset_t *old){
+  sigprocmask(SIG_SETMASK, old, 0);
+}
+
+//------------Clocks------------
+static uint32_t oscillator(uint32_t select){
+  CS_Type *cs = MODEL(CS);
+  switch(select){
+    case 0: return 32768;                       // LFXT
+    case 1: return 9400;                        // VLO
+    case 2: return (cs->CLKEN&0x8000)? 128000 : 32768; // REFO
+    case 3: return 1500000<<(((cs->CTL0>>16)&7) > 5? 5 : ((cs->CTL0>>16)&7)); // DCO
+    case 4: return 24000000;                    // MODOSC
+    case 5: return 48000000;                    // HFXT
+    default: return 32768;
+  }
+}
+uint32_t Sim_MCLK(void){
+  CS_Type *cs = MODEL(CS);
+  return oscillator(cs->CTL1&7)>>((cs->CTL1>>16)&7);
+}
+uint32_t Sim_SMCLK(void){
+  CS_Type *cs = MODEL(CS);
+  return oscillator((cs->CTL1>>4)&7)>>((cs->CTL1>>28)&7);
+}
+uint32_t Sim_ACLK(void){
+  CS_Type *cs = MODEL(CS);
+  return oscillator((cs->CTL1>>8)&7)>>((cs->CTL1>>24)&7);
+}
+
+//------------Register file------------
+static struct Region *region(uintptr_t addr){
+  uint32_t i;
+  for(i = 0; i < REGIONS; i++){
+    if((addr >= Regions[i].Base) && (addr < Regions[i].Base+Regions[i].Size)){
+      return &Regions[i];
+    }
+  }
+  return 0;
+}
+
+void *Sim_Model(const volatile void *device){
+  uintptr_t addr = (uintptr_t)device;
+  struct Region *r = region(addr);
+  if(r == 0){
+    return (void *)addr;                        // memory, as the DMA sees it
+  }
+  return r->Model + (addr - r->Base);
+}
+
+// bring every model up to the current time
+static void update(uint64_t now){
+  DWT_Type *dwt = MODEL(DWT);
+  CoreDebug_Type *debug = MODEL(CoreDebug);
+  uint64_t cycles = Sim_Periods(&Cycles, now, Sim_MCLK());
+  if((debug->DEMCR&0x01000000) && (dwt->CTRL&1) && (Sleeping == 0)){
+    dwt->CYCCNT += (uint32_t)cycles;
+  }
+  SimTimer_Update(now);
+  SimSerial_Update(now);
+}
+
+// core registers in this file
+static void coreWrite(uintptr_t addr){
+  NVIC_Type *nvic = MODEL(NVIC);
+  SCB_Type *scb = MODEL(SCB);
+  PCM_Type *pcm = MODEL(PCM);
+  CS_Type *cs = MODEL(CS);
+  uint32_t i, n;
+  if(addr == (uintptr_t)&PCM->CTL0){
+    n = pcm->CTL0&0x0F;                         // the power mode changes at once
+    pcm->CTL0 = 0xA5960000|(n<<8)|n;
+  }else if(addr == (uintptr_t)&PCM->CLRIFG){
+    pcm->CLRIFG = 0;
+  }else if(addr == (uintptr_t)&CS->CLRIFG){
+    cs->CLRIFG = 0;
+  }else if((addr >= (uintptr_t)&NVIC->ISER[0]) && (addr < (uintptr_t)&NVIC->ISER[8])){
+    n = (addr - (uintptr_t)&NVIC->ISER[0])/4;
+    if(n < 2) Enabled[n] |= nvic->ISER[n];
+  }else if((addr >= (uintptr_t)&NVIC->ICER[0]) && (addr < (uintptr_t)&NVIC->ICER[8])){
+    n = (addr - (uintptr_t)&NVIC->ICER[0])/4;
+    if(n < 2) Enabled[n] &= ~nvic->ICER[n];
+  }else if((addr >= (uintptr_t)&NVIC->ISPR[0]) && (addr < (uintptr_t)&NVIC->ISPR[2])){
+    n = (addr - (uintptr_t)&NVIC->ISPR[0])/4;
+    for(i = 0; i < 32; i++){
+      if(nvic->ISPR[n]&(1u<<i)) Latched[32*n+i] = 1;
+    }
+  }else if((addr >= (uintptr_t)&NVIC->ICPR[0]) && (addr < (uintptr_t)&NVIC->ICPR[2])){
+    n = (addr - (uintptr_t)&NVIC->ICPR[0])/4;
+    for(i = 0; i < 32; i++){
+      if(nvic->ICPR[n]&(1u<<i)) Latched[32*n+i] = 0;
+    }
+  }else if(addr == (uintptr_t)&SCB->ICSR){
+    if(scb->ICSR&0x10000000) Latched[IRQ_PENDSV] = 1;
+    if(scb->ICSR&0x08000000) Latched[IRQ_PENDSV] = 0;
+    if(scb->ICSR&0x04000000) Latched[IRQ_SYSTICK] = 1;
+    if(scb->ICSR&0x02000000) Latched[IRQ_SYSTICK] = 0;
+    scb->ICSR = 0;
+  }
+}
+
+// the register file seen by the program after a read
+static void coreRead(uintptr_t addr){
+  NVIC_Type *nvic = MODEL(NVIC);
+  uint32_t i, n;
+  for(n = 0; n < 2; n++){
+    nvic->ISER[n] = nvic->ICER[n] = Enabled[n];
+    nvic->ISPR[n] = nvic->ICPR[n] = nvic->IABR[n] = 0;
+    for(i = 0; i < 32; i++){
+      if(Latched[32*n+i] || Level[32*n+i]) nvic->ISPR[n] = nvic->ICPR[n] |= 1u<<i;
+      if(Active[32*n+i]) nvic->IABR[n] |= 1u<<i;
+    }
+  }
+  (void)addr;
+}
+
+static void hookRead(uintptr_t addr){
+  if(addr < 0x00040000)      return;            // flash
+  else if(addr < 0x40001000) SimTimer_Read(addr);
+  else if(addr < 0x40003000) SimSerial_Read(addr);
+  else if(addr < 0x40004000) return;
+  else if(addr < 0x40004C00) SimTimer_Read(addr);   // WDT_A
+  else if(addr < 0x40005000) SimGPIO_Read(addr);
+  else if(addr < 0x4000E000) SimTimer_Read(addr);   // Timer32
+  else if(addr >= 0x40011000 && addr < 0x40012000) SimFlash_Read(addr);
+  else if(addr >= 0x40012000 && addr < 0x40013000) SimADC_Read(addr);
+  else if(addr >= 0xE000E010 && addr < 0xE000E020) SimTimer_Read(addr);
+  else if(addr >= 0xE000E100) coreRead(addr);
+}
+
+static void hookAfterRead(uintptr_t addr){
+  if(addr < 0x00040000)      return;
+  else if(addr < 0x40001000) SimTimer_AfterRead(addr);
+  else if(addr < 0x40003000) SimSerial_AfterRead(addr);
+  else if(addr < 0x40004800) return;
+  else if(addr < 0x40004C00) SimTimer_AfterRead(addr);
+  else if(addr < 0x40005000) SimGPIO_AfterRead(addr);
+  else if(addr < 0x4000E000) SimTimer_AfterRead(addr);
+  else if(addr >= 0x40012000 && addr < 0x40013000) SimADC_AfterRead(addr);
+  else if(addr >= 0xE000E010 && addr < 0xE000E020) SimTimer_AfterRead(addr);
+}
+
+static void hookWrite(uintptr_t addr){
+  if(addr < 0x00040000)      SimFlash_Write(addr);
+  else if(addr < 0x40001000) SimTimer_Write(addr);
+  else if(addr < 0x40003000) SimSerial_Write(addr);
+  else if(addr < 0x40004000) SimADC_Write(addr);     // REF_A
+  else if(addr < 0x40004800) return;
+  else if(addr < 0x40004C00) SimTimer_Write(addr);
+  else if(addr < 0x40005000) SimGPIO_Write(addr);
+  else if(addr < 0x4000E000) SimTimer_Write(addr);
+  else if(addr < 0x40010000) SimDMA_Write(addr);
+  else if(addr >= 0x40011000 && addr < 0x40012000) SimFlash_Write(addr);
+  else if(addr >= 0x40012000 && addr < 0x40013000) SimADC_Write(addr);
+  else if(addr >= 0xE000E010 && addr < 0xE000E020) SimTimer_Write(addr);
+  else coreWrite(addr);
+}
+
+uint32_t Sim_BusRead(uintptr_t addr, uint32_t size){
+  void *p = Sim_Model((void *)addr);
+  uint32_t value;
+  if(region(addr)){
+    hookRead(addr);
+  }
+  value = (size == 1)? *(uint8_t *)p : (size == 2)? *(uint16_t *)p : *(uint32_t *)p;
+  if(region(addr)){
+    hookAfterRead(addr);
+  }
+  return value;
+}
+
+// the register behind an address, and its bit for a bit-band alias
+static uintptr_t device(uintptr_t addr, uint32_t *bit){
+  struct Region *r = BITBAND;
+  if((addr < r->Base) || (addr >= r->Base + r->Size)){
+    return addr;
+  }
+  *bit = ((addr - r->Base)/4)%8;
+  return Regions[0].Base + (addr - r->Base)/32;
+}
+static volatile uint32_t *alias(uintptr_t addr){
+  return (volatile uint32_t *)Sim_Model((void *)(addr&~(uintptr_t)3));
+}
+
+void Sim_BusWrite(uintptr_t addr, uint32_t value, uint32_t size){
+  void *p = Sim_Model((void *)addr);
+  if(region(addr) == FLASH){
+    SimFlash_Before(addr);
+  }
+  if(size == 1)      *(uint8_t *)p = value;
+  else if(size == 2) *(uint16_t *)p = value;
+  else               *(uint32_t *)p = value;
+  if(region(addr)){
+    hookWrite(addr);
+  }
+}
+
+//------------DMA requests------------
+void Sim_DMARequest(uint32_t source){
+  if(RequestCount < 64){
+    Requests[RequestCount++] = source;
+  }
+}
+
+// carry out the queued requests; a transfer may raise more
+static void service(void){
+  uint32_t i;
+  if(Servicing){
+    return;                                     // the outer call finishes the queue
+  }
+  Servicing = 1;
+  while(RequestCount){
+    uint32_t source = Requests[0];
+    RequestCount = RequestCount - 1;
+    for(i = 0; i < RequestCount; i++){
+      Requests[i] = Requests[i+1];
+    }
+    SimDMA_Request(source);
+  }
+  Servicing = 0;
+}
+
+//------------Interrupts------------
+void Sim_Line(uint32_t irq, uint32_t level){
+  Level[irq] = (level != 0);
+}
+
+void Sim_Pend(uint32_t irq){
+  Latched[irq] = 1;
+}
+
+static uint32_t enabled(uint32_t irq){
+  if(irq >= 64){
+    return 1;                                   // system exceptions
+  }
+  return (Enabled[irq/32]>>(irq%32))&1;
+}
+
+static int32_t priority(uint32_t irq){
+  NVIC_Type *nvic = MODEL(NVIC);
+  SCB_Type *scb = MODEL(SCB);
+  if(irq == IRQ_SYSTICK) return scb->SHP[11]>>5;
+  if(irq == IRQ_PENDSV) return scb->SHP[10]>>5;
+  return (nvic->IP[irq/4]>>(8*(irq%4)+5))&7;
+}
+
+// highest priority request that can preempt what runs now, or -1
+static int32_t next(void){
+  int32_t best = -1, level = CurrentLevel;
+  uint32_t i;
+  for(i = 0; i < IRQ_COUNT; i++){
+    if((Latched[i] || Level[i]) && !Active[i] && enabled(i)){
+      int32_t p = priority(i);
+      if(p < level){
+        level = p;
+        best = i;
+      }
+    }
+  }
+  return best;
+}
+
+// run the handlers that can preempt, called with SIGALRM blocked
+static void dispatch(void){
+  sigset_t alarm, old;
+  int32_t irq, saved;
+  while((Primask == 0) && ((irq = next()) >= 0)){
+    saved = CurrentLevel;
+    CurrentLevel = priority(irq);
+    Active[irq] = 1;
+    Latched[irq] = 0;
+    if(Vectors[irq]){
+      sigemptyset(&alarm);
+      sigaddset(&alarm, SIGALRM);
+      sigprocmask(SIG_UNBLOCK, &alarm, &old);
+      Vectors[irq]();
+      sigprocmask(SIG_SETMASK, &old, 0);
+    }else{
+      fprintf(stderr, "msp432sim: interrupt %d has no handler, disabled\n", irq);
+      if(irq < 64) Enabled[irq/32] &= ~(1u<<(irq%32));
+    }
+    Active[irq] = 0;
+    CurrentLevel = saved;
+  }
+}
+
+static void dispatchLocked(void){
+  sigset_t old;
+  lock(&old);
+  update(Sim_Now());
+  service();
+  dispatch();
+  unlock(&old);
+}
+
+void __disable_irq(void){
+  Primask = 1;
+}
+
+void __enable_irq(void){
+  Primask = 0;
+  dispatchLocked();
+}
+
+uint32_t __get_PRIMASK(void){
+  return Primask;
+}
+
+void __set_PRIMASK(uint32_t priMask){
+  Primask = priMask&1;
+  if(Primask == 0){
+    dispatchLocked();
+  }
+}
+
+// sleep until the next SIGALRM unless a request is waiting; as on
+// the Cortex-M4 a request wakes the core even with PRIMASK set, and
+// the cycle counter does not count the time asleep
+void __WFI(void){
+  sigset_t old, wait;
+  lock(&old);
+  update(Sim_Now());
+  service();
+  if(next() < 0){
+    wait = old;
+    sigdelset(&wait, SIGALRM);
+    Sleeping = 1;
+    sigsuspend(&wait);
+    Sleeping = 0;
+  }
+  dispatch();
+  unlock(&old);
+}
+
+//------------Traps------------
+static void segvHandler(int sig, siginfo_t *info, void *context){
+  ucontext_t *uc = context;
+  uintptr_t addr = (uintptr_t)info->si_addr;
+  struct Region *r = region(addr);
+  int write = (uc->uc_mcontext.gregs[REG_ERR]&2) != 0;
+  if((r == Fault.Region) && (addr == Fault.Addr) && write && !Fault.Write){
+    Fault.Write = 1;                            // read-modify-write
+    mprotect((void *)r->Base, r->Size, PROT_READ|PROT_WRITE);
+    return;
+  }
+  if((r == 0) || Fault.Region){
+    signal(SIGSEGV, SIG_DFL);                   // a real fault: crash on return
+    return;
+  }
+  Fault.Region = r;
+  Fault.Addr = addr;
+  Fault.Write = write;
+  Fault.Read = !write;
+  Fault.AlarmBlocked = sigismember(&uc->uc_sigmask, SIGALRM);
+  sigaddset(&uc->uc_sigmask, SIGALRM);          // until the access is done
+  update(Sim_Now());
+  if(r == FLASH){
+    SimFlash_Before(addr);                      // only writes trap
+  }
+  if(!write){
+    uint32_t bit;
+    uintptr_t reg = device(addr, &bit);
+    hookRead(reg);
+    if(reg != addr){
+      *alias(addr) = (*(uint8_t *)Sim_Model((void *)reg)>>bit)&1;
+    }
+  }
+  mprotect((void *)r->Base, r->Size, write? PROT_READ|PROT_WRITE : PROT_READ);
+  uc->uc_mcontext.gregs[REG_EFL] |= TF;
+  (void)sig;
+}
+
+static void trapHandler(int sig, siginfo_t *info, void *context){
+  ucontext_t *uc = context;
+  uintptr_t addr = Fault.Addr;
+  int write = Fault.Write, read = Fault.Read;
+  int blocked = Fault.AlarmBlocked;
+  uint32_t bit;
+  uintptr_t reg = device(addr, &bit);
+  uint8_t *byte = Sim_Model((void *)reg);
+  if(Fault.Region == 0){
+    signal(SIGTRAP, SIG_DFL);                   // not ours
+    raise(SIGTRAP);
+    return;
+  }
+  mprotect((void *)Fault.Region->Base, Fault.Region->Size, Fault.Region->Closed);
+  uc->uc_mcontext.gregs[REG_EFL] &= ~TF;
+  Fault.Region = 0;
+  if(read){
+    hookAfterRead(reg);
+  }
+  if(write){
+    if(reg != addr){
+      *byte = (*alias(addr)&1)? *byte|(1u<<bit) : *byte&~(1u<<bit);
+    }
+    hookWrite(reg);
+  }
+  service();
+  if(!blocked){
+    sigdelset(&uc->uc_sigmask, SIGALRM);
+    dispatch();
+  }
+  (void)sig; (void)info;
+}
+
+//------------Events------------
+static void event(struct Event *e){
+  switch(e->Kind){
+    case 'a': Sim_SetVoltage(e->A, e->Value); break;
+    case 'p': Sim_SetPin(e->A, e->B, e->Level); break;
+    case 'c': Sim_Capture(e->A, e->B); break;
+    case 'r': SimSerial_Receive(e->A, e->Text, strlen(e->Text)); break;
+    case 's': Sim_SetSpeed(e->Value); break;
+    case 'l': SimLCD_Print(); break;
+    case 'f': SimFlash_Cut(e->A); break;
+    case 'F': SimFlash_Stall(e->A); break;
+    case 'q': _exit(e->Level);
+  }
+}
+
+static void alarmHandler(int sig){
+  uint64_t now = Sim_Now();
+  uint32_t i;
+  update(now);
+  Sleeping = 0;                                 // awake for what follows
+  while((EventNext < EventCount) && (Events[EventNext].Time <= now)){
+    event(&Events[EventNext]);
+    EventNext = EventNext + 1;
+  }
+  for(i = 0; i < EveryCount; i++){
+    while(Every[i].Next <= now){
+      Every[i].Next += Every[i].Period;
+      Every[i].Task();
+    }
+  }
+  service();
+  dispatch();
+  (void)sig;
+}
+
+// read MSP432SIM_SCRIPT, sorted by time
+static int byTime(const void *a, const void *b){
+  const struct Event *x = a, *y = b;
+  return (x->Time > y->Time) - (x->Time < y->Time);
+}
+static void script(const char *name){
+  char *text, *line, *save, *p;
+  long size;
+  uint32_t lineNumber = 0;
+  FILE *file = fopen(name, "r");
+  if(file == 0){
+    perror(name);
+    _exit(1);
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  text = calloc(size+1, 1);
+  if(fread(text, 1, size, file) != (size_t)size){
+    perror(name);
+    _exit(1);
+  }
+  fclose(file);
+  Events = calloc(size/4+1, sizeof(struct Event));
+  for(line = strtok_r(text, "\n", &save); line; line = strtok_r(0, "\n", &save)){
+    struct Event *e = &Events[EventCount];
+    char kind[16];
+    int n = 0;
+    lineNumber = lineNumber + 1;
+    p = line + strspn(line, " \t");
+    if((*p == '#') || (*p == 0) || (*p == '\r')) continue;
+    e->Time = (uint64_t)(strtod(p, &p)*1e9);
+    if(sscanf(p, " %15s %n", kind, &n) != 1) goto bad;
+    p += n;
+    e->Kind = kind[0];
+    if(strcmp(kind, "adc") == 0){
+      if(sscanf(p, "%u %lf", &e->A, &e->Value) != 2) goto bad;
+    }else if(strcmp(kind, "pin") == 0){
+      char level;
+      if(sscanf(p, "%u.%u %c", &e->A, &e->B, &level) != 3) goto bad;
+      e->Level = (level == 'z')? -1 : (level == '1');
+    }else if(strcmp(kind, "capture") == 0){
+      if(sscanf(p, "%u %u", &e->A, &e->B) != 2) goto bad;
+    }else if(strcmp(kind, "rx") == 0){
+      if(sscanf(p, "%u %n", &e->A, &n) != 1) goto bad;
+      e->Text = malloc(strlen(p+n)+2);
+      strcpy(e->Text, p+n);
+      strtok(e->Text, "\r");
+      strcat(e->Text, "\r");
+    }else if(strcmp(kind, "speed") == 0){
+      if(sscanf(p, "%lf", &e->Value) != 1) goto bad;
+    }else if(strcmp(kind, "lcd") == 0){
+    }else if(strcmp(kind, "flashcut") == 0){
+      if(sscanf(p, "%u", &e->A) != 1) goto bad;
+    }else if(strcmp(kind, "flashstall") == 0){
+      if(sscanf(p, "%u", &e->A) != 1) goto bad;
+      e->Kind = 'F';
+    }else if(strcmp(kind, "quit") == 0){
+      e->Level = atoi(p);
+    }else{
+      goto bad;
+    }
+    EventCount = EventCount + 1;
+    continue;
+bad:
+    fprintf(stderr, "msp432sim: %s:%u: cannot parse \"%s\"\n", name, lineNumber, line);
+    _exit(1);
+  }
+  qsort(Events, EventCount, sizeof(struct Event), byTime);
+}
+
+//------------Sim_Init------------
+// Map the register file, reset the models and start the time base,
+// before main() of the program runs.
+__attribute__((constructor)) static void Sim_Init(void){
+  struct sigaction action;
+  struct itimerval tick = {{0, TICK_US}, {0, TICK_US}};
+  uint32_t i;
+  for(i = 0; i < REGIONS; i++){
+    struct Region *r = &Regions[i];
+    int fd = (r == FLASH)? SimFlash_Open() : memfd_create("msp432sim", 0);
+    off_t offset = (r == FLASH)? r->Base : 0;   // the flash file starts at address 0
+    void *device;
+    if((fd < 0) || ((r != FLASH) && (ftruncate(fd, r->Size) < 0))){
+      perror("msp432sim: memfd");
+      _exit(1);
+    }
+    device = mmap((void *)r->Base, r->Size, r->Closed, MAP_SHARED|MAP_FIXED_NOREPLACE, fd, offset);
+    if((r == FLASH) && (device != (void *)r->Base)){
+      if(device != MAP_FAILED) munmap(device, r->Size);
+      r->Size = r->Base + r->Size - 0x10000;    // below vm.mmap_min_addr
+      r->Base = offset = 0x10000;
+      device = mmap((void *)r->Base, r->Size, r->Closed, MAP_SHARED|MAP_FIXED_NOREPLACE, fd, offset);
+    }
+    r->Model = mmap(0, r->Size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, offset);
+    if((device != (void *)r->Base) || (r->Model == MAP_FAILED)){
+      fprintf(stderr, "msp432sim: cannot map registers at 0x%08lx\n", (unsigned long)r->Base);
+      _exit(1);
+    }
+    close(fd);
+  }
+  // reset values of the core registers
+  MODEL(CS)->CTL0 = 0x00010000;                 // DCO 3 MHz
+  MODEL(CS)->CTL1 = 0x00000033;                 // MCLK and SMCLK from the DCO
+  MODEL(PCM)->CTL0 = 0xA5960000;
+  MODEL(SCB)->CPUID = 0x410FC241;
+  MODEL(SYSCTL)->SRAM_SIZE = 0x00010000;
+  SimGPIO_Init();
+  SimTimer_Init();
+  SimSerial_Init();
+  SimDMA_Init();
+  SimFlash_Init();
+
+  HostBase = HostLast = hostTime();
+  if(getenv("MSP432SIM_SPEED")){
+    Speed = atof(getenv("MSP432SIM_SPEED"));
+  }
+  if(getenv("MSP432SIM_SCRIPT")){
+    script(getenv("MSP432SIM_SCRIPT"));
+  }
+
+  memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  sigaddset(&action.sa_mask, SIGALRM);
+  action.sa_flags = SA_SIGINFO;
+  action.sa_sigaction = segvHandler;
+  sigaction(SIGSEGV, &action, 0);
+  action.sa_flags = SA_SIGINFO|SA_NODEFER;      // handlers it calls trap again
+  action.sa_sigaction = trapHandler;
+  sigaction(SIGTRAP, &action, 0);
+  memset(&action, 0, sizeof(action));
+  action.sa_flags = SA_RESTART;
+  action.sa_handler = alarmHandler;
+  sigaction(SIGALRM, &action, 0);
+  setitimer(ITIMER_REAL, &tick, 0);
+}
+
+//------------Sim.h------------
+// The calls below may come from the program, where they dispatch
+// the interrupts they cause, or from a Sim_Every() task or the
+// script, where SIGALRM is already blocked and the alarm handler
+// dispatches them afterwards.
+static void begin(sigset_t *old){
+  lock(old);
+  update(Sim_Now());
+}
+static void end(const sigset_t *old){
+  service();
+  if(!sigismember(old, SIGALRM)){
+    dispatch();
+  }
+  unlock(old);
+}
+
+uint64_t Sim_Time(void){
+  sigset_t old;
+  uint64_t now;
+  lock(&old);
+  now = Sim_Now();
+  unlock(&old);
+  return now;
+}
+
+void Sim_SetSpeed(double rate){
+  sigset_t old;
+  lock(&old);
+  SimBase = Sim_Now();
+  HostBase = HostLast;
+  Speed = (rate > 0)? rate : Speed;
+  unlock(&old);
+}
+
+void Sim_Every(uint32_t us, void(*task)(void)){
+  sigset_t old;
+  lock(&old);
+  if((EveryCount < EVERY_MAX) && us){
+    Every[EveryCount].Period = (uint64_t)us*1000;
+    Every[EveryCount].Next = Sim_Now() + Every[EveryCount].Period;
+    Every[EveryCount].Task = task;
+    EveryCount = EveryCount + 1;
+  }
+  unlock(&old);
+}
+
+void Sim_SetVoltage(uint32_t channel, double volts){
+  sigset_t old;
+  begin(&old);
+  SimADC_Voltage(channel, volts);
+  end(&old);
+}
+
+void Sim_SetPin(uint32_t port, uint32_t pin, int32_t level){
+  sigset_t old;
+  begin(&old);
+  SimGPIO_Drive(port, pin, level);
+  end(&old);
+}
+
+uint32_t Sim_GetPin(uint32_t port, uint32_t pin){
+  sigset_t old;
+  uint32_t level;
+  begin(&old);
+  level = SimGPIO_Level(port, pin);
+  end(&old);
+  return level;
+}
+
+void Sim_Capture(uint32_t timer, uint32_t ccr){
+  sigset_t old;
+  begin(&old);
+  SimTimer_Capture(timer, ccr);
+  end(&old);
+}
+
+double Sim_Duty(uint32_t timer, uint32_t ccr){
+  sigset_t old;
+  double duty;
+  begin(&old);
+  duty = SimTimer_Duty(timer, ccr);
+  end(&old);
+  return duty;
+}
+
+void Sim_Watch(void(*watch)(uint8_t data)){
+  sigset_t old;
+  begin(&old);
+  SimSerial_Watch(watch);
+  end(&old);
+}
+
+uint32_t Sim_Display(uint8_t image[504]){
+  sigset_t old;
+  uint32_t data;
+  begin(&old);
+  data = SimLCD_Image(image);
+  end(&old);
+  return data;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file      Sim.h
+ * @brief     Host-side MSP432 simulator: the outside world of a lab main
+ * @details   A lab main and the unmodified inc/ drivers are compiled
+ * for the host against the msp.h in this directory and linked with
+ * the simulator (see CMakeLists.txt). Before main() runs, the
+ * simulator maps the peripheral registers at their MSP432 addresses
+ * and traps every access, so each read and write reaches a
+ * behavioral model:<br>
+ * GPIO P1-P10 with pull resistors and edge interrupts on P1-P6,
+ * Timer_A0-A3 in up, continuous and up/down modes with compare,
+ * capture and PWM outputs, Timer32, SysTick, the DWT cycle counter,
+ * the watchdog interval timer, eUSCI UART and SPI, ADC14 with
+ * software and timer triggers, the DMA in basic and ping-pong
+ * cycles, bit-band access to the registers, a Nokia 5110 LCD
+ * on EUSCI_A3, and the flash with the FLCTL program and erase
+ * operations that inc/FlashProgram.c uses, which take simulated
+ * time (see SimFlash.c). Interrupts go through an NVIC model to the ordinary
+ * *_IRQHandler functions, with priorities and preemption.<br>
+ * Simulated time follows the host clock, scaled by the speed; a
+ * stall of the host process counts as a quarter millisecond. Each
+ * register access costs some microseconds of host time, so a
+ * program with fast interrupts, for example ADC14DMA.c at 100 kHz,
+ * needs a speed below 1 to keep up.
+ * EUSCI_A0 is a pseudo-terminal whose name is printed at start,
+ * stdin and stdout with MSP432SIM_UART=stdio, or nothing with
+ * MSP432SIM_UART=none. The flash starts erased, or is kept in the
+ * file MSP432SIM_FLASH names, 256 KB from address 0, across runs.
+ * MSP432SIM_SPEED sets the speed at start, and MSP432SIM_SCRIPT names
+ * a file of timed events, one per line:<br>
+ *   0.5 adc 17 1.25      ADC channel 17 reads 1.25 V<br>
+ *   1.0 pin 1.1 0        drive P1.1 low (z to release)<br>
+ *   1.2 capture 3 0      edge on TA3 CCR0 capture input<br>
+ *   1.5 rx 0 hello       characters and a CR into EUSCI_A0<br>
+ *   2.0 speed 0.1        run at a tenth of real time<br>
+ *   3.0 lcd              draw the Nokia 5110 on stderr<br>
+ *   4.0 flashcut 3       power fails part way through the third flash
+ *                        program or erase from now, exit with status 2<br>
+ *   4.5 flashstall 1     the next flash program or erase never finishes<br>
+ *   9.0 quit 0           exit with status 0<br>
+ * Host code linked with a lab main can do the same through the
+ * functions below, for example a model of the robot called with
+ * Sim_Every() that reads Sim_Duty() and calls Sim_Capture().
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __SIM_H__ // do not include more than once
+#define __SIM_H__
+#include <stdint.h>
+
+/**
+ * Simulated time since the start
+ * @param none
+ * @return time in ns
+ * @brief  Simulated time
+ */
+uint64_t Sim_Time(void);
+
+/**
+ * Set how fast simulated time runs
+ * @param rate simulated seconds per host second, 1 for real time
+ * @return none
+ * @brief  Simulation speed
+ */
+void Sim_SetSpeed(double rate);
+
+/**
+ * Set the voltage on an ADC14 input channel
+ * @param channel 0 to 23
+ * @param volts input voltage
+ * @return none
+ * @brief  Analog input
+ */
+void Sim_SetVoltage(uint32_t channel, double volts);
+
+/**
+ * Drive a port pin from outside
+ * @param port 1 to 10
+ * @param pin 0 to 7
+ * @param level 0 or 1, -1 to release it to its pull resistor
+ * @return none
+ * @brief  Digital input
+ */
+void Sim_SetPin(uint32_t port, uint32_t pin, int32_t level);
+
+/**
+ * Level of a port pin as seen from outside
+ * @param port 1 to 10
+ * @param pin 0 to 7
+ * @return 0 or 1
+ * @brief  Digital output
+ */
+uint32_t Sim_GetPin(uint32_t port, uint32_t pin);
+
+/**
+ * Capture the count of a Timer_A channel set to capture, as an edge
+ * on its input would
+ * @param timer 0 to 3
+ * @param ccr 0 to 6
+ * @return none
+ * @brief  Capture input
+ */
+void Sim_Capture(uint32_t timer, uint32_t ccr);
+
+/**
+ * Duty cycle of a Timer_A output
+ * @param timer 0 to 3
+ * @param ccr 1 to 6
+ * @return fraction of the period the output is high, 0 to 1
+ * @brief  PWM output
+ */
+double Sim_Duty(uint32_t timer, uint32_t ccr);
+
+/**
+ * Contents of the Nokia 5110 on EUSCI_A3, as its PCD8544 holds them
+ * @param image 504 bytes to fill, 6 banks of 84 columns, bit 0 of
+ * each byte the top pixel of the bank
+ * @return data bytes the LCD has taken since the start
+ * @brief  LCD output
+ */
+uint32_t Sim_Display(uint8_t image[504]);
+
+/**
+ * Run a host function periodically in simulated time, in the
+ * context of an interrupt of higher priority than any in the NVIC
+ * @param us period in simulated us
+ * @param task function to run, for example a model of the robot
+ * @return none
+ * @brief  Periodic host model
+ */
+void Sim_Every(uint32_t us, void(*task)(void));
+
+/**
+ * Watch the bytes EUSCI_A0 sends, whatever MSP432SIM_UART says
+ * @param watch host function called with each byte as it enters
+ * the shift register, with the models locked, 0 for none
+ * @return none
+ * @brief  Serial output
+ */
+void Sim_Watch(void(*watch)(uint8_t data));
+
+#endif // __SIM_H__
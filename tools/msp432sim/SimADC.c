@@ -0,0 +1,140 @@
+// SimADC.c
+// Runs on the host, Linux x86-64
+// ADC14 model of the MSP432 simulator: single, sequence and repeat
+// conversions started by ADC14SC or a timer output, the voltages set
+// with Sim_SetVoltage(), flags, IV, interrupts and the DMA request,
+// and the REF_A reference.
+// October 16, 2026
+
+// A conversion takes no simulated time, so ADC14BUSY always reads
+// 0. With ADC14MSC=0 each trigger converts one channel of the
+// sequence, as the timer-triggered drivers in this repository
+// expect; with ADC14MSC=1 one trigger converts the whole sequence.
+// The DMA request comes at the end of a sequence, or after each
+// conversion of a single channel.
+
+#include <stdint.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+
+static double Voltage[32];      // volts on each input channel
+static uint32_t Next;           // MEM of the next conversion
+
+static double reference(void){
+  static const double Volts[4] = {1.2, 1.45, 2.5, 2.5};
+  return Volts[(MODEL(REF_A)->CTL0>>4)&3];
+}
+
+static void lines(void){
+  ADC14_Type *a = MODEL(ADC14);
+  Sim_Line(IRQ_ADC14, a->IER0&a->IFGR0);
+}
+
+// convert into MEM[n]; return 1 at the end of a sequence
+static uint32_t convert(uint32_t n){
+  ADC14_Type *a = MODEL(ADC14);
+  uint32_t bits = 8 + 2*((a->CTL1>>4)&3), vrsel = (a->MCTL[n]>>8)&0xF;
+  double full = ((vrsel == 1) || (vrsel >= 14))? reference() : 3.3;
+  double code = Voltage[a->MCTL[n]&0x1F]/full*((1u<<bits) - 1) + 0.5;
+  uint32_t conseq = (a->CTL0>>17)&3;
+  if(code < 0) code = 0;
+  if(code > (1u<<bits) - 1) code = (1u<<bits) - 1;
+  a->MEM[n] = (uint32_t)code;
+  a->IFGR0 |= 1u<<n;
+  if((conseq == 0) || (conseq == 2)){           // one channel
+    return 1;
+  }
+  if(a->MCTL[n]&0x80){                          // EOS
+    Next = (a->CTL1>>16)&0x1F;
+    return 1;
+  }
+  Next = (n + 1)&0x1F;
+  return 0;
+}
+
+// one trigger: a conversion, or with MSC the whole sequence
+static uint32_t sample(void){
+  ADC14_Type *a = MODEL(ADC14);
+  uint32_t conseq = (a->CTL0>>17)&3, end;
+  if(!(a->CTL0&0x10) || !(a->CTL0&0x02)){
+    return 0;                                   // off or not enabled
+  }
+  if((conseq == 0) || (conseq == 2)){
+    Next = (a->CTL1>>16)&0x1F;
+  }
+  do{
+    end = convert(Next);
+  }while(!end && (a->CTL0&0x80));
+  if(end){
+    Sim_DMARequest(DMASRC(7, 7));
+  }
+  lines();
+  return end;
+}
+
+void SimADC_Trigger(uint32_t shs, uint64_t count){
+  ADC14_Type *a = MODEL(ADC14);
+  if(((a->CTL0>>27)&7) != shs){
+    return;
+  }
+  while(count){
+    count = count - 1;
+    if(sample()){
+      return;                                   // later triggers of this update overrun
+    }
+  }
+}
+
+void SimADC_AfterRead(uintptr_t addr){
+  ADC14_Type *a = MODEL(ADC14);
+  if((addr >= (uintptr_t)&ADC14->MEM[0]) && (addr < (uintptr_t)&ADC14->MEM[32])){
+    a->IFGR0 &= ~(1u<<((addr - (uintptr_t)&ADC14->MEM[0])/4)); // reading MEM clears its flag
+  }else if(addr == (uintptr_t)&ADC14->IV){
+    if(a->IV >= 0x0C){
+      a->IFGR0 &= ~(1u<<((a->IV - 0x0C)/2));
+    }
+  }
+  lines();
+}
+
+void SimADC_Write(uintptr_t addr){
+  ADC14_Type *a = MODEL(ADC14);
+  REF_A_Type *r = MODEL(REF_A);
+  if(addr == (uintptr_t)&REF_A->CTL0){
+    r->CTL0 &= ~0x3400;                         // not busy, ready when on
+    if(r->CTL0&0x01){
+      r->CTL0 |= 0x3000;
+    }
+    return;
+  }
+  if(addr == (uintptr_t)&ADC14->CTL0){
+    if(!(a->CTL0&0x02)){
+      Next = (a->CTL1>>16)&0x1F;                // ENC=0 ends the sequence
+    }
+    if(a->CTL0&0x01){                           // ADC14SC
+      a->CTL0 &= ~0x01;
+      if(((a->CTL0>>27)&7) == 0){
+        sample();
+      }
+    }
+  }else if(addr == (uintptr_t)&ADC14->CLRIFGR0){
+    a->IFGR0 &= ~a->CLRIFGR0;
+    a->CLRIFGR0 = 0;
+  }
+  lines();
+}
+
+void SimADC_Read(uintptr_t addr){
+  ADC14_Type *a = MODEL(ADC14);
+  uint32_t pending = a->IFGR0&a->IER0;
+  if(addr == (uintptr_t)&ADC14->IV){
+    a->IV = pending? 0x0C + 2*__builtin_ctz(pending) : 0;
+  }
+}
+
+void SimADC_Voltage(uint32_t channel, double volts){
+  if(channel < 32){
+    Voltage[channel] = volts;
+  }
+}
@@ -0,0 +1,158 @@
+// SimDMA.c
+// Runs on the host, Linux x86-64
+// DMA model of the MSP432 simulator: the eight channels of the
+// uDMA controller with basic, auto-request and ping-pong cycles,
+// request sources, the SET/CLR register pairs and the completion
+// interrupts DMA_INT0-3.
+// October 16, 2026
+
+// The control table is the one at DMA_Control->CTLBASE, read as the
+// struct DMADescriptor of inc/DMA.h; on the host its pointers are
+// host pointers, and the program is linked below 4 GB so CTLBASE
+// holds the whole address. Each request moves 2^R_POWER items, or
+// all of them in an auto-request cycle, with end-pointer
+// addressing; register addresses go through the models like any
+// other access, so writing TXBUF shifts a byte out.
+
+#include <stdint.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+#include "../../inc/DMA.h"
+
+#define CHANNELS 8
+
+static uint32_t Enabled, Alternate, Masked, Burst, Priority, Config;
+
+// the SET registers read back the state, the CLR registers as 0
+static void shadows(void){
+  DMA_Control_Type *c = MODEL(DMA_Control);
+  c->ENASET = Enabled;     c->ENACLR = 0;
+  c->ALTSET = Alternate;   c->ALTCLR = 0;
+  c->REQMASKSET = Masked;  c->REQMASKCLR = 0;
+  c->USEBURSTSET = Burst;  c->USEBURSTCLR = 0;
+  c->PRIOSET = Priority;   c->PRIOCLR = 0;
+  c->ALTBASE = c->CTLBASE + CHANNELS*sizeof(struct DMADescriptor);
+  c->STAT = (Config&1)|((CHANNELS - 1)<<16);
+}
+
+// DMA_INT0 is a level for the completions not routed to DMA_INT1-3
+static void int0(void){
+  DMA_Channel_Type *d = MODEL(DMA_Channel);
+  const volatile uint32_t *route = &d->INT1_SRCCFG;
+  uint32_t k, others = (1u<<CHANNELS) - 1;
+  for(k = 0; k < 3; k++){
+    if(route[k]&0x20){
+      others &= ~(1u<<(route[k]&7));
+    }
+  }
+  Sim_Line(IRQ_DMA_INT0, d->INT0_SRCFLG&others);
+}
+
+// DMA_INT1-3 are edges for the channel routed to them
+static void complete(uint32_t ch){
+  DMA_Channel_Type *d = MODEL(DMA_Channel);
+  static const uint8_t Irq[3] = {IRQ_DMA_INT1, IRQ_DMA_INT2, IRQ_DMA_INT3};
+  const volatile uint32_t *route = &d->INT1_SRCCFG;
+  uint32_t k;
+  d->INT0_SRCFLG |= 1u<<ch;
+  for(k = 0; k < 3; k++){
+    if((route[k]&0x20) && ((route[k]&7) == ch)){
+      Sim_Pend(Irq[k]);
+    }
+  }
+  int0();
+}
+
+static uint32_t step(uint32_t code){
+  return (code == 3)? 0 : 1u<<code;             // increment in bytes, 3 is none
+}
+
+// carry out one request on channel ch
+static void transfer(uint32_t ch){
+  DMA_Control_Type *c = MODEL(DMA_Control);
+  struct DMADescriptor *table = (struct DMADescriptor *)(uintptr_t)c->CTLBASE;
+  struct DMADescriptor *d = &table[ch + CHANNELS*((Alternate>>ch)&1)];
+  uint32_t control = d->Control, mode = control&7;
+  uint32_t n = ((control>>4)&0x3FF) + 1, items = 1u<<((control>>14)&0xF);
+  uint32_t srcInc = step((control>>26)&3), dstInc = step((control>>30)&3);
+  uint32_t srcSize = 1u<<((control>>24)&3), dstSize = 1u<<((control>>28)&3);
+  if(!(Config&1) || !((Enabled>>ch)&1) || table == 0){
+    return;
+  }
+  if(mode == 0){
+    Enabled &= ~(1u<<ch);                       // stopped descriptor ends the channel
+    shadows();
+    return;
+  }
+  if(mode == 2){
+    items = n;                                  // auto-request runs to the end
+  }
+  while(items && n){
+    uintptr_t src = (uintptr_t)d->SrcEnd - (n - 1)*srcInc;
+    uintptr_t dst = (uintptr_t)d->DstEnd - (n - 1)*dstInc;
+    Sim_BusWrite(dst, Sim_BusRead(src, srcSize), dstSize);
+    items = items - 1;
+    n = n - 1;
+  }
+  if(n){
+    d->Control = (control&~0x3FF0)|((n - 1)<<4);
+    return;
+  }
+  d->Control = control&~0x3FF7;                 // done: count 0, stopped
+  if(mode == 3){                                // ping-pong goes on with the other one
+    Alternate ^= 1u<<ch;
+    if((table[ch + CHANNELS*((Alternate>>ch)&1)].Control&7) == 0){
+      Enabled &= ~(1u<<ch);
+    }
+  }else{
+    Enabled &= ~(1u<<ch);
+  }
+  shadows();
+  complete(ch);
+}
+
+void SimDMA_Init(void){
+  MODEL(DMA_Channel)->DEVICE_CFG = CHANNELS;
+  shadows();
+}
+
+void SimDMA_Request(uint32_t source){
+  DMA_Channel_Type *d = MODEL(DMA_Channel);
+  uint32_t ch = source/8;
+  if((ch < CHANNELS) && ((d->CH_SRCCFG[ch]&7) == (source&7)) && !((Masked>>ch)&1)){
+    transfer(ch);
+  }
+}
+
+void SimDMA_Write(uintptr_t addr){
+  DMA_Control_Type *c = MODEL(DMA_Control);
+  DMA_Channel_Type *d = MODEL(DMA_Channel);
+  uint32_t ch;
+  if(addr == (uintptr_t)&DMA_Control->CFG)              Config = c->CFG;
+  else if(addr == (uintptr_t)&DMA_Control->ENASET)      Enabled |= c->ENASET;
+  else if(addr == (uintptr_t)&DMA_Control->ENACLR)      Enabled &= ~c->ENACLR;
+  else if(addr == (uintptr_t)&DMA_Control->ALTSET)      Alternate |= c->ALTSET;
+  else if(addr == (uintptr_t)&DMA_Control->ALTCLR)      Alternate &= ~c->ALTCLR;
+  else if(addr == (uintptr_t)&DMA_Control->REQMASKSET)  Masked |= c->REQMASKSET;
+  else if(addr == (uintptr_t)&DMA_Control->REQMASKCLR)  Masked &= ~c->REQMASKCLR;
+  else if(addr == (uintptr_t)&DMA_Control->USEBURSTSET) Burst |= c->USEBURSTSET;
+  else if(addr == (uintptr_t)&DMA_Control->USEBURSTCLR) Burst &= ~c->USEBURSTCLR;
+  else if(addr == (uintptr_t)&DMA_Control->PRIOSET)     Priority |= c->PRIOSET;
+  else if(addr == (uintptr_t)&DMA_Control->PRIOCLR)     Priority &= ~c->PRIOCLR;
+  else if(addr == (uintptr_t)&DMA_Channel->SW_CHTRIG){  // software requests
+    uint32_t trigger = d->SW_CHTRIG;
+    d->SW_CHTRIG = 0;
+    for(ch = 0; ch < CHANNELS; ch++){
+      if((trigger>>ch)&1){
+        transfer(ch);
+      }
+    }
+  }else if(addr == (uintptr_t)&DMA_Channel->INT0_CLRFLG){
+    d->INT0_SRCFLG &= ~d->INT0_CLRFLG;
+    d->INT0_CLRFLG = 0;
+    int0();
+  }
+  Enabled &= (1u<<CHANNELS) - 1;
+  shadows();
+}
@@ -0,0 +1,128 @@
+// SimFile.c
+// Runs on the host, Linux x86-64
+// CCS device table of the MSP432 simulator: add_device(), and the
+// fopen() and freopen() of file.h that open a registered device as a
+// host stream.
+// October 16, 2026
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include "file.h"
+
+#undef fopen                    // the host library from here on
+#undef freopen
+
+#define DEVICES 4
+
+static struct Device{
+  const char *Name;
+  int (*Open)(const char *path, unsigned flags, int llv_fd);
+  int (*Close)(int dev_fd);
+  int (*Read)(int dev_fd, char *buf, unsigned count);
+  int (*Write)(int dev_fd, const char *buf, unsigned count);
+} Device[DEVICES];
+
+// one open device stream
+struct Stream{
+  struct Device *Device;
+  int Fd;
+};
+static struct Stream Streams[8];
+
+int add_device(char *name, unsigned flags,
+               int (*dopen)(const char *path, unsigned flags, int llv_fd),
+               int (*dclose)(int dev_fd),
+               int (*dread)(int dev_fd, char *buf, unsigned count),
+               int (*dwrite)(int dev_fd, const char *buf, unsigned count),
+               off_t (*dlseek)(int dev_fd, off_t offset, int origin),
+               int (*dunlink)(const char *path),
+               int (*drename)(const char *old_name, const char *new_name)){
+  uint32_t i;
+  (void)flags; (void)dlseek; (void)dunlink; (void)drename;
+  for(i = 0; i < DEVICES; i++){
+    if(Device[i].Name == 0){
+      Device[i].Name = name;
+      Device[i].Open = dopen;
+      Device[i].Close = dclose;
+      Device[i].Read = dread;
+      Device[i].Write = dwrite;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+// the device named by "name" or "name:path", or 0
+static struct Device *find(const char *path){
+  uint32_t i;
+  size_t n = strcspn(path, ":");
+  for(i = 0; i < DEVICES; i++){
+    if(Device[i].Name && (strlen(Device[i].Name) == n) && (strncmp(Device[i].Name, path, n) == 0)){
+      return &Device[i];
+    }
+  }
+  return 0;
+}
+
+static ssize_t streamRead(void *cookie, char *buf, size_t size){
+  struct Stream *s = cookie;
+  return s->Device->Read? s->Device->Read(s->Fd, buf, size) : 0;
+}
+
+static ssize_t streamWrite(void *cookie, const char *buf, size_t size){
+  struct Stream *s = cookie;
+  return s->Device->Write? s->Device->Write(s->Fd, buf, size) : (ssize_t)size;
+}
+
+static int streamClose(void *cookie){
+  struct Stream *s = cookie;
+  int status = s->Device->Close? s->Device->Close(s->Fd) : 0;
+  s->Device = 0;
+  return status;
+}
+
+static FILE *device(struct Device *d, const char *path, const char *mode){
+  static const cookie_io_functions_t Functions = {streamRead, streamWrite, 0, streamClose};
+  uint32_t i;
+  const char *name = strchr(path, ':');
+  for(i = 0; i < sizeof(Streams)/sizeof(Streams[0]); i++){
+    if(Streams[i].Device == 0){
+      Streams[i].Fd = d->Open? d->Open(name? name + 1 : "", 0, i) : 0;
+      if(Streams[i].Fd < 0){
+        return 0;
+      }
+      Streams[i].Device = d;
+      return fopencookie(&Streams[i], mode, Functions);
+    }
+  }
+  return 0;
+}
+
+FILE *Sim_DeviceOpen(const char *path, const char *mode){
+  struct Device *d = find(path);
+  return d? device(d, path, mode) : fopen(path, mode);
+}
+
+FILE *Sim_DeviceReopen(const char *path, const char *mode, FILE *stream){
+  struct Device *d = find(path);
+  FILE *f;
+  if(d == 0){
+    return freopen(path, mode, stream);
+  }
+  f = device(d, path, mode);
+  if(f == 0){
+    return 0;
+  }
+  fflush(stream);
+  if(stream == stdout){
+    stdout = f;
+  }else if(stream == stderr){
+    stderr = f;
+  }else if(stream == stdin){
+    stdin = f;
+  }
+  return f;
+}
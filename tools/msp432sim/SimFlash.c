@@ -0,0 +1,361 @@
+// SimFlash.c
+// Runs on the host, Linux x86-64
+// Flash model of the MSP432 simulator: the 256 KB main memory, two
+// banks of 32 sectors of 4 KB, and the FLCTL controller that
+// programs and erases it, with power cuts the script can inject.
+// October 16, 2026
+
+// The flash image is mapped read-only at its MSP432 address, so the
+// program reads it without a trap. A write traps; Sim.c calls
+// SimFlash_Before() first so the word it overwrites is known, and
+// the write is then undone, or carried out as flash programming
+// does it, which can only turn 1s into 0s. Erasing turns a whole
+// sector back to 1s. The data changes when an operation starts; its
+// flag in IFG is set on the first read of FLCTL after it would be
+// done, PROGRAM_NS per word or 128-bit block, ERASE_NS per erase and
+// VERIFY_NS per 16 bytes read, round figures for the model rather
+// than the data sheet's, so a program that does not wait sees the
+// flag still clear. The status bits follow the data sheet closely
+// enough for inc/FlashProgram.c: a pre-verify error is a bit to be
+// programmed that is already 0, a post-verify error a bit to be
+// programmed that is still 1, and an erase verify (RDBRST) counts
+// the 16-byte blocks that are not all 1s. Full-word program mode
+// programs each word as it is written, as immediate mode does. The
+// read modes only report themselves in RD_MODE_STATUS, and the
+// information memory is not modeled.
+// A stall, "flashstall n" in the script, is the nth program or
+// erase from then on that never finishes: the data is not changed
+// and the flag never set, so only a timeout gets the program out.
+// The next operation works again.
+// A power cut, "flashcut n" in the script, stops the nth program or
+// erase from then on part way: the words of a burst before a random
+// one are programmed, that one gets some of its 0s, and in an
+// erase each word is either erased or has some of its bits set.
+// The program then exits at once with status 2. With
+// MSP432SIM_FLASH the image is a file that keeps what was
+// programmed, so the next run starts from the torn state, as the
+// robot would after the power came back.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+
+#define FLASH_SIZE 0x40000
+#define BANK_SIZE  0x20000
+#define SECTOR     4096
+
+// FLCTL bits, as in inc/FlashProgram.c
+#define RD_MODE_M       0x0000000F
+#define RD_STATUS_OFS   16
+#define PRG_ENABLE      0x00000001
+#define PRG_VER_PRE     0x00000004
+#define PRG_VER_PST     0x00000008
+#define BRST_START      0x00000001
+#define BRST_TYPE_M     0x00000006
+#define BRST_LEN_M      0x00000038
+#define BRST_AUTO_PRE   0x00000040
+#define BRST_AUTO_PST   0x00000080
+#define BRST_STATUS_M   0x00070000
+#define BRST_PRE_ERR    0x00080000
+#define BRST_PST_ERR    0x00100000
+#define BRST_ADDR_ERR   0x00200000
+#define BRST_CLR_STAT   0x00800000
+#define ERASE_START     0x00000001
+#define ERASE_MODE      0x00000002
+#define ERASE_TYPE_M    0x0000000C
+#define ERASE_STATUS_M  0x00030000
+#define ERASE_ADDR_ERR  0x00040000
+#define ERASE_CLR_STAT  0x00080000
+#define RDBRST_START    0x00000001
+#define RDBRST_MEM_M    0x00000006
+#define RDBRST_STOP     0x00000008
+#define RDBRST_CMP      0x00000010
+#define RDBRST_STAT_M   0x00030000
+#define RDBRST_CMP_ERR  0x00040000
+#define RDBRST_ADDR_ERR 0x00080000
+#define RDBRST_CLR_STAT 0x00800000
+#define IFG_RDBRST      0x00000001
+#define IFG_AVPRE       0x00000002
+#define IFG_AVPST       0x00000004
+#define IFG_PRG         0x00000008
+#define IFG_PRGB        0x00000010
+#define IFG_ERASE       0x00000020
+#define IFG_PRG_ERR     0x00000200
+#define PROGRAM_NS      25000          // a word, or a 128-bit block of a burst
+#define ERASE_NS        8000000        // a sector, or the mass erase
+#define VERIFY_NS       400            // 16 bytes of a read burst
+
+static uint8_t *Image;          // the flash, from address 0
+static uint32_t Before;         // word a trapped write is replacing
+static uint32_t Cut;            // operations until a power cut, 0 for none
+static uint32_t Stall;          // operations until one that never finishes, 0 for none
+static uint32_t Pending;        // IFG flags of the operation in progress
+static uint64_t Done;           // Sim_Now() when it finishes
+
+static uint32_t *word(uint32_t addr){
+  return (uint32_t *)(Image + (addr&~3u));
+}
+
+static uint32_t random32(void){
+  return ((uint32_t)rand()<<16)^(uint32_t)rand();
+}
+
+// 1 if the sector holding addr is write/erase protected
+static uint32_t locked(uint32_t addr){
+  FLCTL_Type *f = MODEL(FLCTL);
+  uint32_t protect = (addr < BANK_SIZE)? f->BANK0_MAIN_WEPROT : f->BANK1_MAIN_WEPROT;
+  return (protect>>((addr%BANK_SIZE)/SECTOR))&1;
+}
+
+// 1 if this operation is the one the power fails in
+static uint32_t cutting(void){
+  if(Cut == 0){
+    return 0;
+  }
+  Cut = Cut - 1;
+  return Cut == 0;
+}
+
+// 1 if this operation is the one that stalls
+static uint32_t stalling(void){
+  if(Stall == 0){
+    return 0;
+  }
+  Stall = Stall - 1;
+  return Stall == 0;
+}
+
+// the operation sets flag in IFG ns from now
+static void finish(uint32_t flag, uint64_t ns){
+  Pending = flag;
+  Done = Sim_Now() + ns;
+}
+
+static void powerOff(const char *operation, uint32_t addr){
+  fprintf(stderr, "msp432sim: power cut during %s at 0x%05x\n", operation, addr);
+  _exit(2);
+}
+
+// program count words at addr from data, as far as the bits allow;
+// the pre-verify and post-verify results in *pre and *pst
+static void program(uint32_t addr, const uint32_t *data, uint32_t count, uint32_t *pre, uint32_t *pst){
+  uint32_t i, torn = count;
+  if(cutting()){
+    torn = (uint32_t)rand()%count;
+  }
+  *pre = *pst = 0;
+  for(i = 0; i < count; i++){
+    uint32_t *w = word(addr+4*i);
+    *pre |= ~*w&~data[i];                       // already 0, programmed again
+    if(i < torn){
+      *w &= data[i];
+    }else if(i == torn){
+      *w &= data[i]|random32();
+    }
+    *pst |= *w&~data[i];                        // still 1
+  }
+  if(torn < count){
+    powerOff("program", addr);
+  }
+}
+
+static void erase(uint32_t addr){
+  uint32_t i;
+  addr = addr&~(SECTOR-1);
+  if(cutting()){
+    for(i = 0; i < SECTOR; i = i + 4){
+      *word(addr+i) = (rand()&1)? 0xFFFFFFFF : *word(addr+i)|random32();
+    }
+    powerOff("erase", addr);
+  }
+  memset(Image+addr, 0xFF, SECTOR);
+}
+
+// a word write by the program to the flash itself
+static void cpuWrite(uint32_t addr){
+  FLCTL_Type *f = MODEL(FLCTL);
+  uint32_t value = *word(addr), pre, pst;
+  *word(addr) = Before;
+  if(((f->PRG_CTLSTAT&PRG_ENABLE) == 0) || locked(addr)){
+    f->IFG |= IFG_PRG_ERR;
+    return;
+  }
+  if(stalling()){
+    return;
+  }
+  program(addr&~3u, &value, 1, &pre, &pst);
+  if((f->PRG_CTLSTAT&PRG_VER_PRE) && pre) f->IFG |= IFG_AVPRE;
+  if((f->PRG_CTLSTAT&PRG_VER_PST) && pst) f->IFG |= IFG_AVPST;
+  finish(IFG_PRG, PROGRAM_NS);
+}
+
+static void burst(FLCTL_Type *f){
+  uint32_t addr = f->PRGBRST_STARTADDR, count = 4*((f->PRGBRST_CTLSTAT&BRST_LEN_M)>>3);
+  uint32_t i, pre, pst;
+  f->PRGBRST_CTLSTAT &= ~(BRST_START|BRST_STATUS_M|BRST_PRE_ERR|BRST_PST_ERR|BRST_ADDR_ERR);
+  if(stalling()){
+    f->PRGBRST_CTLSTAT |= 0x00010000;           // in progress
+    return;
+  }
+  if((count == 0) || (count > 16) || (addr%16) || (addr+4*count > FLASH_SIZE) ||
+     (f->PRGBRST_CTLSTAT&BRST_TYPE_M)){
+    f->PRGBRST_CTLSTAT |= BRST_ADDR_ERR;
+  }else{
+    for(i = 0; i < count; i++){
+      if(locked(addr+4*i)){
+        f->PRGBRST_CTLSTAT |= BRST_ADDR_ERR;
+      }
+    }
+  }
+  if((f->PRGBRST_CTLSTAT&BRST_ADDR_ERR) == 0){
+    program(addr, (const uint32_t *)&f->PRGBRST_DATA0_0, count, &pre, &pst);
+    if((f->PRGBRST_CTLSTAT&BRST_AUTO_PRE) && pre) f->PRGBRST_CTLSTAT |= BRST_PRE_ERR;
+    if((f->PRGBRST_CTLSTAT&BRST_AUTO_PST) && pst) f->PRGBRST_CTLSTAT |= BRST_PST_ERR;
+  }
+  f->PRGBRST_CTLSTAT |= 0x00070000;             // complete
+  finish(IFG_PRGB, PROGRAM_NS*(count/4));
+}
+
+static void eraseStart(FLCTL_Type *f){
+  uint32_t addr = f->ERASE_SECTADDR, s;
+  f->ERASE_CTLSTAT &= ~(ERASE_START|ERASE_STATUS_M|ERASE_ADDR_ERR);
+  if(stalling()){
+    f->ERASE_CTLSTAT |= 0x00010000;             // erase in progress
+    return;
+  }
+  if(f->ERASE_CTLSTAT&ERASE_TYPE_M){
+    f->ERASE_CTLSTAT |= ERASE_ADDR_ERR;         // information memory
+  }else if(f->ERASE_CTLSTAT&ERASE_MODE){        // mass erase, what is not protected
+    for(s = 0; s < FLASH_SIZE; s = s + SECTOR){
+      if(!locked(s)){
+        erase(s);
+      }
+    }
+  }else if((addr >= FLASH_SIZE) || locked(addr)){
+    f->ERASE_CTLSTAT |= ERASE_ADDR_ERR;
+  }else{
+    erase(addr);
+  }
+  f->ERASE_CTLSTAT |= 0x00030000;               // complete
+  finish(IFG_ERASE, ERASE_NS);
+}
+
+// erase verify: 16-byte blocks that are not all 1s, or all 0s
+static void readBurst(FLCTL_Type *f){
+  uint32_t addr = f->RDBRST_STARTADDR&~15u, end = addr + f->RDBRST_LEN, i;
+  uint32_t pattern = (f->RDBRST_CTLSTAT&RDBRST_CMP)? 0xFFFFFFFF : 0;
+  finish(IFG_RDBRST, VERIFY_NS*(f->RDBRST_LEN/16));
+  f->RDBRST_CTLSTAT &= ~(RDBRST_START|RDBRST_STAT_M|RDBRST_CMP_ERR|RDBRST_ADDR_ERR);
+  if((end > FLASH_SIZE) || (f->RDBRST_CTLSTAT&RDBRST_MEM_M)){
+    f->RDBRST_CTLSTAT |= RDBRST_ADDR_ERR;
+    end = addr;
+  }
+  for(; addr < end; addr = addr + 16){
+    for(i = 0; (i < 16) && (*word(addr+i) == pattern); i = i + 4){};
+    if(i < 16){
+      if(f->RDBRST_FAILCNT == 0){
+        f->RDBRST_FAILADDR = addr;
+      }
+      f->RDBRST_FAILCNT = f->RDBRST_FAILCNT + 1;
+      f->RDBRST_CTLSTAT |= RDBRST_CMP_ERR;
+      if(f->RDBRST_CTLSTAT&RDBRST_STOP){
+        break;
+      }
+    }
+  }
+  f->RDBRST_CTLSTAT |= 0x00030000;              // complete
+}
+
+int SimFlash_Open(void){
+  const char *name = getenv("MSP432SIM_FLASH");
+  uint8_t erased[SECTOR];
+  struct stat info;
+  off_t size;
+  int fd = name? open(name, O_RDWR|O_CREAT, 0644) : memfd_create("msp432sim", 0);
+  if((fd < 0) || (fstat(fd, &info) < 0)){
+    perror(name? name : "msp432sim: memfd");
+    _exit(1);
+  }
+  memset(erased, 0xFF, SECTOR);
+  for(size = info.st_size&~(SECTOR-1); size < FLASH_SIZE; size = size + SECTOR){
+    if(pwrite(fd, erased, SECTOR, size) != SECTOR){
+      perror(name? name : "msp432sim: memfd");
+      _exit(1);
+    }
+  }
+  Image = mmap(0, FLASH_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  if(Image == MAP_FAILED){
+    perror("msp432sim: flash");
+    _exit(1);
+  }
+  return fd;
+}
+
+void SimFlash_Init(void){
+  FLCTL_Type *f = MODEL(FLCTL);
+  f->BANK0_RDCTL = f->BANK1_RDCTL = 0x00001000; // one wait state
+  f->BANK0_INFO_WEPROT = f->BANK1_INFO_WEPROT = 0x00000003;
+  f->BANK0_MAIN_WEPROT = f->BANK1_MAIN_WEPROT = 0xFFFFFFFF;
+}
+
+void SimFlash_Cut(uint32_t count){
+  Cut = count;
+}
+
+void SimFlash_Stall(uint32_t count){
+  Stall = count;
+}
+
+void SimFlash_Before(uintptr_t addr){
+  Before = *word(addr);
+}
+
+void SimFlash_Read(uintptr_t addr){
+  FLCTL_Type *f = MODEL(FLCTL);
+  if(Pending && (Sim_Now() >= Done)){
+    f->IFG |= Pending;
+    Pending = 0;
+  }
+  (void)addr;
+}
+
+void SimFlash_Write(uintptr_t addr){
+  FLCTL_Type *f = MODEL(FLCTL);
+  if(addr < FLASH_SIZE){
+    cpuWrite(addr);
+  }else if(addr == (uintptr_t)&FLCTL->BANK0_RDCTL){
+    f->BANK0_RDCTL = (f->BANK0_RDCTL&~(RD_MODE_M<<RD_STATUS_OFS))|((f->BANK0_RDCTL&RD_MODE_M)<<RD_STATUS_OFS);
+  }else if(addr == (uintptr_t)&FLCTL->BANK1_RDCTL){
+    f->BANK1_RDCTL = (f->BANK1_RDCTL&~(RD_MODE_M<<RD_STATUS_OFS))|((f->BANK1_RDCTL&RD_MODE_M)<<RD_STATUS_OFS);
+  }else if(addr == (uintptr_t)&FLCTL->RDBRST_CTLSTAT){
+    if(f->RDBRST_CTLSTAT&RDBRST_CLR_STAT){
+      f->RDBRST_CTLSTAT &= ~(RDBRST_CLR_STAT|RDBRST_STAT_M|RDBRST_CMP_ERR|RDBRST_ADDR_ERR);
+    }
+    if(f->RDBRST_CTLSTAT&RDBRST_START) readBurst(f);
+  }else if(addr == (uintptr_t)&FLCTL->PRGBRST_CTLSTAT){
+    if(f->PRGBRST_CTLSTAT&BRST_CLR_STAT){
+      f->PRGBRST_CTLSTAT &= ~(BRST_CLR_STAT|BRST_STATUS_M|BRST_PRE_ERR|BRST_PST_ERR|BRST_ADDR_ERR);
+    }
+    if(f->PRGBRST_CTLSTAT&BRST_START) burst(f);
+  }else if(addr == (uintptr_t)&FLCTL->ERASE_CTLSTAT){
+    if(f->ERASE_CTLSTAT&ERASE_CLR_STAT){
+      f->ERASE_CTLSTAT &= ~(ERASE_CLR_STAT|ERASE_STATUS_M|ERASE_ADDR_ERR);
+    }
+    if(f->ERASE_CTLSTAT&ERASE_START) eraseStart(f);
+  }else if(addr == (uintptr_t)&FLCTL->CLRIFG){
+    f->IFG &= ~f->CLRIFG;
+    f->CLRIFG = 0;
+  }else if(addr == (uintptr_t)&FLCTL->SETIFG){
+    f->IFG |= f->SETIFG;
+    f->SETIFG = 0;
+  }
+}
@@ -0,0 +1,122 @@
+// SimGPIO.c
+// Runs on the host, Linux x86-64
+// GPIO model of the MSP432 simulator: ports P1-P10 and PJ with
+// direction, pull resistors, pins driven from outside, and edge
+// interrupts with PxIV on P1-P6.
+// October 16, 2026
+
+// A pin reads its output latch when it is an output, the level
+// driven by Sim_SetPin() when something outside drives it, its pull
+// resistor when REN is set, and 0 when it floats. The inputs are
+// worked out again after every write to a port, and every change
+// that matches PxIES sets PxIFG.
+
+#include <stdint.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+
+#define PORTS 11                // P1-P10, PJ last
+
+// offsets in the odd port layout; an even port is one byte higher
+#define IN    0x00
+#define OUT   0x02
+#define DIR   0x04
+#define REN   0x06
+#define IES   0x18
+#define IE    0x1A
+#define IFG   0x1C
+
+static struct{
+  uint8_t Driven;               // pins driven from outside
+  uint8_t Level;                // their levels
+  uint8_t In;                   // last input value, for edges
+} Port[PORTS];
+
+static uint8_t *reg(uint32_t i, uint32_t offset){
+  uintptr_t base = (i == PORTS-1)? (uintptr_t)PJ : DIO_BASE + (i/2)*0x20 + (i&1);
+  return (uint8_t *)Sim_Model((void *)(base + offset));
+}
+
+// PxIV is a 16-bit register of its own, at 0x0E or 0x1E
+static uintptr_t vectorAddress(uint32_t i){
+  return DIO_BASE + (i/2)*0x20 + ((i&1)? 0x1E : 0x0E);
+}
+static uint16_t *vector(uint32_t i){
+  return (uint16_t *)Sim_Model((void *)vectorAddress(i));
+}
+
+// inputs, edges and the interrupt line of port i (0 is P1)
+static void port(uint32_t i){
+  uint8_t dir = *reg(i, DIR), out = *reg(i, OUT);
+  uint8_t outside = (Port[i].Driven&Port[i].Level)|(~Port[i].Driven&*reg(i, REN)&out);
+  uint8_t in = (dir&out)|(~dir&outside);
+  uint8_t rising = in&~Port[i].In, falling = ~in&Port[i].In;
+  *reg(i, IN) = in;
+  Port[i].In = in;
+  if(i < 6){
+    *reg(i, IFG) |= (rising&~*reg(i, IES))|(falling&*reg(i, IES));
+    Sim_Line(IRQ_PORT1 + i, *reg(i, IFG)&*reg(i, IE));
+  }
+}
+
+void SimGPIO_Init(void){
+  uint32_t i;
+  for(i = 0; i < PORTS; i++){
+    port(i);
+  }
+}
+
+void SimGPIO_Read(uintptr_t addr){
+  uint32_t i, pending;
+  for(i = 0; i < PORTS; i++){
+    port(i);
+  }
+  for(i = 0; i < 6; i++){
+    if(addr == vectorAddress(i)){
+      pending = *reg(i, IFG)&*reg(i, IE);
+      *vector(i) = pending? 2*(__builtin_ctz(pending) + 1) : 0;
+    }
+  }
+}
+
+void SimGPIO_AfterRead(uintptr_t addr){
+  uint32_t i;
+  for(i = 0; i < 6; i++){
+    if((addr == vectorAddress(i)) && *vector(i)){
+      *reg(i, IFG) &= ~(1u<<(*vector(i)/2 - 1)); // reading PxIV clears its flag
+      Sim_Line(IRQ_PORT1 + i, *reg(i, IFG)&*reg(i, IE));
+    }
+  }
+}
+
+void SimGPIO_Write(uintptr_t addr){
+  uint32_t i;
+  for(i = 0; i < PORTS; i++){
+    port(i);
+  }
+  SimLCD_Write();                               // RST of the Nokia 5110
+  (void)addr;
+}
+
+void SimGPIO_Drive(uint32_t number, uint32_t pin, int32_t level){
+  uint32_t i = number - 1;
+  if((number < 1) || (number > 10) || (pin > 7)){
+    return;
+  }
+  if(level < 0){
+    Port[i].Driven &= ~(1u<<pin);
+  }else{
+    Port[i].Driven |= 1u<<pin;
+    Port[i].Level = (Port[i].Level&~(1u<<pin))|((level != 0)<<pin);
+  }
+  port(i);
+}
+
+uint32_t SimGPIO_Level(uint32_t number, uint32_t pin){
+  if((number < 1) || (number > 10) || (pin > 7)){
+    return 0;
+  }
+  port(number - 1);
+  return (Port[number - 1].In>>pin)&1;
+}
@@ -0,0 +1,79 @@
+// SimLCD.c
+// Runs on the host, Linux x86-64
+// Nokia 5110 model of the MSP432 simulator: the PCD8544 controller
+// on EUSCI_A3 in SPI mode, with D/C on P9.6 and RST on P9.3 as
+// inc/Nokia5110.c wires it, and its 84 by 48 display RAM.
+// October 16, 2026
+
+// The controller takes a byte when its eighth bit has shifted in,
+// so D/C is read when EUSCI_A3 finishes a byte, not when the program
+// writes TXBUF; a driver that changes D/C too early shows up as
+// commands drawn on the screen or data lost as commands. RST low
+// resets the address and the instruction set; the RAM keeps what
+// it had, where the chip's is undefined.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "SimModel.h"
+
+#define WIDTH 84
+#define BANKS 6
+
+static uint8_t Ram[BANKS][WIDTH];
+static uint32_t X, Y;           // address of the next data byte
+static uint32_t Extended;       // H, the extended instruction set
+static uint32_t Vertical;       // V, vertical addressing
+static uint32_t Data;           // data bytes received
+
+void SimLCD_Write(void){
+  if(SimGPIO_Level(9, 3) == 0){
+    X = Y = 0;
+    Extended = Vertical = 0;
+  }
+}
+
+void SimLCD_Shift(uint8_t byte){
+  if(SimGPIO_Level(9, 3) == 0){
+    return;                                     // held in reset
+  }
+  if(SimGPIO_Level(9, 6)){                      // D/C high, data
+    Ram[Y][X] = byte;
+    Data = Data + 1;
+    if(Vertical){
+      Y = Y + 1;
+      if(Y == BANKS){
+        Y = 0;
+        X = (X + 1)%WIDTH;
+      }
+    }else{
+      X = X + 1;
+      if(X == WIDTH){
+        X = 0;
+        Y = (Y + 1)%BANKS;
+      }
+    }
+  }else if((byte&0xF8) == 0x20){                // function set, either set
+    Vertical = (byte>>1)&1;
+    Extended = byte&1;
+  }else if(!Extended && (byte&0x80)){           // set X
+    X = (byte&0x7F) < WIDTH? (byte&0x7F) : X;
+  }else if(!Extended && ((byte&0xF8) == 0x40)){ // set Y
+    Y = (byte&7) < BANKS? (byte&7) : Y;
+  }                                             // display control, Vop, bias, temperature
+}
+
+uint32_t SimLCD_Image(uint8_t image[BANKS*WIDTH]){
+  memcpy(image, Ram, sizeof(Ram));
+  return Data;
+}
+
+void SimLCD_Print(void){
+  uint32_t row, column;
+  for(row = 0; row < 8*BANKS; row++){
+    for(column = 0; column < WIDTH; column++){
+      fputc(((Ram[row/8][column]>>(row%8))&1)? '#' : '.', stderr);
+    }
+    fputc('\n', stderr);
+  }
+}
@@ -0,0 +1,169 @@
+/**
+ * @file      SimModel.h
+ * @brief     Interface between the simulator core and the peripheral models
+ * @details   Sim.c owns the register file, the time base and the
+ * interrupt controller. Each peripheral model is a set of hooks it
+ * calls: Update() advances the model to the current time, Read()
+ * runs before the firmware reads one of its registers so the value
+ * is current, AfterRead() carries out read side effects such as
+ * clearing a receive flag, and Write() acts on a register the
+ * firmware has just written.<br>
+ * Models reach their registers through Sim_Model(), a view of the
+ * register file that does not trap, and report interrupt requests
+ * with Sim_Line() (level, the flag stays until the ISR clears it) or
+ * Sim_Pend() (edge, cleared when the ISR is entered).
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __SIMMODEL_H__ // do not include more than once
+#define __SIMMODEL_H__
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * Interrupt numbers, as in the MSP432 vector table
+ */
+#define IRQ_WDT_A     3
+#define IRQ_TA0_0     8
+#define IRQ_EUSCIA0   16
+#define IRQ_EUSCIB0   20
+#define IRQ_ADC14     24
+#define IRQ_T32_INT1  25
+#define IRQ_T32_INT2  26
+#define IRQ_DMA_INT3  31
+#define IRQ_DMA_INT2  32
+#define IRQ_DMA_INT1  33
+#define IRQ_DMA_INT0  34
+#define IRQ_PORT1     35
+#define IRQ_SYSTICK   64   /**< exceptions after the 64 interrupts */
+#define IRQ_PENDSV    65
+#define IRQ_COUNT     66
+
+/**
+ * DMA request sources, channel*8+source as in DMA_Channel->CH_SRCCFG
+ */
+#define DMASRC(ch, src) ((ch)*8+(src))
+
+/**
+ * \struct SimCount
+ * \brief Converts elapsed simulated time to clock periods without drift
+ */
+struct SimCount{
+  uint64_t Last;     /**< ns of the last conversion */
+  uint64_t Fraction; /**< ns*Hz left over, below 1e9 */
+};
+
+/**
+ * Address of a device register in the view that does not trap
+ * @param device address the firmware uses
+ * @return pointer the models use
+ */
+void *Sim_Model(const volatile void *device);
+#define MODEL(dev) ((__typeof__(*(dev)) *)Sim_Model(dev))
+
+/**
+ * Simulated time
+ * @return ns since the start
+ */
+uint64_t Sim_Now(void);
+
+/**
+ * Clock periods since the last call, 0 the first time
+ * @param c counter state
+ * @param now simulated time in ns
+ * @param hz clock frequency
+ * @return whole periods
+ */
+uint64_t Sim_Periods(struct SimCount *c, uint64_t now, uint32_t hz);
+
+/**
+ * Clock frequencies from the CS registers
+ * @return Hz
+ */
+uint32_t Sim_MCLK(void);
+uint32_t Sim_SMCLK(void);
+uint32_t Sim_ACLK(void);
+
+/**
+ * Set the level of an interrupt request line
+ * @param irq interrupt number
+ * @param level nonzero to request
+ */
+void Sim_Line(uint32_t irq, uint32_t level);
+
+/**
+ * Latch an edge-triggered interrupt request
+ * @param irq interrupt number or IRQ_SYSTICK/IRQ_PENDSV
+ */
+void Sim_Pend(uint32_t irq);
+
+/**
+ * Queue a DMA request, carried out after the current hook
+ * @param source DMASRC(channel, source)
+ */
+void Sim_DMARequest(uint32_t source);
+
+/**
+ * Read or write a device register as the DMA does, with the hooks
+ * @param addr device address
+ * @param size 1, 2 or 4 bytes
+ */
+uint32_t Sim_BusRead(uintptr_t addr, uint32_t size);
+void Sim_BusWrite(uintptr_t addr, uint32_t value, uint32_t size);
+
+/**
+ * Host side of the models, behind the calls in Sim.h, with the
+ * models up to date and SIGALRM blocked
+ */
+void SimSerial_Receive(uint32_t port, const char *data, uint32_t size);
+void SimSerial_Watch(void(*watch)(uint8_t data));
+void SimGPIO_Drive(uint32_t port, uint32_t pin, int32_t level);
+uint32_t SimGPIO_Level(uint32_t port, uint32_t pin);
+void SimTimer_Capture(uint32_t timer, uint32_t ccr);
+double SimTimer_Duty(uint32_t timer, uint32_t ccr);
+void SimADC_Voltage(uint32_t channel, double volts);
+uint32_t SimLCD_Image(uint8_t image[504]);
+void SimLCD_Print(void);
+
+/**
+ * Hooks of each model, called by Sim.c with SIGALRM blocked
+ */
+void SimGPIO_Init(void);
+void SimGPIO_Read(uintptr_t addr);
+void SimGPIO_AfterRead(uintptr_t addr);
+void SimGPIO_Write(uintptr_t addr);
+
+void SimTimer_Init(void);
+void SimTimer_Update(uint64_t now);
+void SimTimer_Read(uintptr_t addr);
+void SimTimer_AfterRead(uintptr_t addr);
+void SimTimer_Write(uintptr_t addr);
+
+void SimSerial_Init(void);
+void SimSerial_Update(uint64_t now);
+void SimSerial_AfterRead(uintptr_t addr);
+void SimSerial_Write(uintptr_t addr);
+void SimSerial_Read(uintptr_t addr);
+
+void SimADC_Trigger(uint32_t shs, uint64_t count);
+void SimADC_Read(uintptr_t addr);
+void SimADC_AfterRead(uintptr_t addr);
+void SimADC_Write(uintptr_t addr);
+
+void SimDMA_Init(void);
+void SimDMA_Request(uint32_t source);
+void SimDMA_Write(uintptr_t addr);
+
+void SimLCD_Write(void);
+void SimLCD_Shift(uint8_t byte);
+
+int SimFlash_Open(void);
+void SimFlash_Init(void);
+void SimFlash_Cut(uint32_t count);
+void SimFlash_Stall(uint32_t count);
+void SimFlash_Before(uintptr_t addr);
+void SimFlash_Read(uintptr_t addr);
+void SimFlash_Write(uintptr_t addr);
+
+#endif // __SIMMODEL_H__
@@ -0,0 +1,289 @@
+// SimSerial.c
+// Runs on the host, Linux x86-64
+// eUSCI model of the MSP432 simulator: UART and SPI transmit and
+// receive at the programmed bit rate, flags, IV, interrupts and DMA
+// requests. EUSCI_A0, the LaunchPad's USB serial port, is connected
+// to a pseudo-terminal or to stdin and stdout, and EUSCI_A3 to the
+// Nokia 5110 of SimLCD.c.
+// October 16, 2026
+
+// Transmit has the holding register TXBUF and a shift register, as
+// on the chip: a byte written while the shifter is idle moves into
+// it at once and TXIFG sets again; a second byte waits in TXBUF
+// until the first has taken its ten bit times. Each rising edge of
+// TXIFG or RXIFG is a DMA request. A received byte lands in RXBUF
+// only when the last one has been read, so input typed ahead waits
+// here rather than overrunning. The models catch up at every access,
+// so a flag can come up between the read and the write of the
+// program's IFG &= ~bit; flags raised since the program last read
+// IFG survive such a write, as they would in the few cycles of a
+// read-modify-write on the chip.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+
+#define MODULES 8               // A0-A3, then B0-B3
+#define RXQSIZE 4096            // power of 2
+
+// register offsets that differ between A and B modules
+#define STATW(i) ((i) < 4? 0x0A : 0x08)
+#define IE(i)    ((i) < 4? 0x1A : 0x2A)
+#define IFG(i)   ((i) < 4? 0x1C : 0x2C)
+#define IV(i)    ((i) < 4? 0x1E : 0x2E)
+#define CTLW0    0x00
+#define BRW      0x06
+#define MCTLW    0x08
+#define RXBUF    0x0C
+#define TXBUF    0x0E
+
+static struct{
+  uint32_t Shifting;            // a byte is in the shift register
+  uint8_t Shifter;              // that byte
+  int32_t Holding;              // byte waiting in TXBUF, -1 if none
+  uint64_t ShiftDone;           // ns when the shift register empties
+  uint64_t RxReady;             // ns when the next byte may arrive
+  uint16_t Flags;               // IFG at the last look, for edges
+  uint16_t Raised;              // flags set since the program read IFG
+  char RxQ[RXQSIZE];
+  uint32_t RxPut, RxGet;
+} Serial[MODULES];
+
+static int In = -1, Out = -1;   // host side of EUSCI_A0
+static int Stdio;               // translate LF to CR on input
+static uint64_t LastPoll;
+static void (*Watch)(uint8_t data);  // sees EUSCI_A0 output, 0 for none
+
+static uintptr_t base(uint32_t i){
+  return (i < 4)? (uintptr_t)EUSCI_A0 + 0x400*i : (uintptr_t)EUSCI_B0 + 0x400*(i - 4);
+}
+
+static volatile uint16_t *reg(uint32_t i, uint32_t offset){
+  return (volatile uint16_t *)Sim_Model((void *)(base(i) + offset));
+}
+
+static uint32_t module(uintptr_t addr){
+  return (addr < (uintptr_t)EUSCI_B0)? (addr - (uintptr_t)EUSCI_A0)/0x400
+                                    : 4 + (addr - (uintptr_t)EUSCI_B0)/0x400;
+}
+
+// ns to shift one character
+static uint64_t charTime(uint32_t i){
+  uint16_t ctl = *reg(i, CTLW0);
+  uint64_t hz, bits, brw = *reg(i, BRW)? *reg(i, BRW) : 1;
+  switch((ctl>>6)&3){
+    case 0: hz = 0; break;                      // UCLK pin, not connected
+    case 1: hz = Sim_ACLK(); break;
+    default: hz = Sim_SMCLK(); break;
+  }
+  if(hz == 0){
+    return 1000;
+  }
+  if(ctl&0x0100){                               // UCSYNC, SPI
+    bits = 8;
+  }else{
+    bits = 10 + ((ctl>>15)&1) + ((ctl>>11)&1);  // start, 8 data, parity, stop bits
+    if(*reg(i, MCTLW)&1){
+      brw = 16*brw;                             // UCOS16
+    }
+  }
+  return bits*brw*1000000000u/hz;
+}
+
+// DMA requests on the rising edges of the flags, and the interrupt
+static void flags(uint32_t i){
+  uint16_t ifg = *reg(i, IFG(i)), rising = ifg&~Serial[i].Flags;
+  uint32_t channel = 2*(i&3), source = (i < 4)? 1 : 2;
+  if(rising&0x02){
+    Sim_DMARequest(DMASRC(channel, source));
+  }
+  if(rising&0x01){
+    Sim_DMARequest(DMASRC(channel + 1, source));
+  }
+  Serial[i].Flags = ifg;
+  Sim_Line(((i < 4)? IRQ_EUSCIA0 : IRQ_EUSCIB0 - 4) + i, ifg&*reg(i, IE(i)));
+}
+
+static void raise(uint32_t i, uint16_t bits){
+  *reg(i, IFG(i)) |= bits;
+  Serial[i].Raised |= bits;
+}
+
+// a byte enters the shift register, and leaves the chip
+static void shift(uint32_t i, uint8_t data, uint64_t start){
+  Serial[i].Shifting = 1;
+  Serial[i].Shifter = data;
+  Serial[i].ShiftDone = start + charTime(i);
+  raise(i, 0x02);
+  if((i == 0) && (Out >= 0)){
+    if(write(Out, &data, 1)){}
+  }
+  if((i == 0) && Watch){
+    (*Watch)(data);
+  }
+}
+
+static void poll(uint64_t now){
+  char buf[256];
+  ssize_t n, k;
+  if((In < 0) || (now - LastPoll < 100000)){
+    return;
+  }
+  LastPoll = now;
+  if(RXQSIZE - (Serial[0].RxPut - Serial[0].RxGet) < sizeof(buf)){
+    return;
+  }
+  n = read(In, buf, sizeof(buf));
+  for(k = 0; k < n; k++){
+    if(Stdio && (buf[k] == '\n')){
+      buf[k] = '\r';
+    }
+  }
+  if(n > 0){
+    SimSerial_Receive(0, buf, n);
+  }
+}
+
+static void serialUpdate(uint32_t i, uint64_t now){
+  if(*reg(i, CTLW0)&1){
+    return;                                     // UCSWRST
+  }
+  if(Serial[i].Shifting && (now >= Serial[i].ShiftDone)){
+    Serial[i].Shifting = 0;
+    if(*reg(i, CTLW0)&0x0100){                  // SPI receives as it sends
+      *reg(i, RXBUF) = 0xFF;
+      raise(i, 0x01);
+      if(i == 3){
+        SimLCD_Shift(Serial[i].Shifter);        // the Nokia 5110 on EUSCI_A3
+      }
+    }
+    if(Serial[i].Holding >= 0){
+      shift(i, Serial[i].Holding, Serial[i].ShiftDone);
+      Serial[i].Holding = -1;
+    }else if(i < 4){
+      raise(i, 0x08);                           // UCTXCPTIFG
+    }
+  }
+  if((Serial[i].RxPut != Serial[i].RxGet) && !(*reg(i, IFG(i))&0x01) && (now >= Serial[i].RxReady)){
+    *reg(i, RXBUF) = (uint8_t)Serial[i].RxQ[Serial[i].RxGet&(RXQSIZE-1)];
+    Serial[i].RxGet = Serial[i].RxGet + 1;
+    Serial[i].RxReady = now + charTime(i);
+    raise(i, 0x01);
+  }
+  flags(i);
+}
+
+void SimSerial_Init(void){
+  uint32_t i;
+  const char *mode = getenv("MSP432SIM_UART");
+  for(i = 0; i < MODULES; i++){
+    *reg(i, CTLW0) = (i < 4)? 0x0001 : 0x01C1;
+    *reg(i, IFG(i)) = 0x02;
+    Serial[i].Flags = 0x02;
+    Serial[i].Holding = -1;
+  }
+  if(mode && (strcmp(mode, "stdio") == 0)){
+    In = 0;
+    Out = 1;
+    Stdio = 1;
+  }else if(!mode || (strcmp(mode, "none") != 0)){
+    struct termios raw;
+    In = Out = posix_openpt(O_RDWR|O_NOCTTY);
+    if((In < 0) || grantpt(In) || unlockpt(In)){
+      perror("msp432sim: pty");
+      exit(1);
+    }
+    // hold the terminal side open, so the port survives a reconnect
+    if(open(ptsname(In), O_RDWR|O_NOCTTY) >= 0){}
+    tcgetattr(In, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(In, TCSANOW, &raw);
+    fprintf(stderr, "msp432sim: EUSCI_A0 is %s\n", ptsname(In));
+  }
+  if(In >= 0){
+    fcntl(In, F_SETFL, fcntl(In, F_GETFL)|O_NONBLOCK);
+  }
+}
+
+void SimSerial_Update(uint64_t now){
+  uint32_t i;
+  poll(now);
+  for(i = 0; i < MODULES; i++){
+    serialUpdate(i, now);
+  }
+}
+
+void SimSerial_Read(uintptr_t addr){
+  uint32_t i = module(addr);
+  uint16_t pending = *reg(i, IFG(i))&*reg(i, IE(i));
+  uintptr_t offset = addr - base(i);
+  if(offset == IFG(i)){
+    Serial[i].Raised = 0;
+  }else if(offset == STATW(i)){
+    *reg(i, STATW(i)) = (*reg(i, STATW(i))&~1)|(Serial[i].Shifting || (Serial[i].Holding >= 0));
+  }else if(offset == IV(i)){
+    *reg(i, IV(i)) = pending? 2*(__builtin_ctz(pending) + 1) : 0;
+  }
+}
+
+void SimSerial_AfterRead(uintptr_t addr){
+  uint32_t i = module(addr);
+  uintptr_t offset = addr - base(i);
+  if(offset == RXBUF){
+    *reg(i, IFG(i)) &= ~0x01;                   // reading RXBUF clears UCRXIFG
+  }else if((offset == IV(i)) && *reg(i, IV(i))){
+    *reg(i, IFG(i)) &= ~(1u<<(*reg(i, IV(i))/2 - 1));
+  }
+  flags(i);
+}
+
+void SimSerial_Write(uintptr_t addr){
+  uint32_t i = module(addr);
+  uintptr_t offset = addr - base(i);
+  if(offset == CTLW0){
+    if(*reg(i, CTLW0)&1){                       // UCSWRST resets the state machines
+      *reg(i, IE(i)) = 0;
+      *reg(i, IFG(i)) = 0x02;
+      Serial[i].Shifting = 0;
+      Serial[i].Holding = -1;
+    }
+  }else if(offset == IFG(i)){
+    *reg(i, IFG(i)) |= Serial[i].Raised;
+  }else if(offset == TXBUF){
+    if(*reg(i, CTLW0)&1){
+      return;
+    }
+    *reg(i, IFG(i)) &= ~0x0A;                   // TXIFG and TXCPTIFG
+    flags(i);
+    if(Serial[i].Shifting){
+      Serial[i].Holding = (uint8_t)*reg(i, TXBUF);
+    }else{
+      shift(i, (uint8_t)*reg(i, TXBUF), Sim_Now());
+    }
+  }
+  flags(i);
+}
+
+void SimSerial_Receive(uint32_t port, const char *data, uint32_t size){
+  uint32_t k;
+  if(port > 3){
+    return;
+  }
+  for(k = 0; (k < size) && (Serial[port].RxPut - Serial[port].RxGet < RXQSIZE); k++){
+    Serial[port].RxQ[Serial[port].RxPut&(RXQSIZE-1)] = data[k];
+    Serial[port].RxPut = Serial[port].RxPut + 1;
+  }
+  serialUpdate(port, Sim_Now());
+}
+
+void SimSerial_Watch(void(*watch)(uint8_t data)){
+  Watch = watch;
+}
@@ -0,0 +1,415 @@
+// SimTimer.c
+// Runs on the host, Linux x86-64
+// Timer models of the MSP432 simulator: Timer_A0-A3 with compare,
+// capture, PWM outputs and ADC14 triggers, Timer32, SysTick and the
+// watchdog timer.
+// October 16, 2026
+
+// The models do not step tick by tick. Each update converts the
+// simulated time since the last one to clock periods and counts,
+// in closed form, how often the counter entered each compare value
+// in that many periods; so an update costs the same after 1 us or
+// after 10 s, and a flag set twice in one update is simply set.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#define __I volatile           // models write the read-only registers
+#include "msp.h"
+#include "SimModel.h"
+
+static Timer_A_Type *const TimerA[4] = {TIMER_A0, TIMER_A1, TIMER_A2, TIMER_A3};
+static Timer32_Type *const Timer32[2] = {TIMER32_1, TIMER32_2};
+
+static struct{
+  struct SimCount Clock;
+  uint32_t Count;           // counter, or in up/down mode the phase 0 to 2*CCR0-1
+} A[4];
+
+static struct{
+  struct SimCount Clock;
+  uint32_t Value;
+  uint32_t Stopped;         // one-shot timer that reached 0
+} T32[2];
+
+static struct{
+  struct SimCount Clock;
+  uint32_t Value;
+  uint32_t CountFlag;
+} Tick;
+
+static struct{
+  struct SimCount Clock;
+  uint64_t Count;
+} Watchdog;
+
+// periods until a counter at x next enters v, counting modulo period
+static uint64_t distance(uint64_t x, uint64_t v, uint64_t period){
+  uint64_t d = (v + period - x%period)%period;
+  return d? d : period;
+}
+
+// times a value first reached after k0 periods, then every period,
+// is reached in ticks periods
+static uint64_t hits(uint64_t k0, uint64_t period, uint64_t ticks){
+  if(ticks < k0){
+    return 0;
+  }
+  return 1 + (ticks - k0)/period;
+}
+
+//------------Timer_A------------
+static uint32_t timerAClock(const Timer_A_Type *t){
+  uint32_t hz;
+  switch((t->CTL>>8)&3){
+    case 1: hz = Sim_ACLK(); break;
+    case 2: hz = Sim_SMCLK(); break;
+    default: return 0;                          // TACLK and INCLK are not connected
+  }
+  return hz/(1u<<((t->CTL>>6)&3))/((t->EX0&7) + 1);
+}
+
+static uint32_t timerAValue(uint32_t i){
+  const Timer_A_Type *t = MODEL(TimerA[i]);
+  uint32_t c = t->CCR[0];
+  if(((t->CTL>>4)&3) == 3){
+    return (A[i].Count <= c)? A[i].Count : 2*c - A[i].Count;
+  }
+  return A[i].Count;
+}
+
+static void timerALines(uint32_t i){
+  const Timer_A_Type *t = MODEL(TimerA[i]);
+  uint32_t n, any = ((t->CTL&3) == 3);
+  for(n = 1; n < 7; n++){
+    any |= ((t->CCTL[n]&0x11) == 0x11);
+  }
+  Sim_Line(IRQ_TA0_0 + 2*i, (t->CCTL[0]&0x11) == 0x11);
+  Sim_Line(IRQ_TA0_0 + 2*i + 1, any);
+}
+
+static void timerAUpdate(uint32_t i, uint64_t now){
+  Timer_A_Type *t = MODEL(TimerA[i]);
+  uint64_t ticks = Sim_Periods(&A[i].Clock, now, timerAClock(t));
+  uint64_t hit[7] = {0}, wrap, period, x = A[i].Count;
+  uint32_t mc = (t->CTL>>4)&3, c = t->CCR[0], n, v;
+  if((ticks == 0) || (mc == 0)){
+    return;
+  }
+  if(mc == 3){                                  // up/down: value v at phases v and 2c-v
+    if(c == 0){
+      return;
+    }
+    period = 2*(uint64_t)c;
+    for(n = 0; n < 7; n++){
+      v = (n == 0)? c : t->CCR[n];
+      if(v <= c){
+        hit[n] = hits(distance(x, v, period), period, ticks);
+        if((v > 0) && (v < c)){
+          hit[n] += hits(distance(x, period - v, period), period, ticks);
+        }
+      }
+    }
+  }else{
+    if(mc == 1){                                // up: 0 to CCR0
+      period = (uint64_t)c + 1;
+      if(x > c){                                // CCR0 moved below the count
+        if(ticks < 65535 - x){
+          A[i].Count = x + ticks;
+          return;
+        }
+        ticks -= 65535 - x;                     // at 65535 the next period wraps as from CCR0
+        x = c;
+      }
+    }else{                                      // continuous: 0 to 0xFFFF
+      period = 65536;
+    }
+    for(n = 0; n < 7; n++){
+      v = (n == 0)? c : t->CCR[n];
+      if((mc == 2) || (v <= c)){
+        hit[n] = hits(distance(x, v, period), period, ticks);
+      }
+    }
+  }
+  wrap = hits(distance(x, 0, period), period, ticks);
+  A[i].Count = (x + ticks)%period;
+  for(n = 0; n < 7; n++){
+    if(hit[n] && !(t->CCTL[n]&0x0100)){         // compare
+      t->CCTL[n] |= 0x0001;
+    }
+  }
+  if(wrap){
+    t->CTL |= 0x0001;
+  }
+  // ADC14 sample triggers, one per rising edge of CCR1 or CCR2 output
+  for(n = 1; n < 3; n++){
+    uint32_t outmod = (t->CCTL[n]>>5)&7;
+    uint64_t edges = ((outmod == 6) || (outmod == 7))? hit[0] : hit[n];
+    if(edges && !((i == 3) && (n == 2))){
+      SimADC_Trigger(2*i + n, edges);
+    }
+  }
+  timerALines(i);
+}
+
+static void timerARead(uint32_t i, uintptr_t addr){
+  Timer_A_Type *t = MODEL(TimerA[i]);
+  uint32_t n;
+  if(addr == (uintptr_t)&TimerA[i]->R){
+    t->R = timerAValue(i);
+  }else if(addr == (uintptr_t)&TimerA[i]->IV){
+    t->IV = 0;
+    for(n = 1; n < 7; n++){                     // highest priority enabled flag
+      if((t->CCTL[n]&0x11) == 0x11){
+        t->IV = 2*n;
+        return;
+      }
+    }
+    if((t->CTL&3) == 3){
+      t->IV = 0x0E;
+    }
+  }
+}
+
+static void timerAAfterRead(uint32_t i, uintptr_t addr){
+  Timer_A_Type *t = MODEL(TimerA[i]);
+  if(addr == (uintptr_t)&TimerA[i]->IV){        // reading IV clears its flag
+    if(t->IV == 0x0E){
+      t->CTL &= ~0x0001;
+    }else if(t->IV){
+      t->CCTL[t->IV/2] &= ~0x0001;
+    }
+    timerALines(i);
+  }
+}
+
+static void timerAWrite(uint32_t i, uintptr_t addr){
+  Timer_A_Type *t = MODEL(TimerA[i]);
+  if(addr == (uintptr_t)&TimerA[i]->CTL){
+    if(t->CTL&0x0004){                          // TACLR
+      A[i].Count = 0;
+      t->CTL &= ~0x0004;
+    }
+  }else if(addr == (uintptr_t)&TimerA[i]->R){
+    A[i].Count = t->R;
+  }
+  timerALines(i);
+}
+
+void SimTimer_Capture(uint32_t timer, uint32_t ccr){
+  Timer_A_Type *t;
+  if((timer > 3) || (ccr > 6)){
+    return;
+  }
+  t = MODEL(TimerA[timer]);
+  if(!(t->CCTL[ccr]&0x0100) || !(t->CCTL[ccr]&0xC000)){
+    return;                                     // not capturing
+  }
+  if(t->CCTL[ccr]&0x0001){
+    t->CCTL[ccr] |= 0x0002;                     // COV, the last capture was not read
+  }
+  t->CCR[ccr] = timerAValue(timer);
+  t->CCTL[ccr] |= 0x0001;
+  timerALines(timer);
+}
+
+double SimTimer_Duty(uint32_t timer, uint32_t ccr){
+  const Timer_A_Type *t;
+  uint32_t outmod, mc;
+  double c, x, duty;
+  if((timer > 3) || (ccr < 1) || (ccr > 6)){
+    return 0;
+  }
+  t = MODEL(TimerA[timer]);
+  outmod = (t->CCTL[ccr]>>5)&7;
+  mc = (t->CTL>>4)&3;
+  c = t->CCR[0];
+  x = t->CCR[ccr];
+  if(outmod == 0){
+    return (t->CCTL[ccr]>>2)&1;                 // OUT bit
+  }
+  if((mc == 0) || (c == 0)){
+    return 0;
+  }
+  if(outmod == 4){
+    return 0.5;                                 // toggle
+  }
+  if(mc == 3){
+    switch(outmod){
+      case 2: duty = x/c; break;                // toggle/reset, high around 0
+      case 6: duty = (c - x)/c; break;          // toggle/set, high around CCR0
+      case 3: case 7: duty = (outmod == 3)? (c - x)/c : x/c; break;
+      default: duty = (outmod == 1); break;     // set or reset
+    }
+  }else if(mc == 1){
+    switch(outmod){
+      case 7: duty = x/(c + 1); break;          // reset/set
+      case 3: duty = (c + 1 - x)/(c + 1); break; // set/reset
+      case 2: duty = (c - x)/(c + 1); break;
+      case 6: duty = (x + 1)/(c + 1); break;
+      default: duty = (outmod == 1); break;
+    }
+  }else{
+    return 0;
+  }
+  return (duty < 0)? 0 : (duty > 1)? 1 : duty;
+}
+
+//------------Timer32------------
+static void timer32Lines(uint32_t i){
+  Timer32_Type *t = MODEL(Timer32[i]);
+  t->MIS = (t->CONTROL&0x20)? t->RIS : 0;
+  Sim_Line(IRQ_T32_INT1 + i, t->MIS&1);
+}
+
+static void timer32Update(uint32_t i, uint64_t now){
+  Timer32_Type *t = MODEL(Timer32[i]);
+  uint32_t hz = Sim_MCLK()>>(4*((t->CONTROL>>2)&3));
+  uint64_t ticks = Sim_Periods(&T32[i].Clock, now, hz), period, first, r;
+  uint64_t mask = (t->CONTROL&0x02)? 0xFFFFFFFF : 0xFFFF;
+  if((ticks == 0) || !(t->CONTROL&0x80) || T32[i].Stopped){
+    return;
+  }
+  // periodic reloads LOAD after 0, free-running wraps
+  period = (t->CONTROL&0x40)? (t->LOAD&mask) + 1 : mask + 1;
+  first = T32[i].Value? T32[i].Value : period;  // from 0 it reloads first
+  if(ticks < first){
+    T32[i].Value = first - ticks;
+    return;
+  }
+  t->RIS = 1;
+  if(t->CONTROL&0x01){                          // one-shot stops at 0
+    T32[i].Value = 0;
+    T32[i].Stopped = 1;
+  }else{
+    r = (ticks - first)%period;
+    T32[i].Value = r? period - r : 0;
+  }
+  timer32Lines(i);
+}
+
+static void timer32Write(uint32_t i, uintptr_t addr){
+  Timer32_Type *t = MODEL(Timer32[i]);
+  if(addr == (uintptr_t)&Timer32[i]->LOAD){
+    T32[i].Value = t->LOAD;
+    T32[i].Stopped = 0;
+    t->BGLOAD = t->LOAD;
+  }else if(addr == (uintptr_t)&Timer32[i]->BGLOAD){
+    t->LOAD = t->BGLOAD;                        // takes effect at the next reload
+  }else if(addr == (uintptr_t)&Timer32[i]->INTCLR){
+    t->RIS = 0;
+  }
+  timer32Lines(i);
+}
+
+//------------SysTick------------
+static void sysTickUpdate(uint64_t now){
+  SysTick_Type *s = MODEL(SysTick);
+  uint64_t ticks = Sim_Periods(&Tick.Clock, now, Sim_MCLK()), period, first, r;
+  if((ticks == 0) || !(s->CTRL&1) || ((s->LOAD&0xFFFFFF) == 0)){
+    return;
+  }
+  period = (s->LOAD&0xFFFFFF) + 1;
+  first = Tick.Value? Tick.Value : period;      // from 0 it reloads first
+  if(ticks < first){
+    Tick.Value = first - ticks;
+    return;
+  }
+  r = (ticks - first)%period;
+  Tick.Value = r? period - r : 0;
+  Tick.CountFlag = 1;
+  if(s->CTRL&2){
+    Sim_Pend(IRQ_SYSTICK);
+  }
+}
+
+//------------Watchdog------------
+static void watchdogUpdate(uint64_t now){
+  WDT_A_Type *w = MODEL(WDT_A);
+  static const uint8_t Shift[8] = {31, 27, 23, 19, 15, 13, 9, 6};
+  uint64_t interval = 1ull<<Shift[w->CTL&7], ticks, count;
+  uint32_t hz;
+  switch((w->CTL>>5)&3){
+    case 0: hz = Sim_SMCLK(); break;
+    case 1: hz = Sim_ACLK(); break;
+    case 2: hz = 9400; break;
+    default: hz = 32768; break;
+  }
+  ticks = Sim_Periods(&Watchdog.Clock, now, hz);
+  if((ticks == 0) || (w->CTL&0x80)){
+    return;                                     // held
+  }
+  count = (Watchdog.Count + ticks)/interval;
+  Watchdog.Count = (Watchdog.Count + ticks)%interval;
+  if(count){
+    if(w->CTL&0x10){                            // interval timer
+      Sim_Pend(IRQ_WDT_A);
+    }else{
+      static const char message[] = "msp432sim: watchdog reset\n";
+      if(write(2, message, sizeof(message) - 1)){}
+      _exit(1);
+    }
+  }
+}
+
+//------------Hooks------------
+void SimTimer_Init(void){
+  MODEL(WDT_A)->CTL = 0x6980;                   // held, as SystemInit() leaves it
+  MODEL(SysTick)->CALIB = 0xC0000000;
+}
+
+void SimTimer_Update(uint64_t now){
+  uint32_t i;
+  for(i = 0; i < 4; i++){
+    timerAUpdate(i, now);
+  }
+  for(i = 0; i < 2; i++){
+    timer32Update(i, now);
+  }
+  sysTickUpdate(now);
+  watchdogUpdate(now);
+}
+
+void SimTimer_Read(uintptr_t addr){
+  if(addr < 0x40001000){
+    timerARead((addr - 0x40000000)/0x400, addr);
+  }else if(addr >= (uintptr_t)TIMER32_1 && addr < (uintptr_t)TIMER32_1 + 0x40){
+    uint32_t i = (addr - (uintptr_t)TIMER32_1)/0x20;
+    MODEL(Timer32[i])->VALUE = T32[i].Value;
+    timer32Lines(i);
+  }else if(addr >= (uintptr_t)SysTick && addr < (uintptr_t)SysTick + 0x10){
+    SysTick_Type *s = MODEL(SysTick);
+    s->VAL = Tick.Value;
+    s->CTRL = (s->CTRL&~0x00010000)|(Tick.CountFlag<<16);
+  }
+}
+
+void SimTimer_AfterRead(uintptr_t addr){
+  if(addr < 0x40001000){
+    timerAAfterRead((addr - 0x40000000)/0x400, addr);
+  }else if(addr == (uintptr_t)&SysTick->CTRL){
+    Tick.CountFlag = 0;                         // COUNTFLAG clears on read
+  }
+}
+
+void SimTimer_Write(uintptr_t addr){
+  if(addr < 0x40001000){
+    timerAWrite((addr - 0x40000000)/0x400, addr);
+  }else if(addr >= (uintptr_t)TIMER32_1 && addr < (uintptr_t)TIMER32_1 + 0x40){
+    timer32Write((addr - (uintptr_t)TIMER32_1)/0x20, addr);
+  }else if(addr == (uintptr_t)&SysTick->VAL){
+    SysTick_Type *s = MODEL(SysTick);
+    Tick.Value = 0;                             // any write clears the count and the flag
+    Tick.CountFlag = 0;
+    s->VAL = 0;
+  }else if(addr == (uintptr_t)&SysTick->CTRL){
+    SysTick_Type *s = MODEL(SysTick);
+    s->CTRL = (s->CTRL&~0x00010000)|(Tick.CountFlag<<16);
+  }else if(addr >= (uintptr_t)WDT_A && addr < (uintptr_t)WDT_A + 0x10){
+    WDT_A_Type *w = MODEL(WDT_A);
+    if(w->CTL&0x08){                            // WDTCNTCL
+      Watchdog.Count = 0;
+    }
+    w->CTL = 0x6900|(w->CTL&0xF7);              // password reads as 0x69
+  }
+}
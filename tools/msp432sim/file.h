@@ -0,0 +1,70 @@
+/**
+ * @file      file.h
+ * @brief     Host-side stand-in for the CCS run-time device table
+ * @details   UART0_Initprintf() in inc/UART0.c registers the UART as a
+ * CCS device with add_device() and points stdout at it with fopen()
+ * and freopen(). This header gives the simulator build the same
+ * calls: a registered device is opened as a host stream whose writes
+ * and reads go to the device functions, so printf() reaches
+ * uart_write() and so EUSCI_A0 as it does on the LaunchPad.
+ * Other paths are ordinary host files.<br>
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __FILE_H__ // do not include more than once
+#define __FILE_H__
+#include <stdio.h>
+#include <sys/types.h>
+
+#define _SSA 0                  // single stream device
+#define _MSA 1                  // multiple stream device
+
+/**
+ * Register a device under a name, as in the CCS run-time library
+ * @param name device name, opened as "name" or "name:path"
+ * @param flags _SSA or _MSA
+ * @param dopen called by open with the path, the flags and a stream number
+ * @param dclose called by close
+ * @param dread called to read characters
+ * @param dwrite called to write characters
+ * @param dlseek called to seek
+ * @param dunlink called to remove a file
+ * @param drename called to rename a file
+ * @return 0 if registered, -1 if the table is full
+ * @brief  Add a device
+ */
+int add_device(char *name, unsigned flags,
+               int (*dopen)(const char *path, unsigned flags, int llv_fd),
+               int (*dclose)(int dev_fd),
+               int (*dread)(int dev_fd, char *buf, unsigned count),
+               int (*dwrite)(int dev_fd, const char *buf, unsigned count),
+               off_t (*dlseek)(int dev_fd, off_t offset, int origin),
+               int (*dunlink)(const char *path),
+               int (*drename)(const char *old_name, const char *new_name));
+
+/**
+ * Open a registered device or a host file
+ * @param path device name, or a host file name
+ * @param mode as in fopen()
+ * @return stream, or NULL
+ * @brief  fopen() that knows the devices
+ */
+FILE *Sim_DeviceOpen(const char *path, const char *mode);
+
+/**
+ * Open a registered device or a host file in place of a stream;
+ * stdin, stdout and stderr are replaced, so the standard streams
+ * can be pointed at a device
+ * @param path device name, or a host file name
+ * @param mode as in freopen()
+ * @param stream stream to replace
+ * @return new stream, or NULL
+ * @brief  freopen() that knows the devices
+ */
+FILE *Sim_DeviceReopen(const char *path, const char *mode, FILE *stream);
+
+#define fopen(path, mode)           Sim_DeviceOpen(path, mode)
+#define freopen(path, mode, stream) Sim_DeviceReopen(path, mode, stream)
+
+#endif
@@ -0,0 +1,437 @@
+/**
+ * @file      msp.h
+ * @brief     MSP432P401R register file for the host simulator
+ * @details   Stands in for the TI device header when inc/ drivers and
+ * lab mains are compiled on the host. The peripherals are at their
+ * MSP432 addresses with the MSP432 register layouts; Sim.c maps
+ * memory there and traps every access, so the drivers run
+ * unmodified. Only the registers and bit names the drivers in this
+ * repository use are defined.<br>
+ * NVIC->IP is declared as 32-bit words, four priorities per word,
+ * because that is how the drivers in this repository write it.
+ * @version   V1.0
+ * @date      October 16, 2026
+ ******************************************************************************/
+
+#ifndef __MSP_H__ // do not include more than once
+#define __MSP_H__
+#include <stdint.h>
+
+#define __MSP432P401R__
+#ifndef __I                     // the models in Sim*.c write them
+#define __I  volatile const
+#endif
+#define __O  volatile
+#define __IO volatile
+
+/******************************************************************************
+* Digital I/O, the odd ports at even addresses and the even ports at odd     *
+******************************************************************************/
+typedef struct {
+  __I  uint8_t IN;
+       uint8_t RESERVED0;
+  __IO uint8_t OUT;
+       uint8_t RESERVED1;
+  __IO uint8_t DIR;
+       uint8_t RESERVED2;
+  __IO uint8_t REN;
+       uint8_t RESERVED3;
+  __IO uint8_t DS;
+       uint8_t RESERVED4;
+  __IO uint8_t SEL0;
+       uint8_t RESERVED5;
+  __IO uint8_t SEL1;
+       uint8_t RESERVED6;
+  __I  uint16_t IV;
+       uint8_t RESERVED7[6];
+  __IO uint8_t SELC;
+       uint8_t RESERVED8;
+  __IO uint8_t IES;
+       uint8_t RESERVED9;
+  __IO uint8_t IE;
+       uint8_t RESERVED10;
+  __IO uint8_t IFG;
+       uint8_t RESERVED11;
+} DIO_PORT_Odd_Interruptable_Type;
+
+typedef struct {
+       uint8_t RESERVED0;
+  __I  uint8_t IN;
+       uint8_t RESERVED1;
+  __IO uint8_t OUT;
+       uint8_t RESERVED2;
+  __IO uint8_t DIR;
+       uint8_t RESERVED3;
+  __IO uint8_t REN;
+       uint8_t RESERVED4;
+  __IO uint8_t DS;
+       uint8_t RESERVED5;
+  __IO uint8_t SEL0;
+       uint8_t RESERVED6;
+  __IO uint8_t SEL1;
+       uint8_t RESERVED7[9];
+  __IO uint8_t SELC;
+       uint8_t RESERVED8;
+  __IO uint8_t IES;
+       uint8_t RESERVED9;
+  __IO uint8_t IE;
+       uint8_t RESERVED10;
+  __IO uint8_t IFG;
+  __I  uint16_t IV;
+} DIO_PORT_Even_Interruptable_Type;
+
+typedef DIO_PORT_Odd_Interruptable_Type DIO_PORT_Odd_Type;
+typedef DIO_PORT_Even_Interruptable_Type DIO_PORT_Even_Type;
+
+/******************************************************************************
+* Timer_A, Timer32, eUSCI, ADC14, DMA                                         *
+******************************************************************************/
+typedef struct {
+  __IO uint16_t CTL;
+  __IO uint16_t CCTL[7];
+  __IO uint16_t R;
+  __IO uint16_t CCR[7];
+  __IO uint16_t EX0;
+       uint16_t RESERVED0[6];
+  __I  uint16_t IV;
+} Timer_A_Type;
+
+typedef struct {
+  __IO uint32_t LOAD;
+  __I  uint32_t VALUE;
+  __IO uint32_t CONTROL;
+  __O  uint32_t INTCLR;
+  __I  uint32_t RIS;
+  __I  uint32_t MIS;
+  __IO uint32_t BGLOAD;
+} Timer32_Type;
+
+typedef struct {
+  __IO uint16_t CTLW0;
+  __IO uint16_t CTLW1;
+       uint16_t RESERVED0;
+  __IO uint16_t BRW;
+  __IO uint16_t MCTLW;
+  __IO uint16_t STATW;
+  __I  uint16_t RXBUF;
+  __IO uint16_t TXBUF;
+  __IO uint16_t ABCTL;
+  __IO uint16_t IRCTL;
+       uint16_t RESERVED1[3];
+  __IO uint16_t IE;
+  __IO uint16_t IFG;
+  __I  uint16_t IV;
+} EUSCI_A_Type;
+
+typedef struct {
+  __IO uint16_t CTLW0;
+  __IO uint16_t CTLW1;
+       uint16_t RESERVED0;
+  __IO uint16_t BRW;
+  __IO uint16_t STATW;
+  __IO uint16_t TBCNT;
+  __I  uint16_t RXBUF;
+  __IO uint16_t TXBUF;
+       uint16_t RESERVED1[2];
+  __IO uint16_t I2COA0;
+  __IO uint16_t I2COA1;
+  __IO uint16_t I2COA2;
+  __IO uint16_t I2COA3;
+  __I  uint16_t ADDRX;
+  __IO uint16_t ADDMASK;
+  __IO uint16_t I2CSA;
+       uint16_t RESERVED2[4];
+  __IO uint16_t IE;
+  __IO uint16_t IFG;
+  __I  uint16_t IV;
+} EUSCI_B_Type;
+
+typedef struct {
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t LO0;
+  __IO uint32_t HI0;
+  __IO uint32_t LO1;
+  __IO uint32_t HI1;
+  __IO uint32_t MCTL[32];
+  __IO uint32_t MEM[32];
+       uint32_t RESERVED0[9];
+  __IO uint32_t IER0;
+  __IO uint32_t IER1;
+  __I  uint32_t IFGR0;
+  __I  uint32_t IFGR1;
+  __O  uint32_t CLRIFGR0;
+  __IO uint32_t CLRIFGR1;
+  __IO uint32_t IV;
+} ADC14_Type;
+
+typedef struct {
+  __I  uint32_t DEVICE_CFG;
+  __IO uint32_t SW_CHTRIG;
+       uint32_t RESERVED0[2];
+  __IO uint32_t CH_SRCCFG[32];
+       uint32_t RESERVED1[28];
+  __IO uint32_t INT1_SRCCFG;
+  __IO uint32_t INT2_SRCCFG;
+  __IO uint32_t INT3_SRCCFG;
+       uint32_t RESERVED2;
+  __I  uint32_t INT0_SRCFLG;
+  __O  uint32_t INT0_CLRFLG;
+} DMA_Channel_Type;
+
+typedef struct {
+  __I  uint32_t STAT;
+  __O  uint32_t CFG;
+  __IO uint32_t CTLBASE;
+  __I  uint32_t ALTBASE;
+  __I  uint32_t WAITSTAT;
+  __O  uint32_t SWREQ;
+  __IO uint32_t USEBURSTSET;
+  __O  uint32_t USEBURSTCLR;
+  __IO uint32_t REQMASKSET;
+  __O  uint32_t REQMASKCLR;
+  __IO uint32_t ENASET;
+  __O  uint32_t ENACLR;
+  __IO uint32_t ALTSET;
+  __O  uint32_t ALTCLR;
+  __IO uint32_t PRIOSET;
+  __O  uint32_t PRIOCLR;
+       uint32_t RESERVED0[3];
+  __IO uint32_t ERRCLR;
+} DMA_Control_Type;
+
+typedef struct {
+  __IO uint16_t CTL0;
+} REF_A_Type;
+
+/******************************************************************************
+* Clock, power, flash and system control                                      *
+******************************************************************************/
+typedef struct {
+  __IO uint32_t KEY;
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t CTL2;
+  __IO uint32_t CTL3;
+       uint32_t RESERVED0[7];
+  __IO uint32_t CLKEN;
+  __I  uint32_t STAT;
+       uint32_t RESERVED1[2];
+  __IO uint32_t IE;
+       uint32_t RESERVED2;
+  __I  uint32_t IFG;
+       uint32_t RESERVED3;
+  __O  uint32_t CLRIFG;
+       uint32_t RESERVED4;
+  __O  uint32_t SETIFG;
+       uint32_t RESERVED5;
+  __IO uint32_t DCOERCAL0;
+  __IO uint32_t DCOERCAL1;
+} CS_Type;
+
+typedef struct {
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t IE;
+  __I  uint32_t IFG;
+  __O  uint32_t CLRIFG;
+} PCM_Type;
+
+typedef struct {
+  __I  uint32_t POWER_STAT;
+       uint32_t RESERVED0[3];
+  __IO uint32_t BANK0_RDCTL;
+  __IO uint32_t BANK1_RDCTL;
+       uint32_t RESERVED1[2];
+  __IO uint32_t RDBRST_CTLSTAT;
+  __IO uint32_t RDBRST_STARTADDR;
+  __IO uint32_t RDBRST_LEN;
+       uint32_t RESERVED2[4];
+  __IO uint32_t RDBRST_FAILADDR;
+  __IO uint32_t RDBRST_FAILCNT;
+       uint32_t RESERVED3[3];
+  __IO uint32_t PRG_CTLSTAT;
+  __IO uint32_t PRGBRST_CTLSTAT;
+  __IO uint32_t PRGBRST_STARTADDR;
+       uint32_t RESERVED4;
+  __IO uint32_t PRGBRST_DATA0_0;
+  __IO uint32_t PRGBRST_DATA0_1;
+  __IO uint32_t PRGBRST_DATA0_2;
+  __IO uint32_t PRGBRST_DATA0_3;
+  __IO uint32_t PRGBRST_DATA1_0;
+  __IO uint32_t PRGBRST_DATA1_1;
+  __IO uint32_t PRGBRST_DATA1_2;
+  __IO uint32_t PRGBRST_DATA1_3;
+  __IO uint32_t PRGBRST_DATA2_0;
+  __IO uint32_t PRGBRST_DATA2_1;
+  __IO uint32_t PRGBRST_DATA2_2;
+  __IO uint32_t PRGBRST_DATA2_3;
+  __IO uint32_t PRGBRST_DATA3_0;
+  __IO uint32_t PRGBRST_DATA3_1;
+  __IO uint32_t PRGBRST_DATA3_2;
+  __IO uint32_t PRGBRST_DATA3_3;
+  __IO uint32_t ERASE_CTLSTAT;
+  __IO uint32_t ERASE_SECTADDR;
+       uint32_t RESERVED5[2];
+  __IO uint32_t BANK0_INFO_WEPROT;
+  __IO uint32_t BANK0_MAIN_WEPROT;
+       uint32_t RESERVED6[2];
+  __IO uint32_t BANK1_INFO_WEPROT;
+  __IO uint32_t BANK1_MAIN_WEPROT;
+       uint32_t RESERVED7[2];
+  __IO uint32_t BMRK_CTLSTAT;
+  __IO uint32_t BMRK_IFETCH;
+  __IO uint32_t BMRK_DREAD;
+  __IO uint32_t BMRK_CMP;
+       uint32_t RESERVED8[4];
+  __I  uint32_t IFG;
+  __IO uint32_t IE;
+  __O  uint32_t CLRIFG;
+  __O  uint32_t SETIFG;
+} FLCTL_Type;
+
+typedef struct {
+       uint16_t RESERVED0[6];
+  __IO uint16_t CTL;
+} WDT_A_Type;
+
+typedef struct {
+  __IO uint32_t REBOOT_CTL;
+  __IO uint32_t NMI_CTLSTAT;
+  __IO uint32_t WDTRESET_CTL;
+  __IO uint32_t PERIHALT_CTL;
+  __I  uint32_t SRAM_SIZE;
+  __IO uint32_t SRAM_BANKEN;
+  __IO uint32_t SRAM_BANKRET;
+} SYSCTL_Type;
+
+/******************************************************************************
+* Cortex-M4 system control space                                              *
+******************************************************************************/
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+  __IO uint32_t ISER[8];
+       uint32_t RESERVED0[24];
+  __IO uint32_t ICER[8];
+       uint32_t RESERVED1[24];
+  __IO uint32_t ISPR[8];
+       uint32_t RESERVED2[24];
+  __IO uint32_t ICPR[8];
+       uint32_t RESERVED3[24];
+  __IO uint32_t IABR[8];
+       uint32_t RESERVED4[56];
+  __IO uint32_t IP[60];
+} NVIC_Type;
+
+typedef struct {
+  __I  uint32_t CPUID;
+  __IO uint32_t ICSR;
+  __IO uint32_t VTOR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CCR;
+  __IO uint8_t  SHP[12];
+  __IO uint32_t SHCSR;
+  __IO uint32_t CFSR;
+  __IO uint32_t HFSR;
+  __IO uint32_t DFSR;
+  __IO uint32_t MMFAR;
+  __IO uint32_t BFAR;
+  __IO uint32_t AFSR;
+  __I  uint32_t PFR[2];
+  __I  uint32_t DFR;
+  __I  uint32_t ADR;
+  __I  uint32_t MMFR[4];
+  __I  uint32_t ISAR[5];
+       uint32_t RESERVED0[5];
+  __IO uint32_t CPACR;
+} SCB_Type;
+
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  __IO uint32_t DHCSR;
+  __O  uint32_t DCRSR;
+  __IO uint32_t DCRDR;
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+/******************************************************************************
+* Addresses                                                                   *
+******************************************************************************/
+#define PERIPH_BASE     ((uintptr_t)0x40000000)
+#define DIO_BASE        (PERIPH_BASE+0x4C00)
+#define TIMER_A0 ((Timer_A_Type *)(PERIPH_BASE+0x0000))
+#define TIMER_A1 ((Timer_A_Type *)(PERIPH_BASE+0x0400))
+#define TIMER_A2 ((Timer_A_Type *)(PERIPH_BASE+0x0800))
+#define TIMER_A3 ((Timer_A_Type *)(PERIPH_BASE+0x0C00))
+#define EUSCI_A0 ((EUSCI_A_Type *)(PERIPH_BASE+0x1000))
+#define EUSCI_A1 ((EUSCI_A_Type *)(PERIPH_BASE+0x1400))
+#define EUSCI_A2 ((EUSCI_A_Type *)(PERIPH_BASE+0x1800))
+#define EUSCI_A3 ((EUSCI_A_Type *)(PERIPH_BASE+0x1C00))
+#define EUSCI_B0 ((EUSCI_B_Type *)(PERIPH_BASE+0x2000))
+#define EUSCI_B1 ((EUSCI_B_Type *)(PERIPH_BASE+0x2400))
+#define EUSCI_B2 ((EUSCI_B_Type *)(PERIPH_BASE+0x2800))
+#define EUSCI_B3 ((EUSCI_B_Type *)(PERIPH_BASE+0x2C00))
+#define REF_A    ((REF_A_Type *)(PERIPH_BASE+0x3000))
+#define WDT_A    ((WDT_A_Type *)(PERIPH_BASE+0x4800))
+#define P1  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0000))
+#define P2  ((DIO_PORT_Even_Interruptable_Type *)(DIO_BASE+0x0000))
+#define P3  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0020))
+#define P4  ((DIO_PORT_Even_Interruptable_Type *)(DIO_BASE+0x0020))
+#define P5  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0040))
+#define P6  ((DIO_PORT_Even_Interruptable_Type *)(DIO_BASE+0x0040))
+#define P7  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0060))
+#define P8  ((DIO_PORT_Even_Interruptable_Type *)(DIO_BASE+0x0060))
+#define P9  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0080))
+#define P10 ((DIO_PORT_Even_Interruptable_Type *)(DIO_BASE+0x0080))
+#define PJ  ((DIO_PORT_Odd_Interruptable_Type *)(DIO_BASE+0x0120))
+#define TIMER32_1 ((Timer32_Type *)(PERIPH_BASE+0xC000))
+#define TIMER32_2 ((Timer32_Type *)(PERIPH_BASE+0xC020))
+#define DMA_Channel ((DMA_Channel_Type *)(PERIPH_BASE+0xE000))
+#define DMA_Control ((DMA_Control_Type *)(PERIPH_BASE+0xF000))
+#define PCM      ((PCM_Type *)(PERIPH_BASE+0x10000))
+#define CS       ((CS_Type *)(PERIPH_BASE+0x10400))
+#define FLCTL    ((FLCTL_Type *)(PERIPH_BASE+0x11000))
+#define ADC14    ((ADC14_Type *)(PERIPH_BASE+0x12000))
+#define DWT      ((DWT_Type *)(uintptr_t)0xE0001000)
+#define SysTick  ((SysTick_Type *)(uintptr_t)0xE000E010)
+#define NVIC     ((NVIC_Type *)(uintptr_t)0xE000E100)
+#define SCB      ((SCB_Type *)(uintptr_t)0xE000ED00)
+#define CoreDebug ((CoreDebug_Type *)(uintptr_t)0xE000EDF0)
+#define SYSCTL   ((SYSCTL_Type *)(uintptr_t)0xE0043000)
+
+/******************************************************************************
+* Bit names used by the drivers                                               *
+******************************************************************************/
+#define FLCTL_BANK0_RDCTL_WAIT_2 ((uint32_t)0x00002000)
+#define FLCTL_BANK1_RDCTL_WAIT_2 ((uint32_t)0x00002000)
+#define REFCTL0 (REF_A->CTL0)
+#define P1OUT   (P1->OUT)
+#define P4SEL0  (P4->SEL0)
+#define P4SEL1  (P4->SEL1)
+#define WDT_A_CTL_PW   ((uint16_t)0x5A00)
+#define WDT_A_CTL_HOLD ((uint16_t)0x0080)
+
+/******************************************************************************
+* Core instructions, carried out by the simulator                             *
+******************************************************************************/
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __WFI(void);
+#define __NOP() ((void)0)
+#define __DSB() ((void)0)
+#define __ISB() ((void)0)
+
+#endif // __MSP_H__
@@ -0,0 +1,6 @@
+// msp432.h
+// Runs on the host, Linux x86-64
+// The other name of the TI device header, used by Reflectance.c.
+// October 16, 2026
+
+#include "msp.h"
@@ -0,0 +1,132 @@
+// ADC14DMATest.c
+// Runs on the host, Linux x86-64
+// Runs the DMA ping-pong capture of inc/ADC14DMA.c on the
+// simulator's ADC14, Timer A1 and DMA models: the 24-word
+// descriptors, blocks landing in the two halves in turn, one
+// DMA_INT1 per block of 3*ADCDMA_TRIPLES conversions, the
+// decimated values, and the restart when the interrupt falls a
+// whole block behind.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/ADC14DMA.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define PERIOD 1200                // SMCLK counts, 10 kHz conversions, a block every 2.4 ms
+#define BLOCKUS (ADCDMA_BLOCKSIZE*PERIOD/12)
+extern uint32_t ADCDMABuf[2][ADCDMA_BLOCKSIZE];
+extern volatile uint32_t ADCDMALost;
+
+static uint32_t code(double volts){
+  return (uint32_t)(volts/3.3*16383+0.5);
+}
+
+static volatile uint32_t Calls, Bad, Gap, Half[2];
+static uint32_t Want[3];
+static uint64_t Last;              // ns of the previous task call
+static void task(uint32_t ch17, uint32_t ch12, uint32_t ch16){
+  uint64_t now = Sim_Time();
+  uint32_t *block = ((DMA_PRIMARY(ADCDMA_CHANNEL)->Control&DMA_CYCLE_MASK) == 0) ? ADCDMABuf[0] : ADCDMABuf[1];
+  uint32_t i;
+  if((ch17 != Want[0]) || (ch12 != Want[1]) || (ch16 != Want[2])) Bad++;
+  for(i = 0; i < ADCDMA_BLOCKSIZE; i++){
+    if(block[i] != Want[i%3]) Bad++;
+  }
+  Half[block == ADCDMABuf[1]]++;
+  if(Calls && ((now-Last)/1000 > Gap)) Gap = (uint32_t)((now-Last)/1000);
+  Last = now;
+  Calls++;
+}
+
+static void voltages(double v17, double v12, double v16){
+  Sim_SetVoltage(17, v17);
+  Sim_SetVoltage(12, v12);
+  Sim_SetVoltage(16, v16);
+  Want[0] = code(v17);
+  Want[1] = code(v12);
+  Want[2] = code(v16);
+}
+
+static void wait(uint32_t calls){
+  uint32_t n = Calls+calls;
+  while(Calls < n){}
+}
+
+int main(void){
+  static uint32_t dst[ADCDMA_BLOCKSIZE];
+  struct DMADescriptor d;
+  uint32_t a, b, c, i, n, lost;
+  uint64_t t;
+
+  // the helpers
+  CHECK((ADCDMA_Control(24)&DMA_CYCLE_MASK) == 3);
+  CHECK(((ADCDMA_Control(24)>>4)&0x3FF) == 23);
+  ADCDMA_Descriptor(&d, ADC14->MEM, dst);
+  CHECK(d.SrcEnd == &ADC14->MEM[23]);
+  CHECK(d.DstEnd == &dst[23]);
+  for(i = 0; i < ADCDMA_BLOCKSIZE; i++) dst[i] = (i%3 == 0) ? 100+i : (i%3 == 1) ? 16383 : 0xC000|5;
+  ADCDMA_Decimate(dst, 3, &a, &b, &c);
+  CHECK(a == (8*100+(0+3+6+9+12+15+18+21))/8);
+  CHECK(b == 16383);
+  CHECK(c == 5);                   // bits above 14 ignored
+  ADCDMA_Decimate(dst, 0, &a, &b, &c);
+  CHECK(b == 8*16383);
+
+  // blocks of 24 words, halves in turn, one interrupt each
+  Clock_Init48MHz();
+  Sim_SetSpeed(0.5);
+  voltages(1.0, 2.0, 3.0);
+  ADC0_InitDMACh17_12_16(&task, PERIOD, 3);
+  CHECK(ADCDMA_Latest(&a, &b, &c) == 0);
+  EnableInterrupts();
+  t = Sim_Time();
+  wait(40);
+  t = (Sim_Time()-t)/1000;
+  CHECK(Bad == 0);
+  CHECK((t >= 39*BLOCKUS) && (t <= 41*BLOCKUS+500));
+  CHECK(Gap <= BLOCKUS+500);
+  CHECK((Half[0] >= 19) && (Half[1] >= 19) && (Half[0] <= Half[1]+1) && (Half[1] <= Half[0]+1));
+  CHECK(ADCDMALost == 0);
+  CHECK(ADCDMA_Latest(&a, &b, &c) >= 40);
+  CHECK((a == Want[0]) && (b == Want[1]) && (c == Want[2]));
+
+  // a new input reaches the task within two blocks
+  voltages(0.5, 1.5, 2.5);
+  wait(2);
+  Bad = 0;
+  wait(10);
+  CHECK(Bad == 0);
+
+  // held off for three blocks, the channel stops with both halves
+  // full and restarts from the primary
+  lost = ADCDMALost;
+  DisableInterrupts();
+  t = Sim_Time();
+  while(Sim_Time()-t < 3*BLOCKUS*1000ull){}
+  n = Calls;
+  EnableInterrupts();
+  wait(1);
+  CHECK(ADCDMALost == lost+1);
+  CHECK(Calls >= n+2);             // both halves processed
+  Bad = 0;
+  wait(10);
+  CHECK(Bad == 0);
+  CHECK(ADCDMALost == lost+1);
+
+  ADC0_StopDMA();
+  n = Calls;
+  t = Sim_Time();
+  while(Sim_Time()-t < 4*BLOCKUS*1000ull){}
+  CHECK(Calls == n);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,116 @@
+// ADC14Test.c
+// Runs on the host, Linux x86-64
+// Runs the timer-triggered repeat sequence of inc/ADC14.c on the
+// simulator's ADC14 and Timer A1 models: the register setup, one
+// end-of-sequence interrupt per 3*period with channels 17, 12 and
+// 16 in order, ADC_Latest17_12_16(), the ring behind
+// ADC_Get17_12_16() with its overrun count, and
+// ADC0_StopTimerTrigger().
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/ADC14.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define PERIOD 333                 // 2 us counts, a triple every 1.998 ms
+extern volatile uint32_t ADCLost;
+
+static uint32_t code(double volts){
+  return (uint32_t)(volts/3.3*16383+0.5);
+}
+
+static volatile uint32_t Calls, Bad, Gap;
+static uint32_t Want17, Want12, Want16;
+static uint64_t Last;              // ns of the previous task call
+static void task(uint32_t ch17, uint32_t ch12, uint32_t ch16){
+  uint64_t now = Sim_Time();
+  if((ch17 != Want17) || (ch12 != Want12) || (ch16 != Want16)) Bad++;
+  if(Calls && ((now-Last)/1000 > Gap)) Gap = (uint32_t)((now-Last)/1000);
+  Last = now;
+  Calls++;
+}
+
+static void voltages(double v17, double v12, double v16){
+  Sim_SetVoltage(17, v17);
+  Sim_SetVoltage(12, v12);
+  Sim_SetVoltage(16, v16);
+  Want17 = code(v17);
+  Want12 = code(v12);
+  Want16 = code(v16);
+}
+
+static void wait(uint32_t calls){
+  uint32_t n = Calls+calls;
+  while(Calls < n){}
+}
+
+int main(void){
+  uint32_t a, b, c, n, i;
+  uint64_t t;
+  Clock_Init48MHz();
+  Sim_SetSpeed(0.5);
+  voltages(1.0, 2.0, 3.0);
+  ADC0_InitTimerTriggerCh17_12_16(&task, PERIOD);
+
+  // the setup, read back without trapping
+  CHECK(MODEL(ADC14)->CTL0 == 0x1C263312);
+  CHECK((MODEL(ADC14)->MCTL[0]&0x9F) == 17);
+  CHECK((MODEL(ADC14)->MCTL[1]&0x9F) == 12);
+  CHECK((MODEL(ADC14)->MCTL[2]&0x9F) == (16|0x80));
+  CHECK(MODEL(ADC14)->IER0 == 0x04);
+  CHECK(MODEL(TIMER_A1)->CCR[0] == PERIOD-1);
+  CHECK(ADC_Latest17_12_16(&a, &b, &c) == 0);
+  CHECK(ADC_Get17_12_16(&a, &b, &c) == 0);
+
+  // a triple every 3*PERIOD*2 us, in channel order
+  __enable_irq();
+  t = Sim_Time();
+  wait(50);
+  t = (Sim_Time()-t)/1000;
+  CHECK(Bad == 0);
+  CHECK((t >= 49*3*PERIOD*2) && (t <= 51*3*PERIOD*2+500));
+  CHECK(Gap <= 3*PERIOD*2+500);
+  n = ADC_Latest17_12_16(&a, &b, &c);
+  CHECK(n >= 50);
+  CHECK((a == Want17) && (b == Want12) && (c == Want16));
+
+  // the ring keeps the last ADC_RINGSIZE triples
+  CHECK(ADC_Get17_12_16(&a, &b, &c) == 1);
+  CHECK(ADCLost >= 50-ADC_RINGSIZE);
+  CHECK((a == Want17) && (b == Want12) && (c == Want16));
+  while(ADC_Get17_12_16(&a, &b, &c)){}
+
+  // a new input shows up in the next triple, and Get drains in order
+  voltages(0.5, 1.5, 2.5);
+  wait(2);
+  CHECK(ADC_Latest17_12_16(&a, &b, &c) > n);
+  CHECK((a == Want17) && (b == Want12) && (c == Want16));
+  Bad = 0;
+  while(ADC_Get17_12_16(&a, &b, &c)){}
+  n = ADCLost;
+  for(i = 0; i < 20; i++){
+    wait(1);
+    CHECK(ADC_Get17_12_16(&a, &b, &c) == 1);
+    CHECK((a == Want17) && (b == Want12) && (c == Want16));
+  }
+  CHECK(ADCLost == n);
+  CHECK(Bad == 0);
+
+  // stopped, nothing more converts
+  ADC0_StopTimerTrigger();
+  n = Calls;
+  t = Sim_Time();
+  while(Sim_Time()-t < 20000000){}
+  CHECK(Calls == n);
+  CHECK(!(MODEL(ADC14)->CTL0&0x02));
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,112 @@
+// ClockTest.c
+// Runs on the host, Linux x86-64
+// Checks the delays of inc/Clock.c on the simulated DWT cycle
+// counter and watchdog: Clock_Delay1ms() and Clock_Delay1us()
+// against the simulator's time, Clock_Now() against it over
+// seconds at 3 and 48 MHz, where dropping the fraction of a
+// microsecond in each watchdog interval would lose about 1 ms a
+// second, across Clock_Init48MHz() and with interrupts held off for
+// many intervals, and Clock_Sleep1ms(), which must sleep, so the
+// cycle counter stops, and still wait the whole time.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define SLACK 50                   // us, Clock_Now() against the simulator
+
+// Clock_Now() minus the simulator's time, us, both from the start
+static uint64_t Now0, Sim0;
+static int64_t drift(void){
+  uint64_t now = Clock_Now(), sim = Sim_Time();
+  return (int64_t)(now-Now0)-(int64_t)((sim-Sim0)/1000);
+}
+
+// the simulator's us while the work runs, the work tried again
+// if a host stall makes it late, up to 3 times
+static uint64_t timed(void (*work)(uint32_t), uint32_t n, uint64_t us, uint32_t *cycles){
+  uint64_t t;
+  uint32_t c, tries;
+  for(tries = 0; tries < 3; tries++){
+    c = DWT->CYCCNT;
+    t = Sim_Time();
+    work(n);
+    t = (Sim_Time()-t)/1000;
+    c = DWT->CYCCNT-c;
+    if(t < us+SLACK) break;
+  }
+  if(cycles) *cycles = c;
+  return t;
+}
+
+int main(void){
+  uint64_t t;
+  uint32_t cycles;
+  int64_t d;
+
+  // 3 MHz out of reset: a watchdog interval of 2730.67 us
+  Sim_SetSpeed(0.2);
+  EnableInterrupts();
+  Now0 = Clock_Now();
+  Sim0 = Sim_Time();
+  CHECK(Clock_GetFreq() == 3000000);
+  t = Sim_Time();
+  while(Sim_Time()-t < 1000000000){}
+  d = drift();
+  printf("3 MHz: %lld us off after 1 s\n", (long long)d);
+  CHECK((d > -SLACK) && (d < SLACK));
+
+  // on to 48 MHz without a jump
+  Clock_Init48MHz();
+  CHECK(Clock_GetFreq() == 48000000);
+  d = drift();
+  CHECK((d > -SLACK) && (d < SLACK));
+
+  // busy-waits on the cycle counter
+  t = timed(&Clock_Delay1ms, 10, 10000, &cycles);
+  printf("Clock_Delay1ms(10) %llu us, %u cycles\n", (unsigned long long)t, cycles);
+  CHECK((t >= 10000) && (t < 10000+SLACK));
+  CHECK((cycles >= 480000) && (cycles < 480000+48*SLACK));
+  t = timed(&Clock_Delay1us, 250, 250, 0);
+  CHECK((t >= 250) && (t < 250+SLACK));
+  t = timed(&Clock_Delay1us, 2500, 2500, 0);
+  CHECK((t >= 2500) && (t < 2500+SLACK));
+
+  // 682.67 us intervals for 2 s
+  t = Sim_Time();
+  while(Sim_Time()-t < 2000000000){}
+  d = drift();
+  printf("48 MHz: %lld us off after 2 s more\n", (long long)d);
+  CHECK((d > -SLACK) && (d < SLACK));
+
+  // asleep: the whole time, give or take the reads around it, at
+  // most an interval late, and the core stopped for much of it;
+  // the simulator wakes it on every host tick
+  t = timed(&Clock_Sleep1ms, 20, 20000+683, &cycles);
+  printf("Clock_Sleep1ms(20) %llu us, %u cycles\n", (unsigned long long)t, cycles);
+  CHECK((t > 20000-SLACK) && (t < 20000+683+SLACK));
+  CHECK(cycles < 20*48000*3/4);
+  d = drift();
+  CHECK((d > -SLACK) && (d < SLACK));
+
+  // 10 ms with interrupts disabled, made up from the cycle counter
+  // to the nearest interval
+  DisableInterrupts();
+  t = Sim_Time();
+  while(Sim_Time()-t < 10000000){}
+  EnableInterrupts();
+  Clock_Delay1ms(2);
+  d = drift();
+  printf("held off 10 ms: %lld us off\n", (long long)d);
+  CHECK((d > -683-SLACK) && (d < 683+SLACK));
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,135 @@
+// FIFOTest.c
+// Runs on the host, Linux x86-64
+// Checks the single-producer single-consumer queue of inc/FIFO0.c:
+// full, empty, HighWater and Lost on one thread, the indices
+// wrapping past 2^32, the TxFifo0/RxFifo0 sizes, and then a
+// producer and a consumer on two threads mixing Fifo_Put/Fifo_PutN
+// and Fifo_Get/Fifo_GetN, with nothing lost, repeated or reordered.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../../../inc/FIFO0.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define SIZE 64
+#define COUNT 5000000u             // bytes through the queue on two threads
+static struct Fifo Q;
+static uint8_t Buf[SIZE];
+
+// byte i of the stream
+static uint8_t stream(uint32_t i){
+  return (uint8_t)(i*2654435761u>>24);
+}
+
+static void *producer(void *arg){
+  uint8_t chunk[SIZE];
+  uint32_t i = 0, n, k, seed = 1;
+  while(i < COUNT){
+    seed = seed*1103515245+12345;
+    if(seed&0x10000){
+      if(Fifo_Put(&Q, stream(i)) == FIFOSUCCESS){
+        i++;
+      }else{
+        sched_yield();             // full, let the consumer run on one CPU
+      }
+    }else{
+      n = 1+((seed>>20)%SIZE);
+      if(n > COUNT-i) n = COUNT-i;
+      for(k = 0; k < n; k++) chunk[k] = stream(i+k);
+      k = Fifo_PutN(&Q, chunk, n);
+      if(k == 0) sched_yield();
+      i += k;
+    }
+  }
+  return arg;
+}
+
+static uint32_t Bad;
+static void *consumer(void *arg){
+  uint8_t chunk[SIZE], data;
+  uint32_t i = 0, n, k, seed = 7;
+  while(i < COUNT){
+    seed = seed*1103515245+12345;
+    if(seed&0x10000){
+      if(Fifo_Get(&Q, &data) == FIFOSUCCESS){
+        Bad += (data != stream(i));
+        i++;
+      }else{
+        sched_yield();             // empty
+      }
+    }else{
+      n = Fifo_GetN(&Q, chunk, 1+((seed>>20)%SIZE));
+      if(n == 0) sched_yield();
+      for(k = 0; k < n; k++) Bad += (chunk[k] != stream(i+k));
+      i += n;
+    }
+  }
+  return arg;
+}
+
+int main(void){
+  uint8_t in[SIZE+8], out[SIZE+8], data;
+  char c;
+  uint32_t i;
+  pthread_t p, q;
+  sigset_t alarm;
+
+  // one thread: full, empty and the counters
+  Fifo_Init(&Q, Buf, SIZE);
+  CHECK(Fifo_Get(&Q, &data) == FIFOFAIL);
+  for(i = 0; i < SIZE; i++) CHECK(Fifo_Put(&Q, i) == FIFOSUCCESS);
+  CHECK(Fifo_Size(&Q) == SIZE);    // the whole buffer is usable
+  CHECK(Fifo_Put(&Q, 99) == FIFOFAIL);
+  CHECK(Q.Lost == 1);
+  CHECK(Q.HighWater == SIZE);
+  for(i = 0; i < SIZE; i++) CHECK((Fifo_Get(&Q, &data) == FIFOSUCCESS) && (data == i));
+  CHECK(Fifo_Size(&Q) == 0);
+  for(i = 0; i < sizeof(in); i++) in[i] = 200+i;
+  CHECK(Fifo_PutN(&Q, in, 10) == 10);
+  CHECK(Fifo_PutN(&Q, &in[10], SIZE) == SIZE-10);
+  CHECK(Q.Lost == 11);
+  CHECK(Fifo_GetN(&Q, out, sizeof(out)) == SIZE);
+  for(i = 0; i < SIZE; i++) CHECK(out[i] == in[i]);
+  CHECK(Fifo_GetN(&Q, out, 5) == 0);
+
+  // the free running indices wrap
+  Q.PutI = Q.GetI = 0xFFFFFFF0;
+  CHECK(Fifo_PutN(&Q, in, 40) == 40);
+  CHECK(Fifo_Size(&Q) == 40);
+  for(i = 0; i < 40; i++) CHECK((Fifo_Get(&Q, &data) == FIFOSUCCESS) && (data == in[i]));
+  CHECK(Q.PutI == 0x18);
+
+  // the UART queues report their own sizes
+  TxFifo0_Init();
+  RxFifo0_Init();
+  CHECK(TxFifo0_Put('a') && TxFifo0_Put('b') && RxFifo0_Put('c'));
+  CHECK(TxFifo0_Size() == 2);
+  CHECK(RxFifo0_Size() == 1);
+  CHECK(RxFifo0_Get(&c) && (c == 'c'));
+  CHECK(RxFifo0_Size() == 0);
+  CHECK(TxFifo0_Size() == 2);
+
+  // two threads, the simulator's clock kept out of them
+  sigemptyset(&alarm);
+  sigaddset(&alarm, SIGALRM);
+  pthread_sigmask(SIG_BLOCK, &alarm, 0);
+  Fifo_Init(&Q, Buf, SIZE);
+  pthread_create(&p, 0, &producer, 0);
+  pthread_create(&q, 0, &consumer, 0);
+  pthread_join(p, 0);
+  pthread_join(q, 0);
+  printf("%u bytes, %u wrong, high water %u of %u\n", COUNT, Bad, Q.HighWater, SIZE);
+  CHECK(Bad == 0);
+  CHECK(Fifo_Size(&Q) == 0);
+  CHECK(Q.PutI == COUNT);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,132 @@
+// FlashProgramTest.c
+// Runs on the host, Linux x86-64
+// Checks inc/FlashProgram.c on the simulated flash: program and
+// erase in Bank 1 with interrupts running and in Bank 0 with them
+// masked, the refusals, a stalled operation in each of write,
+// burst and erase timing out, and the split erase of
+// Flash_EraseStart() and Flash_ErasePoll().
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/FlashProgram.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+static volatile uint32_t Ticks;    // 1 ms SysTick interrupts
+void SysTick_Handler(void){
+  Ticks = Ticks+1;
+}
+
+static volatile uint32_t *word(uint32_t addr){
+  return (volatile uint32_t *)(uintptr_t)addr;
+}
+
+static uint32_t us(void){
+  return (uint32_t)(Sim_Time()/1000);
+}
+
+// program and erase one sector; interrupts run during a Bank 1
+// erase and are held off during a Bank 0 one
+static void sector(uint32_t addr, int bank0){
+  uint32_t src[16], i, t;
+  for(i = 0; i < 16; i++) src[i] = 0x12345678*(i+1)^addr;
+  Ticks = 0;
+  CHECK(Flash_Erase(addr) == NOERROR);
+  if(bank0){
+    CHECK(Ticks <= 2);
+  }else{
+    CHECK(Ticks > 2);
+  }
+  for(i = 0; i < 1024; i++) CHECK(*word(addr+4*i) == 0xFFFFFFFF);
+  CHECK(Flash_FastWrite(src, addr, 16) == 16);
+  CHECK(memcmp((void *)(uintptr_t)addr, src, 64) == 0);
+  CHECK(Flash_FastWrite(src, addr+64, 5) == 5);
+  CHECK(*word(addr+64+20) == 0xFFFFFFFF);
+  CHECK(Flash_FastWrite(src, addr+64, 5) == 5);           // the same again
+  CHECK(Flash_Write(addr+128, 0xA5A5F00F) == NOERROR);
+  CHECK(*word(addr+128) == 0xA5A5F00F);
+  CHECK(Flash_Write(addr+128, 0x0000F00F) == NOERROR);    // only clears bits
+  CHECK(Flash_Write(addr+128, 0xFFFFFFFF) == ERROR);      // cannot set them
+  CHECK(Flash_WriteArray(src, addr+256, 10) == 10);
+  CHECK(memcmp((void *)(uintptr_t)(addr+256), src, 40) == 0);
+  src[0] = 0xFFFFFFFF;
+  CHECK(Flash_FastWrite(src, addr, 4) == 0);              // word 0 cannot go back to 1s
+  src[0] = 1;
+  // a stalled operation returns on its timeout and leaves the data
+  SimFlash_Stall(1);
+  t = us();
+  CHECK(Flash_Write(addr+512, 0x11111111) == ERROR);
+  CHECK(us()-t < 5000);
+  CHECK(*word(addr+512) == 0xFFFFFFFF);
+  SimFlash_Stall(1);
+  t = us();
+  CHECK(Flash_FastWrite(src, addr+1024, 16) == 0);
+  CHECK(us()-t < 5000);
+  SimFlash_Stall(1);
+  t = us();
+  CHECK(Flash_Erase(addr) == ERROR);
+  CHECK((us()-t >= 50000) && (us()-t < 80000));
+  CHECK(*word(addr+128) == 0x0000F00F);
+  CHECK(Flash_Erase(addr) == NOERROR);                    // and then works again
+  CHECK(*word(addr+128) == 0xFFFFFFFF);
+  CHECK(Flash_Write(addr+512, 0x11111111) == NOERROR);
+  // protection back on, and the wait states of Clock_Init48MHz()
+  CHECK((FLCTL->BANK0_MAIN_WEPROT == 0xFFFFFFFF) && (FLCTL->BANK1_MAIN_WEPROT == 0xFFFFFFFF));
+  CHECK((FLCTL->BANK0_RDCTL == 0x2000) && (FLCTL->BANK1_RDCTL == 0x2000));
+}
+
+static void split(void){
+  uint32_t w = 0x1234, polls = 0, t;
+  int r;
+  CHECK(Flash_EraseStart(0x1E000) == ERROR);              // Bank 1 only
+  CHECK(Flash_Write(0x31000, 0) == NOERROR);
+  CHECK(Flash_EraseStart(0x31000) == NOERROR);
+  CHECK(Flash_Write(0x32000, 1) == ERROR);                // one operation at a time
+  CHECK(Flash_FastWrite(&w, 0x32000, 1) == 0);
+  CHECK(Flash_Erase(0x32000) == ERROR);
+  CHECK(Flash_EraseStart(0x32000) == ERROR);
+  while((r = Flash_ErasePoll()) == FLASH_BUSY){
+    polls = polls+1;
+    Clock_Delay1us(100);
+  }
+  CHECK(r == NOERROR);
+  CHECK(polls > 10);                                      // it did return while busy
+  CHECK(*word(0x31000) == 0xFFFFFFFF);
+  CHECK(Flash_Write(0x32000, 1) == NOERROR);              // free again
+  SimFlash_Stall(1);
+  CHECK(Flash_EraseStart(0x31000) == NOERROR);
+  t = us();
+  while((r = Flash_ErasePoll()) == FLASH_BUSY){
+    Clock_Delay1us(100);
+  }
+  CHECK(r == ERROR);
+  CHECK((us()-t >= 45000) && (us()-t < 80000));
+  CHECK(Flash_Erase(0x31000) == NOERROR);
+}
+
+int main(void){
+  uint32_t src[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  Clock_Init48MHz();
+  SysTick->LOAD = 48000-1;         // 1 ms
+  SysTick->VAL = 0;
+  SysTick->CTRL = 7;
+  __enable_irq();
+  sector(0x30000, 0);
+  CHECK(Flash_Blackout() == 0);
+  sector(0x1E000, 1);
+  CHECK((Flash_Blackout() > 0) && (Flash_Blackout() <= 50000+2*100+1000+100));
+  CHECK(Flash_FastWrite(src, 0x1FFF0, 8) == 0);           // across the banks
+  CHECK(Flash_FastWrite(src, 0x3FFF0, 8) == 0);           // past the end
+  CHECK(Flash_Erase(0x1E004) == ERROR);                   // not a sector
+  CHECK(Flash_Write(0x40000, 0) == ERROR);
+  split();
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,34 @@
+# FlightLogCut.cmake
+# Runs on the host, Linux x86-64
+# Power-cut test of inc/FlightLog.c, run by ctest:
+#   cmake -DPROGRAM=FlightLogTest -DFLASH=image -DJOURNAL=file -P FlightLogCut.cmake
+# Runs FlightLogTest again and again on one flash image, each time
+# with the power cut at a different flash program or erase, so the
+# next run starts from a torn burst, header or erase. Every run must
+# find all the records flushed before, undamaged and in order. A
+# last run with no cut must finish.
+# October 16, 2026
+
+file(REMOVE ${FLASH} ${JOURNAL})
+set(cuts 0)
+foreach(run RANGE 1 61)
+  if(run EQUAL 61)
+    set(cut 0)
+  else()
+    math(EXPR cut "(${run}*37)%157+1")
+  endif()
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E env MSP432SIM_UART=none MSP432SIM_FLASH=${FLASH}
+            ${PROGRAM} ${JOURNAL} ${cut}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output)
+  if(result EQUAL 2)
+    math(EXPR cuts "${cuts}+1")
+  elseif(NOT result EQUAL 0)
+    message(FATAL_ERROR "run ${run}, cut at ${cut}: ${result}\n${output}")
+  endif()
+endforeach()
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "the run with no cut did not finish: ${result}\n${output}")
+endif()
+message("61 runs, ${cuts} power cuts")
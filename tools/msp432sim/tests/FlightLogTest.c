@@ -0,0 +1,123 @@
+// FlightLogTest.c
+// Runs on the host, Linux x86-64
+// One power cycle of inc/FlightLog.c for the power-cut test that
+// FlightLogCut.cmake runs: start from the flash image that
+// MSP432SIM_FLASH keeps, check what the log holds, then add
+// records with a power cut armed.
+//   FlightLogTest journal cut
+// journal a host file of the records flushed so far, a line
+//         "first next" after each flush that returned NOERROR
+// cut     the flash operation to cut, 0 for none
+// Exits with status 0 when all records are added, 2 when the power
+// is cut and 1 when the log lost or damaged a record.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/FlashProgram.h"
+#include "../../../inc/FlightLog.h"
+
+#define BASE 0x30000
+#define SECTORS 4
+#define ADDS 300
+
+static int Fails;
+static uint32_t Visits, Last;
+static uint8_t Seen[100000];       // by sequence number
+
+// the record with a given sequence number, the same in every run
+static void fill(uint32_t seq, struct TelemetryRecord *r){
+  memset(r, 0, sizeof(*r));
+  r->Time = seq*100;
+  r->Reflectance = seq*7;
+  r->Bumps = seq>>8;
+  r->IR[0] = seq;
+  r->IR[1] = ~seq;
+  r->IR[2] = seq*3;
+  r->Period[0] = seq^0x5555;
+  r->Period[1] = seq+9;
+  r->Steps[0] = -(int32_t)seq;
+  r->Steps[1] = seq*seq;
+  r->Duty[0] = seq;
+  r->Duty[1] = -seq;
+}
+
+static void visit(uint32_t seq, const struct TelemetryRecord *r){
+  struct TelemetryRecord want;
+  fill(seq, &want);
+  if(memcmp(&want, r, sizeof(want)) != 0){
+    printf("FAIL record %u damaged\n", seq);
+    Fails++;
+  }
+  if(Visits && (seq <= Last)){
+    printf("FAIL record %u after %u\n", seq, Last);
+    Fails++;
+  }
+  if(seq < sizeof(Seen)) Seen[seq] = 1;
+  Last = seq;
+  Visits = Visits+1;
+}
+
+int main(int argc, char **argv){
+  struct TelemetryRecord r;
+  uint32_t cut, start, next, oldest, seq, i;
+  FILE *journal;
+  if(argc != 3){
+    printf("usage: FlightLogTest journal cut\n");
+    return 1;
+  }
+  cut = atoi(argv[2]);
+  Clock_Init48MHz();
+  if(FlightLog_Init(BASE, SECTORS) != NOERROR){
+    printf("FAIL FlightLog_Init\n");
+    return 1;
+  }
+  if(FlightLog_Walk(&visit) != Visits){
+    printf("FAIL FlightLog_Walk count\n");
+    Fails++;
+  }
+  // every record flushed before must be there, back to the
+  // SECTORS-2 full sectors the ring keeps behind the head
+  start = FlightLog_Next();
+  oldest = (start > (SECTORS-2)*FLIGHTLOG_RECORDS) ? start-(SECTORS-2)*FLIGHTLOG_RECORDS : 0;
+  journal = fopen(argv[1], "r");
+  while(journal && (fscanf(journal, "%u %u", &seq, &next) == 2)){
+    if(next > start){
+      printf("FAIL next %u before the flushed %u\n", start, next);
+      Fails++;
+    }
+    for(seq = (seq > oldest) ? seq : oldest; (seq < next) && (Fails < 10); seq++){
+      if(Seen[seq] == 0){
+        printf("FAIL flushed record %u lost\n", seq);
+        Fails++;
+      }
+    }
+  }
+  if(journal) fclose(journal);
+  if(Fails){
+    return 1;
+  }
+  SimFlash_Cut(cut);
+  for(i = 0; i < ADDS; i++){
+    fill(FlightLog_Next(), &r);
+    if(FlightLog_Add(&r) != NOERROR){
+      printf("FAIL FlightLog_Add %u\n", FlightLog_Next());
+      return 1;
+    }
+    if((rand()%25 == 0) || (i == ADDS-1)){
+      if(FlightLog_Flush() != NOERROR){
+        printf("FAIL FlightLog_Flush\n");
+        return 1;
+      }
+      journal = fopen(argv[1], "a");      // kept when the power is cut
+      fprintf(journal, "%u %u\n", start, FlightLog_Next());
+      fclose(journal);
+    }
+  }
+  return 0;
+}
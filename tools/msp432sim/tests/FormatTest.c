@@ -0,0 +1,149 @@
+// FormatTest.c
+// Runs on the host, Linux x86-64
+// Checks every conversion in inc/Format.c against snprintf, for
+// 0 to 99999, every 7919th number up to 2^32-1 and the values
+// around powers of ten, the sign change and the ends of the range.
+// Then times Format_UDec() against the recursive OutUDec it
+// replaced, in ns per number on the host; it must not be slower.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../../../inc/Format.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+static void compare(const char *what, uint32_t n, uint32_t arg, const char *got, uint32_t len, const char *want){
+  if((strcmp(got, want) != 0) || (len != strlen(want))){
+    if(Fails < 20){
+      printf("FAIL %s(0x%08X, %u): \"%s\" %u, snprintf \"%s\"\n", what, n, arg, got, len, want);
+    }
+    Fails++;
+  }
+}
+
+// a fixed-width field that does not fit is all '*'
+static void stars(char *want, uint32_t width){
+  if(strlen(want) > width){
+    memset(want, '*', width);
+    want[width] = 0;
+  }
+}
+
+static void check(uint32_t n){
+  char got[FORMAT_MAXLEN+4], want[32];
+  uint32_t len, w, d, p;
+  len = Format_UDec(got, n);
+  snprintf(want, sizeof(want), "%u", n);
+  compare("Format_UDec", n, 0, got, len, want);
+  len = Format_SDec(got, (int32_t)n);
+  snprintf(want, sizeof(want), "%d", (int32_t)n);
+  compare("Format_SDec", n, 0, got, len, want);
+  len = Format_UHex(got, n);
+  snprintf(want, sizeof(want), "%X", n);
+  compare("Format_UHex", n, 0, got, len, want);
+  for(w = 1; w < FORMAT_MAXLEN; w++){
+    len = Format_UDecWidth(got, n, w);
+    snprintf(want, sizeof(want), "%*u", (int)w, n);
+    stars(want, w);
+    compare("Format_UDecWidth", n, w, got, len, want);
+    len = Format_SDecWidth(got, (int32_t)n, w);
+    snprintf(want, sizeof(want), "%*d", (int)w, (int32_t)n);
+    stars(want, w);
+    compare("Format_SDecWidth", n, w, got, len, want);
+  }
+  for(w = 1; w <= 8; w++){
+    len = Format_UHexWidth(got, n, w);
+    snprintf(want, sizeof(want), "%0*X", (int)w, (w == 8) ? n : n&((1u<<(4*w))-1));
+    compare("Format_UHexWidth", n, w, got, len, want);
+  }
+  for(d = 1, p = 10; d <= 9; d++, p = p*10){
+    len = Format_UFix(got, n, d);
+    snprintf(want, sizeof(want), "%u.%0*u", n/p, (int)d, n%p);
+    compare("Format_UFix", n, d, got, len, want);
+  }
+}
+
+// the old UART0_OutUDec, with the characters going to a buffer
+static char Old[FORMAT_MAXLEN];
+static uint32_t OldI;
+static void __attribute__((noinline)) oldOutUDec(uint32_t n){
+  if(n >= 10){
+    oldOutUDec(n/10);
+    n = n%10;
+  }
+  Old[OldI++] = n+'0';
+}
+static uint32_t oldUDec(char *s, uint32_t n){
+  OldI = 0;
+  oldOutUDec(n);
+  Old[OldI] = 0;
+  memcpy(s, Old, OldI+1);
+  return OldI;
+}
+
+static double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+// ns per number converted by f, the best of 5 tries
+#define NUMBERS 1000000
+static volatile uint32_t Sink;
+static double bench(uint32_t (*f)(char *, uint32_t), uint32_t first, uint32_t step){
+  char s[FORMAT_MAXLEN];
+  double best = 1e9, t;
+  uint32_t i, n, k;
+  for(k = 0; k < 5; k++){
+    t = seconds();
+    for(i = 0, n = first; i < NUMBERS; i++, n += step){
+      Sink = f(s, n)+s[0];
+    }
+    t = (seconds()-t)*1e9/NUMBERS;
+    if(t < best) best = t;
+  }
+  return best;
+}
+
+int main(void){
+  char s[FORMAT_MAXLEN], t[FORMAT_MAXLEN];
+  double old, now;
+  uint64_t n;
+  uint32_t p;
+  for(n = 0; n < 100000; n++){
+    check((uint32_t)n);
+  }
+  for(n = 100000; n <= 0xFFFFFFFF; n = n+7919){
+    check((uint32_t)n);
+  }
+  for(p = 10; p <= 1000000000; p = p*10){
+    check(p-1);
+    check(p);
+    check(-(int32_t)p);
+    check(-(int32_t)p+1);
+  }
+  check(0x7FFFFFFF);
+  check(0x80000000);                   // INT32_MIN
+  check(0x80000001);
+  check(0xFFFFFFFF);
+
+  // 10 digits, and up to 5 as Lab 5 prints them
+  for(n = 0; n <= 0xFFFFFFFF; n = n+65537){
+    p = oldUDec(s, (uint32_t)n);
+    CHECK((p == Format_UDec(t, (uint32_t)n)) && (strcmp(s, t) == 0));
+  }
+  old = bench(&oldUDec, 1000000000, 3);
+  now = bench(&Format_UDec, 1000000000, 3);
+  printf("10 digits: recursive %.1f ns, Format_UDec %.1f ns\n", old, now);
+  CHECK(now <= old);
+  old = bench(&oldUDec, 0, 1);
+  now = bench(&Format_UDec, 0, 1);
+  printf("0 to 999999: recursive %.1f ns, Format_UDec %.1f ns\n", old, now);
+  CHECK(now <= old);
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
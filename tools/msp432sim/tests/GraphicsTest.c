@@ -0,0 +1,245 @@
+// GraphicsTest.c
+// Runs on the host, Linux x86-64
+// Checks inc/Graphics.c against a pixel-by-pixel model: 3000
+// random fills, lines, scrolls, sprites and characters in every
+// mode, many partly or wholly off the screen. Then a status page
+// is drawn and compared with the golden image below, and the
+// simulated display must match Screen after each flush.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/Nokia5110.h"
+#include "../../../inc/Graphics.h"
+#include "../../../inc/Format.h"
+
+static int Fails;
+static uint8_t Ref[48][84];        // the model, one byte per pixel
+
+static int pixel(int32_t y, int32_t x){
+  return (Screen[84*(y/8)+x]>>(y%8))&1;
+}
+
+// apply one drawn pixel v to the model in a mode; shapes draw 1s
+static void model(int32_t y, int32_t x, int v, uint32_t mode){
+  if((x < 0) || (x >= 84) || (y < 0) || (y >= 48)) return;
+  if(mode == GRAPHICS_CLEAR){
+    if(v) Ref[y][x] = 0;
+  }else if(mode == GRAPHICS_SET){
+    if(v) Ref[y][x] = 1;
+  }else if(mode == GRAPHICS_INVERT){
+    if(v) Ref[y][x] ^= 1;
+  }else{
+    Ref[y][x] = v;
+  }
+}
+
+static void box(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t mode){
+  int32_t a, b;
+  for(a = y; a < y+h; a++){
+    for(b = x; b < x+w; b++){
+      model(a, b, 1, mode);
+    }
+  }
+}
+
+static int differ(void){
+  int32_t y, x, n = 0;
+  for(y = 0; y < 48; y++){
+    for(x = 0; x < 84; x++){
+      n += pixel(y, x) != Ref[y][x];
+    }
+  }
+  return n;
+}
+
+static void flushed(const char *what){
+  uint8_t image[504];
+  Nokia5110_DisplayBuffer();
+  while(Nokia5110_DisplayBusy()){}
+  Clock_Delay1ms(1);
+  Sim_Display(image);
+  if(memcmp(image, Screen, 504) != 0){
+    printf("FAIL %s: display differs from Screen\n", what);
+    Fails++;
+  }
+}
+
+static void shapes(void){
+  static uint8_t bits[6*40], old[48][84];
+  struct Sprite s;
+  int32_t i, a, b;
+  for(i = 0; i < 504; i++) Screen[i] = rand();
+  Nokia5110_DrawFullImage(Screen);
+  for(a = 0; a < 48; a++){
+    for(b = 0; b < 84; b++) Ref[a][b] = pixel(a, b);
+  }
+  for(i = 0; i < 3000; i++){
+    int32_t kind = rand()%6, x = rand()%100-8, y = rand()%64-8;
+    int32_t w = rand()%90, h = rand()%56;
+    uint32_t mode = rand()%4, shape = (mode == GRAPHICS_COPY) ? GRAPHICS_SET : mode;
+    if(kind == 0){
+      Graphics_FillRect(x, y, w, h, mode);
+      box(x, y, w, h, shape);
+    }else if(kind == 1){
+      Graphics_HLine(x, y, w, mode);
+      box(x, y, w, 1, shape);
+      Graphics_VLine(x, y, h, mode);
+      box(x, y, 1, h, shape);
+    }else if(kind == 2){
+      Graphics_Rect(x, y, w, h, mode);
+      if((w > 0) && (h > 0)){    // each pixel of the outline once
+        box(x, y, w, 1, shape);
+        if(h > 1) box(x, y+h-1, w, 1, shape);
+        box(x, y+1, 1, h-2, shape);
+        if(w > 1) box(x+w-1, y+1, 1, h-2, shape);
+      }
+    }else if(kind == 3){
+      int32_t dx = rand()%21-10, dy = (rand()&1) ? 0 : rand()%21-10;
+      memcpy(old, Ref, sizeof(old));
+      Graphics_Scroll(x, y, w, h, dx, dy);
+      for(a = y; a < y+h; a++){
+        for(b = x; b < x+w; b++){
+          int32_t sa = a-dy, sb = b-dx;
+          if((a < 0) || (a >= 48) || (b < 0) || (b >= 84)) continue;
+          Ref[a][b] = ((sa >= y) && (sa < y+h) && (sb >= x) && (sb < x+w) &&
+                       (sa >= 0) && (sa < 48) && (sb >= 0) && (sb < 84)) ? old[sa][sb] : 0;
+        }
+      }
+    }else if(kind == 4){
+      s.Width = rand()%40+1;
+      s.Height = rand()%47+1;
+      s.Bits = bits;
+      for(a = 0; a < 6*40; a++) bits[a] = rand();
+      Graphics_Sprite(x, y, &s, mode);
+      for(a = 0; a < s.Height; a++){
+        for(b = 0; b < s.Width; b++){
+          model(y+a, x+b, (bits[s.Width*(a/8)+b]>>(a%8))&1, mode);
+        }
+      }
+    }else{
+      char c = ' '+rand()%96;
+      const uint8_t *g = Nokia5110_Glyph(c);
+      if(Graphics_Char(x, y, c, mode) != x+GRAPHICS_CHARW){
+        printf("FAIL Graphics_Char return\n");
+        Fails++;
+      }
+      for(a = 0; a < 8; a++){
+        for(b = 0; b < GRAPHICS_CHARW; b++){
+          model(y+a, x+b, (b < 5) ? (g[b]>>a)&1 : 0, mode);
+        }
+      }
+    }
+    if(differ()){
+      printf("FAIL operation %d, kind %d at %d,%d size %d,%d mode %u: %d pixels differ\n",
+             i, kind, x, y, w, h, mode, differ());
+      Fails++;
+      return;
+    }
+    if(i%50 == 0) flushed("random");
+  }
+  flushed("random");
+}
+
+// the status page, # on and . off
+static const char *const Golden[48] = {
+  "####################################################################################",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..####...####.#.....#...#..............#...........#..............................#",
+  "#..#...#.#.....#.....#..#...............#...........#..............................#",
+  "#..#...#.#.....#.....#.#..........###..###....###..###...#...#..###................#",
+  "#..####...###..#.....##..........#......#........#..#....#...#.#...................#",
+  "#..#.#.......#.#.....#.#..........###...#.....####..#....#...#..###................#",
+  "#..#..#......#.#.....#..#............#..#..#.#...#..#..#.#..##.....#...............#",
+  "#..#...#.####..#####.#...#.......####....##...####...##...##.#.####................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "####################################################################################",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..#...................#....###..#####.............................................#",
+  "#..#..................##...#...#....#..............................................#",
+  "#..#...................#.......#...#.........##.#......##.#........................#",
+  "#..#...................#......#.....#........#.#.#.....#.#.#.......................#",
+  "#..#...................#.....#.......#.......#.#.#.....#.#.#.......................#",
+  "#..#...................#....#....#...#.......#...#.....#...#.......................#",
+  "#..#####..............###..#####..###........#...#.....#...#.......................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..####.......................#..#####.............................................#",
+  "#..#...#.....................##..#.................................................#",
+  "#..#...#....................#.#..####........##.#......##.#........................#",
+  "#..####....................#..#......#.......#.#.#.....#.#.#.......................#",
+  "#..#.#.....................#####.....#.......#.#.#.....#.#.#.......................#",
+  "#..#..#.......................#..#...#.......#...#.....#...#.......................#",
+  "#..#...#......................#...###........#...#.....#...#.......................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..########################################........................................#",
+  "#..###...###...############################........................................#",
+  "#..##.###.#.###.###########################........................................#",
+  "#..##.#####.###.###########################........................................#",
+  "#..##.#...#.###.###########################........................................#",
+  "#..##.###.#.###.###########################........................................#",
+  "#..##.###.#.###.###########################........................................#",
+  "#..###....##...############################........................................#",
+  "#..########################################........................................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "#..................................................................................#",
+  "####################################################################################"
+};
+
+static void golden(void){
+  int32_t y, x, n = 0;
+  Nokia5110_ClearBuffer();
+  Graphics_Rect(0, 0, 84, 48, GRAPHICS_SET);
+  Graphics_String(3, 3, "RSLK status", GRAPHICS_SET);
+  Graphics_HLine(1, 12, 82, GRAPHICS_SET);
+  Graphics_SetCursor(3, 15, GRAPHICS_COPY);
+  Graphics_OutString("L ");
+  Format_OutUDecWidth(&Graphics_OutString, 123, 4);
+  Graphics_OutString(" mm");
+  Graphics_SetCursor(3, 24, GRAPHICS_COPY);
+  Graphics_OutString("R ");
+  Format_OutUDecWidth(&Graphics_OutString, 45, 4);
+  Graphics_OutString(" mm");
+  Graphics_FillRect(3, 35, 40, 9, GRAPHICS_SET);
+  Graphics_String(5, 36, "GO", GRAPHICS_INVERT);
+  Graphics_Scroll(50, 15, 30, 17, 4, 0);   // nothing there, stays blank
+  for(y = 0; y < 48; y++){
+    for(x = 0; x < 84; x++){
+      n += pixel(y, x) != (Golden[y][x] == '#');
+    }
+  }
+  if(n){
+    printf("FAIL status page: %d pixels differ from the golden image, drawn:\n", n);
+    for(y = 0; y < 48; y++){
+      printf("  \"");
+      for(x = 0; x < 84; x++) putchar(pixel(y, x) ? '#' : '.');
+      printf("\",\n");
+    }
+    Fails++;
+  }
+  flushed("status page");
+}
+
+int main(void){
+  Clock_Init48MHz();
+  Nokia5110_Init();
+  EnableInterrupts();
+  srand(1);
+  shapes();
+  golden();
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,82 @@
+// IRDistanceTest.c
+// Runs on the host, Linux x86-64
+// Checks the IR distance tables of inc/IRDistance.c against the
+// Lab 4 curve fits they replaced, 100000/(n-2630), 836100/(n-1558)
+// and 100000/(n-2390), over every 14-bit input and past it: in
+// range, never rising with n, IR_MAXDIST at and below each
+// offset where the fits divide by zero or wrap, and within
+// 2% + 1 mm of the fit from 100 to 800 mm. Then fits a table
+// with IRDistance_Calibrate() as Lab 5 does.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../../../inc/IRDistance.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+static const struct{
+  const char *name;
+  int32_t a, b;                    // distance a/(n-b)
+  int32_t (*convert)(int32_t n);
+} Fit[3] = {
+  {"left",   100000, 2630, &LeftConvert},
+  {"center", 836100, 1558, &CenterConvert},
+  {"right",  100000, 2390, &RightConvert},
+};
+
+int main(void){
+  static const uint32_t mm[8] = {100, 150, 200, 250, 300, 400, 500, 700};
+  uint32_t adc[8];
+  int32_t n, d, last, want, err, worst;
+  uint32_t s, i, bad;
+  for(s = 0; s < 3; s++){
+    last = IR_MAXDIST;
+    worst = 0;
+    bad = 0;
+    for(n = 0; n < 20000; n++){
+      d = IRDistance_Convert(s, n);
+      if((d < 0) || (d > IR_MAXDIST) || (d > last)) bad++;
+      if((n <= Fit[s].b) && (d != IR_MAXDIST)) bad++;
+      if((n <= 16383) && (Fit[s].convert(n) != d)) bad++;
+      if((n > Fit[s].b) && (n <= 16383)){
+        want = Fit[s].a/(n-Fit[s].b);
+        if((want >= 100) && (want <= IR_MAXDIST)){
+          err = (d > want) ? d-want : want-d;
+          if(err*100 > 2*want+100){
+            if(bad < 10) printf("FAIL %s n=%d: %d mm, the fit says %d\n", Fit[s].name, n, d, want);
+            bad++;
+          }
+          if(err > worst) worst = err;
+        }
+      }
+      last = d;
+    }
+    printf("%s: worst %d mm from the fit in 100 to 800 mm\n", Fit[s].name, worst);
+    CHECK(bad == 0);
+    CHECK(Fit[s].convert(-100) == IR_MAXDIST);
+  }
+
+  // calibration from eight walls, on the center fit
+  for(i = 0; i < 8; i++) adc[i] = Fit[1].b+Fit[1].a/mm[i];
+  CHECK(IRDistance_Calibrate(IR_CENTER, adc, mm, 8) == 1);
+  for(i = 0; i < 8; i++){
+    d = IRDistance_Convert(IR_CENTER, adc[i]);
+    CHECK((d >= (int32_t)mm[i]-(int32_t)mm[i]/50-2) && (d <= (int32_t)mm[i]+(int32_t)mm[i]/50+2));
+  }
+  CHECK(IRDistance_Convert(IR_CENTER, 0) == 700);      // past the farthest wall
+  CHECK(IRDistance_Convert(IR_CENTER, 16383) == 100);  // past the nearest
+  last = IR_MAXDIST;
+  for(n = 0; n <= 16383; n++){
+    d = IRDistance_Convert(IR_CENTER, n);
+    CHECK(d <= last);
+    last = d;
+  }
+  CHECK(IRDistance_Calibrate(IR_CENTER, adc, mm, 1) == 0);
+  CHECK(IRDistance_Calibrate(IR_CENTER, adc, mm, IR_MAXPOINTS+1) == 0);
+  CHECK(IRDistance_Calibrate(3, adc, mm, 8) == 0);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
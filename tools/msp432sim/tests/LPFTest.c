@@ -0,0 +1,113 @@
+// LPFTest.c
+// Runs on the host, Linux x86-64
+// Checks inc/LPF.c bit for bit against the LPF.c it replaced, a
+// copy of which is below: a filter object of every size 1 to 1024
+// on random 14-bit data, and the three fixed filters, which take
+// 1 to LPF_FIXEDSIZE and refuse the rest. Then times both at
+// size 256 in ns per sample on the host.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../../inc/LPF.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+// the old LPF_Init/LPF_Calc, 32-bit MACQ and a divide
+static uint32_t Size, X[1024], I1, LPFSum;
+static void oldInit(uint32_t initial, uint32_t size){ uint32_t i;
+  if(size>1024) size=1024;
+  Size = size;
+  I1 = Size-1;
+  LPFSum = Size*initial;
+  for(i=0; i<Size; i++){
+    X[i] = initial;
+  }
+}
+static uint32_t oldCalc(uint32_t newdata){
+  LPFSum = LPFSum+newdata-X[I1];
+  X[I1] = newdata;
+  if(I1 == 0){
+    I1 = Size-1;
+  } else{
+    I1--;
+  }
+  return LPFSum/Size;
+}
+
+static double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+#define SAMPLES 1000000
+static uint16_t Data[SAMPLES];
+static volatile uint32_t Sink;
+
+int main(void){
+  static uint16_t buf[LPF_MAXSIZE];
+  struct LPF f;
+  uint32_t size, initial, i, n, bad;
+  double t, old, obj;
+  srand(1);
+  for(i = 0; i < SAMPLES; i++) Data[i] = rand()&0x3FFF;
+
+  // every size, the filter object against the old filter
+  for(size = 1; size <= 1024; size++){
+    initial = Data[size];
+    oldInit(initial, size);
+    LPF_Create(&f, buf, size, initial);
+    CHECK((f.Shift == LPF_NOSHIFT) == ((size&(size-1)) != 0));
+    n = 3*size+100;
+    bad = 0;
+    for(i = 0; i < n; i++){
+      bad += (LPF_Filter(&f, Data[(size*7+i)%SAMPLES]) != oldCalc(Data[(size*7+i)%SAMPLES]));
+    }
+    if(bad){
+      printf("FAIL size %u: %u of %u outputs differ\n", size, bad, n);
+      Fails++;
+    }
+  }
+
+  // the fixed filters take 1 to LPF_FIXEDSIZE and refuse the rest
+  CHECK(LPF_Calc(1234) == 1234);            // passes through before Init
+  for(size = 1; size <= LPF_FIXEDSIZE; size++){
+    CHECK(LPF_Init(100, size) && LPF_Init2(100, size) && LPF_Init3(100, size));
+    oldInit(100, size);
+    bad = 0;
+    for(i = 0; i < 2*size+10; i++){
+      uint32_t y = oldCalc(Data[i]);
+      bad += (LPF_Calc(Data[i]) != y) + (LPF_Calc2(Data[i]) != y) + (LPF_Calc3(Data[i]) != y);
+    }
+    if(bad){
+      printf("FAIL fixed size %u: %u outputs differ\n", size, bad);
+      Fails++;
+    }
+  }
+  CHECK(LPF_Init(100, 4) == 1);
+  CHECK(LPF_Init(5000, 0) == 0);
+  CHECK(LPF_Init(5000, LPF_FIXEDSIZE+1) == 0);
+  CHECK(LPF_Init2(5000, 512) == 0);
+  CHECK(LPF_Init3(5000, 1024) == 0);
+  CHECK(LPF_Calc(100) == 100);              // still the depth 4 filter of 100s
+  CHECK(LPF_Calc(500) == 200);
+
+  // ns per sample at size 256
+  oldInit(0, 256);
+  t = seconds();
+  for(i = 0; i < SAMPLES; i++) Sink = oldCalc(Data[i]);
+  old = (seconds()-t)*1e9/SAMPLES;
+  LPF_Create(&f, buf, 256, 0);
+  t = seconds();
+  for(i = 0; i < SAMPLES; i++) Sink = LPF_Filter(&f, Data[i]);
+  obj = (seconds()-t)*1e9/SAMPLES;
+  printf("size 256: old LPF_Calc %.2f ns, LPF_Filter %.2f ns per sample; "
+         "RAM per channel %u bytes, was %u\n", old, obj, 256*2, 1024*4);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
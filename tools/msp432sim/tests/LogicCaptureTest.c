@@ -0,0 +1,169 @@
+// LogicCaptureTest.c
+// Runs on the host, Linux x86-64
+// Round trip of inc/LogicCapture.c through tools/logic/logic2vcd:
+// a model drives square waves on P4.0-P4.3 while LogicCapture
+// samples them at 10 kHz and sends its blocks out of the
+// simulator's EUSCI_A0, with text in between; logic2vcd turns the
+// bytes into VCD, which must show every edge and the level between
+// edges. Then a long UART0_Write holds the line until every block
+// buffer is full, and the x span in the VCD must be the samples
+// LogicCapture_Dropped() counts.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/UART0.h"
+#include "../../../inc/LogicCapture.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define FREQ 10000                 // samples per second
+#define SAMPLENS (1000000000/FREQ)
+#define PINS 4
+#define MAXEDGES 4000
+
+// P4.k is a square wave of half period Half[k] us from Start
+static const uint32_t Half[PINS] = {1300, 2100, 3700, 7900};
+static struct{ uint64_t t; uint8_t level; } Edge[PINS][MAXEDGES];
+static uint32_t Edges[PINS];
+static uint64_t Start;             // ns when the waves start, 0 before
+static uint8_t Level[PINS];
+static void waves(void){
+  uint64_t now = Sim_Time();
+  uint32_t k;
+  uint8_t level;
+  if(Start == 0) return;
+  for(k = 0; k < PINS; k++){
+    level = ((now-Start)/(Half[k]*1000ull))&1;
+    if(level != Level[k]){
+      Level[k] = level;
+      Sim_SetPin(4, k, level);
+      if(Edges[k] < MAXEDGES){
+        Edge[k][Edges[k]].t = now;
+        Edge[k][Edges[k]].level = level;
+        Edges[k]++;
+      }
+    }
+  }
+}
+
+static uint8_t Wire[1<<20];        // what EUSCI_A0 sent
+static uint32_t WireN;
+static void watch(uint8_t data){
+  if(WireN < sizeof(Wire)) Wire[WireN++] = data;
+}
+
+// the VCD, one list of changes per channel
+static struct{ uint64_t t; char v; } Change[PINS][MAXEDGES];
+static uint32_t Changes[PINS];
+static unsigned long long Lost;
+static void convert(void){
+  FILE *f = fopen("LogicCaptureTest.bin", "wb");
+  char line[256], name[16];
+  char id;
+  int bit;
+  unsigned long long t = 0;
+  int map[128];
+  fwrite(Wire, 1, WireN, f);
+  fclose(f);
+  memset(map, -1, sizeof(map));
+  f = popen(LOGIC2VCD " -0 P4 LogicCaptureTest.bin 2>LogicCaptureTest.txt", "r");
+  while(fgets(line, sizeof(line), f)){
+    if(sscanf(line, "$var wire 1 %c %15s $end", &id, name) == 2){
+      if(sscanf(name, "P4.%d", &bit) == 1) map[(int)id] = bit;
+    }else if(line[0] == '#'){
+      t = strtoull(&line[1], 0, 10);
+    }else if(((line[0] == '0') || (line[0] == '1') || (line[0] == 'x')) && (map[(int)line[1]] >= 0)){
+      bit = map[(int)line[1]];
+      if(Changes[bit] < MAXEDGES){
+        Change[bit][Changes[bit]].t = t;
+        Change[bit][Changes[bit]].v = line[0];
+        Changes[bit]++;
+      }
+    }
+  }
+  CHECK(pclose(f) == 0);
+  f = fopen("LogicCaptureTest.txt", "r");
+  CHECK(f && fgets(line, sizeof(line), f) && (sscanf(line, "blocks %*u, bad CRC %*u, missing blocks %*u, samples %*u, lost samples %llu", &Lost) == 1));
+  if(f) fclose(f);
+}
+
+// the VCD level of channel k at t ns from the start of the capture
+static char level(uint32_t k, uint64_t t){
+  char v = '?';
+  uint32_t i;
+  for(i = 0; (i < Changes[k]) && (Change[k][i].t <= t); i++) v = Change[k][i].v;
+  return v;
+}
+
+int main(void){
+  static char hold[3000];
+  uint64_t t0, t, a, b, x0 = 0, x1 = 0;
+  uint32_t k, i, n, bad, dropped;
+  Clock_Init48MHz();
+  Sim_Watch(&watch);
+  UART0_Init();
+  Sim_SetSpeed(0.2);
+  Sim_Every(20, &waves);
+  EnableInterrupts();
+
+  // 0.3 s of clean capture, with text between the blocks
+  t0 = Sim_Time();
+  LogicCapture_Init(&P4->IN, 0x0F, 0, 0, FREQ, 2);
+  Start = Sim_Time();
+  while(Sim_Time()-Start < 150000000){}
+  UART0_OutString("text the converter skips\r\n");
+  while(Sim_Time()-Start < 300000000){}
+  CHECK(LogicCapture_Dropped() == 0);
+
+  // the line held for 260 ms: the four blocks fill, then samples drop
+  memset(hold, 'z', sizeof(hold));
+  t = Sim_Time();
+  CHECK(UART0_Write(hold, sizeof(hold)));
+  while(Sim_Time()-t < 400000000){}
+  Start = 0;                       // no edges the capture cannot see
+  LogicCapture_Stop();
+  dropped = LogicCapture_Dropped();
+  convert();
+  printf("%u bytes, %u samples dropped, logic2vcd lost %llu\n", WireN, dropped, Lost);
+  CHECK(dropped > 1000);
+  CHECK(Lost == dropped);
+
+  // the x spans, the same on every channel, add up to the drops
+  for(i = 0; i < Changes[0]; i++){
+    if(Change[0][i].v == 'x'){
+      CHECK(x0 == 0);              // one span
+      x0 = Change[0][i].t;
+      x1 = (i+1 < Changes[0]) ? Change[0][i+1].t : x0;
+    }
+  }
+  CHECK((x1-x0)/SAMPLENS == dropped);
+
+  // between edges, away from the x span, the VCD has the model's level
+  for(k = 0; k < PINS; k++){
+    bad = n = 0;
+    for(i = 0; i+1 < Edges[k]; i++){
+      a = Edge[k][i].t-t0;
+      b = Edge[k][i+1].t-t0;
+      t = (a+b)/2;
+      if((b+3*SAMPLENS > x0) && (a < x1+3*SAMPLENS)) continue;
+      n++;
+      bad += (level(k, t) != '0'+Edge[k][i].level);
+      // and the edge within a sample and the model's 20 us of the truth
+      if(level(k, a+SAMPLENS+30000) != '0'+Edge[k][i].level) bad++;
+    }
+    printf("P4.%u: %u edges, %u checked, %u wrong\n", k, Edges[k], n, bad);
+    CHECK(n > 30);
+    CHECK(bad == 0);
+  }
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
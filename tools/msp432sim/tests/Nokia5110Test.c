@@ -0,0 +1,84 @@
+// Nokia5110Test.c
+// Runs on the host, Linux x86-64
+// Checks the DMA flush of inc/Nokia5110.c against the simulated
+// PCD8544: after each kind of drawing the display RAM must equal
+// Screen, a one-pixel change must send one data byte and a repeat
+// refresh none, also with refreshes requested during a flush.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/Nokia5110.h"
+
+static int Fails;
+static uint32_t Sent;              // data bytes the display has received
+
+// wait out the flush, compare the display with Screen and return
+// the data bytes sent since the last call, or -1 for none expected
+static void check(const char *what, int32_t bytes){
+  uint8_t image[504];
+  uint32_t total, sent;
+  while(Nokia5110_DisplayBusy()){}
+  Clock_Delay1ms(1);               // the last byte leaves the SPI
+  total = Sim_Display(image);
+  sent = total-Sent;
+  Sent = total;
+  if(memcmp(image, Screen, 504) != 0){
+    printf("FAIL %s: display differs from Screen\n", what);
+    Fails++;
+  }else if((bytes >= 0) && (sent != (uint32_t)bytes)){
+    printf("FAIL %s: %u data bytes sent, expected %d\n", what, sent, bytes);
+    Fails++;
+  }
+}
+
+int main(void){
+  static uint8_t image[504];
+  int i;
+  Clock_Init48MHz();
+  Nokia5110_Init();
+  EnableInterrupts();
+  Nokia5110_DisplayBuffer();       // the RAM is unknown after reset
+  check("init", 504);
+  Nokia5110_Clear();
+  check("clear", -1);
+  Nokia5110_OutString("Hello RSLK");
+  check("text", -1);
+  Nokia5110_SetCursor(3, 4);
+  Nokia5110_OutUDec(12345);
+  check("number", -1);
+  Nokia5110_ClearBuffer();
+  for(i = 0; i < 48; i = i+1){
+    Nokia5110_SetPxl(i, i);
+    Nokia5110_SetPxl(i, 83-i);
+  }
+  Nokia5110_DisplayBuffer();
+  check("pixels", -1);
+  Nokia5110_ClrPxl(10, 10);
+  Nokia5110_DisplayBuffer();
+  check("one pixel", 1);
+  Nokia5110_DisplayBuffer();
+  check("no change", 0);
+  for(i = 0; i < 504; i = i+1){
+    image[i] = i*13+1;
+  }
+  Nokia5110_DrawFullImage(image);
+  check("full image", -1);
+  Nokia5110_DrawFullImage(image);
+  check("same image", -1);
+  for(i = 0; i < 200; i = i+1){    // refresh again before the last one is done
+    Nokia5110_SetPxl(i%48, (i*5)%84);
+    Nokia5110_ClrPxl((i+7)%48, (i*3)%84);
+    Nokia5110_SetCursor(0, 5);
+    Nokia5110_OutUDec(i);
+    Nokia5110_DisplayBuffer();
+  }
+  check("back to back", -1);
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
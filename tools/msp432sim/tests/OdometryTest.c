@@ -0,0 +1,195 @@
+// OdometryTest.c
+// Runs on the host, Linux x86-64
+// Replays synthetic tachometer step counts through inc/Odometry.c
+// with the Lab5 geometry, 150 mm wheelbase, 220 mm wheels and 360
+// steps per turn, and checks the pose against the exact path:
+// straight forward and back, arcs both ways, spins in place and a
+// square. Each motion drives the wheels at constant speeds, the
+// counts are the whole steps each wheel has covered, and
+// Odometry_Update() gets them every 10 ms as the Lab5 control task
+// would. Also checks the sine table, the covariance growth, and
+// that Odometry_Get() never returns a torn pose while the
+// simulator's timer updates it.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Sim.h"
+#include "../../../inc/Odometry.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define WHEELBASE 150              // mm
+#define CIRCUMFERENCE 220          // mm
+#define STEPS 360                  // per wheel turn
+#define STEP ((double)CIRCUMFERENCE/STEPS)
+#define DT 0.01                    // s between updates
+#define PI 3.14159265358979
+
+static double SL, SR;              // wheel travel, mm
+static double Tx, Ty, Tt;          // exact pose, mm and radians
+static double PosErr, HeadErr;     // of the last compare(), mm and degrees
+
+static int32_t steps(double s){
+  return (int32_t)floor(s/STEP+1e-9);
+}
+
+static void start(void){
+  SL = SR = 0;
+  Tx = Ty = Tt = 0;
+  Odometry_Init(WHEELBASE, CIRCUMFERENCE, STEPS, steps(SL), steps(SR));
+}
+
+// both wheels at constant speeds in mm/s for a time, the exact pose
+// moving along the arc they make
+static void drive(double vl, double vr, double time){
+  uint32_t i, n = (uint32_t)(time/DT+0.5);
+  double v = (vl+vr)/2, w = (vr-vl)/WHEELBASE, t;
+  double sl = SL, sr = SR;
+  for(i = 1; i <= n; i++){
+    SL = sl+vl*DT*i;
+    SR = sr+vr*DT*i;
+    Odometry_Update(steps(SL), steps(SR));
+  }
+  time = n*DT;
+  if(fabs(w) < 1e-12){
+    Tx += v*time*cos(Tt);
+    Ty += v*time*sin(Tt);
+  }else{
+    t = Tt+w*time;
+    Tx += v/w*(sin(t)-sin(Tt));
+    Ty -= v/w*(cos(t)-cos(Tt));
+    Tt = t;
+  }
+}
+
+// the error of the estimate against the exact pose
+static void compare(const char *name){
+  struct Pose p;
+  double d;
+  Odometry_Get(&p);
+  PosErr = hypot(p.X/65536.0-Tx, p.Y/65536.0-Ty);
+  d = p.Theta*(2*PI/4294967296.0)-Tt;
+  d = remainder(d, 2*PI);
+  HeadErr = fabs(d)*180/PI;
+  printf("%-24s x %8.2f y %8.2f heading %7.2f deg, error %5.2f mm %5.3f deg\n",
+    name, p.X/65536.0, p.Y/65536.0, (int32_t)p.Theta*(180/2147483648.0), PosErr, HeadErr);
+}
+
+// an arc of radius r mm to the left, negative to the right, of
+// the given angle at 200 mm/s
+static void arc(double r, double degrees){
+  double w = 200/fabs(r);          // rad/s
+  double s = (r > 0) ? 1 : -1;
+  drive(w*(fabs(r)-s*WHEELBASE/2.0), w*(fabs(r)+s*WHEELBASE/2.0), degrees*PI/180/w);
+}
+
+// in place, positive to the left, each wheel at 100 mm/s
+static void spin(double degrees){
+  double s = (degrees > 0) ? 1 : -1;
+  drive(-100*s, 100*s, fabs(degrees)*PI/180*WHEELBASE/2/100);
+}
+
+// every Sim_Every() call is one more step of each wheel, straight along X
+static volatile int32_t Count;
+static void tick(void){
+  Count = Count+1;
+  Odometry_Update(Count, Count);
+}
+
+int main(void){
+  struct Pose p, half;
+  uint32_t i, n, seen, torn, last;
+  int32_t worst = 0, e;
+  double var;
+
+  // the table against the library, every 2^20th angle
+  for(i = 0; i < 4096; i++){
+    e = Odometry_Sin(i<<20)-(int32_t)lround(65536*sin(i*(2*PI/4096)));
+    if(abs(e) > worst) worst = abs(e);
+    e = Odometry_Cos((i<<20)+12345)-(int32_t)lround(65536*cos(((i<<20)+12345)*(2*PI/4294967296.0)));
+    if(abs(e) > worst) worst = abs(e);
+  }
+  CHECK(worst <= 2);
+  CHECK((Odometry_Sin(0x40000000) == 65536) && (Odometry_Sin(0xC0000000) == -65536));
+
+  // straight: within a step, heading untouched
+  start();
+  drive(250, 250, 2);
+  compare("straight 500 mm");
+  Odometry_Get(&half);
+  drive(250, 250, 2);
+  compare("straight 1000 mm");
+  CHECK((PosErr < STEP) && (HeadErr == 0));
+  Odometry_Get(&p);
+  CHECK(p.Updates == 400);
+  // each step adds 0.01 mm^2 to its wheel: X by a quarter of both
+  // wheels' variance, the heading by their sum over the wheelbase
+  // squared, and Y through the heading, the cube of the distance
+  var = 2.0*steps(1000)*ODOMETRY_STEPVAR/4294967296.0;
+  CHECK(fabs(p.Pxx/65536.0-var/4) < 0.01*var/4);
+  CHECK(fabs(p.Ptt/65536.0-var/(WHEELBASE*WHEELBASE)) < 0.02*var/(WHEELBASE*WHEELBASE));
+  CHECK((p.Pyy > 6*half.Pyy) && (p.Pyy < 9*half.Pyy) && (half.Pyy > 0));
+  drive(-250, -250, 4);
+  compare("and back");
+  CHECK((PosErr < STEP) && (HeadErr == 0));
+  Odometry_Get(&half);
+  CHECK(half.Pxx > p.Pxx);         // backing up adds to the uncertainty
+
+  // arcs: a quarter circle each way, then a whole circle
+  start();
+  arc(300, 90);
+  compare("arc 300 mm left 90");
+  CHECK((PosErr < 2) && (HeadErr < 0.5));
+  arc(-300, 90);
+  compare("arc 300 mm right 90");
+  CHECK((PosErr < 3) && (HeadErr < 0.5));
+  start();
+  arc(200, 360);
+  compare("circle 200 mm");
+  CHECK((PosErr < 3) && (HeadErr < 0.5));
+
+  // spins: a turn each way comes back to the start
+  start();
+  spin(360);
+  compare("spin 360 left");
+  CHECK((PosErr < 1) && (HeadErr < 0.5));
+  spin(-450);
+  compare("spin 450 right");
+  CHECK((PosErr < 1) && (HeadErr < 0.5));
+  Odometry_Get(&p);
+  CHECK(fabs(p.Heading/65536.0-remainder(Tt, 2*PI)) < 0.01);  // radians, Q16
+
+  // a 500 mm square, back to the start facing along X
+  start();
+  for(i = 0; i < 4; i++){
+    drive(250, 250, 2);
+    spin(90);
+  }
+  compare("square 500 mm");
+  CHECK((PosErr < 5) && (HeadErr < 1));
+
+  // a reader never sees half an update: X and Pxx must belong to
+  // the same Updates, with the simulator's timer updating
+  Odometry_Init(WHEELBASE, CIRCUMFERENCE, STEPS, 0, 0);
+  Count = 0;
+  Sim_Every(20, &tick);
+  n = seen = torn = last = 0;
+  while(Count < 2500){
+    Odometry_Get(&p);
+    torn += (p.X != (int32_t)p.Updates*(int32_t)((CIRCUMFERENCE<<16)/STEPS));
+    torn += (p.Pxx != (int32_t)(((int64_t)p.Updates*(2*ODOMETRY_STEPVAR/4))>>16));
+    seen += (p.Updates != last);
+    last = p.Updates;
+    n++;
+  }
+  printf("%u reads, %u updates seen, %u torn\n", n, seen, torn);
+  CHECK(torn == 0);
+  CHECK(seen > 100);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
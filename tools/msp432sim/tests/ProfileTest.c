@@ -0,0 +1,120 @@
+// ProfileTest.c
+// Runs on the host, Linux x86-64
+// Steps the motion profiles of inc/Profile.c as the periodic
+// interrupt would and checks continuity: no step moves further than
+// the speed allows or changes speed faster than the acceleration
+// limit, or acceleration faster than the jerk limit, and the
+// position agrees with the speed. Then the endpoints: the last step
+// is exactly the distance at rest, after the planned number of
+// steps, for long and short moves, trapezoids and S-curves, forward
+// and backward.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include "../../../inc/Profile.h"
+#include "../../../inc/SpeedControl.h"
+#include "../../../inc/Motion.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define RATE SPEED_RATE            // steps per second, as Motion_Update() steps them
+
+// step a planned move to its end, checking every step against the
+// limits; returns the steps taken, or 0 if any step broke a limit
+static uint32_t walk(struct Profile *p, float vmax, float amax, float jmax){
+  double dt = 1.0/RATE, s0 = 0, v0 = 0, a0 = 0, s, v, a, ds, sum = 0;
+  uint32_t n = 0, bad = 0, more;
+  do{
+    more = Profile_Step(p);
+    n++;
+    s = p->Sign*p->Position;       // forward from here on
+    v = p->Sign*p->Velocity;
+    a = (v-v0)/dt;
+    ds = s-s0;
+    bad += (v < -1e-4) || (v > vmax*1.0001+1e-4);
+    bad += (ds < -1e-4) || (ds > vmax*dt*1.0001+1e-4);
+    // the position is the integral of the speed, to the accuracy of
+    // the trapezoid rule across a change of acceleration
+    bad += fabs(ds-0.5*(v0+v)*dt) > 0.25*amax*dt*dt+3e-4;
+    if(more){                      // the last step snaps to the end
+      bad += fabs(a) > amax*1.001+0.05;
+      // a second difference of float speeds, good to a few percent
+      if(jmax > 0) bad += fabs(a-a0) > jmax*dt*1.1+0.05;
+    }
+    sum += 0.5*(v0+v)*dt;
+    s0 = s;
+    v0 = v;
+    a0 = a;
+  }while(more && (n < 100000));
+  if(bad) printf("%u of %u steps off the limits\n", bad, n);
+  bad += fabs(sum-p->Distance) > 0.002*p->Distance+1e-3;
+  return bad ? 0 : n;
+}
+
+// a move with its checks at both ends
+static void move(float d, float vmax, float amax, float jmax){
+  struct Profile p;
+  float s, v;
+  uint32_t n;
+  Profile_Plan(&p, d, vmax, amax, jmax, RATE);
+  CHECK(p.V <= vmax*1.0001f);
+  CHECK(p.A <= amax*1.0001f);
+  CHECK(p.Ticks == (uint32_t)ceilf(p.T*RATE));
+  Profile_At(&p, 0.5f*p.T, &s, &v);
+  CHECK(fabsf(s-0.5f*d) < 1e-3f*fabsf(d)+1e-4f);  // the stop mirrors the start
+  n = walk(&p, vmax, amax, jmax);
+  CHECK(n == p.Ticks);
+  CHECK((p.Position == d) && (p.Velocity == 0));
+  CHECK(Profile_Step(&p) == 0);    // and stays there
+  CHECK((p.Position == d) && (p.Velocity == 0));
+  printf("%8.2f mm %s: peak %7.2f mm/s %8.2f mm/s^2, %u steps\n",
+    d, (jmax > 0) ? "S-curve  " : "trapezoid", p.V, p.A, n);
+}
+
+int main(void){
+  struct Profile p;
+  float s, v;
+
+  // long moves reach the limits, and their times follow
+  move(1000, 300, 600, 0);
+  Profile_Plan(&p, 1000, 300, 600, 0, RATE);
+  CHECK((p.V == 300) && (p.A == 600) && (p.Tj == 0));
+  CHECK(fabsf(p.T-(1000.0f/300+300.0f/600)) < 1e-4f);
+  move(1000, 300, 600, 3000);
+  Profile_Plan(&p, 1000, 300, 600, 3000, RATE);
+  CHECK((p.V == 300) && (p.A == 600));
+  CHECK(fabsf(p.Tj-0.2f) < 1e-6f);
+  CHECK(fabsf(p.T-(1000.0f/300+300.0f/600+0.2f)) < 1e-4f);
+
+  // short moves lower the peak to fit
+  move(50, 300, 600, 0);           // a triangle, V = sqrt(A*d)
+  Profile_Plan(&p, 50, 300, 600, 0, RATE);
+  CHECK(fabsf(p.V-sqrtf(600*50)) < 1e-3f);
+  move(100, 300, 600, 3000);       // reaches amax, not vmax
+  Profile_Plan(&p, 100, 300, 600, 3000, RATE);
+  CHECK((p.V < 300) && (p.A == 600));
+  move(10, 300, 600, 3000);        // not even amax
+  Profile_Plan(&p, 10, 300, 600, 3000, RATE);
+  CHECK((p.A < 600) && (fabsf(p.V-cbrtf(0.25f*10*10*3000)) < 1e-3f));
+
+  // backward, and the moves of Lab5 with the Motion.h limits: each
+  // wheel of a 90 degree turn covers pi*150*90/360 mm
+  move(-250, 300, 600, 3000);
+  move(300, MOTION_VMAX, MOTION_AMAX, MOTION_JMAX);
+  move(-117.81f, MOTION_VMAX, MOTION_AMAX, MOTION_JMAX);
+  move(3.5f, 200, 1000, 0);        // a few steps
+
+  // nothing to do
+  Profile_Plan(&p, 0, 300, 600, 3000, RATE);
+  CHECK(p.Ticks == 0);
+  CHECK(Profile_Step(&p) == 0);
+  CHECK((p.Position == 0) && (p.Velocity == 0));
+  Profile_At(&p, 1, &s, &v);
+  CHECK((s == 0) && (v == 0));
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,126 @@
+// ReflectanceSplitTest.c
+// Runs on the host, Linux x86-64
+// Checks the split-phase Reflectance_Start/Reflectance_End of
+// inc/Reflectance.c against a model of the QTR-8RC on P5, P7 and
+// P9: the IR LEDs, the decay window in simulated time when
+// Reflectance_Init() runs before Clock_Init48MHz(), the double
+// buffer and its sequence number, and Reflectance_Read() from an
+// interrupt during a scan.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/Reflectance.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+// each sensor reads high for its decay time after P7 turns input,
+// which the model sees up to 2 us late
+static const uint32_t Decay[8] = {300, 1200, 500, 2000, 100, 950, 850, 1500};
+static uint64_t Released;          // ns when P7 turned input, 0 while charged
+static void sensor(void){
+  uint64_t now = Sim_Time();
+  uint32_t i;
+  if(MODEL(P7)->DIR){              // charging
+    for(i = 0; i < 8; i++) Sim_SetPin(7, i, 1);
+    Released = 0;
+    return;
+  }
+  if(Released == 0) Released = now;
+  for(i = 0; i < 8; i++){
+    Sim_SetPin(7, i, (now-Released < Decay[i]*1000ull) ? 1 : 0);
+  }
+}
+
+static uint8_t black(uint32_t us){
+  uint8_t data = 0;
+  uint32_t i;
+  for(i = 0; i < 8; i++){
+    if(Decay[i] > us) data |= 1<<i;
+  }
+  return data;
+}
+
+// one scan; returns its length in simulated us
+static uint32_t scan(void){
+  uint64_t t = Sim_Time();
+  Reflectance_Start();
+  CHECK(Sim_GetPin(5, 3) == 1);    // IR LEDs on
+  CHECK(Sim_GetPin(9, 2) == 1);
+  CHECK(Reflectance_Busy());
+  while(Reflectance_Busy()){}
+  CHECK(Sim_GetPin(5, 3) == 0);    // and off again
+  CHECK(Sim_GetPin(9, 2) == 0);
+  return (uint32_t)((Sim_Time()-t)/1000);
+}
+
+// a Reflectance_Read() from an interrupt above T32_INT2
+static volatile int Armed, Result;
+void SysTick_Handler(void){
+  if(Armed){
+    Result = Reflectance_Read(100);
+    Armed = 0;
+  }
+}
+
+int main(void){
+  uint32_t seq, seq2, us;
+  Reflectance_Init();              // before the clock, at 3 MHz
+  Clock_Init48MHz();
+  Sim_SetSpeed(0.05);
+  Sim_Every(2, &sensor);
+  for(us = 0; us < 5; us++) sensor();
+
+  Reflectance_Latest(&seq);
+  CHECK(seq == 0);
+  us = scan();
+  CHECK((us >= REFLECTANCE_DEFAULTTIME) && (us < REFLECTANCE_DEFAULTTIME+60));
+  CHECK(Reflectance_Latest(&seq2) == black(REFLECTANCE_DEFAULTTIME));
+  CHECK(seq2 == seq+1);
+  CHECK(Reflectance_End() == black(REFLECTANCE_DEFAULTTIME));
+
+  // End does not wait, it gives the last complete scan
+  Reflectance_SetTime(400);
+  Reflectance_Start();
+  CHECK(Reflectance_End() == black(REFLECTANCE_DEFAULTTIME));
+  while(Reflectance_Busy()){}
+  CHECK(Reflectance_Latest(&seq) == black(400));
+  CHECK(seq == seq2+1);
+  us = scan();
+  CHECK((us >= 400) && (us < 460));
+  CHECK(Reflectance_End() == black(400));
+
+  // a blocking read is refused during a scan, from the foreground
+  // and from an interrupt that preempts T32_INT2_IRQHandler
+  Reflectance_Start();
+  CHECK(Reflectance_Read(900) == REFLECTANCE_BUSY);
+  CHECK(Reflectance_Center(900) == REFLECTANCE_BUSY);
+  while(Reflectance_Busy()){}
+  SCB->SHP[11] = 0;                // SysTick priority 0, above T32_INT2
+  SysTick->LOAD = 4800-1;          // 100 us
+  SysTick->VAL = 0;
+  SysTick->CTRL = 7;
+  Reflectance_Latest(&seq);
+  Reflectance_Start();
+  Armed = 1;
+  while(Armed){}
+  CHECK(Result == REFLECTANCE_BUSY);
+  while(Reflectance_Busy()){}
+  CHECK(Reflectance_Latest(&seq2) == black(400));
+  CHECK(seq2 == seq+1);
+  SysTick->CTRL = 0;
+
+  // and goes ahead when the sensors are idle
+  CHECK(Reflectance_Read(900) == black(900));
+  CHECK(Reflectance_Center(900) == ((black(900)>>3)&3));
+  CHECK(Sim_GetPin(5, 3) == 0);
+  CHECK(!Reflectance_Busy());
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,94 @@
+// ReflectanceTest.c
+// Runs on the host, Linux x86-64
+// Checks ReflectanceTable[] in inc/Reflectance.c against the
+// weighted-average loop it replaced, and the count and class of
+// every reading, for all 256 inputs. Then times both on the host,
+// in ns per call over every input; the table must not be slower.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "../../../inc/Reflectance.h"
+
+static int Fails;
+#define CHECK(c, data) do{ if(!(c)){ printf("FAIL 0x%02X: %s\n", data, #c); Fails++; } }while(0)
+
+// the Lab 2 loop: bit i has weight W[i], 0 off the line
+static int32_t position(uint8_t data){
+  const int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+  int32_t num = 0, den = 0, i;
+  for(i = 0; i < 8; i++){
+    num += ((data>>i)&1)*W[i];
+    den += (data>>i)&1;
+  }
+  return den ? num/den : 0;
+}
+
+static uint8_t count(uint8_t data){
+  uint8_t n = 0;
+  while(data){
+    n = n + (data&1);
+    data = data>>1;
+  }
+  return n;
+}
+
+// number of runs of adjacent 1s
+static int groups(uint8_t data){
+  int g = 0, i, last = 0;
+  for(i = 0; i < 8; i++){
+    int b = (data>>i)&1;
+    if(b && !last) g++;
+    last = b;
+  }
+  return g;
+}
+
+static uint8_t code(uint8_t data){
+  if(data == 0) return REFLECTANCE_OFFLINE;
+  if(groups(data) > 1) return REFLECTANCE_SPLIT;
+  return (count(data) <= 4) ? REFLECTANCE_LINE : REFLECTANCE_WIDE;
+}
+
+static double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+// ns per call of f over all 256 inputs, the best of 5 tries
+#define ROUNDS 20000
+static volatile int32_t Sink;
+static double bench(int32_t (*f)(uint8_t)){
+  double best = 1e9, t;
+  int r, k, d;
+  for(k = 0; k < 5; k++){
+    t = seconds();
+    for(r = 0; r < ROUNDS; r++){
+      for(d = 0; d < 256; d++) Sink = f(d);
+    }
+    t = (seconds()-t)*1e9/(ROUNDS*256.0);
+    if(t < best) best = t;
+  }
+  return best;
+}
+
+int main(void){
+  double loop, table;
+  int d;
+  for(d = 0; d < 256; d++){
+    CHECK(Reflectance_Position(d) == position(d), d);
+    CHECK(Reflectance_Count(d) == count(d), d);
+    CHECK(Reflectance_Code(d) == code(d), d);
+  }
+  loop = bench(&position);
+  table = bench(&Reflectance_Position);
+  printf("W[] loop %.2f ns per call, ReflectanceTable[] %.2f ns per call\n", loop, table);
+  if(table > loop){
+    printf("FAIL the table is slower than the loop\n");
+    Fails++;
+  }
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,144 @@
+// ReflectanceTimesTest.c
+// Runs on the host, Linux x86-64
+// Replays decay traces through Reflectance_ReadTimes() in
+// inc/Reflectance.c on the simulator: a line swept across the
+// array, a white floor, pins that outlast the budget and a budget
+// too big for times[]. Each trace gives the time every P7 pin stays
+// high after the sensors turn input.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SimModel.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/Reflectance.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define WHITE 250                  // us, decay over the floor
+#define SLACK 20                   // us, a measured time may be late by this
+
+static const int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+static uint32_t Decay[8];          // the trace being replayed
+static uint64_t Released;          // ns when P7 turned input, 0 while charged
+static void sensor(void){
+  uint64_t now = Sim_Time();
+  uint32_t i;
+  if(MODEL(P7)->DIR){              // charging
+    for(i = 0; i < 8; i++) Sim_SetPin(7, i, 1);
+    Released = 0;
+    return;
+  }
+  if(Released == 0) Released = now;
+  for(i = 0; i < 8; i++){
+    Sim_SetPin(7, i, (now-Released < Decay[i]*1000ull) ? 1 : 0);
+  }
+}
+
+// a 19 mm black line centered at x (0.1 mm), darker the closer
+// the sensor is to its middle
+static void line(int32_t x){
+  int i;
+  for(i = 0; i < 8; i++){
+    double d = (W[i]-x)/95.0;
+    Decay[i] = WHITE+(uint32_t)(1500*exp(-d*d));
+  }
+}
+
+// the scan, checked against the trace; a time is never early,
+// but a host stall can make one late, so a late scan is tried
+// again, up to 3 times
+static int replay(uint16_t times[8], uint32_t budget){
+  int high, i, late, tries;
+  for(tries = 1; ; tries++){
+    high = Reflectance_ReadTimes(times, budget);
+    late = 0;
+    for(i = 0; i < 8; i++){
+      if(Decay[i] >= budget){
+        CHECK(times[i] == ((budget > 65535) ? 65535 : budget));
+        CHECK(high&(1<<i));
+      }else{
+        CHECK(times[i] >= Decay[i]);
+        late += (times[i] > Decay[i]+SLACK);
+        CHECK(!(high&(1<<i)));
+      }
+    }
+    if((late == 0) || (tries == 3)) break;
+  }
+  CHECK(late == 0);
+  return high;
+}
+
+// the centroid the exact trace gives
+static int32_t exact(uint16_t white){
+  int32_t num = 0, den = 0, i;
+  for(i = 0; i < 8; i++){
+    int32_t d = (int32_t)Decay[i]-white;
+    if(d > 0){
+      num += d*W[i];
+      den += d;
+    }
+  }
+  return den ? num/den : 0;
+}
+
+int main(void){
+  uint16_t times[8];
+  int32_t x, p, last = 1000;
+  uint64_t t;
+  int i;
+  Clock_Init48MHz();
+  Reflectance_Init();
+  Sim_SetSpeed(0.02);
+  Sim_Every(2, &sensor);
+
+  // the line swept from the left edge to the right, every 2.5 mm
+  for(x = 332; x >= -332; x -= 25){
+    line(x);
+    replay(times, 2500);
+    p = Reflectance_PositionTimes(times, WHITE+50);
+    CHECK((p >= exact(WHITE+50)-10) && (p <= exact(WHITE+50)+10));
+    CHECK(p < last);               // moves with the line
+    if((x <= 237) && (x >= -237)){
+      CHECK((p >= x-20) && (p <= x+20));
+    }
+    last = p;
+  }
+
+  // white floor: all fall together, nothing darker than white
+  for(i = 0; i < 8; i++) Decay[i] = WHITE;
+  CHECK(replay(times, 2500) == 0);
+  CHECK(Reflectance_PositionTimes(times, WHITE+50) == 0);
+
+  // black under sensors 2 and 3 lasts past a short budget
+  line(95);
+  Decay[2] = Decay[3] = 5000;
+  CHECK(replay(times, 1000) == 0x0C);
+
+  // a budget past 65535 us is cut to what times[] holds
+  Sim_SetSpeed(0.1);
+  Decay[7] = 100000;
+  for(i = 0; i < 3; i++){          // again if the host stalls
+    t = Sim_Time();
+    CHECK(Reflectance_ReadTimes(times, 100000) == 0x80);
+    t = (Sim_Time()-t)/1000;
+    if(t < 65535+200) break;
+  }
+  CHECK(times[7] == 65535);
+  CHECK((t >= 65535) && (t < 65535+200));
+  Sim_SetSpeed(0.02);
+
+  // nothing measured during a split-phase scan
+  times[0] = 12345;
+  Reflectance_Start();
+  CHECK(Reflectance_ReadTimes(times, 2500) == REFLECTANCE_BUSY);
+  CHECK(times[0] == 12345);
+  while(Reflectance_Busy()){}
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,157 @@
+// SchedulerTest.c
+// Runs on the host, Linux x86-64
+// Checks the task table scheduler of inc/Scheduler.c, first with a
+// simulated tick: a loop calls Scheduler_Tick() and Scheduler_Run()
+// and a fake cycle counter advances as the tasks say. Release
+// times against period and phase, priority order, one run and an
+// overrun count for missed releases, WCET and total cycles, and
+// the tick cost when nothing is due. Then the same scheduler as
+// the Lab5 robot runs it on the simulator, SysTick releasing and
+// PendSV running, where the tick must preempt a long task.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/SysTickInts.h"
+#include "../../../inc/Scheduler.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+static uint32_t Fake;              // the simulated cycle counter
+static uint32_t fake(void){
+  return Fake;
+}
+
+static char Order[64];             // names of the tasks in the order they ran
+static uint32_t OrderN;
+static uint32_t Bad;               // runs away from Phase+k*Period
+static struct SchedTask Table[3];
+static void task(uint32_t i, uint32_t cost){
+  uint32_t tick = Scheduler_Now()-1;
+  if(OrderN < sizeof(Order)-1){
+    Order[OrderN++] = Table[i].Name[0];
+    Order[OrderN] = 0;
+  }
+  if((tick < Table[i].Phase) || ((tick-Table[i].Phase)%Table[i].Period)) Bad++;
+  Fake += cost;
+}
+static void taskA(void){ task(0, 100); }
+static void taskB(void){ task(1, 300+Scheduler_Now()%7); }
+static void taskC(void){ task(2, 2000); }
+
+// on the simulator
+static struct SchedTask Robot[2];
+static volatile uint32_t Preempted;// ticks during the last long run
+static void fast(void){}
+static void slow(void){
+  uint64_t t = Sim_Time();
+  uint32_t now = Scheduler_Now();
+  while(Sim_Time()-t < 3000000){}  // 3 ms, the tick is 1 ms
+  Preempted = Scheduler_Now()-now;
+}
+static uint32_t cycles(void){
+  return DWT->CYCCNT;
+}
+void SysTick_Handler(void){
+  if(Scheduler_Tick()){
+    SCB->ICSR = 0x10000000;        // PENDSVSET
+  }
+}
+void PendSV_Handler(void){
+  Scheduler_Run();
+}
+
+static void table(void){
+  memset(Table, 0, sizeof(Table));
+  Table[0] = (struct SchedTask){ .Name = "A", .Task = &taskA, .Period = 10, .Phase = 0, .Priority = 1 };
+  Table[1] = (struct SchedTask){ .Name = "B", .Task = &taskB, .Period = 50, .Phase = 3, .Priority = 0 };
+  Table[2] = (struct SchedTask){ .Name = "C", .Task = &taskC, .Period = 100, .Phase = 3, .Priority = 2 };
+  Scheduler_Init(Table, 3, &fake);
+  OrderN = Bad = 0;
+}
+
+int main(void){
+  uint32_t i, due, wcet;
+  uint64_t t;
+
+  // 1000 ticks, the tasks run after each one
+  table();
+  due = 0;
+  for(i = 0; i < 1000; i++){
+    due += Scheduler_Tick();
+    Scheduler_Run();
+  }
+  CHECK(Scheduler_Now() == 1000);
+  CHECK(Bad == 0);
+  CHECK((Table[0].Runs == 100) && (Table[1].Runs == 20) && (Table[2].Runs == 10));
+  CHECK(due == 100+20);            // ticks 3, 53, ... release B and C together
+  CHECK((Table[0].Overruns == 0) && (Table[1].Overruns == 0) && (Table[2].Overruns == 0));
+  CHECK((Table[0].WCET == 100) && (Table[0].Cycles == 100*100));
+  CHECK(Table[2].WCET == 2000);
+  wcet = 0;
+  for(i = 3; i < 1000; i += 50) if(300+(i+1)%7 > wcet) wcet = 300+(i+1)%7;
+  CHECK(Table[1].WCET == wcet);
+  CHECK(strncmp(Order, "ABCA", 4) == 0);
+
+  // released together, highest priority first
+  table();
+  for(i = 0; i < 3; i++) Scheduler_Tick();
+  CHECK(Scheduler_Tick());         // tick 3, B and C
+  Scheduler_Run();
+  CHECK(strcmp(Order, "BAC") == 0);// A's release at tick 0 waited too
+  CHECK(Bad == 1);                 // A ran at tick 3
+
+  // releases missed while the tasks did not run: one run each
+  table();
+  for(i = 0; i < 35; i++) Scheduler_Tick();
+  CHECK(Table[0].Overruns == 3);   // 4 releases, ticks 0 to 30
+  CHECK(Table[2].Overruns == 0);
+  Scheduler_Run();
+  CHECK((Table[0].Runs == 1) && (Table[1].Runs == 1) && (Table[2].Runs == 1));
+  Scheduler_Run();
+  CHECK(Table[0].Runs == 1);
+  Scheduler_ResetStats();
+  CHECK((Table[0].Runs == 0) && (Table[0].Overruns == 0) && (Table[2].WCET == 0) && (Table[2].Cycles == 0));
+
+  // nothing due between releases
+  table();
+  CHECK(Scheduler_Tick());         // tick 0, A
+  Scheduler_Run();
+  CHECK(Scheduler_Tick() == 0);    // ticks 1 and 2
+  CHECK(Scheduler_Tick() == 0);
+  CHECK(Scheduler_Tick());         // tick 3, B and C
+
+  // on the simulator: SysTick at 1 ms releases, PendSV at
+  // priority 7 runs the tasks, and the tick preempts them
+  Clock_Init48MHz();
+  Sim_SetSpeed(0.2);
+  CoreDebug->DEMCR |= 0x01000000;
+  DWT->CTRL |= 0x00000001;
+  Robot[0] = (struct SchedTask){ .Name = "fast", .Task = &fast, .Period = 1, .Phase = 0, .Priority = 0 };
+  Robot[1] = (struct SchedTask){ .Name = "slow", .Task = &slow, .Period = 20, .Phase = 5, .Priority = 1 };
+  Scheduler_Init(Robot, 2, &cycles);
+  SCB->SHP[10] = 7<<5;
+  SysTick_Init(48000, 2);
+  EnableInterrupts();
+  t = Sim_Time();
+  while(Sim_Time()-t < 200000000){}
+  SysTick->CTRL = 0;
+  i = Scheduler_Now();
+  printf("%u ticks, slow ran %u times, WCET %u cycles, fast %u runs %u overruns\n",
+    i, Robot[1].Runs, Robot[1].WCET, Robot[0].Runs, Robot[0].Overruns);
+  CHECK((i >= 199) && (i <= 201));
+  CHECK((Robot[1].Runs >= 9) && (Robot[1].Runs <= 10));
+  CHECK(Preempted >= 2);           // ticks went on under the 3 ms task
+  CHECK((Robot[1].WCET >= 3*48000) && (Robot[1].WCET < 6*48000));
+  CHECK(Robot[0].Overruns >= 2*(Robot[1].Runs-1)); // fast waited behind slow
+  CHECK(Robot[0].Runs+Robot[0].Overruns >= i-1);
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,174 @@
+// TelemetryTest.cpp
+// Runs on the host, Linux x86-64
+// Round trip of inc/Telemetry.c through the tools/telemetry
+// decoder, with a stand-in for UART0 that keeps the bytes:
+// 100000 samples, COBS at every length 0 to 700, frames dropped
+// while both buffers are busy, and corrupted or noisy streams.
+// October 16, 2026
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "../../../inc/Telemetry.h"
+}
+#include "../../telemetry/TelemetryDecoder.h"
+
+static int Fails;
+#define CHECK(c) do { if (!(c)) { printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } } while (0)
+
+// ---- UART0.h: queue the bytes, finish each buffer at once unless held ----
+static std::vector<uint8_t> Wire;
+static bool Hold;                 // leave buffers in flight until UART0_Flush()
+static std::vector<std::pair<const void *, void (*)(const void *)>> InFlight;
+
+extern "C" int UART0_WriteCallback(const void *buf, size_t size, void (*done)(const void *buf)) {
+  const uint8_t *p = static_cast<const uint8_t *>(buf);
+  Wire.insert(Wire.end(), p, p + size);
+  if (Hold) {
+    InFlight.push_back({buf, done});
+  } else if (done) {
+    done(buf);
+  }
+  return 1;
+}
+extern "C" void UART0_Flush(void) {
+  for (auto &f : InFlight) {
+    if (f.second) {
+      f.second(f.first);
+    }
+  }
+  InFlight.clear();
+}
+
+// samples much like the robot's, with now and then a jump to any value
+static TelemetryRecord next(const TelemetryRecord &last) {
+  TelemetryRecord r = last;
+  if (rand() % 50 == 0) {
+    uint8_t *p = reinterpret_cast<uint8_t *>(&r);
+    for (size_t i = 0; i < sizeof(r); i++) {
+      p[i] = static_cast<uint8_t>(rand());
+    }
+    return r;
+  }
+  r.Time += 2;
+  if (rand() % 4 == 0) r.Reflectance = static_cast<uint8_t>(rand());
+  if (rand() % 20 == 0) r.Bumps = static_cast<uint8_t>(rand() & 0x3F);
+  for (int k = 0; k < 3; k++) r.IR[k] = static_cast<uint16_t>(r.IR[k] + rand() % 21 - 10);
+  for (int k = 0; k < 2; k++) {
+    r.Period[k] = static_cast<uint16_t>(r.Period[k] + rand() % 201 - 100);
+    r.Steps[k] += rand() % 3;
+    if (rand() % 10 == 0) r.Duty[k] = static_cast<int16_t>(rand() % 30001 - 15000);
+  }
+  return r;
+}
+
+static void roundTrip(void) {
+  std::vector<TelemetryRecord> sent, got;
+  TelemetryRecord r = {};
+  TelemetryDecoder d([&got](uint8_t, const TelemetryRecord &s) { got.push_back(s); });
+  Wire.clear();
+  Telemetry_Init();
+  for (int i = 0; i < 100000; i++) {
+    r = next(r);
+    sent.push_back(r);
+    Telemetry_Add(&r);
+  }
+  Telemetry_Flush();
+  d.Feed(Wire.data(), Wire.size());
+  CHECK(got.size() == sent.size());
+  CHECK(memcmp(got.data(), sent.data(), sizeof(TelemetryRecord) * sent.size()) == 0);
+  CHECK(d.GetStats().Frames == (100000 + TELEMETRY_BATCH - 1) / TELEMETRY_BATCH);
+  CHECK(d.GetStats().BadCRC == 0 && d.GetStats().BadFrame == 0 && d.GetStats().Missing == 0);
+  CHECK(Telemetry_Dropped() == 0);
+  printf("  %u samples in %u bytes, %.1f bytes per sample\n", static_cast<unsigned>(sent.size()),
+         static_cast<unsigned>(Wire.size()), static_cast<double>(Wire.size()) / sent.size());
+}
+
+static void cobs(void) {
+  static uint8_t src[700], enc[700 + 700 / 254 + 1];
+  for (uint32_t n = 0; n <= 700; n++) {
+    for (uint32_t i = 0; i < n; i++) {
+      src[i] = (rand() % 4 == 0) ? 0 : static_cast<uint8_t>(rand());
+    }
+    if (n == 600) memset(src, 0x55, n);   // runs past 254 with no 0
+    uint32_t len = Telemetry_COBSEncode(enc, src, n);
+    std::vector<uint8_t> in(enc, enc + len), out;
+    CHECK(len <= n + n / 254 + 1);
+    CHECK(memchr(enc, 0, len) == nullptr);
+    CHECK(TelemetryDecoder::COBSDecode(in, out));
+    CHECK(out.size() == n && memcmp(out.data(), src, n) == 0);
+  }
+}
+
+// with both buffers in flight the next frame is dropped, and the
+// decoder sees the gap in the sequence numbers
+static void drops(void) {
+  TelemetryRecord r = {};
+  TelemetryDecoder d([](uint8_t, const TelemetryRecord &) {});
+  Wire.clear();
+  Telemetry_Init();
+  Hold = true;
+  for (int i = 0; i < 3 * TELEMETRY_BATCH; i++) {
+    r = next(r);
+    Telemetry_Add(&r);
+  }
+  CHECK(Telemetry_Dropped() == 1);
+  Hold = false;
+  UART0_Flush();
+  for (int i = 0; i < TELEMETRY_BATCH; i++) {
+    r = next(r);
+    Telemetry_Add(&r);
+  }
+  Telemetry_Flush();
+  d.Feed(Wire.data(), Wire.size());
+  CHECK(d.GetStats().Frames == 3);
+  CHECK(d.GetStats().Missing == 1);
+}
+
+// a bad byte costs only its own frame, and noise between frames is
+// counted and skipped
+static void corrupt(void) {
+  TelemetryRecord r = {};
+  std::vector<size_t> ends;
+  Wire.clear();
+  Telemetry_Init();
+  for (int i = 0; i < 20 * TELEMETRY_BATCH; i++) {
+    r = next(r);
+    Telemetry_Add(&r);
+    if (i % TELEMETRY_BATCH == TELEMETRY_BATCH - 1) ends.push_back(Wire.size());
+  }
+  Telemetry_Flush();
+  for (int frame = 1; frame < 19; frame++) {
+    for (size_t at = ends[frame - 1]; at < ends[frame] - 1; at++) {
+      std::vector<uint8_t> bad = Wire;
+      uint32_t samples = 0;
+      bad[at] = static_cast<uint8_t>(bad[at] == 0x01 ? 0x02 : bad[at] ^ 0x01);
+      TelemetryDecoder d([&samples](uint8_t, const TelemetryRecord &) { samples++; });
+      d.Feed(bad.data(), bad.size());
+      CHECK(d.GetStats().BadCRC + d.GetStats().BadFrame == 1);
+      CHECK(d.GetStats().Frames == 19 && samples == 19 * TELEMETRY_BATCH);
+      CHECK(d.GetStats().Missing == 1);
+    }
+  }
+  std::vector<uint8_t> noisy(Wire.begin(), Wire.begin() + ends[9]);
+  const uint8_t junk[] = {0x13, 0x37, 0xFF, 0x00, 0x00, 0x42, 0x00};
+  noisy.insert(noisy.end(), junk, junk + sizeof(junk));
+  noisy.insert(noisy.end(), Wire.begin() + ends[9], Wire.end());
+  TelemetryDecoder d([](uint8_t, const TelemetryRecord &) {});
+  d.Feed(noisy.data(), noisy.size());
+  CHECK(d.GetStats().Frames == 20 && d.GetStats().Missing == 0);
+  CHECK(d.GetStats().BadCRC + d.GetStats().BadFrame == 2);
+}
+
+int main() {
+  srand(12);
+  roundTrip();
+  cobs();
+  drops();
+  corrupt();
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
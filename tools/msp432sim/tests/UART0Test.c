@@ -0,0 +1,130 @@
+// UART0Test.c
+// Runs on the host, Linux x86-64
+// Checks the DMA transmit queue of inc/UART0.c against the
+// simulator's EUSCI_A0 and DMA models, with every byte that
+// leaves the shift register watched: the text and its order
+// across UART0_OutChar() and UART0_Write(), the back-pressure of
+// a full queue and a full TxBuf, the completion callbacks, the
+// line rate, UART0_Flush() with interrupts disabled, and the
+// time a caller spends in UART0_OutString().
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/UART0.h"
+
+static int Fails;
+#define CHECK(c) do{ if(!(c)){ printf("FAIL line %d: %s\n", __LINE__, #c); Fails++; } }while(0)
+
+#define CHARNS 86806               // 10 bits at 115,200 baud
+
+static char Seen[8192];
+static volatile uint32_t SeenN;
+static void watch(uint8_t data){
+  if(SeenN < sizeof(Seen)) Seen[SeenN] = data;
+  SeenN++;
+}
+
+// the bytes seen since the last call match want
+static int sent(const char *want){
+  uint32_t n = strlen(want);
+  int ok = (SeenN == n) && (memcmp(Seen, want, n) == 0);
+  if(!ok) printf("sent %u bytes \"%.*s\", wanted \"%s\"\n", SeenN, (int)SeenN, Seen, want);
+  SeenN = 0;
+  return ok;
+}
+
+static const void *Done[32];
+static volatile uint32_t DoneN;
+static void done(const void *buf){
+  Done[DoneN++] = buf;
+}
+
+int main(void){
+  static char lines[UART0_TXQSIZE+1][8];
+  static char big[1200], want[4*(UART0_TXQSIZE+1)+1];
+  uint64_t t;
+  uint32_t i, n;
+  Clock_Init48MHz();
+  Sim_Watch(&watch);
+  UART0_Init();
+  EnableInterrupts();
+
+  // OutChar, OutString and OutUDec come out in order
+  UART0_OutChar('>');
+  UART0_OutString("hello ");
+  UART0_OutUDec(4294967295u);
+  UART0_OutUHex2(0x3C);
+  UART0_Flush();
+  CHECK(sent(">hello 42949672953C"));
+
+  // the caller does not wait for the line; slowed down, as each
+  // register access costs the simulator microseconds of host time
+  Sim_SetSpeed(0.05);
+  t = Sim_Time();
+  UART0_OutString("0123456789012345678901234567890123456789");
+  t = Sim_Time()-t;
+  CHECK(t < 4*CHARNS);
+  t = Sim_Time();
+  UART0_Flush();
+  t = Sim_Time()-t;
+  CHECK((t > 36*CHARNS) && (t < 41*CHARNS));
+  CHECK(sent("0123456789012345678901234567890123456789"));
+  Sim_SetSpeed(1);
+
+  // Write is not copied and keeps its place among OutChar bytes
+  UART0_OutString("a");
+  CHECK(UART0_Write("BCD", 3));
+  UART0_OutString("ef");
+  CHECK(UART0_Write("", 0));
+  CHECK(UART0_Write("G", 1));
+  UART0_Flush();
+  CHECK(sent("aBCDefG"));
+
+  // a full queue refuses the next buffer and takes it once one is done
+  DoneN = 0;
+  for(i = 0; i <= UART0_TXQSIZE; i++) sprintf(lines[i], "<%02u>", i);
+  for(i = 0; i < UART0_TXQSIZE; i++){
+    CHECK(UART0_WriteCallback(lines[i], 4, &done));
+  }
+  CHECK(UART0_WriteCallback(lines[UART0_TXQSIZE], 4, &done) == 0);
+  CHECK(DoneN == 0);
+  while(DoneN == 0){}
+  CHECK(Done[0] == lines[0]);
+  CHECK(UART0_WriteCallback(lines[UART0_TXQSIZE], 4, &done));
+  UART0_Flush();
+  CHECK(DoneN == UART0_TXQSIZE+1);
+  n = 0;
+  for(i = 0; i <= UART0_TXQSIZE; i++){
+    n += (Done[i] == lines[i]);
+    strcpy(&want[4*i], lines[i]);
+  }
+  CHECK(n == UART0_TXQSIZE+1);
+  CHECK(sent(want));
+
+  // more than TxBuf holds: OutChar waits for room and loses nothing
+  for(i = 0; i < sizeof(big)-1; i++) big[i] = 'A'+i%26;
+  big[sizeof(big)-1] = 0;
+  t = Sim_Time();
+  UART0_OutString(big);
+  t = Sim_Time()-t;
+  CHECK(t > (uint64_t)(sizeof(big)-1-UART0_TXBUFSIZE-2)*CHARNS);
+  UART0_Flush();
+  CHECK(sent(big));
+
+  // with interrupts disabled the waiting loops move the bytes
+  DisableInterrupts();
+  UART0_OutString("no interrupts ");
+  CHECK(UART0_Write("still sent", 10));
+  UART0_Flush();
+  EnableInterrupts();
+  CHECK(sent("no interrupts still sent"));
+
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,160 @@
+// WidgetTest.c
+// Runs on the host, Linux x86-64
+// Snapshot test of inc/Widget.c: a dashboard of a reflectance bar,
+// a two-trace strip chart and four bar gauges takes 400 random
+// samples. After each one Screen must equal a snapshot redrawn
+// from scratch out of the whole history, the simulated display
+// must equal Screen after the flush, and a repeat of the same
+// values must send nothing.
+// October 16, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../../../inc/Clock.h"
+#include "../../../inc/CortexM.h"
+#include "../../../inc/Nokia5110.h"
+#include "../../../inc/Widget.h"
+
+#define SAMPLES 400
+#define CHARTW 60
+#define CHARTH 30
+
+static int Fails;
+static uint8_t Ref[48][84];
+static int32_t Rows[SAMPLES][2];   // chart row of each trace per sample
+static uint32_t Total;             // data bytes the display has received
+
+static int pixel(int32_t y, int32_t x){
+  return (Screen[84*(y/8)+x]>>(y%8))&1;
+}
+
+static int32_t scale(int32_t v, int32_t min, int32_t max, int32_t n){
+  if(v <= min) return 0;
+  if(v >= max) return n;
+  return (int32_t)(((int64_t)(v-min)*n+(max-min)/2)/(max-min));
+}
+
+// the one-pixel frame of a cell or gauge, and a filled inside
+static void frame(int32_t x, int32_t y, int32_t w, int32_t h){
+  int32_t a, b;
+  for(a = y; a < y+h; a++){
+    for(b = x; b < x+w; b++){
+      if((a == y) || (a == y+h-1) || (b == x) || (b == x+w-1)) Ref[a][b] = 1;
+    }
+  }
+}
+static void inside(int32_t x, int32_t y, int32_t w, int32_t h){
+  int32_t a, b;
+  for(a = y; a < y+h; a++){
+    for(b = x; b < x+w; b++) Ref[a][b] = 1;
+  }
+}
+
+// the whole dashboard after n samples
+static void snapshot(int32_t n, uint8_t data, const int32_t *ir){
+  int32_t i, c, t, a;
+  memset(Ref, 0, sizeof(Ref));
+  for(i = 0; i < 8; i++){
+    frame(2+10*i, 0, 11, 8);
+    if(data&(0x80>>i)) inside(2+10*i+1, 1, 9, 6);
+  }
+  for(c = 0; c < CHARTW; c++){
+    int32_t k = n-CHARTW+c;
+    if(k < 0) continue;
+    for(t = 0; t < 2; t++){
+      int32_t row = Rows[k][t], prev = (k > 0) ? Rows[k-1][t] : row;
+      int32_t top = (row < prev) ? row : prev, bottom = (row < prev) ? prev : row;
+      for(a = top; a <= bottom; a++) Ref[a][c] = 1;
+    }
+  }
+  for(i = 0; i < 3; i++){
+    int32_t level = scale(ir[i], 0, 800, 36);
+    frame(63+7*i, 10, 6, 38);
+    if(level) inside(63+7*i+1, 10+38-1-level, 4, level);
+  }
+  frame(0, 41, CHARTW, 7);
+  a = scale(ir[0], 0, 800, CHARTW-2);
+  if(a) inside(1, 42, a, 5);
+}
+
+// compare with the snapshot, flush, compare the display, and
+// return the data bytes sent
+static uint32_t compare(const char *what, int32_t i){
+  uint8_t image[504];
+  int32_t y, x, n = 0;
+  uint32_t total, sent;
+  for(y = 0; y < 48; y++){
+    for(x = 0; x < 84; x++) n += pixel(y, x) != Ref[y][x];
+  }
+  if(n){
+    printf("FAIL %s %d: %d pixels differ from the snapshot\n", what, i, n);
+    Fails++;
+  }
+  Nokia5110_DisplayBuffer();
+  while(Nokia5110_DisplayBusy()){}
+  Clock_Delay1ms(1);
+  total = Sim_Display(image);
+  sent = total-Total;
+  Total = total;
+  if(memcmp(image, Screen, 504) != 0){
+    printf("FAIL %s %d: display differs from Screen\n", what, i);
+    Fails++;
+  }
+  return sent;
+}
+
+int main(void){
+  struct Chart chart;
+  struct Gauge gauge[4];
+  struct Reflect bar;
+  int32_t speed[2] = {0, 0}, ir[3] = {400, 400, 400}, i, k;
+  uint8_t data = 0;
+  uint32_t sent;
+  Clock_Init48MHz();
+  Nokia5110_Init();
+  EnableInterrupts();
+  srand(2);
+  Nokia5110_ClearBuffer();
+  Widget_InitReflect(&bar, 2, 0, 11, 8);
+  Widget_InitChart(&chart, 0, 10, CHARTW, CHARTH, -300, 300, 2);
+  for(i = 0; i < 3; i++) Widget_InitGauge(&gauge[i], 63+7*i, 10, 6, 38, 0, 800, 1);
+  Widget_InitGauge(&gauge[3], 0, 41, CHARTW, 7, 0, 800, 0);
+  for(i = 0; i < 3; i++) Widget_Gauge(&gauge[i], ir[i]);
+  Widget_Gauge(&gauge[3], ir[0]);
+  snapshot(0, data, ir);
+  compare("start", 0);
+  for(i = 0; i < SAMPLES; i++){
+    for(k = 0; k < 2; k++){
+      speed[k] += rand()%81-40;
+      if(i%97 == k) speed[k] = (k == 0) ? 1000 : -1000;   // off the chart
+      if(speed[k] > 350) speed[k] = 350;
+      if(speed[k] < -350) speed[k] = -350;
+      Rows[i][k] = 10+CHARTH-1-scale(speed[k], -300, 300, CHARTH-1);
+    }
+    if(rand()%3 == 0) data ^= 1<<(rand()%8);
+    for(k = 0; k < 3; k++){
+      ir[k] += rand()%101-50;
+      if(rand()%20 == 0) ir[k] = rand()%1000-100;
+    }
+    Widget_Reflect(&bar, data);
+    Widget_Chart(&chart, speed);
+    for(k = 0; k < 3; k++) Widget_Gauge(&gauge[k], ir[k]);
+    Widget_Gauge(&gauge[3], ir[0]);
+    snapshot(i+1, data, ir);
+    compare("sample", i);
+  }
+  Widget_Reflect(&bar, data);      // the same values again
+  for(k = 0; k < 3; k++) Widget_Gauge(&gauge[k], ir[k]);
+  Widget_Gauge(&gauge[3], ir[0]);
+  sent = compare("unchanged", SAMPLES);
+  if(sent != 0){
+    printf("FAIL unchanged widgets sent %u bytes\n", sent);
+    Fails++;
+  }
+  printf("%s\n", Fails ? "FAILED" : "ok");
+  return Fails != 0;
+}
@@ -0,0 +1,22 @@
+// msp.h
+// Runs on the host PC
+// Stands in for the MSP432 msp.h when speedsim builds
+// inc/Tachometer.c: the ports it uses for Encoder B are plain
+// variables that speedsim.c sets before each capture.
+// October 16, 2026
+
+#ifndef __MSP_H__ // do not include more than once
+#define __MSP_H__
+#include <stdint.h>
+
+struct SpeedsimPort{
+  uint8_t IN;
+  uint8_t DIR;
+  uint8_t SEL0;
+  uint8_t SEL1;
+};
+extern struct SpeedsimPort SpeedsimP9, SpeedsimP10;
+#define P9  (&SpeedsimP9)
+#define P10 (&SpeedsimP10)
+
+#endif
@@ -0,0 +1,137 @@
+// TelemetryDecoder.cpp
+// Runs on the host PC
+// Decoder for the COBS-framed telemetry stream of inc/Telemetry.c.
+// October 16, 2026
+
+#include "TelemetryDecoder.h"
+#include <utility>
+
+TelemetryDecoder::TelemetryDecoder(SampleHandler handler)
+  : handler(std::move(handler)) {
+  encoded.reserve(TELEMETRY_FRAMEMAX);
+}
+
+void TelemetryDecoder::Feed(const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    if (data[i] == 0) {
+      frameEnd();
+    } else if (encoded.size() < TELEMETRY_FRAMEMAX) {
+      encoded.push_back(data[i]);
+    } else {
+      overflow = true;            // no delimiter, resynchronize at the next 0x00
+    }
+  }
+}
+
+// CRC-16/CCITT-FALSE, same as Telemetry_CRC16() on the robot
+static uint16_t crc16(const uint8_t *data, size_t size) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= static_cast<uint16_t>(data[i] << 8);
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+void TelemetryDecoder::frameEnd() {
+  std::vector<uint8_t> raw;
+  std::vector<TelemetryRecord> samples;
+  uint8_t seq;
+  if (encoded.empty()) {
+    return;                       // idle line or back-to-back delimiters
+  }
+  if (overflow || !COBSDecode(encoded, raw) || raw.size() < 4) {
+    stats.BadFrame++;
+  } else if (crc16(raw.data(), raw.size() - 2) !=
+             (raw[raw.size() - 2] | (raw[raw.size() - 1] << 8))) {
+    stats.BadCRC++;
+  } else if (!DecodeFrame(raw, seq, samples)) {
+    stats.BadFrame++;
+  } else {
+    if (haveSeq) {
+      stats.Missing += static_cast<uint8_t>(seq - lastSeq - 1);
+    }
+    haveSeq = true;
+    lastSeq = seq;
+    stats.Frames++;
+    for (const TelemetryRecord &r : samples) {
+      stats.Samples++;
+      handler(seq, r);
+    }
+  }
+  encoded.clear();
+  overflow = false;
+}
+
+bool TelemetryDecoder::COBSDecode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out) {
+  size_t i = 0;
+  out.clear();
+  while (i < in.size()) {
+    uint8_t code = in[i];
+    if (code == 0 || i + code > in.size()) {
+      return false;
+    }
+    out.insert(out.end(), in.begin() + i + 1, in.begin() + i + code);
+    i += code;
+    if (code != 0xFF && i < in.size()) {
+      out.push_back(0);
+    }
+  }
+  return true;
+}
+
+static bool getVarint(const std::vector<uint8_t> &raw, size_t &i, size_t end, int32_t &value) {
+  uint32_t z = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (i >= end) {
+      return false;
+    }
+    uint8_t b = raw[i++];
+    z |= static_cast<uint32_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      value = static_cast<int32_t>((z >> 1) ^ (0u - (z & 1)));
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TelemetryDecoder::DecodeFrame(const std::vector<uint8_t> &raw, uint8_t &seq,
+                                   std::vector<TelemetryRecord> &samples) {
+  size_t end = raw.size() - 2;    // CRC already checked
+  size_t i = 2;
+  TelemetryRecord r = {};
+  seq = raw[0];
+  samples.clear();
+  for (unsigned n = 0; n < raw[1]; n++) {
+    int32_t d[TELEMETRY_FIELDS] = {};
+    if (i + 2 > end) {
+      return false;
+    }
+    uint32_t mask = raw[i] | (raw[i + 1] << 8);
+    i += 2;
+    if (mask >> TELEMETRY_FIELDS) {
+      return false;
+    }
+    for (int f = 0; f < TELEMETRY_FIELDS; f++) {
+      if ((mask & (1u << f)) && !getVarint(raw, i, end, d[f])) {
+        return false;
+      }
+    }
+    r.Time += static_cast<uint32_t>(d[0]);
+    r.Reflectance = static_cast<uint8_t>(r.Reflectance + d[1]);
+    r.Bumps = static_cast<uint8_t>(r.Bumps + d[2]);
+    for (int k = 0; k < 3; k++) {
+      r.IR[k] = static_cast<uint16_t>(r.IR[k] + d[3 + k]);
+    }
+    for (int k = 0; k < 2; k++) {
+      r.Period[k] = static_cast<uint16_t>(r.Period[k] + d[6 + k]);
+      r.Steps[k] = static_cast<int32_t>(static_cast<uint32_t>(r.Steps[k]) + static_cast<uint32_t>(d[8 + k]));
+      r.Duty[k] = static_cast<int16_t>(r.Duty[k] + d[10 + k]);
+    }
+    samples.push_back(r);
+  }
+  return i == end;
+}
@@ -0,0 +1,52 @@
+// TelemetryDecoder.h
+// Runs on the host PC
+// Decoder for the COBS-framed telemetry stream of inc/Telemetry.c.
+// Feed it bytes in any chunk size; it calls back once per sample.
+// October 16, 2026
+
+#ifndef __TELEMETRYDECODER_H__ // do not include more than once
+#define __TELEMETRYDECODER_H__
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../../inc/Telemetry.h"  // record layout and sizes only
+
+class TelemetryDecoder {
+public:
+  // called for each decoded sample with the frame sequence number
+  using SampleHandler = std::function<void(uint8_t seq, const TelemetryRecord &r)>;
+
+  struct Stats {
+    uint32_t Frames = 0;       // good frames
+    uint32_t Samples = 0;      // samples delivered
+    uint32_t BadCRC = 0;       // frames with a CRC error
+    uint32_t BadFrame = 0;     // COBS, length or sample coding errors
+    uint32_t Missing = 0;      // frames lost, from sequence gaps
+  };
+
+  explicit TelemetryDecoder(SampleHandler handler);
+
+  // Process received bytes
+  void Feed(const uint8_t *data, size_t size);
+
+  const Stats &GetStats() const { return stats; }
+
+  // Pure functions, exposed for testing
+  static bool COBSDecode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out);
+  static bool DecodeFrame(const std::vector<uint8_t> &raw, uint8_t &seq,
+                          std::vector<TelemetryRecord> &samples);
+
+private:
+  void frameEnd();
+
+  SampleHandler handler;
+  std::vector<uint8_t> encoded;   // bytes since the last 0x00
+  bool overflow = false;
+  bool haveSeq = false;
+  uint8_t lastSeq = 0;
+  Stats stats;
+};
+
+#endif // __TELEMETRYDECODER_H__
@@ -0,0 +1,50 @@
+// telemetry2csv.cpp
+// Runs on the host PC
+// Convert a captured telemetry stream to CSV.
+// October 16, 2026
+//
+// Build from this directory:
+//   g++ -std=c++17 -O2 -o telemetry2csv telemetry2csv.cpp TelemetryDecoder.cpp
+// Usage:
+//   telemetry2csv [capture.bin] > log.csv
+// Reads standard input when no file is given, so a serial port
+// configured for 115200 8N1 raw mode can be piped straight in.
+// Frame statistics go to standard error at the end.
+
+#include <cstdio>
+#include "TelemetryDecoder.h"
+
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 1) {
+    in = std::fopen(argv[1], "rb");
+    if (in == nullptr) {
+      std::perror(argv[1]);
+      return 1;
+    }
+  }
+  std::printf("seq,time_ms,reflectance,bumps,ir_left,ir_center,ir_right,"
+              "period_left,period_right,steps_left,steps_right,duty_left,duty_right\n");
+  TelemetryDecoder decoder([](uint8_t seq, const TelemetryRecord &r) {
+    std::printf("%u,%lu,%u,%u,%u,%u,%u,%u,%u,%ld,%ld,%d,%d\n",
+                seq, static_cast<unsigned long>(r.Time), r.Reflectance, r.Bumps,
+                r.IR[0], r.IR[1], r.IR[2], r.Period[0], r.Period[1],
+                static_cast<long>(r.Steps[0]), static_cast<long>(r.Steps[1]),
+                r.Duty[0], r.Duty[1]);
+  });
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+    decoder.Feed(buf, n);
+    std::fflush(stdout);
+  }
+  const TelemetryDecoder::Stats &s = decoder.GetStats();
+  std::fprintf(stderr, "frames %lu, samples %lu, bad CRC %lu, bad frames %lu, missing %lu\n",
+               static_cast<unsigned long>(s.Frames), static_cast<unsigned long>(s.Samples),
+               static_cast<unsigned long>(s.BadCRC), static_cast<unsigned long>(s.BadFrame),
+               static_cast<unsigned long>(s.Missing));
+  if (in != stdin) {
+    std::fclose(in);
+  }
+  return 0;
+}